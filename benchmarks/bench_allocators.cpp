@@ -0,0 +1,775 @@
+// Allocator microbenchmarks
+// Replay allocation traces shaped like the game workloads against every heap
+// layer we ship, and report time per operation, resident memory and fragmentation.
+//
+// Usage: bench_allocators [scale] [trace]
+//      scale   multiply the number of operations of every trace, default 1
+//      trace   only run traces which name contain this string
+//
+// Every (trace, heap) pair run in a forked child process, so the RSS of one
+// heap never pollute the next measurement.
+//
+// Columns:
+//      ns/op       wall time per allocation operation (alloc, realloc or free)
+//      peak KB     peak of bytes requested by the trace
+//      live KB     bytes requested that still alive when RSS is sampled
+//      RSS KB      resident memory growth while replaying, sampled before the trace drain
+//      frag        RSS KB / live KB, 1.0 is perfect, lower than 1.0 mean pages are shared with the baseline
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/wait.h>
+
+#include "Native/Memory.h"
+#include "Native/HeapLayers.h"
+
+// -------------------------------------------------------------------
+// Traces
+// -------------------------------------------------------------------
+
+enum TraceOpKind : uint8_t
+{
+    TraceOpKind_Alloc,
+    TraceOpKind_Realloc,
+    TraceOpKind_Free,
+};
+
+struct TraceOp
+{
+    TraceOpKind kind;
+    int32_t     slot;
+    int32_t     size;
+};
+
+struct Trace
+{
+    int32_t     slotCount;
+
+    int32_t     opCount;
+    int32_t     opCapacity;
+    TraceOp*    ops;
+
+    int32_t     drainIndex;     // Index of first op of the drain phase, RSS is sampled here
+    int64_t     liveBytes;      // Bytes alive at the drain point
+    int64_t     peakBytes;
+
+    // Generation state
+    int32_t*    sizes;
+    int64_t     currentBytes;
+};
+
+struct TraceDesc
+{
+    const char* name;
+    int32_t     threadCount;
+    void        (*Generate)(Trace* trace, int32_t threadIndex, int32_t scale);
+};
+
+// Deterministic random, the traces are the same for every heap
+struct Random
+{
+    uint64_t    state;
+
+    inline uint32_t Next(void)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return (uint32_t)(state >> 16);
+    }
+
+    inline int32_t Range(int32_t min, int32_t max)
+    {
+        return min + (int32_t)(Next() % (uint32_t)(max - min + 1));
+    }
+
+    // Log-uniform distribution, many small blocks and few big ones
+    inline int32_t LogRange(int32_t min, int32_t max)
+    {
+        const int32_t minBits = 31 - __builtin_clz((uint32_t)min);
+        const int32_t maxBits = 31 - __builtin_clz((uint32_t)max);
+        const int32_t bits = Range(minBits, maxBits);
+        const int32_t size = (1 << bits) + (int32_t)(Next() & ((1u << bits) - 1));
+        return size < min ? min : (size > max ? max : size);
+    }
+};
+
+static void Trace_Init(Trace* trace, int32_t slotCount)
+{
+    memset(trace, 0, sizeof(*trace));
+    trace->slotCount = slotCount;
+    trace->sizes = (int32_t*)calloc((size_t)slotCount, sizeof(int32_t));
+}
+
+static void Trace_Destroy(Trace* trace)
+{
+    free(trace->ops);
+    free(trace->sizes);
+    memset(trace, 0, sizeof(*trace));
+}
+
+static void Trace_Push(Trace* trace, TraceOpKind kind, int32_t slot, int32_t size)
+{
+    assert(slot >= 0 && slot < trace->slotCount);
+
+    if (trace->opCount == trace->opCapacity)
+    {
+        trace->opCapacity = trace->opCapacity > 0 ? trace->opCapacity * 2 : 4096;
+        trace->ops = (TraceOp*)realloc(trace->ops, sizeof(TraceOp) * (size_t)trace->opCapacity);
+    }
+
+    TraceOp* op = &trace->ops[trace->opCount++];
+    op->kind = kind;
+    op->slot = slot;
+    op->size = size;
+
+    switch (kind)
+    {
+    case TraceOpKind_Alloc:
+        assert(trace->sizes[slot] == 0);
+        trace->currentBytes += size;
+        trace->sizes[slot] = size;
+        break;
+
+    case TraceOpKind_Realloc:
+        assert(trace->sizes[slot] > 0);
+        trace->currentBytes += size - trace->sizes[slot];
+        trace->sizes[slot] = size;
+        break;
+
+    case TraceOpKind_Free:
+        assert(trace->sizes[slot] > 0);
+        trace->currentBytes -= trace->sizes[slot];
+        trace->sizes[slot] = 0;
+        break;
+    }
+
+    if (trace->currentBytes > trace->peakBytes)
+    {
+        trace->peakBytes = trace->currentBytes;
+    }
+}
+
+static void Trace_Alloc(Trace* trace, int32_t slot, int32_t size)
+{
+    Trace_Push(trace, TraceOpKind_Alloc, slot, size);
+}
+
+static void Trace_Realloc(Trace* trace, int32_t slot, int32_t size)
+{
+    Trace_Push(trace, TraceOpKind_Realloc, slot, size);
+}
+
+static void Trace_Free(Trace* trace, int32_t slot)
+{
+    Trace_Push(trace, TraceOpKind_Free, slot, 0);
+}
+
+// Mark the drain point, then free everything still alive
+static void Trace_Drain(Trace* trace)
+{
+    trace->drainIndex = trace->opCount;
+    trace->liveBytes = trace->currentBytes;
+
+    for (int32_t slot = trace->slotCount - 1; slot >= 0; slot--)
+    {
+        if (trace->sizes[slot] > 0)
+        {
+            Trace_Free(trace, slot);
+        }
+    }
+}
+
+// Shape of LDtkParse: world defs, then levels with layers, tiles arrays grown by doubling,
+// whole world unloaded in reverse order before the next load
+static void Trace_GenerateLDtkLoad(Trace* trace, int32_t threadIndex, int32_t scale)
+{
+    constexpr int32_t LEVEL_COUNT       = 16;
+    constexpr int32_t LAYER_COUNT       = 6;
+    constexpr int32_t SLOTS_PER_LAYER   = 4;                            // name, tiles, values, entities
+    constexpr int32_t SLOTS_PER_LEVEL   = 2 + LAYER_COUNT * SLOTS_PER_LAYER;    // name, layers
+    constexpr int32_t DEF_SLOTS         = 64;
+
+    constexpr int32_t TILE_SIZE         = 40;                           // sizeof(LDtkTile)
+    constexpr int32_t LAYER_SIZE        = 200;                          // sizeof(LDtkLayer)
+    constexpr int32_t ENTITY_SIZE       = 48;                           // sizeof(LDtkEntity)
+
+    Trace_Init(trace, DEF_SLOTS + LEVEL_COUNT * SLOTS_PER_LEVEL);
+
+    Random random = { 0x1d7c0ad1ull + (uint64_t)threadIndex };
+    const int32_t loadCount = 32 * scale;
+    for (int32_t load = 0; load < loadCount; load++)
+    {
+        if (load > 0)
+        {
+            for (int32_t slot = trace->slotCount - 1; slot >= 0; slot--)
+            {
+                if (trace->sizes[slot] > 0)
+                {
+                    Trace_Free(trace, slot);
+                }
+            }
+        }
+
+        // Tilesets, enums, layer defs, entity defs, and their names
+        for (int32_t slot = 0; slot < DEF_SLOTS; slot++)
+        {
+            Trace_Alloc(trace, slot, (slot & 1) ? random.Range(8, 32) : random.Range(48, 512));
+        }
+
+        for (int32_t level = 0; level < LEVEL_COUNT; level++)
+        {
+            const int32_t levelSlot = DEF_SLOTS + level * SLOTS_PER_LEVEL;
+            Trace_Alloc(trace, levelSlot + 0, random.Range(8, 32));
+            Trace_Alloc(trace, levelSlot + 1, LAYER_SIZE * LAYER_COUNT);
+
+            for (int32_t layer = 0; layer < LAYER_COUNT; layer++)
+            {
+                const int32_t layerSlot = levelSlot + 2 + layer * SLOTS_PER_LAYER;
+                Trace_Alloc(trace, layerSlot + 0, random.Range(8, 24));
+
+                // Tiles array grow like Array<T>
+                const int32_t tileCount = random.Range(200, 2000);
+                int32_t capacity = 16;
+                Trace_Alloc(trace, layerSlot + 1, capacity * TILE_SIZE);
+                while (capacity < tileCount)
+                {
+                    capacity *= 2;
+                    Trace_Realloc(trace, layerSlot + 1, capacity * TILE_SIZE);
+                }
+
+                Trace_Alloc(trace, layerSlot + 2, random.Range(1, 8) * 24);
+
+                const int32_t entityCount = random.Range(0, 32);
+                if (entityCount > 0)
+                {
+                    Trace_Alloc(trace, layerSlot + 3, entityCount * ENTITY_SIZE);
+                }
+            }
+        }
+    }
+
+    Trace_Drain(trace);
+}
+
+// Shape of a logging burst: each line format into a temp buffer, then the record is kept
+// in a ring of recent lines, the oldest record is freed when the ring is full
+static void Trace_GenerateLogBurst(Trace* trace, int32_t threadIndex, int32_t scale)
+{
+    constexpr int32_t RING_SIZE     = 1024;
+    constexpr int32_t TEMP_SLOT     = RING_SIZE;
+
+    Trace_Init(trace, RING_SIZE + 1);
+
+    Random random = { 0x106b0857ull + (uint64_t)threadIndex };
+    const int32_t lineCount = 200000 * scale;
+    for (int32_t line = 0; line < lineCount; line++)
+    {
+        const int32_t slot = line % RING_SIZE;
+        const int32_t textSize = random.Range(24, 160);
+
+        Trace_Alloc(trace, TEMP_SLOT, 4096);
+
+        if (trace->sizes[slot] > 0)
+        {
+            Trace_Free(trace, slot);
+        }
+        Trace_Alloc(trace, slot, 16 + textSize);
+
+        Trace_Free(trace, TEMP_SLOT);
+    }
+
+    Trace_Drain(trace);
+}
+
+// Shape of string manipulations: short strings created, appended, replaced and destroyed at random
+static void Trace_GenerateStringChurn(Trace* trace, int32_t threadIndex, int32_t scale)
+{
+    constexpr int32_t SLOT_COUNT    = 4096;
+    constexpr int32_t MAX_LENGTH    = 4096;
+
+    Trace_Init(trace, SLOT_COUNT);
+
+    Random random = { 0x5791c4a2ull + (uint64_t)threadIndex };
+    const int32_t stepCount = 400000 * scale;
+    for (int32_t step = 0; step < stepCount; step++)
+    {
+        const int32_t slot = (int32_t)(random.Next() % SLOT_COUNT);
+        const int32_t size = trace->sizes[slot];
+        if (size == 0)
+        {
+            Trace_Alloc(trace, slot, random.LogRange(8, 128));
+            continue;
+        }
+
+        switch (random.Next() % 3)
+        {
+        case 0:
+            Trace_Free(trace, slot);
+            break;
+
+        case 1:
+            if (size + size / 2 + 8 > MAX_LENGTH)
+            {
+                Trace_Free(trace, slot);
+            }
+            else
+            {
+                Trace_Realloc(trace, slot, size + size / 2 + 8);
+            }
+            break;
+
+        case 2:
+            Trace_Free(trace, slot);
+            Trace_Alloc(trace, slot, random.LogRange(8, 128));
+            break;
+        }
+    }
+
+    Trace_Drain(trace);
+}
+
+// Random mixed sizes, every thread own its blocks
+static void Trace_GenerateMixed(Trace* trace, int32_t threadIndex, int32_t scale)
+{
+    constexpr int32_t SLOT_COUNT    = 2048;
+
+    Trace_Init(trace, SLOT_COUNT);
+
+    Random random = { 0x3b9f21c7ull + (uint64_t)threadIndex * 7919 };
+    const int32_t stepCount = 200000 * scale;
+    for (int32_t step = 0; step < stepCount; step++)
+    {
+        const int32_t slot = (int32_t)(random.Next() % SLOT_COUNT);
+        if (trace->sizes[slot] > 0)
+        {
+            Trace_Free(trace, slot);
+        }
+        else
+        {
+            Trace_Alloc(trace, slot, random.LogRange(8, 32 * 1024));
+        }
+    }
+
+    Trace_Drain(trace);
+}
+
+static const TraceDesc TRACES[] = {
+    { "ldtk_load",      1, Trace_GenerateLDtkLoad       },
+    { "log_burst",      1, Trace_GenerateLogBurst       },
+    { "string_churn",   1, Trace_GenerateStringChurn    },
+    { "mixed_mt",       4, Trace_GenerateMixed          },
+};
+
+// -------------------------------------------------------------------
+// Heaps
+// -------------------------------------------------------------------
+
+// Baseline, call the system allocator directly
+struct GlibcMallocBench
+{
+    static constexpr const char*    NAME            = "glibc malloc";
+    static constexpr bool           SHARED_STATE    = false;
+
+    inline void* Alloc(int32_t size)                            { return malloc((size_t)size); }
+    inline void* Realloc(void* ptr, int32_t, int32_t size)      { return realloc(ptr, (size_t)size); }
+    inline void  Free(void* ptr, int32_t)                       { free(ptr); }
+};
+
+struct CrtMallocBench
+{
+    static constexpr const char*    NAME            = "CrtMalloc";
+    static constexpr bool           SHARED_STATE    = false;
+
+    CrtMalloc heap;
+
+    inline void* Alloc(int32_t size)                            { return heap.Alloc(size); }
+    inline void* Realloc(void* ptr, int32_t, int32_t size)      { return heap.Realloc(ptr, size); }
+    inline void  Free(void* ptr, int32_t)                       { heap.Free(ptr); }
+};
+
+// Size classes from 8 bytes to 16KB served by paged free lists, bigger blocks by CRT
+struct StrictSegHeapBench
+{
+    static constexpr const char*    NAME            = "StrictSegHeap";
+    static constexpr bool           SHARED_STATE    = false;
+
+    StrictSegHeap<12, StrictSegHeapTraits, SizeHeap<PagedFreeList>, SizeHeap<CrtMalloc>> heap;
+
+    inline void* Alloc(int32_t size)                            { return heap.Alloc(size); }
+    inline void* Realloc(void* ptr, int32_t, int32_t size)      { return heap.Realloc(ptr, size); }
+    inline void  Free(void* ptr, int32_t)                       { heap.Free(ptr); }
+};
+
+// PagedFreeList only serve one item size, so it get a single 256 bytes class
+// and bigger blocks fall back to CRT, like a pool in front of the general heap
+struct PagedFreeListBench
+{
+    static constexpr const char*    NAME            = "PagedFreeList";
+    static constexpr bool           SHARED_STATE    = false;
+    static constexpr int32_t        ITEM_SIZE       = 256;
+
+    PagedFreeList   heap;
+    CrtMalloc       fallback;
+
+    inline void* Alloc(int32_t size)
+    {
+        return size <= ITEM_SIZE ? heap.Alloc(ITEM_SIZE) : fallback.Alloc(size);
+    }
+
+    inline void* Realloc(void* ptr, int32_t oldSize, int32_t size)
+    {
+        if (oldSize > ITEM_SIZE && size > ITEM_SIZE)
+        {
+            return fallback.Realloc(ptr, size);
+        }
+
+        if (oldSize <= ITEM_SIZE && size <= ITEM_SIZE)
+        {
+            return ptr;
+        }
+
+        void* newPtr = Alloc(size);
+        memcpy(newPtr, ptr, (size_t)(oldSize < size ? oldSize : size));
+        Free(ptr, oldSize);
+        return newPtr;
+    }
+
+    inline void Free(void* ptr, int32_t size)
+    {
+        if (size <= ITEM_SIZE)
+        {
+            heap.Free(ptr);
+        }
+        else
+        {
+            fallback.Free(ptr);
+        }
+    }
+};
+
+// Memory_*Tag in debug build: allocation tracking plus call stack capture
+struct MemoryTrackerBench
+{
+    static constexpr const char*    NAME            = "MemoryTracker";
+    static constexpr bool           SHARED_STATE    = true;
+    static constexpr const char*    TAG             = "Bench";
+
+    inline void* Alloc(int32_t size)                            { return Memory_AllocTag(TAG, size, 16); }
+    inline void* Realloc(void* ptr, int32_t, int32_t size)      { return Memory_ReallocTag(TAG, ptr, size, 16); }
+    inline void  Free(void* ptr, int32_t)                       { Memory_FreeTag(TAG, ptr); }
+};
+
+// Same tracker without call stacks, show the cost of the capture alone
+struct MemoryTrackerNoStackBench : MemoryTrackerBench
+{
+    static constexpr const char*    NAME            = "MemoryTracker/0";
+
+    inline MemoryTrackerNoStackBench()
+    {
+        Memory_SetCallStackDepth(0);
+    }
+};
+
+// -------------------------------------------------------------------
+// Measurement
+// -------------------------------------------------------------------
+
+struct BenchResult
+{
+    bool        ran;
+    int64_t     elapsedNs;
+    int64_t     opCount;
+    int64_t     rssBytes;
+};
+
+static inline int64_t Bench_NowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+
+static int64_t Bench_ResidentBytes(void)
+{
+    FILE* file = fopen("/proc/self/statm", "r");
+    if (!file)
+    {
+        return 0;
+    }
+
+    long long pages = 0;
+    long long resident = 0;
+    if (fscanf(file, "%lld %lld", &pages, &resident) != 2)
+    {
+        resident = 0;
+    }
+    fclose(file);
+
+    return (int64_t)resident * sysconf(_SC_PAGESIZE);
+}
+
+// Write in every page of the block, so the block count in RSS like real data would
+static inline void Bench_Touch(void* ptr, int32_t size)
+{
+    uint8_t* bytes = (uint8_t*)ptr;
+    for (int32_t i = 0; i < size; i += 4096)
+    {
+        bytes[i] = (uint8_t)i;
+    }
+    bytes[size - 1] = (uint8_t)size;
+}
+
+template <typename Heap>
+static void Bench_Replay(Heap& heap, const Trace* trace, void** ptrs, int32_t begin, int32_t end)
+{
+    for (int32_t i = begin; i < end; i++)
+    {
+        const TraceOp op = trace->ops[i];
+        switch (op.kind)
+        {
+        case TraceOpKind_Alloc:
+            ptrs[op.slot] = heap.Alloc(op.size);
+            Bench_Touch(ptrs[op.slot], op.size);
+            trace->sizes[op.slot] = op.size;
+            break;
+
+        case TraceOpKind_Realloc:
+            ptrs[op.slot] = heap.Realloc(ptrs[op.slot], trace->sizes[op.slot], op.size);
+            Bench_Touch(ptrs[op.slot], op.size);
+            trace->sizes[op.slot] = op.size;
+            break;
+
+        case TraceOpKind_Free:
+            heap.Free(ptrs[op.slot], trace->sizes[op.slot]);
+            ptrs[op.slot] = nullptr;
+            trace->sizes[op.slot] = 0;
+            break;
+        }
+    }
+}
+
+struct BenchThread
+{
+    pthread_t           handle;
+    pthread_barrier_t*  barrier;
+
+    Trace*              trace;
+    void**              ptrs;
+    int64_t             elapsedNs;
+};
+
+template <typename Heap>
+static void* Bench_ThreadMain(void* data)
+{
+    BenchThread* thread = (BenchThread*)data;
+    Trace* trace = thread->trace;
+
+    Heap heap;
+
+    pthread_barrier_wait(thread->barrier);     // Start
+    int64_t start = Bench_NowNs();
+    Bench_Replay(heap, trace, thread->ptrs, 0, trace->drainIndex);
+    thread->elapsedNs = Bench_NowNs() - start;
+
+    pthread_barrier_wait(thread->barrier);     // Reached drain point
+    pthread_barrier_wait(thread->barrier);     // RSS sampled
+
+    start = Bench_NowNs();
+    Bench_Replay(heap, trace, thread->ptrs, trace->drainIndex, trace->opCount);
+    thread->elapsedNs += Bench_NowNs() - start;
+
+    return nullptr;
+}
+
+template <typename Heap>
+static BenchResult Bench_Run(Trace* traces, int32_t threadCount)
+{
+    BenchResult result = {};
+    result.ran = true;
+
+    for (int32_t i = 0; i < threadCount; i++)
+    {
+        memset(traces[i].sizes, 0, sizeof(int32_t) * (size_t)traces[i].slotCount);
+        result.opCount += traces[i].opCount;
+    }
+
+    if (threadCount == 1)
+    {
+        Trace* trace = &traces[0];
+        void** ptrs = (void**)calloc((size_t)trace->slotCount, sizeof(void*));
+
+        Heap heap;
+
+        const int64_t baseline = Bench_ResidentBytes();
+        int64_t start = Bench_NowNs();
+        Bench_Replay(heap, trace, ptrs, 0, trace->drainIndex);
+        result.elapsedNs = Bench_NowNs() - start;
+
+        result.rssBytes = Bench_ResidentBytes() - baseline;
+
+        start = Bench_NowNs();
+        Bench_Replay(heap, trace, ptrs, trace->drainIndex, trace->opCount);
+        result.elapsedNs += Bench_NowNs() - start;
+
+        free(ptrs);
+        return result;
+    }
+
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, nullptr, (unsigned)threadCount + 1);
+
+    BenchThread threads[16] = {};
+    assert(threadCount <= 16);
+    for (int32_t i = 0; i < threadCount; i++)
+    {
+        threads[i].barrier = &barrier;
+        threads[i].trace = &traces[i];
+        threads[i].ptrs = (void**)calloc((size_t)traces[i].slotCount, sizeof(void*));
+        pthread_create(&threads[i].handle, nullptr, Bench_ThreadMain<Heap>, &threads[i]);
+    }
+
+    const int64_t baseline = Bench_ResidentBytes();
+    pthread_barrier_wait(&barrier);     // Start
+    pthread_barrier_wait(&barrier);     // Reached drain point
+    result.rssBytes = Bench_ResidentBytes() - baseline;
+    pthread_barrier_wait(&barrier);     // RSS sampled
+
+    for (int32_t i = 0; i < threadCount; i++)
+    {
+        pthread_join(threads[i].handle, nullptr);
+        result.elapsedNs += threads[i].elapsedNs;
+        free(threads[i].ptrs);
+    }
+
+    pthread_barrier_destroy(&barrier);
+    return result;
+}
+
+// Run in a child process, so every heap start from a fresh address space
+template <typename Heap>
+static BenchResult Bench_RunIsolated(Trace* traces, int32_t threadCount)
+{
+    BenchResult result = {};
+
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        return result;
+    }
+
+    const pid_t pid = fork();
+    if (pid == 0)
+    {
+        close(fds[0]);
+
+        BenchResult childResult = Bench_Run<Heap>(traces, threadCount);
+        if (write(fds[1], &childResult, sizeof(childResult)) != (ssize_t)sizeof(childResult))
+        {
+            _exit(1);
+        }
+
+        close(fds[1]);
+        _exit(0);
+    }
+
+    close(fds[1]);
+    if (pid < 0 || read(fds[0], &result, sizeof(result)) != (ssize_t)sizeof(result))
+    {
+        memset(&result, 0, sizeof(result));
+    }
+    close(fds[0]);
+
+    if (pid > 0)
+    {
+        int status = 0;
+        waitpid(pid, &status, 0);
+    }
+
+    return result;
+}
+
+template <typename Heap>
+static void Bench_Report(Trace* traces, int32_t threadCount, int64_t peakBytes, int64_t liveBytes)
+{
+    if (threadCount > 1 && Heap::SHARED_STATE)
+    {
+        // Every thread own a heap instance, heaps with global unlocked state cannot run
+        printf("    %-18s %10s\n", Heap::NAME, "skipped");
+        return;
+    }
+
+    const BenchResult result = Bench_RunIsolated<Heap>(traces, threadCount);
+    if (!result.ran || result.opCount == 0)
+    {
+        printf("    %-18s %10s\n", Heap::NAME, "failed");
+        return;
+    }
+
+    // Busy time of all threads over all ops, the mean op cost under contention
+    const double nsPerOp = (double)result.elapsedNs / (double)result.opCount;
+    const double frag = liveBytes > 0 ? (double)result.rssBytes / (double)liveBytes : 0.0;
+    printf("    %-18s %10.1f %10lld %10lld %10lld %8.2f\n",
+        Heap::NAME, nsPerOp,
+        (long long)(peakBytes / 1024), (long long)(liveBytes / 1024),
+        (long long)(result.rssBytes / 1024), frag);
+    fflush(stdout);
+}
+
+int main(int argc, char* argv[])
+{
+    const int32_t scale = argc > 1 ? atoi(argv[1]) : 1;
+    const char* filter = argc > 2 ? argv[2] : nullptr;
+    if (scale <= 0)
+    {
+        fprintf(stderr, "Usage: %s [scale] [trace]\n", argv[0]);
+        return 1;
+    }
+
+    for (const TraceDesc& desc : TRACES)
+    {
+        if (filter && !strstr(desc.name, filter))
+        {
+            continue;
+        }
+
+        Trace traces[16];
+        int64_t opCount = 0;
+        int64_t peakBytes = 0;
+        int64_t liveBytes = 0;
+        for (int32_t i = 0; i < desc.threadCount; i++)
+        {
+            desc.Generate(&traces[i], i, scale);
+            opCount += traces[i].opCount;
+            peakBytes += traces[i].peakBytes;
+            liveBytes += traces[i].liveBytes;
+        }
+
+        printf("%s: %d thread(s), %lld ops\n", desc.name, desc.threadCount, (long long)opCount);
+        printf("    %-18s %10s %10s %10s %10s %8s\n", "heap", "ns/op", "peak KB", "live KB", "RSS KB", "frag");
+
+        Bench_Report<GlibcMallocBench>(traces, desc.threadCount, peakBytes, liveBytes);
+        Bench_Report<CrtMallocBench>(traces, desc.threadCount, peakBytes, liveBytes);
+        Bench_Report<StrictSegHeapBench>(traces, desc.threadCount, peakBytes, liveBytes);
+        Bench_Report<PagedFreeListBench>(traces, desc.threadCount, peakBytes, liveBytes);
+        Bench_Report<MemoryTrackerBench>(traces, desc.threadCount, peakBytes, liveBytes);
+        Bench_Report<MemoryTrackerNoStackBench>(traces, desc.threadCount, peakBytes, liveBytes);
+        printf("\n");
+
+        for (int32_t i = 0; i < desc.threadCount; i++)
+        {
+            Trace_Destroy(&traces[i]);
+        }
+    }
+
+    return 0;
+}
+
+//! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
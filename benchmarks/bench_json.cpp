@@ -0,0 +1,849 @@
+// JSON benchmarks
+// Parse the shipped LDtk worlds (serially, in situ, then with large arrays split
+// across threads), stream them with JsonReader (all tokens, then
+// skipping the levels), build their JsonTape and parse one level from it,
+// look up every member of every object the way LDtkParser does, load the
+// worlds with LDtkParse, then cook them and load the cooked blob (relocation
+// only, the blob is already in memory like a mapped file), and parse their
+// level index then load the first level on demand, and load only their
+// collision layer.
+// Then the same with synthetic worlds made from the biggest shipped one:
+// its levels repeated 100 times, and one level with a 1000x1000 IntGrid layer.
+// Sizes are the bytes of scratch buffer used: parser values, or the whole
+// LDtkParse buffer (text, values and world).
+//
+// Usage: bench_json [scale] [file]
+//      scale   multiply the number of repetitions, default 1
+//      file    only run files which name contain this string, "synthetic" for the synthetic worlds
+//
+// Lookups, over all objects then only indexed objects (JSON_OBJECT_INDEX_MIN members or more):
+//      scan        exact linear scan of the members, what JsonFind did before the index
+//      JsonFind    hash the name then use the object index (or scan small objects)
+//      JsonFindKey prebuilt keys, no hashing
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <time.h>
+#include <dirent.h>
+
+#include <thread>
+
+#include "Misc/Json.h"
+#include "Misc/LDtkParser.h"
+#include "Misc/LDtkCooker.h"
+
+constexpr const char*   ASSETS_DIR          = "../assets";
+constexpr int32_t       PARSE_BUFFER_SIZE   = 256 * 1024 * 1024;
+constexpr int32_t       STREAM_BUFFER_SIZE  = 4 * 1024;
+constexpr int32_t       PARSE_REPEAT        = 50;       // For documents up to REPEAT_BYTES, less for bigger ones
+constexpr int32_t       REPEAT_BYTES        = 1024 * 1024;
+constexpr int32_t       LOOKUP_REPEAT       = 200;      // For 8192 lookups, less when there are more
+constexpr int32_t       MAX_LOOKUPS         = 1024 * 1024;
+
+constexpr const char*   SYNTHETIC_SOURCE    = "../assets/pixel_adventure_v2.ldtk";
+constexpr int32_t       SYNTHETIC_LEVELS    = 100;
+constexpr int32_t       SYNTHETIC_GRID_SIZE = 1000;
+
+static char gParseBuffer[PARSE_BUFFER_SIZE];
+static char gStreamBuffer[STREAM_BUFFER_SIZE];
+static char gTapeBuffer[PARSE_BUFFER_SIZE];
+alignas(16) static char gLevelBuffer[PARSE_BUFFER_SIZE];
+static char gWriteBuffer[PARSE_BUFFER_SIZE];
+static char gInSituBuffer[PARSE_BUFFER_SIZE];
+
+// -------------------------------------------------------------------
+// Utilities
+// -------------------------------------------------------------------
+
+static inline int64_t Bench_NowNs(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000ll + ts.tv_nsec;
+}
+
+static char* Bench_ReadFile(const char* path, int32_t* outLength)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        return nullptr;
+    }
+
+    fseek(file, 0, SEEK_END);
+    const int32_t length = (int32_t)ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    char* content = (char*)malloc((size_t)length + 1);
+    if (content)
+    {
+        *outLength = (int32_t)fread(content, 1, (size_t)length, file);
+        content[*outLength] = '\0';
+    }
+
+    fclose(file);
+    return content;
+}
+
+static int32_t Bench_Repeat(int32_t length, int32_t scale)
+{
+    const int64_t repeat = (int64_t)PARSE_REPEAT * REPEAT_BYTES / (length > REPEAT_BYTES ? length : REPEAT_BYTES);
+    return (repeat > 3 ? (int32_t)repeat : 3) * scale;
+}
+
+// JsonParallelForFunc on one thread per core, JobSystem need the engine; threads are started on each call, it is timed
+static void Bench_ParallelFor(JsonRangeFunc func, void* data, int32_t count, int32_t batchSize)
+{
+    constexpr int32_t MAX_THREADS = 16;
+
+    const int32_t cores = (int32_t)std::thread::hardware_concurrency();
+    int32_t threadCount = cores < MAX_THREADS ? cores : MAX_THREADS;
+    threadCount = threadCount < count / (batchSize > 0 ? batchSize : 1) ? threadCount : count / (batchSize > 0 ? batchSize : 1);
+    if (threadCount <= 1)
+    {
+        func(data, 0, count);
+        return;
+    }
+
+    std::thread threads[MAX_THREADS];
+    for (int32_t i = 0; i < threadCount; i++)
+    {
+        const int32_t start = (int32_t)((int64_t)count * i / threadCount);
+        const int32_t end = (int32_t)((int64_t)count * (i + 1) / threadCount);
+        threads[i] = std::thread(func, data, start, end);
+    }
+
+    for (int32_t i = 0; i < threadCount; i++)
+    {
+        threads[i].join();
+    }
+}
+
+// -------------------------------------------------------------------
+// Lookups
+// -------------------------------------------------------------------
+
+struct Lookup
+{
+    Json        parent;
+    const char* name;
+    JsonKey     key;
+};
+
+static void Bench_CollectLookups(const Json json, Lookup* lookups, int32_t* count)
+{
+    if (json.type == JsonType_Array)
+    {
+        for (int32_t i = 0; i < json.length; i++)
+        {
+            Bench_CollectLookups(json.array[i], lookups, count);
+        }
+    }
+    else if (json.type == JsonType_Object)
+    {
+        for (int32_t i = 0; i < json.length; i++)
+        {
+            const JsonObjectMember* member = &json.object[i];
+            if (member->name && *count < MAX_LOOKUPS)
+            {
+                Lookup* lookup = &lookups[(*count)++];
+                lookup->parent  = json;
+                lookup->name    = member->name;
+                lookup->key     = JsonMakeKey(member->name);
+            }
+
+            Bench_CollectLookups(member->value, lookups, count);
+        }
+    }
+}
+
+static bool Bench_ScanFind(const Json parent, const char* name, Json* outResult)
+{
+    for (int32_t i = 0; i < parent.length; i++)
+    {
+        const JsonObjectMember* member = &parent.object[i];
+        if (member->name && strcmp(member->name, name) == 0)
+        {
+            *outResult = member->value;
+            return true;
+        }
+    }
+
+    *outResult = JSON_NULL;
+    return false;
+}
+
+template <typename Find>
+static double Bench_Lookups(const Lookup* lookups, int32_t count, int32_t repeat, Find find)
+{
+    int32_t found = 0;
+
+    const int64_t start = Bench_NowNs();
+    for (int32_t r = 0; r < repeat; r++)
+    {
+        for (int32_t i = 0; i < count; i++)
+        {
+            Json value;
+            found += find(lookups[i], &value);
+        }
+    }
+    const int64_t elapsed = Bench_NowNs() - start;
+
+    if (found != count * repeat)
+    {
+        fprintf(stderr, "Lookups failed: %d of %d found\n", found, count * repeat);
+        exit(1);
+    }
+
+    return (double)elapsed / ((double)count * repeat);
+}
+
+// -------------------------------------------------------------------
+// Streaming
+// -------------------------------------------------------------------
+
+struct MemorySource
+{
+    const char* content;
+    int32_t     length;
+    int32_t     cursor;
+};
+
+static int32_t Bench_ReadMemory(void* userData, void* buffer, int32_t bufferSize)
+{
+    MemorySource* source = (MemorySource*)userData;
+
+    const int32_t remain = source->length - source->cursor;
+    const int32_t count = remain < bufferSize ? remain : bufferSize;
+    memcpy(buffer, source->content + source->cursor, (size_t)count);
+    source->cursor += count;
+    return count;
+}
+
+static MemorySource gLDtkSource;
+
+// LDtkReadFileFn over gLDtkSource, whatever the file name
+static bool Bench_LDtkReadMemory(const char* fileName, void* buffer, int32_t* bufferSize)
+{
+    (void)fileName;
+
+    if (buffer)
+    {
+        if (*bufferSize < gLDtkSource.length)
+        {
+            return false;
+        }
+
+        memcpy(buffer, gLDtkSource.content, (size_t)gLDtkSource.length);
+    }
+
+    *bufferSize = gLDtkSource.length;
+    return true;
+}
+
+// Collision only: the IntGrid layer the game collide with
+static bool Bench_LDtkCollisionLayer(void* userData, const char* layerName, LDtkLayerType type)
+{
+    (void)userData;
+    return type == LDtkLayerType_IntGrid && strcmp(layerName, "Collisions") == 0;
+}
+
+static int32_t Bench_StreamTokens(const char* content, int32_t length, bool skipLevels)
+{
+    MemorySource source = { content, length, 0 };
+
+    JsonReader reader;
+    JsonReader_Init(&reader, JsonParseFlags_Default, gStreamBuffer, STREAM_BUFFER_SIZE, Bench_ReadMemory, &source);
+
+    int32_t tokenCount = 0;
+    while (true)
+    {
+        const JsonToken token = JsonReader_Next(&reader);
+        if (token == JsonToken_End || token == JsonToken_Error)
+        {
+            break;
+        }
+
+        tokenCount++;
+        if (skipLevels && token == JsonToken_Name && strcmp(reader.value.string, "levels") == 0)
+        {
+            JsonReader_SkipValue(&reader);
+        }
+    }
+
+    if (reader.error != JsonError_None)
+    {
+        fprintf(stderr, "JsonReader failed: %s\n", reader.message);
+        exit(1);
+    }
+
+    return tokenCount;
+}
+
+// -------------------------------------------------------------------
+// Synthetic worlds
+// -------------------------------------------------------------------
+
+// Values of the synthetic worlds share the parsed ones, only the changed arrays and objects are new.
+// The copies have no member index, they are only written, never searched.
+constexpr int32_t       MAX_SYNTHETIC_ALLOCS = 64;
+
+static void*            gSyntheticAllocs[MAX_SYNTHETIC_ALLOCS];
+static int32_t          gSyntheticAllocCount = 0;
+
+static void* Bench_SyntheticAlloc(size_t size)
+{
+    if (gSyntheticAllocCount == MAX_SYNTHETIC_ALLOCS)
+    {
+        fprintf(stderr, "Too many synthetic allocations\n");
+        exit(1);
+    }
+
+    void* buffer = malloc(size);
+    gSyntheticAllocs[gSyntheticAllocCount++] = buffer;
+    return buffer;
+}
+
+static void Bench_SyntheticFreeAll(void)
+{
+    for (int32_t i = 0; i < gSyntheticAllocCount; i++)
+    {
+        free(gSyntheticAllocs[i]);
+    }
+
+    gSyntheticAllocCount = 0;
+}
+
+static Json Bench_MakeInteger(int64_t value)
+{
+    Json result = JSON_NULL;
+    result.type     = JsonType_Number;
+    result.length   = JsonNumberKind_Integer;
+    result.integer  = value;
+    return result;
+}
+
+static Json Bench_MakeArray(int32_t length)
+{
+    Json result = JSON_NULL;
+    result.type     = JsonType_Array;
+    result.length   = length;
+    result.array    = (Json*)Bench_SyntheticAlloc(sizeof(Json) * (size_t)length);
+    return result;
+}
+
+// Copy of object with the value of one member replaced
+static Json Bench_ReplaceMember(const Json object, const char* name, const Json value)
+{
+    Json result = object;
+    result.object = (JsonObjectMember*)Bench_SyntheticAlloc(sizeof(JsonObjectMember) * (size_t)object.length);
+    memcpy(result.object, object.object, sizeof(JsonObjectMember) * (size_t)object.length);
+
+    for (int32_t i = 0; i < result.length; i++)
+    {
+        if (result.object[i].name && strcmp(result.object[i].name, name) == 0)
+        {
+            result.object[i].value = value;
+        }
+    }
+
+    return result;
+}
+
+// The levels of world, repeated
+static Json Bench_RepeatLevels(const Json world, int32_t repeat)
+{
+    Json levels;
+    if (JsonFindWithType(world, "levels", JsonType_Array, &levels) != JsonError_None || levels.length == 0)
+    {
+        return JSON_NULL;
+    }
+
+    Json newLevels = Bench_MakeArray(levels.length * repeat);
+    for (int32_t i = 0; i < newLevels.length; i++)
+    {
+        newLevels.array[i] = levels.array[i % levels.length];
+    }
+
+    return Bench_ReplaceMember(world, "levels", newLevels);
+}
+
+// The first level of world alone, with its IntGrid layer resized to size x size cells
+static Json Bench_BigIntGrid(const Json world, int32_t size)
+{
+    Json levels, layers;
+    if (JsonFindWithType(world, "levels", JsonType_Array, &levels) != JsonError_None || levels.length == 0
+        || JsonFindWithType(levels.array[0], "layerInstances", JsonType_Array, &layers) != JsonError_None)
+    {
+        return JSON_NULL;
+    }
+
+    Json newLayers = Bench_MakeArray(layers.length);
+    memcpy(newLayers.array, layers.array, sizeof(Json) * (size_t)layers.length);
+
+    int64_t gridSize = 0;
+    for (int32_t i = 0; i < layers.length; i++)
+    {
+        Json type, csv, cellSize;
+        if (JsonFindWithType(layers.array[i], "__type", JsonType_String, &type) != JsonError_None || strcmp(type.string, "IntGrid") != 0
+            || JsonFindWithType(layers.array[i], "intGridCsv", JsonType_Array, &csv) != JsonError_None || csv.length == 0
+            || JsonFindWithType(layers.array[i], "__gridSize", JsonType_Number, &cellSize) != JsonError_None)
+        {
+            continue;
+        }
+
+        Json newCsv = Bench_MakeArray(size * size);
+        for (int32_t cell = 0; cell < newCsv.length; cell++)
+        {
+            newCsv.array[cell] = csv.array[cell % csv.length];
+        }
+
+        Json layer = Bench_ReplaceMember(layers.array[i], "intGridCsv", newCsv);
+        layer = Bench_ReplaceMember(layer, "__cWid", Bench_MakeInteger(size));
+        layer = Bench_ReplaceMember(layer, "__cHei", Bench_MakeInteger(size));
+        newLayers.array[i] = layer;
+
+        gridSize = JsonInteger(cellSize);
+        break;
+    }
+
+    if (gridSize == 0)
+    {
+        return JSON_NULL;
+    }
+
+    Json level = Bench_ReplaceMember(levels.array[0], "layerInstances", newLayers);
+    level = Bench_ReplaceMember(level, "pxWid", Bench_MakeInteger(gridSize * size));
+    level = Bench_ReplaceMember(level, "pxHei", Bench_MakeInteger(gridSize * size));
+
+    Json newLevels = Bench_MakeArray(1);
+    newLevels.array[0] = level;
+    return Bench_ReplaceMember(world, "levels", newLevels);
+}
+
+// Text of a synthetic world, free it
+static char* Bench_WriteDocument(const Json json, int32_t* outLength)
+{
+    JsonWriter writer;
+    JsonWriter_Init(&writer, JsonWriteFlags_Default, gWriteBuffer, PARSE_BUFFER_SIZE, NULL, NULL);
+    if (!JsonWriter_Value(&writer, json) || !JsonWriter_Finish(&writer))
+    {
+        fprintf(stderr, "JsonWriter failed: %d\n", writer.error);
+        return nullptr;
+    }
+
+    char* content = (char*)malloc((size_t)writer.length + 1);
+    memcpy(content, gWriteBuffer, (size_t)writer.length);
+    content[writer.length] = '\0';
+
+    *outLength = writer.length;
+    return content;
+}
+
+// -------------------------------------------------------------------
+// Benchmarks
+// -------------------------------------------------------------------
+
+static void Bench_Document(const char* name, const char* content, int32_t length, int32_t scale)
+{
+    printf("%s: %d KB\n", name, length / 1024);
+
+    const int32_t parseRepeat = Bench_Repeat(length, scale);
+
+    // Parse
+    Json json;
+    JsonResult result = {};
+    int64_t bestNs = INT64_MAX;
+    for (int32_t r = 0; r < parseRepeat; r++)
+    {
+        const int64_t start = Bench_NowNs();
+        result = JsonParse(content, length, JsonParseFlags_Default, gParseBuffer, PARSE_BUFFER_SIZE, &json);
+        const int64_t elapsed = Bench_NowNs() - start;
+        bestNs = elapsed < bestNs ? elapsed : bestNs;
+    }
+
+    if (result.error != JsonError_None)
+    {
+        fprintf(stderr, "JsonParse failed: %s\n", result.message);
+        return;
+    }
+
+    printf("    %-18s %10.1f us %10.1f MB/s %10d KB\n", "JsonParse", bestNs / 1000.0, (double)length / (double)bestNs * 1000.0, result.memoryUsage / 1024);
+
+    // In situ, the document is copied back before each run, the copy is not timed
+    if (length < PARSE_BUFFER_SIZE)
+    {
+        Json inSitu;
+        JsonResult inSituResult = {};
+        bestNs = INT64_MAX;
+        for (int32_t r = 0; r < parseRepeat; r++)
+        {
+            memcpy(gInSituBuffer, content, (size_t)length);
+
+            const int64_t start = Bench_NowNs();
+            inSituResult = JsonParse(gInSituBuffer, length, JsonParseFlags_InSitu, gLevelBuffer, PARSE_BUFFER_SIZE, &inSitu);
+            const int64_t elapsed = Bench_NowNs() - start;
+            bestNs = elapsed < bestNs ? elapsed : bestNs;
+        }
+
+        printf("    %-18s %10.1f us %10.1f MB/s %10d KB\n", "JsonParse in situ", bestNs / 1000.0, (double)length / (double)bestNs * 1000.0, inSituResult.memoryUsage / 1024);
+    }
+
+    // Large arrays split across the cores, the values must be the same
+    {
+        Json parallel;
+        JsonResult parallelResult = {};
+        bestNs = INT64_MAX;
+        for (int32_t r = 0; r < parseRepeat; r++)
+        {
+            const int64_t start = Bench_NowNs();
+            parallelResult = JsonParseParallel(content, length, JsonParseFlags_Default, Bench_ParallelFor, gLevelBuffer, PARSE_BUFFER_SIZE, &parallel);
+            const int64_t elapsed = Bench_NowNs() - start;
+            bestNs = elapsed < bestNs ? elapsed : bestNs;
+        }
+
+        if (parallelResult.error != JsonError_None || !JsonEquals(json, parallel))
+        {
+            fprintf(stderr, "JsonParseParallel failed: %s\n", parallelResult.message);
+        }
+        else
+        {
+            printf("    %-18s %10.1f us %10.1f MB/s %10d KB (%u threads)\n", "JsonParse parallel", bestNs / 1000.0, (double)length / (double)bestNs * 1000.0, parallelResult.memoryUsage / 1024, std::thread::hardware_concurrency());
+        }
+    }
+
+    // Streaming, every token then the same without the levels
+    for (int32_t pass = 0; pass < 2; pass++)
+    {
+        int32_t tokenCount = 0;
+        bestNs = INT64_MAX;
+        for (int32_t r = 0; r < parseRepeat; r++)
+        {
+            const int64_t start = Bench_NowNs();
+            tokenCount = Bench_StreamTokens(content, length, pass == 1);
+            const int64_t elapsed = Bench_NowNs() - start;
+            bestNs = elapsed < bestNs ? elapsed : bestNs;
+        }
+
+        printf("    %-18s %10.1f us %10.1f MB/s %10d KB (%d tokens)\n", pass == 0 ? "JsonReader" : "JsonReader skip", bestNs / 1000.0, (double)length / (double)bestNs * 1000.0, STREAM_BUFFER_SIZE / 1024, tokenCount);
+    }
+
+    // Write the document back, compact into memory
+    JsonWriter writer;
+    bestNs = INT64_MAX;
+    for (int32_t r = 0; r < parseRepeat; r++)
+    {
+        const int64_t start = Bench_NowNs();
+        JsonWriter_Init(&writer, JsonWriteFlags_Default, gWriteBuffer, PARSE_BUFFER_SIZE, NULL, NULL);
+        JsonWriter_Value(&writer, json);
+        JsonWriter_Finish(&writer);
+        const int64_t elapsed = Bench_NowNs() - start;
+        bestNs = elapsed < bestNs ? elapsed : bestNs;
+    }
+
+    if (writer.error != JsonError_None)
+    {
+        fprintf(stderr, "JsonWriter failed: %d\n", writer.error);
+    }
+    else
+    {
+        printf("    %-18s %10.1f us %10.1f MB/s %10d KB written\n", "JsonWriter", bestNs / 1000.0, (double)writer.length / (double)bestNs * 1000.0, writer.length / 1024);
+    }
+
+    // Tape, then one level out of the world from the tape
+    JsonTape tape;
+    bestNs = INT64_MAX;
+    for (int32_t r = 0; r < parseRepeat; r++)
+    {
+        const int64_t start = Bench_NowNs();
+        result = JsonTape_Build(content, length, JsonParseFlags_Default, gTapeBuffer, PARSE_BUFFER_SIZE, &tape);
+        const int64_t elapsed = Bench_NowNs() - start;
+        bestNs = elapsed < bestNs ? elapsed : bestNs;
+    }
+
+    if (result.error != JsonError_None)
+    {
+        fprintf(stderr, "JsonTape_Build failed: %s\n", result.message);
+        return;
+    }
+
+    printf("    %-18s %10.1f us %10.1f MB/s %10d KB (%d nodes)\n", "JsonTape_Build", bestNs / 1000.0, (double)length / (double)bestNs * 1000.0, result.memoryUsage / 1024, tape.count);
+
+    const int32_t levels = JsonTape_Find(&tape, 0, "levels");
+    const int32_t levelCount = levels >= 0 ? JsonTape_GetLength(&tape, levels) : 0;
+    if (levelCount > 0)
+    {
+        Json level;
+        bestNs = INT64_MAX;
+        for (int32_t r = 0; r < parseRepeat; r++)
+        {
+            const int64_t start = Bench_NowNs();
+            const int32_t node = JsonTape_GetItem(&tape, levels, levelCount - 1);
+            result = JsonTape_Parse(&tape, node, JsonParseFlags_Default, gLevelBuffer, PARSE_BUFFER_SIZE, &level);
+            const int64_t elapsed = Bench_NowNs() - start;
+            bestNs = elapsed < bestNs ? elapsed : bestNs;
+        }
+
+        printf("    %-18s %10.1f us %24d KB (last of %d levels)\n", "JsonTape_Parse", bestNs / 1000.0, result.memoryUsage / 1024, levelCount);
+    }
+
+    // Lookups
+    Lookup* lookups = (Lookup*)malloc(sizeof(Lookup) * MAX_LOOKUPS);
+    int32_t lookupCount = 0;
+    Bench_CollectLookups(json, lookups, &lookupCount);
+
+    // Indexed objects only, put them first
+    int32_t indexedCount = 0;
+    for (int32_t i = 0; i < lookupCount; i++)
+    {
+        if (lookups[i].parent.indexed)
+        {
+            const Lookup lookup = lookups[indexedCount];
+            lookups[indexedCount++] = lookups[i];
+            lookups[i] = lookup;
+        }
+    }
+
+    for (int32_t pass = 0; pass < 2; pass++)
+    {
+        const int32_t count = pass == 0 ? lookupCount : indexedCount;
+        const int32_t repeat = (count > 8192 ? (int32_t)((int64_t)LOOKUP_REPEAT * 8192 / count) + 1 : LOOKUP_REPEAT) * scale;
+
+        const double scanNs = Bench_Lookups(lookups, count, repeat, [](const Lookup& lookup, Json* value) {
+            return Bench_ScanFind(lookup.parent, lookup.name, value);
+        });
+        const double findNs = Bench_Lookups(lookups, count, repeat, [](const Lookup& lookup, Json* value) {
+            return JsonFind(lookup.parent, lookup.name, value);
+        });
+        const double findKeyNs = Bench_Lookups(lookups, count, repeat, [](const Lookup& lookup, Json* value) {
+            return JsonFindKey(lookup.parent, lookup.key, value);
+        });
+
+        printf("    %s (%d members)\n", pass == 0 ? "all objects" : "indexed objects", count);
+        printf("    %-18s %10.1f ns/lookup\n", "scan", scanNs);
+        printf("    %-18s %10.1f ns/lookup\n", "JsonFind", findNs);
+        printf("    %-18s %10.1f ns/lookup\n", "JsonFindKey", findKeyNs);
+    }
+
+    free(lookups);
+
+    // Whole world, the file is read from memory
+    const LDtkContext context = { gParseBuffer, PARSE_BUFFER_SIZE, Bench_LDtkReadMemory, nullptr, nullptr, nullptr, nullptr, nullptr };
+    gLDtkSource = { content, length, 0 };
+
+    LDtkWorld world;
+    LDtkError error = {};
+    bestNs = INT64_MAX;
+    for (int32_t r = 0; r < parseRepeat; r++)
+    {
+        const int64_t start = Bench_NowNs();
+        error = LDtkParse(name, context, LDtkParseFlags_LayerReverseOrder, &world);
+        const int64_t elapsed = Bench_NowNs() - start;
+        bestNs = elapsed < bestNs ? elapsed : bestNs;
+    }
+
+    if (error.code != LDtkErrorCode_None)
+    {
+        fprintf(stderr, "LDtkParse failed: %s\n", error.message);
+    }
+    else
+    {
+        printf("    %-18s %10.1f us %10.1f MB/s %10d KB (%d levels)\n", "LDtkParse", bestNs / 1000.0, (double)length / (double)bestNs * 1000.0, world.memoryUsage / 1024, world.levelCount);
+
+        // Every load relocate a fresh copy of the blob, the copy is not timed
+        const LDtkSourceStamp stamp = { length, 0 };
+        int32_t cookedSize;
+        error = LDtkCook(&world, LDtkParseFlags_LayerReverseOrder, stamp, NULL, 0, gWriteBuffer, PARSE_BUFFER_SIZE, &cookedSize);
+
+        bestNs = INT64_MAX;
+        for (int32_t r = 0; r < parseRepeat && error.code == LDtkErrorCode_None; r++)
+        {
+            memcpy(gLevelBuffer, gWriteBuffer, (size_t)cookedSize);
+
+            const int64_t start = Bench_NowNs();
+            error = LDtkLoadCooked(gLevelBuffer, cookedSize, LDtkParseFlags_LayerReverseOrder, stamp, &world);
+            const int64_t elapsed = Bench_NowNs() - start;
+            bestNs = elapsed < bestNs ? elapsed : bestNs;
+        }
+
+        if (error.code != LDtkErrorCode_None)
+        {
+            fprintf(stderr, "LDtkLoadCooked failed: %s\n", error.message);
+        }
+        else
+        {
+            printf("    %-18s %10.1f us %10.1f MB/s %10d KB (%d levels)\n", "LDtkLoadCooked", bestNs / 1000.0, (double)cookedSize / (double)bestNs * 1000.0, cookedSize / 1024, world.levelCount);
+        }
+
+        // Level index then the layers of its first level, the way the game start
+        const LDtkParseFlags indexFlags = (LDtkParseFlags)(LDtkParseFlags_LayerReverseOrder | LDtkParseFlags_LevelIndex);
+        const LDtkContext levelContext = { gLevelBuffer, PARSE_BUFFER_SIZE, Bench_LDtkReadMemory, nullptr, nullptr, nullptr, nullptr, nullptr };
+
+        LDtkWorld index;
+        int64_t bestIndexNs = INT64_MAX;
+        bestNs = INT64_MAX;
+        error = LDtkParse(name, context, indexFlags, &index);
+        for (int32_t r = 0; r < parseRepeat && error.code == LDtkErrorCode_None && index.levelCount > 0; r++)
+        {
+            const int64_t start = Bench_NowNs();
+            error = LDtkParse(name, context, indexFlags, &index);
+            const int64_t indexEnd = Bench_NowNs();
+            if (error.code == LDtkErrorCode_None)
+            {
+                error = LDtkLoadLevel(&index, index.levels[0].id, levelContext, LDtkParseFlags_LayerReverseOrder);
+            }
+            const int64_t end = Bench_NowNs();
+
+            bestIndexNs = indexEnd - start < bestIndexNs ? indexEnd - start : bestIndexNs;
+            bestNs = end - indexEnd < bestNs ? end - indexEnd : bestNs;
+        }
+
+        if (error.code != LDtkErrorCode_None)
+        {
+            fprintf(stderr, "LDtkParse level index failed: %s\n", error.message);
+        }
+        else if (index.levelCount > 0)
+        {
+            printf("    %-18s %10.1f us %10.1f MB/s %10d KB (%d levels)\n", "LDtkParse index", bestIndexNs / 1000.0, (double)length / (double)bestIndexNs * 1000.0, index.memoryUsage / 1024, index.levelCount);
+            printf("    %-18s %10.1f us %10s      %10d KB (1 level)\n", "LDtkLoadLevel", bestNs / 1000.0, "", index.levels[0].memoryUsage / 1024);
+        }
+
+        // Collision layer only, the JSON parser skip the other layers and the auto tiles
+        const LDtkParseFlags collisionFlags = (LDtkParseFlags)(LDtkParseFlags_SkipAutoLayerTiles | LDtkParseFlags_SkipBackground);
+        LDtkContext collisionContext = context;
+        collisionContext.layerFilter = Bench_LDtkCollisionLayer;
+
+        LDtkWorld collision;
+        bestNs = INT64_MAX;
+        for (int32_t r = 0; r < parseRepeat; r++)
+        {
+            const int64_t start = Bench_NowNs();
+            error = LDtkParse(name, collisionContext, collisionFlags, &collision);
+            const int64_t elapsed = Bench_NowNs() - start;
+            bestNs = elapsed < bestNs ? elapsed : bestNs;
+        }
+
+        if (error.code != LDtkErrorCode_None)
+        {
+            fprintf(stderr, "LDtkParse collision only failed: %s\n", error.message);
+        }
+        else
+        {
+            printf("    %-18s %10.1f us %10.1f MB/s %10d KB (collision only)\n", "LDtkParse", bestNs / 1000.0, (double)length / (double)bestNs * 1000.0, collision.memoryUsage / 1024);
+        }
+    }
+
+    printf("\n");
+}
+
+static void Bench_Synthetic(int32_t scale)
+{
+    int32_t length = 0;
+    char* source = Bench_ReadFile(SYNTHETIC_SOURCE, &length);
+    if (!source)
+    {
+        fprintf(stderr, "Cannot read %s\n", SYNTHETIC_SOURCE);
+        return;
+    }
+
+    // The source values stay alive while the synthetic documents are benchmarked
+    static char sourceBuffer[PARSE_BUFFER_SIZE];
+
+    Json world;
+    const JsonResult result = JsonParse(source, length, JsonParseFlags_Default, sourceBuffer, PARSE_BUFFER_SIZE, &world);
+    if (result.error != JsonError_None)
+    {
+        fprintf(stderr, "JsonParse failed: %s\n", result.message);
+        free(source);
+        return;
+    }
+
+    char name[256];
+    const Json synthetics[] = { Bench_RepeatLevels(world, SYNTHETIC_LEVELS), Bench_BigIntGrid(world, SYNTHETIC_GRID_SIZE) };
+    for (int32_t i = 0; i < 2; i++)
+    {
+        if (synthetics[i].type != JsonType_Object)
+        {
+            fprintf(stderr, "Cannot make synthetic world %d from %s\n", i, SYNTHETIC_SOURCE);
+            continue;
+        }
+
+        int32_t syntheticLength = 0;
+        char* content = Bench_WriteDocument(synthetics[i], &syntheticLength);
+        if (content)
+        {
+            if (i == 0) snprintf(name, sizeof(name), "synthetic, levels x%d", SYNTHETIC_LEVELS);
+            else        snprintf(name, sizeof(name), "synthetic, %dx%d IntGrid", SYNTHETIC_GRID_SIZE, SYNTHETIC_GRID_SIZE);
+
+            Bench_Document(name, content, syntheticLength, scale);
+            free(content);
+        }
+    }
+
+    Bench_SyntheticFreeAll();
+    free(source);
+}
+
+static void Bench_File(const char* path, int32_t scale)
+{
+    int32_t length = 0;
+    char* content = Bench_ReadFile(path, &length);
+    if (!content)
+    {
+        fprintf(stderr, "Cannot read %s\n", path);
+        return;
+    }
+
+    Bench_Document(path, content, length, scale);
+    free(content);
+}
+
+int main(int argc, char* argv[])
+{
+    const int32_t scale = argc > 1 ? atoi(argv[1]) : 1;
+    const char* filter = argc > 2 ? argv[2] : nullptr;
+    if (scale <= 0)
+    {
+        fprintf(stderr, "Usage: %s [scale] [file]\n", argv[0]);
+        return 1;
+    }
+
+    DIR* dir = opendir(ASSETS_DIR);
+    if (!dir)
+    {
+        fprintf(stderr, "Cannot open %s, run from the benchmarks directory\n", ASSETS_DIR);
+        return 1;
+    }
+
+    while (struct dirent* entry = readdir(dir))
+    {
+        const char* extension = strrchr(entry->d_name, '.');
+        if (!extension || strcmp(extension, ".ldtk") != 0)
+        {
+            continue;
+        }
+
+        if (filter && !strstr(entry->d_name, filter))
+        {
+            continue;
+        }
+
+        char path[1024];
+        snprintf(path, sizeof(path), "%s/%s", ASSETS_DIR, entry->d_name);
+        Bench_File(path, scale);
+    }
+
+    closedir(dir);
+
+    if (!filter || strstr("synthetic", filter))
+    {
+        Bench_Synthetic(scale);
+    }
+
+    return 0;
+}
+
+//! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
@@ -0,0 +1,695 @@
+// JSON and LDtk fuzz target
+// Every input go through all the entry points, and their results are checked against JsonParse:
+//      JsonParse       with and without comments and strict top level, then in situ (same values)
+//      JsonWriter      the values written then parsed again are the same, compact and pretty
+//      JsonReader      read in small random chunks, accept what JsonParse accept
+//      JsonTape        build what JsonParse accept, walk every node
+//      JsonQueryMemory the exact buffer size of what JsonParse accept, 16 bytes less is out of memory
+//      skip hook       JsonParseSkipping accept what JsonParse accept, JsonQueryMemorySkipping size is exact
+//      LDtkParse       the document as a world, must not crash, LDtkQueryMemory size is exact when it parse
+//      LDtkCook        the world cooked, loaded then cooked again give the same blob, a corrupted blob must not crash
+//      parallelFor     the world parsed with external levels in parallel cook to the same blob
+//      LDtkLoadLevel   the levels of a level index loaded one by one cook to the same blob
+//      selective parse the layers the flags and the filter keep are the ones of the whole world, LDtkQueryMemory size is exact
+// A failed check abort, the sanitizers report the rest.
+//
+// LLVMFuzzerTestOneInput is the libFuzzer entry point (make libfuzzer, require clang).
+// Without libFuzzer a standalone driver mutate the seeds: the shipped LDtk worlds,
+// the files given in argument, and a few small documents.
+//
+// Usage: fuzz_json [iterations] [seed] [files...]
+//      iterations  number of mutated inputs, default 10000
+//      seed        random seed, default 1
+
+#include <math.h>
+#include <stdio.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dirent.h>
+#include <sanitizer/common_interface_defs.h>
+
+#include "Misc/Json.h"
+#include "Misc/LDtkParser.h"
+#include "Misc/LDtkCooker.h"
+
+constexpr const char*   ASSETS_DIR          = "../assets";
+constexpr int32_t       MAX_INPUT_SIZE      = 1024 * 1024;
+constexpr int32_t       PARSE_BUFFER_SIZE   = 32 * 1024 * 1024;
+constexpr int32_t       READER_BUFFER_SIZE  = MAX_INPUT_SIZE + 64;
+
+static char gParseBuffer[PARSE_BUFFER_SIZE];
+alignas(16) static char gCheckBuffer[PARSE_BUFFER_SIZE];
+alignas(16) static char gWriteBuffer[PARSE_BUFFER_SIZE];
+static char gInSituText[MAX_INPUT_SIZE];
+static char gReaderBuffer[READER_BUFFER_SIZE];
+alignas(16) static char gLDtkBuffer[PARSE_BUFFER_SIZE];
+alignas(16) static char gCookedBuffer[PARSE_BUFFER_SIZE];
+
+#define FUZZ_CHECK(condition)                                                       \
+    do {                                                                            \
+        if (!(condition))                                                           \
+        {                                                                           \
+            fprintf(stderr, "Check failed: %s\n\tAt %s:%d\n", #condition, __FILE__, __LINE__); \
+            abort();                                                                \
+        }                                                                           \
+    } while (false)
+
+// -------------------------------------------------------------------
+// Checks
+// -------------------------------------------------------------------
+
+static uint32_t gChunkState = 1;
+
+struct ChunkSource
+{
+    const uint8_t*  data;
+    int32_t         length;
+    int32_t         cursor;
+};
+
+// Give the input 1 to 64 bytes at a time, so the reader refill everywhere
+static int32_t Fuzz_ReadChunk(void* userData, void* buffer, int32_t bufferSize)
+{
+    ChunkSource* source = (ChunkSource*)userData;
+
+    gChunkState = gChunkState * 1103515245u + 12345u;
+    const int32_t chunk = 1 + (int32_t)((gChunkState >> 16) & 63);
+
+    int32_t count = source->length - source->cursor;
+    count = count < chunk ? count : chunk;
+    count = count < bufferSize ? count : bufferSize;
+
+    memcpy(buffer, source->data + source->cursor, (size_t)count);
+    source->cursor += count;
+    return count;
+}
+
+// JsonEquals, except that numbers too big for a double are written as null
+static bool Fuzz_WrittenEquals(const Json value, const Json written)
+{
+    if (value.type == JsonType_Number && !JsonIsInteger(value) && !isfinite(value.number))
+    {
+        return written.type == JsonType_Null;
+    }
+
+    if (value.type != written.type)
+    {
+        return false;
+    }
+
+    if ((value.type == JsonType_Array || value.type == JsonType_Object) && value.length != written.length)
+    {
+        return false;
+    }
+
+    if (value.type == JsonType_Array)
+    {
+        for (int32_t i = 0; i < value.length; i++)
+        {
+            if (!Fuzz_WrittenEquals(value.array[i], written.array[i]))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    if (value.type == JsonType_Object)
+    {
+        for (int32_t i = 0; i < value.length; i++)
+        {
+            const char* name = value.object[i].name ? value.object[i].name : "";
+            const char* writtenName = written.object[i].name ? written.object[i].name : "";
+            if (strcmp(name, writtenName) != 0 || !Fuzz_WrittenEquals(value.object[i].value, written.object[i].value))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    return JsonEquals(value, written);
+}
+
+static void Fuzz_CheckWriter(const Json json, JsonParseFlags flags, JsonWriteFlags writeFlags)
+{
+    JsonWriter writer;
+    JsonWriter_Init(&writer, writeFlags, gWriteBuffer, PARSE_BUFFER_SIZE, NULL, NULL);
+
+    // Too deep documents are refused by the writer only
+    if (!JsonWriter_Value(&writer, json) || !JsonWriter_Finish(&writer))
+    {
+        FUZZ_CHECK(writer.error == JsonError_OutOfMemory);
+        return;
+    }
+
+    Json written;
+    const JsonResult result = JsonParse(gWriteBuffer, writer.length, (JsonParseFlags)(flags | JsonParseFlags_NoStrictTopLevel), gCheckBuffer, PARSE_BUFFER_SIZE, &written);
+    FUZZ_CHECK(result.error == JsonError_None);
+    FUZZ_CHECK(Fuzz_WrittenEquals(json, written));
+}
+
+static void Fuzz_CheckReader(const uint8_t* data, int32_t size, JsonParseFlags flags, bool parsed)
+{
+    ChunkSource source = { data, size, 0 };
+
+    JsonReader reader;
+    JsonReader_Init(&reader, flags, gReaderBuffer, READER_BUFFER_SIZE, Fuzz_ReadChunk, &source);
+
+    JsonToken token;
+    do
+    {
+        token = JsonReader_Next(&reader);
+    } while (token != JsonToken_End && token != JsonToken_Error);
+
+    FUZZ_CHECK(!parsed || token == JsonToken_End);
+}
+
+static void Fuzz_WalkTape(const JsonTape* tape)
+{
+    char string[256];
+    for (int32_t node = 0; node < tape->count; node++)
+    {
+        Json value;
+        switch (JsonTape_GetType(tape, node))
+        {
+        case JsonType_Array:
+            for (int32_t i = 0; i < JsonTape_GetLength(tape, node); i++)
+            {
+                FUZZ_CHECK(JsonTape_GetItem(tape, node, i) > node);
+            }
+            break;
+
+        case JsonType_Object:
+            JsonTape_Find(tape, node, "identifier");
+            break;
+
+        case JsonType_String:
+            JsonTape_GetString(tape, node, string, sizeof(string));
+            break;
+
+        default:
+            JsonTape_GetValue(tape, node, &value);
+            break;
+        }
+
+        FUZZ_CHECK(JsonTape_Skip(tape, node) > node);
+    }
+}
+
+// Skip the arrays and objects where the depth and the first byte of the name are not both odd or even
+static bool Fuzz_Skip(void* userData, const JsonSkipTarget* target)
+{
+    (void)userData;
+    FUZZ_CHECK(target->depth > 0 && target->length > 0 && (target->text[0] == '[' || target->text[0] == '{'));
+
+    const uint8_t first = target->name ? (uint8_t)target->name[0] : 0;
+    return ((target->depth + first) & 1) != 0;
+}
+
+static const uint8_t*   gLDtkData;
+static int32_t          gLDtkSize;
+
+// Ranges run on this thread in reverse order, what a parallel parse must not depend on
+static void Fuzz_LDtkParallelFor(LDtkRangeFn* func, void* data, int32_t count, int32_t batchSize)
+{
+    for (int32_t end = count; end > 0; end -= batchSize)
+    {
+        const int32_t start = end > batchSize ? end - batchSize : 0;
+        func(data, start, end);
+    }
+}
+
+// Keep the layers with an even first letter, empty names included
+static bool Fuzz_LDtkLayerFilter(void* userData, const char* layerName, LDtkLayerType type)
+{
+    (void)userData;
+    (void)type;
+    return ((uint8_t)layerName[0] & 1) == 0;
+}
+
+static const LDtkParseFlags FUZZ_SELECTIVE_FLAGS = (LDtkParseFlags)(LDtkParseFlags_SkipEntityLayers | LDtkParseFlags_SkipAutoLayerTiles
+    | LDtkParseFlags_SkipIntGridValues | LDtkParseFlags_SkipBackground);
+
+// Every file of the world is the input, external levels included
+static bool Fuzz_LDtkReadMemory(const char* fileName, void* buffer, int32_t* bufferSize)
+{
+    (void)fileName;
+
+    if (buffer)
+    {
+        if (*bufferSize < gLDtkSize)
+        {
+            return false;
+        }
+
+        memcpy(buffer, gLDtkData, (size_t)gLDtkSize);
+    }
+
+    *bufferSize = gLDtkSize;
+    return true;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    if (size == 0 || size > (size_t)MAX_INPUT_SIZE)
+    {
+        return 0;
+    }
+
+    const char*     text    = (const char*)data;
+    const int32_t   length  = (int32_t)size;
+
+    for (int32_t variant = 0; variant < 4; variant++)
+    {
+        const JsonParseFlags flags = (JsonParseFlags)variant; // SupportComment and NoStrictTopLevel
+
+        Json json;
+        const JsonResult result = JsonParse(text, length, flags, gParseBuffer, PARSE_BUFFER_SIZE, &json);
+        const bool parsed = result.error == JsonError_None;
+        FUZZ_CHECK(result.message != NULL);
+
+        // In situ give the same values
+        Json inSitu;
+        memcpy(gInSituText, text, size);
+        const JsonResult inSituResult = JsonParse(gInSituText, length, (JsonParseFlags)(flags | JsonParseFlags_InSitu), gCheckBuffer, PARSE_BUFFER_SIZE, &inSitu);
+        FUZZ_CHECK(inSituResult.error == result.error);
+        FUZZ_CHECK(!parsed || JsonEquals(json, inSitu));
+
+        if (parsed)
+        {
+            Fuzz_CheckWriter(json, flags, JsonWriteFlags_Default);
+            Fuzz_CheckWriter(json, flags, JsonWriteFlags_Pretty);
+        }
+
+        // The reader and the tape stop after the first value without strict top level, trailing bytes are not checked
+        const bool strict = (flags & JsonParseFlags_NoStrictTopLevel) == 0;
+        Fuzz_CheckReader(data, length, flags, parsed && strict);
+
+        // The tape does not support comments
+        if ((flags & JsonParseFlags_SupportComment) == 0)
+        {
+            JsonTape tape;
+            const JsonResult tapeResult = JsonTape_Build(text, length, flags, gCheckBuffer, PARSE_BUFFER_SIZE, &tape);
+            FUZZ_CHECK(!(parsed && strict) || tapeResult.error == JsonError_None);
+            if (tapeResult.error == JsonError_None)
+            {
+                Fuzz_WalkTape(&tape);
+            }
+
+            int32_t bufferSize;
+            const JsonResult query = JsonQueryMemory(text, length, flags, &bufferSize);
+            FUZZ_CHECK(!parsed || query.error == JsonError_None);
+            if (parsed)
+            {
+                Json exact;
+                FUZZ_CHECK(query.memoryUsage == result.memoryUsage);
+                FUZZ_CHECK(JsonParse(text, length, flags, gCheckBuffer, bufferSize, &exact).error == JsonError_None);
+                FUZZ_CHECK(JsonParse(text, length, flags, gCheckBuffer, bufferSize - 16, &exact).error == JsonError_OutOfMemory);
+
+                Json skipped;
+                const JsonResult skipResult = JsonParseSkipping(text, length, flags, Fuzz_Skip, nullptr, nullptr, nullptr, nullptr, gCheckBuffer, PARSE_BUFFER_SIZE, &skipped);
+                const JsonResult skipQuery = JsonQueryMemorySkipping(text, length, flags, Fuzz_Skip, nullptr, &bufferSize);
+                FUZZ_CHECK(skipResult.error == JsonError_None && skipQuery.error == JsonError_None);
+                FUZZ_CHECK(skipQuery.memoryUsage == skipResult.memoryUsage);
+                FUZZ_CHECK(JsonParseSkipping(text, length, flags, Fuzz_Skip, nullptr, nullptr, nullptr, nullptr, gCheckBuffer, bufferSize, &skipped).error == JsonError_None);
+                FUZZ_CHECK(JsonParseSkipping(text, length, flags, Fuzz_Skip, nullptr, nullptr, nullptr, nullptr, gCheckBuffer, bufferSize - 16, &skipped).error == JsonError_OutOfMemory);
+            }
+        }
+        else if (parsed)
+        {
+            Json skipped;
+            FUZZ_CHECK(JsonParseSkipping(text, length, flags, Fuzz_Skip, nullptr, nullptr, nullptr, nullptr, gCheckBuffer, PARSE_BUFFER_SIZE, &skipped).error == JsonError_None);
+        }
+    }
+
+    gLDtkData = data;
+    gLDtkSize = length;
+
+    const LDtkContext context = { gLDtkBuffer, PARSE_BUFFER_SIZE, Fuzz_LDtkReadMemory, nullptr, nullptr, nullptr, nullptr, nullptr };
+
+    LDtkWorld world;
+    const LDtkError error = LDtkParse("fuzz.ldtk", context, LDtkParseFlags_None, &world);
+    LDtkParse("fuzz.ldtk", context, LDtkParseFlags_LayerReverseOrder, &world);
+
+    int32_t worldBufferSize;
+    if (error.code == LDtkErrorCode_None && LDtkQueryMemory("fuzz.ldtk", context, LDtkParseFlags_None, &worldBufferSize).code == LDtkErrorCode_None)
+    {
+        const LDtkContext exactContext = { gLDtkBuffer, worldBufferSize, Fuzz_LDtkReadMemory, nullptr, nullptr, nullptr, nullptr, nullptr };
+        FUZZ_CHECK(LDtkParse("fuzz.ldtk", exactContext, LDtkParseFlags_None, &world).code == LDtkErrorCode_None);
+        FUZZ_CHECK(world.memoryUsage == worldBufferSize);
+    }
+
+    // Skipped layers and arrays are never parsed in gLDtkBuffer, the whole world is parsed in gCheckBuffer to compare
+    LDtkWorld whole;
+    const LDtkContext wholeContext = { gCheckBuffer, PARSE_BUFFER_SIZE, Fuzz_LDtkReadMemory, nullptr, nullptr, nullptr, nullptr, nullptr };
+    if (error.code == LDtkErrorCode_None && LDtkParse("fuzz.ldtk", wholeContext, LDtkParseFlags_None, &whole).code == LDtkErrorCode_None)
+    {
+        LDtkContext selectiveContext = context;
+        selectiveContext.layerFilter = Fuzz_LDtkLayerFilter;
+        FUZZ_CHECK(LDtkParse("fuzz.ldtk", selectiveContext, FUZZ_SELECTIVE_FLAGS, &world).code == LDtkErrorCode_None);
+        FUZZ_CHECK(world.levelCount == whole.levelCount);
+
+        for (int32_t i = 0; i < world.levelCount; i++)
+        {
+            const LDtkLevel* level = &world.levels[i];
+            const LDtkLevel* wholeLevel = &whole.levels[i];
+            FUZZ_CHECK(level->id == wholeLevel->id && level->bgPath == nullptr && level->bgScaleX == 0.0f);
+
+            int32_t layerIndex = 0;
+            for (int32_t j = 0; j < wholeLevel->layerCount; j++)
+            {
+                const LDtkLayer* wholeLayer = &wholeLevel->layers[j];
+                const char* wholeName = wholeLayer->name ? wholeLayer->name : "";
+                if (wholeLayer->type == LDtkLayerType_Entities || !Fuzz_LDtkLayerFilter(nullptr, wholeName, wholeLayer->type))
+                {
+                    continue;
+                }
+
+                FUZZ_CHECK(layerIndex < level->layerCount);
+                const LDtkLayer* layer = &level->layers[layerIndex++];
+                FUZZ_CHECK(strcmp(layer->name ? layer->name : "", wholeName) == 0 && layer->type == wholeLayer->type);
+                FUZZ_CHECK(layer->valueCount == 0 && layer->entityCount == wholeLayer->entityCount);
+                FUZZ_CHECK(layer->tileCount == (layer->type == LDtkLayerType_Tiles ? wholeLayer->tileCount : 0));
+            }
+            FUZZ_CHECK(layerIndex == level->layerCount);
+        }
+
+        int32_t selectiveBufferSize;
+        if (LDtkQueryMemory("fuzz.ldtk", selectiveContext, FUZZ_SELECTIVE_FLAGS, &selectiveBufferSize).code == LDtkErrorCode_None)
+        {
+            LDtkContext exactContext = selectiveContext;
+            exactContext.bufferSize = selectiveBufferSize;
+            FUZZ_CHECK(LDtkParse("fuzz.ldtk", exactContext, FUZZ_SELECTIVE_FLAGS, &world).code == LDtkErrorCode_None);
+            FUZZ_CHECK(world.memoryUsage == selectiveBufferSize);
+
+            exactContext.bufferSize = selectiveBufferSize - 16;
+            FUZZ_CHECK(LDtkParse("fuzz.ldtk", exactContext, FUZZ_SELECTIVE_FLAGS, &world).code != LDtkErrorCode_None);
+        }
+    }
+
+    int32_t cookedSize;
+    if (error.code == LDtkErrorCode_None && LDtkParse("fuzz.ldtk", context, LDtkParseFlags_None, &world).code == LDtkErrorCode_None
+        && LDtkCook(&world, LDtkParseFlags_None, LDtkSourceStamp{ length, 0 }, NULL, 0, gCookedBuffer, PARSE_BUFFER_SIZE, &cookedSize).code == LDtkErrorCode_None)
+    {
+        // Stale when the source or the flags are not the same
+        LDtkWorld cooked;
+        memcpy(gCheckBuffer, gCookedBuffer, (size_t)cookedSize);
+        FUZZ_CHECK(LDtkLoadCooked(gCheckBuffer, cookedSize, LDtkParseFlags_LayerReverseOrder, LDtkSourceStamp{ length, 0 }, &cooked).code == LDtkErrorCode_StaleCookedWorld);
+        FUZZ_CHECK(LDtkLoadCooked(gCheckBuffer, cookedSize, LDtkParseFlags_None, LDtkSourceStamp{ length + 1, 0 }, &cooked).code == LDtkErrorCode_StaleCookedWorld);
+
+        // Stale when an external level file is not the one it was cooked from
+        const LDtkLevelSource missingSource = { "fuzz_missing.ldtkl", LDtkSourceStamp{ length, 0 } };
+        int32_t sourcedSize;
+        FUZZ_CHECK(LDtkCook(&world, LDtkParseFlags_None, LDtkSourceStamp{ length, 0 }, &missingSource, 1, gWriteBuffer, PARSE_BUFFER_SIZE, &sourcedSize).code == LDtkErrorCode_None);
+        FUZZ_CHECK(LDtkLoadCooked(gWriteBuffer, sourcedSize, LDtkParseFlags_None, LDtkSourceStamp{ length, 0 }, &cooked).code == LDtkErrorCode_StaleCookedWorld);
+
+        int32_t recookedSize;
+        FUZZ_CHECK(LDtkLoadCooked(gCheckBuffer, cookedSize, LDtkParseFlags_None, LDtkSourceStamp{ length, 0 }, &cooked).code == LDtkErrorCode_None);
+        FUZZ_CHECK(LDtkCook(&cooked, LDtkParseFlags_None, LDtkSourceStamp{ length, 0 }, NULL, 0, gWriteBuffer, PARSE_BUFFER_SIZE, &recookedSize).code == LDtkErrorCode_None);
+        FUZZ_CHECK(recookedSize == cookedSize && memcmp(gWriteBuffer, gCookedBuffer, (size_t)cookedSize) == 0);
+
+        // One corrupted byte, picked from the input so a failure can be replayed
+        const int32_t position = (int32_t)(((uint32_t)length * 2654435761u) % (uint32_t)cookedSize);
+        memcpy(gCheckBuffer, gCookedBuffer, (size_t)cookedSize);
+        gCheckBuffer[position] ^= (char)(1 + length % 255);
+        if (LDtkLoadCooked(gCheckBuffer, cookedSize, LDtkParseFlags_None, LDtkSourceStamp{ length, 0 }, &cooked).code == LDtkErrorCode_None)
+        {
+            LDtkCook(&cooked, LDtkParseFlags_None, LDtkSourceStamp{ length, 0 }, NULL, 0, gWriteBuffer, PARSE_BUFFER_SIZE, &recookedSize);
+        }
+
+        // Same world whatever the order the levels are read in
+        LDtkContext parallelContext = context;
+        parallelContext.parallelFor = Fuzz_LDtkParallelFor;
+        FUZZ_CHECK(LDtkParse("fuzz.ldtk", parallelContext, LDtkParseFlags_None, &world).code == LDtkErrorCode_None);
+        FUZZ_CHECK(LDtkCook(&world, LDtkParseFlags_None, LDtkSourceStamp{ length, 0 }, NULL, 0, gWriteBuffer, PARSE_BUFFER_SIZE, &recookedSize).code == LDtkErrorCode_None);
+        FUZZ_CHECK(recookedSize == cookedSize && memcmp(gWriteBuffer, gCookedBuffer, (size_t)cookedSize) == 0);
+
+        // Levels loaded on demand, packed in one buffer. Levels are found by id, a world with the same id twice is not compared.
+        LDtkWorld index;
+        FUZZ_CHECK(LDtkParse("fuzz.ldtk", context, LDtkParseFlags_LevelIndex, &index).code == LDtkErrorCode_None);
+
+        bool uniqueIds = true;
+        int32_t levelOffset = 0;
+        for (int32_t i = 0; i < index.levelCount && uniqueIds; i++)
+        {
+            for (int32_t j = 0; j < i; j++)
+            {
+                uniqueIds = uniqueIds && index.levels[j].id != index.levels[i].id;
+            }
+
+            const LDtkContext levelContext = { gCheckBuffer + levelOffset, PARSE_BUFFER_SIZE - levelOffset, Fuzz_LDtkReadMemory, nullptr, nullptr, nullptr, nullptr, nullptr };
+            if (uniqueIds && LDtkLoadLevel(&index, index.levels[i].id, levelContext, LDtkParseFlags_None).code == LDtkErrorCode_None)
+            {
+                levelOffset += (index.levels[i].memoryUsage + 15) & ~15;
+            }
+            else
+            {
+                uniqueIds = false;
+            }
+        }
+
+        if (uniqueIds)
+        {
+            index.memoryUsage = world.memoryUsage;
+            FUZZ_CHECK(LDtkCook(&index, LDtkParseFlags_None, LDtkSourceStamp{ length, 0 }, NULL, 0, gWriteBuffer, PARSE_BUFFER_SIZE, &recookedSize).code == LDtkErrorCode_None);
+            FUZZ_CHECK(recookedSize == cookedSize && memcmp(gWriteBuffer, gCookedBuffer, (size_t)cookedSize) == 0);
+        }
+    }
+    return 0;
+}
+
+// -------------------------------------------------------------------
+// Standalone driver
+// -------------------------------------------------------------------
+
+#if !defined(FUZZ_WITH_LIBFUZZER)
+
+constexpr int32_t       MAX_SEEDS           = 64;
+constexpr const char*   FAILURE_PATH        = "out/failure.json";
+
+struct Seed
+{
+    uint8_t*    data;
+    int32_t     size;
+};
+
+static Seed             gSeeds[MAX_SEEDS];
+static int32_t          gSeedCount = 0;
+static uint64_t         gRandom = 1;
+
+static uint32_t Fuzz_Random(uint32_t range)
+{
+    gRandom ^= gRandom << 13;
+    gRandom ^= gRandom >> 7;
+    gRandom ^= gRandom << 17;
+    return (uint32_t)(gRandom >> 32) % range;
+}
+
+static void Fuzz_AddSeed(const void* data, int32_t size)
+{
+    if (gSeedCount < MAX_SEEDS && size > 0 && size <= MAX_INPUT_SIZE)
+    {
+        gSeeds[gSeedCount].data = (uint8_t*)malloc((size_t)size);
+        gSeeds[gSeedCount].size = size;
+        memcpy(gSeeds[gSeedCount].data, data, (size_t)size);
+        gSeedCount++;
+    }
+}
+
+static void Fuzz_AddSeedFile(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        fprintf(stderr, "Cannot read %s\n", path);
+        return;
+    }
+
+    static uint8_t content[MAX_INPUT_SIZE];
+    const int32_t size = (int32_t)fread(content, 1, sizeof(content), file);
+    fclose(file);
+
+    Fuzz_AddSeed(content, size);
+}
+
+// Tokens and edge cases the mutations insert
+static const char* const FUZZ_DICTIONARY[] =
+{
+    "{", "}", "[", "]", ",", ":", "\"", "\\", "\\u", "\\ud83d", "\\udc00", "\\u0000",
+    "true", "false", "null", "-", "0", "-0", ".5", "1e308", "1e-400", "18446744073709551616",
+    "9223372036854775807", "-9223372036854775808", "0.1e+", "//", "/*", "*/", "\n", "\r", "\t",
+    "\xc3\xa9", "\xf0\x9f\x98\x80", "\xc3", "\xff", "\"levels\":", "\"layerInstances\":", "\"intGridCsv\":",
+    "\"__type\":\"IntGrid\"", "\"__cWid\":", "\"coordId\":", "\"externalRelPath\":",
+};
+
+static uint8_t          gInput[MAX_INPUT_SIZE];
+static int32_t          gInputSize = 0;
+
+static void Fuzz_SaveInput(void)
+{
+    if (FILE* file = fopen(FAILURE_PATH, "wb"))
+    {
+        fwrite(gInput, 1, (size_t)gInputSize, file);
+        fclose(file);
+        fprintf(stderr, "Input saved to %s, run again with: fuzz_json 0 0 %s\n", FAILURE_PATH, FAILURE_PATH);
+    }
+}
+
+// Failed asserts of the parsers
+static void Fuzz_OnAbort(int signal)
+{
+    Fuzz_SaveInput();
+
+    ::signal(signal, SIG_DFL);
+    raise(signal);
+}
+
+static int32_t Fuzz_Mutate(uint8_t* data, int32_t size, int32_t capacity)
+{
+    const int32_t mutationCount = 1 + (int32_t)Fuzz_Random(8);
+    for (int32_t m = 0; m < mutationCount; m++)
+    {
+        const int32_t position = size > 0 ? (int32_t)Fuzz_Random((uint32_t)size + 1) : 0;
+        switch (Fuzz_Random(6))
+        {
+        case 0: // Flip a byte
+            if (position < size)
+            {
+                data[position] ^= (uint8_t)(1u << Fuzz_Random(8));
+            }
+            break;
+
+        case 1: // Insert a token
+        {
+            const char* token = FUZZ_DICTIONARY[Fuzz_Random(sizeof(FUZZ_DICTIONARY) / sizeof(FUZZ_DICTIONARY[0]))];
+            const int32_t tokenLength = (int32_t)strlen(token);
+            if (size + tokenLength <= capacity)
+            {
+                memmove(data + position + tokenLength, data + position, (size_t)(size - position));
+                memcpy(data + position, token, (size_t)tokenLength);
+                size += tokenLength;
+            }
+        } break;
+
+        case 2: // Remove a range
+        {
+            const int32_t count = (int32_t)Fuzz_Random(16) + 1;
+            if (position + count <= size)
+            {
+                memmove(data + position, data + position + count, (size_t)(size - position - count));
+                size -= count;
+            }
+        } break;
+
+        case 3: // Duplicate a range, deep nesting and long arrays
+        {
+            const int32_t count = (int32_t)Fuzz_Random(64) + 1;
+            if (position + count <= size && size + count <= capacity)
+            {
+                memmove(data + position + count, data + position, (size_t)(size - position));
+                size += count;
+            }
+        } break;
+
+        case 4: // Truncate
+            if (Fuzz_Random(8) == 0)
+            {
+                size = position;
+            }
+            break;
+
+        default: // Replace a byte with a structural one
+            if (position < size)
+            {
+                data[position] = (uint8_t)"{}[]:,\"\\ 0"[Fuzz_Random(10)];
+            }
+            break;
+        }
+    }
+
+    return size;
+}
+
+int main(int argc, char* argv[])
+{
+    const int32_t iterations = argc > 1 ? atoi(argv[1]) : 10000;
+    gRandom = argc > 2 ? (uint64_t)strtoull(argv[2], NULL, 10) * 0x9E3779B97F4A7C15ull + 1 : 1;
+
+    for (int32_t i = 3; i < argc; i++)
+    {
+        Fuzz_AddSeedFile(argv[i]);
+    }
+
+    if (DIR* dir = opendir(ASSETS_DIR))
+    {
+        while (struct dirent* entry = readdir(dir))
+        {
+            const char* extension = strrchr(entry->d_name, '.');
+            if (extension && strcmp(extension, ".ldtk") == 0)
+            {
+                char path[1024];
+                snprintf(path, sizeof(path), "%s/%s", ASSETS_DIR, entry->d_name);
+                Fuzz_AddSeedFile(path);
+            }
+        }
+
+        closedir(dir);
+    }
+
+    static const char* const SMALL_SEEDS[] =
+    {
+        "{}", "[]", "[1, -2.5e3, \"a\\n\\u00e9\", true, false, null]",
+        "{\"a\": {\"b\": [[], {}, 0.1]}, \"c\": \"\\ud83d\\ude00\"}",
+        "// comment\n{/* comment */ \"a\": 1}", "123", "\"top level\"",
+    };
+
+    for (const char* seed : SMALL_SEEDS)
+    {
+        Fuzz_AddSeed(seed, (int32_t)strlen(seed));
+    }
+
+    __sanitizer_set_death_callback(Fuzz_SaveInput);
+    signal(SIGABRT, Fuzz_OnAbort);
+
+    // Seeds as they are first
+    for (int32_t i = 0; i < gSeedCount; i++)
+    {
+        memcpy(gInput, gSeeds[i].data, (size_t)gSeeds[i].size);
+        gInputSize = gSeeds[i].size;
+        LLVMFuzzerTestOneInput(gInput, (size_t)gInputSize);
+    }
+
+    for (int32_t i = 0; i < iterations; i++)
+    {
+        const Seed seed = gSeeds[Fuzz_Random((uint32_t)gSeedCount)];
+        memcpy(gInput, seed.data, (size_t)seed.size);
+
+        gInputSize = Fuzz_Mutate(gInput, seed.size, MAX_INPUT_SIZE);
+        LLVMFuzzerTestOneInput(gInput, (size_t)gInputSize);
+
+        if ((i + 1) % 1000 == 0)
+        {
+            printf("%d / %d inputs\n", i + 1, iterations);
+            fflush(stdout);
+        }
+    }
+
+    printf("%d seeds, %d inputs, no failure\n", gSeedCount, iterations);
+
+    for (int32_t i = 0; i < gSeedCount; i++)
+    {
+        free(gSeeds[i].data);
+    }
+
+    return 0;
+}
+
+#endif
+
+//! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
@@ -197,3 +197,28 @@ do
 
     filter {}
 end
+
+-- Cook .ldtk worlds for the game: LDtkCook.exe assets/pixel_adventure.ldtk --layer-reverse-order
+project("LDtkCook." .. string.upper(_ACTION))
+do
+    kind "ConsoleApp"
+
+    includedirs {
+        path.join(ROOT_DIR, "src"),
+    }
+
+    files {
+        path.join(ROOT_DIR, "tools/ldtk_cook.c"),
+
+        path.join(ROOT_DIR, "src/Misc/Json.h"),
+        path.join(ROOT_DIR, "src/Misc/Json.c"),
+        path.join(ROOT_DIR, "src/Misc/LDtkParser.h"),
+        path.join(ROOT_DIR, "src/Misc/LDtkParser.c"),
+        path.join(ROOT_DIR, "src/Misc/LDtkCooker.h"),
+        path.join(ROOT_DIR, "src/Misc/LDtkCooker.c"),
+        path.join(ROOT_DIR, "src/Text/Utf8.h"),
+        path.join(ROOT_DIR, "src/Text/Utf8.cpp"),
+    }
+
+    filter {}
+end
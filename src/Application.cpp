@@ -21,6 +21,8 @@
 
 #include "Game/Game.h"
 #include "Misc/Logging.h"
+#include "Text/StringId.h"
+#include "Text/StringBuilder.h"
 
 #include "ThirdPartyImpl/imgui_impl_sdl.h"
 #include "ThirdPartyImpl/imgui_impl_opengl3.h"
@@ -33,10 +35,13 @@ static void Application_RenderDevTools(float deltaTime)
 #ifdef BUILD_PROFILING
     ImGui::Begin("Frame", nullptr, ImGuiWindowFlags_NoFocusOnAppearing);
 
-    char fpsText[1024];
-    snprintf(fpsText, sizeof(fpsText), "FPS: %.3f", deltaTime > FLOAT_EPSILON ? 1.0f / deltaTime : 0.0f);
+    StringBuilder fpsText;
+    StringBuilder_Init(&fpsText, String_GetTempArena());
+    StringBuilder_Append(&fpsText, "FPS: ");
+    StringBuilder_AppendFloat(&fpsText, deltaTime > FLOAT_EPSILON ? 1.0f / deltaTime : 0.0f, 3);
 
-    ImGui::Text(fpsText);
+    ImGui::TextUnformatted(StringBuilder_GetString(&fpsText));
+    StringBuilder_CleanUp(&fpsText);
 
     //vec2 fpsTextSize = vec2_mul1(Graphics::TextSize(fpsText), 2.0f);
     //
@@ -124,6 +129,10 @@ int ApplicationMain(int argc, char* argv[])
             return -(int)graphicsError;
         }
 
+        // Parse buffers and vertex arrays overruns fault at the exact instruction in debug build
+        Memory_SetGuardTag("LDtk", MemoryGuardFlags_Default);
+        Memory_SetGuardTag("SpriteBatch", MemoryGuardFlags_Default);
+
         // Setup subsystems
         JobSystem::Setup();
         Input_Setup();
@@ -241,6 +250,7 @@ int ApplicationMain(int argc, char* argv[])
         // Frame end
         Input_EndFrame();
         Timer_EndFrame();
+        String_ResetTemp();
     }
 
     LogStorage_Destroy(logStorage);
@@ -261,6 +271,7 @@ int ApplicationMain(int argc, char* argv[])
         // Shutdown subsystems
         Input_Shutdown();
         JobSystem::Shutdown();
+        StringId_Shutdown();
 
         Graphics_Shutdown(&window);
 
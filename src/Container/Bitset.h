@@ -0,0 +1,478 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BITSET_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define BITSET_USE_SSE2 0
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "Native/Memory.h"
+
+// -------------------------------------------------------------------
+// Word spans
+// Both bitset types are arrays of 64 bits words, these work on any of them.
+// Bits past the bit count are always zero.
+// -------------------------------------------------------------------
+
+constexpr int32_t BITSET_WORD_BITS = 64;
+
+static inline int32_t Bitset_WordCount(int32_t bitCount)
+{
+    return (bitCount + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS;
+}
+
+static inline int32_t Bitset_PopCount64(uint64_t word)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    return (int32_t)__popcnt64(word);
+#elif defined(_MSC_VER)
+    return (int32_t)(__popcnt((uint32_t)word) + __popcnt((uint32_t)(word >> 32)));
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+// Index of the lowest set bit, word must not be zero
+static inline int32_t Bitset_TrailingZeros64(uint64_t word)
+{
+    assert(word != 0);
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return (int32_t)index;
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanForward(&index, (uint32_t)word))
+    {
+        return (int32_t)index;
+    }
+    _BitScanForward(&index, (uint32_t)(word >> 32));
+    return (int32_t)index + 32;
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+// Number of set bits in the span
+static inline int32_t Bitset_CountWords(const uint64_t* words, int32_t wordCount)
+{
+    int32_t count = 0;
+    for (int32_t i = 0; i < wordCount; i++)
+    {
+        count += Bitset_PopCount64(words[i]);
+    }
+    return count;
+}
+
+// Number of set bits before bit index
+static inline int32_t Bitset_RankWords(const uint64_t* words, int32_t index)
+{
+    const int32_t wordIndex = index / BITSET_WORD_BITS;
+    const int32_t bitIndex = index % BITSET_WORD_BITS;
+
+    int32_t rank = Bitset_CountWords(words, wordIndex);
+    if (bitIndex > 0)
+    {
+        rank += Bitset_PopCount64(words[wordIndex] & ((1ull << bitIndex) - 1));
+    }
+    return rank;
+}
+
+// First set bit at or after start, -1 if none
+static inline int32_t Bitset_FindNextWords(const uint64_t* words, int32_t wordCount, int32_t start)
+{
+    int32_t wordIndex = start / BITSET_WORD_BITS;
+    if (wordIndex >= wordCount)
+    {
+        return -1;
+    }
+
+    uint64_t word = words[wordIndex] & (~0ull << (start % BITSET_WORD_BITS));
+    while (word == 0)
+    {
+        if (++wordIndex >= wordCount)
+        {
+            return -1;
+        }
+        word = words[wordIndex];
+    }
+
+    return wordIndex * BITSET_WORD_BITS + Bitset_TrailingZeros64(word);
+}
+
+// First clear bit at or after start, -1 if none before bitCount
+static inline int32_t Bitset_FindNextClearWords(const uint64_t* words, int32_t bitCount, int32_t start)
+{
+    const int32_t wordCount = Bitset_WordCount(bitCount);
+
+    int32_t wordIndex = start / BITSET_WORD_BITS;
+    if (wordIndex >= wordCount)
+    {
+        return -1;
+    }
+
+    uint64_t word = ~words[wordIndex] & (~0ull << (start % BITSET_WORD_BITS));
+    while (word == 0)
+    {
+        if (++wordIndex >= wordCount)
+        {
+            return -1;
+        }
+        word = ~words[wordIndex];
+    }
+
+    const int32_t index = wordIndex * BITSET_WORD_BITS + Bitset_TrailingZeros64(word);
+    return index < bitCount ? index : -1;
+}
+
+// Set or clear bits in [start, end)
+static inline void Bitset_AssignRangeWords(uint64_t* words, int32_t start, int32_t end, bool value)
+{
+    if (start >= end)
+    {
+        return;
+    }
+
+    const int32_t firstWord = start / BITSET_WORD_BITS;
+    const int32_t lastWord = (end - 1) / BITSET_WORD_BITS;
+    const uint64_t firstMask = ~0ull << (start % BITSET_WORD_BITS);
+    const uint64_t lastMask = ~0ull >> ((BITSET_WORD_BITS - end % BITSET_WORD_BITS) % BITSET_WORD_BITS);
+
+    if (firstWord == lastWord)
+    {
+        const uint64_t mask = firstMask & lastMask;
+        words[firstWord] = value ? (words[firstWord] | mask) : (words[firstWord] & ~mask);
+        return;
+    }
+
+    words[firstWord] = value ? (words[firstWord] | firstMask) : (words[firstWord] & ~firstMask);
+    memset(words + firstWord + 1, value ? 0xff : 0x00, sizeof(uint64_t) * (size_t)(lastWord - firstWord - 1));
+    words[lastWord] = value ? (words[lastWord] | lastMask) : (words[lastWord] & ~lastMask);
+}
+
+// dst = a & b, spans may alias
+static inline void Bitset_AndWords(uint64_t* dst, const uint64_t* a, const uint64_t* b, int32_t wordCount)
+{
+    int32_t i = 0;
+#if BITSET_USE_SSE2
+    for (; i + 2 <= wordCount; i += 2)
+    {
+        const __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        const __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_and_si128(va, vb));
+    }
+#endif
+    for (; i < wordCount; i++)
+    {
+        dst[i] = a[i] & b[i];
+    }
+}
+
+// dst = a | b, spans may alias
+static inline void Bitset_OrWords(uint64_t* dst, const uint64_t* a, const uint64_t* b, int32_t wordCount)
+{
+    int32_t i = 0;
+#if BITSET_USE_SSE2
+    for (; i + 2 <= wordCount; i += 2)
+    {
+        const __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        const __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_or_si128(va, vb));
+    }
+#endif
+    for (; i < wordCount; i++)
+    {
+        dst[i] = a[i] | b[i];
+    }
+}
+
+// dst = a & ~b, spans may alias
+static inline void Bitset_AndNotWords(uint64_t* dst, const uint64_t* a, const uint64_t* b, int32_t wordCount)
+{
+    int32_t i = 0;
+#if BITSET_USE_SSE2
+    for (; i + 2 <= wordCount; i += 2)
+    {
+        const __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        const __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_andnot_si128(vb, va));
+    }
+#endif
+    for (; i < wordCount; i++)
+    {
+        dst[i] = a[i] & ~b[i];
+    }
+}
+
+// Determine if any bit is set
+static inline bool Bitset_AnyWords(const uint64_t* words, int32_t wordCount)
+{
+    uint64_t any = 0;
+    for (int32_t i = 0; i < wordCount; i++)
+    {
+        any |= words[i];
+    }
+    return any != 0;
+}
+
+// Iterate set bits in increasing order, func(int32_t index)
+template <typename Func>
+inline void Bitset_ForEachWords(const uint64_t* words, int32_t wordCount, Func&& func)
+{
+    for (int32_t wordIndex = 0; wordIndex < wordCount; wordIndex++)
+    {
+        for (uint64_t word = words[wordIndex]; word != 0; word &= word - 1)
+        {
+            func(wordIndex * BITSET_WORD_BITS + Bitset_TrailingZeros64(word));
+        }
+    }
+}
+
+// -------------------------------------------------------------------
+// Bitset types
+// -------------------------------------------------------------------
+
+/// Methods shared by FixedBitset and Bitset, Derived provide words, bitCount and wordCount
+template <typename Derived>
+struct BitsetOps
+{
+    inline uint64_t* Words(void)
+    {
+        return ((Derived*)this)->words;
+    }
+
+    inline const uint64_t* Words(void) const
+    {
+        return ((const Derived*)this)->words;
+    }
+
+    inline int32_t BitCount(void) const
+    {
+        return ((const Derived*)this)->GetBitCount();
+    }
+
+    inline int32_t WordCount(void) const
+    {
+        return Bitset_WordCount(BitCount());
+    }
+
+    inline bool Get(int32_t index) const
+    {
+        assert(index >= 0 && index < BitCount());
+        return (Words()[index / BITSET_WORD_BITS] >> (index % BITSET_WORD_BITS)) & 1;
+    }
+
+    inline void Set(int32_t index)
+    {
+        assert(index >= 0 && index < BitCount());
+        Words()[index / BITSET_WORD_BITS] |= 1ull << (index % BITSET_WORD_BITS);
+    }
+
+    inline void Clear(int32_t index)
+    {
+        assert(index >= 0 && index < BitCount());
+        Words()[index / BITSET_WORD_BITS] &= ~(1ull << (index % BITSET_WORD_BITS));
+    }
+
+    inline void Assign(int32_t index, bool value)
+    {
+        value ? Set(index) : Clear(index);
+    }
+
+    inline void Toggle(int32_t index)
+    {
+        assert(index >= 0 && index < BitCount());
+        Words()[index / BITSET_WORD_BITS] ^= 1ull << (index % BITSET_WORD_BITS);
+    }
+
+    // Set bits in [start, end)
+    inline void SetRange(int32_t start, int32_t end)
+    {
+        assert(start >= 0 && end <= BitCount());
+        Bitset_AssignRangeWords(Words(), start, end, true);
+    }
+
+    // Clear bits in [start, end)
+    inline void ClearRange(int32_t start, int32_t end)
+    {
+        assert(start >= 0 && end <= BitCount());
+        Bitset_AssignRangeWords(Words(), start, end, false);
+    }
+
+    inline void SetAll(void)
+    {
+        Bitset_AssignRangeWords(Words(), 0, BitCount(), true);
+    }
+
+    inline void ClearAll(void)
+    {
+        memset(Words(), 0, sizeof(uint64_t) * (size_t)WordCount());
+    }
+
+    // Number of set bits
+    inline int32_t Count(void) const
+    {
+        return Bitset_CountWords(Words(), WordCount());
+    }
+
+    // Number of set bits before index
+    inline int32_t Rank(int32_t index) const
+    {
+        assert(index >= 0 && index <= BitCount());
+        return Bitset_RankWords(Words(), index);
+    }
+
+    inline bool Any(void) const
+    {
+        return Bitset_AnyWords(Words(), WordCount());
+    }
+
+    // First set bit, -1 if none
+    inline int32_t FindFirst(void) const
+    {
+        return Bitset_FindNextWords(Words(), WordCount(), 0);
+    }
+
+    // First set bit at or after start, -1 if none
+    inline int32_t FindNext(int32_t start) const
+    {
+        return Bitset_FindNextWords(Words(), WordCount(), start);
+    }
+
+    // First clear bit at or after start, -1 if none
+    inline int32_t FindNextClear(int32_t start) const
+    {
+        return Bitset_FindNextClearWords(Words(), BitCount(), start);
+    }
+
+    // Iterate set bits in increasing order, func(int32_t index)
+    template <typename Func>
+    inline void ForEach(Func&& func) const
+    {
+        Bitset_ForEachWords(Words(), WordCount(), func);
+    }
+
+    // this &= other, both must have the same bit count
+    inline void And(const BitsetOps& other)
+    {
+        assert(BitCount() == other.BitCount());
+        Bitset_AndWords(Words(), Words(), other.Words(), WordCount());
+    }
+
+    // this |= other, both must have the same bit count
+    inline void Or(const BitsetOps& other)
+    {
+        assert(BitCount() == other.BitCount());
+        Bitset_OrWords(Words(), Words(), other.Words(), WordCount());
+    }
+
+    // this &= ~other, both must have the same bit count
+    inline void AndNot(const BitsetOps& other)
+    {
+        assert(BitCount() == other.BitCount());
+        Bitset_AndNotWords(Words(), Words(), other.Words(), WordCount());
+    }
+};
+
+/// Bitset with compile-time size, no allocations
+template <int32_t BITS>
+struct FixedBitset : BitsetOps<FixedBitset<BITS>>
+{
+    static constexpr int32_t    BIT_COUNT   = BITS;
+    static constexpr int32_t    WORD_COUNT  = (BITS + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS;
+
+    uint64_t    words[WORD_COUNT];
+
+    inline FixedBitset()
+        : words()
+    {
+    }
+
+    inline int32_t GetBitCount(void) const
+    {
+        return BIT_COUNT;
+    }
+};
+
+/// Bitset with runtime size, words are 16 bytes aligned
+struct Bitset : BitsetOps<Bitset>
+{
+    static constexpr const char* TAG = "Bitset";
+
+    int32_t     bitCount;
+    int32_t     wordCapacity;
+    uint64_t*   words;
+
+    inline Bitset()
+        : bitCount(0)
+        , wordCapacity(0)
+        , words(nullptr)
+    {
+    }
+
+    inline ~Bitset()
+    {
+        assert(words == nullptr);
+    }
+
+    inline int32_t GetBitCount(void) const
+    {
+        return bitCount;
+    }
+
+    // Clean memory usage
+    inline void CleanUp(void)
+    {
+        Memory_FreeTag(TAG, words);
+
+        bitCount = 0;
+        wordCapacity = 0;
+        words = nullptr;
+    }
+
+    // Change the number of bits, new bits are cleared
+    inline bool Resize(int32_t newBitCount)
+    {
+        assert(newBitCount >= 0);
+
+        const int32_t oldWordCount = Bitset_WordCount(bitCount);
+        const int32_t newWordCount = Bitset_WordCount(newBitCount);
+        if (newWordCount > wordCapacity)
+        {
+            // Round up to whole 16 bytes blocks, like the alignment of the allocation
+            const int32_t newCapacity = (newWordCount + 1) & ~1;
+            uint64_t* newWords = (uint64_t*)Memory_ReallocTag(TAG, words, (int32_t)sizeof(uint64_t) * newCapacity, 16);
+            if (!newWords)
+            {
+                return false;
+            }
+
+            words = newWords;
+            wordCapacity = newCapacity;
+        }
+
+        if (newBitCount < bitCount)
+        {
+            // Keep bits past the bit count zero
+            Bitset_AssignRangeWords(words, newBitCount, newWordCount * BITSET_WORD_BITS, false);
+        }
+        else if (newWordCount > oldWordCount)
+        {
+            memset(words + oldWordCount, 0, sizeof(uint64_t) * (size_t)(newWordCount - oldWordCount));
+        }
+
+        bitCount = newBitCount;
+        return true;
+    }
+};
+
+//! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
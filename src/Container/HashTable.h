@@ -2,36 +2,125 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HASH_TABLE_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define HASH_TABLE_USE_SSE2 0
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #include "Native/Memory.h"
 
-// @note: unused
+/// Hash and equality of key types
+/// Specialize this (or pass a custom traits) for user key types
+template <typename TKey>
+struct HashTraits;
+
+// Finalizer of MurmurHash3, spread every input bits to the whole hash
+static inline uint64_t HashTraits_Mix(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdull;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+#define HASH_TRAITS_INTEGER(T)                                              \
+    template <>                                                             \
+    struct HashTraits<T>                                                    \
+    {                                                                       \
+        static inline uint64_t Hash(T key)                                  \
+        {                                                                   \
+            return HashTraits_Mix((uint64_t)key);                           \
+        }                                                                   \
+                                                                            \
+        static inline bool Equals(T a, T b)                                 \
+        {                                                                   \
+            return a == b;                                                  \
+        }                                                                   \
+    }
+
+HASH_TRAITS_INTEGER(int32_t);
+HASH_TRAITS_INTEGER(uint32_t);
+HASH_TRAITS_INTEGER(int64_t);
+HASH_TRAITS_INTEGER(uint64_t);
+
+#undef HASH_TRAITS_INTEGER
+
 template <typename T>
+struct HashTraits<T*>
+{
+    static inline uint64_t Hash(const T* key)
+    {
+        return HashTraits_Mix((uint64_t)(uintptr_t)key);
+    }
+
+    static inline bool Equals(const T* a, const T* b)
+    {
+        return a == b;
+    }
+};
+
+/// Null-terminated strings are compared by content
+/// @note: the table only store the pointer, the string must outlive its entry
+template <>
+struct HashTraits<const char*>
+{
+    static inline uint64_t Hash(const char* key)
+    {
+        // FNV-1a
+        uint64_t hash = 0xcbf29ce484222325ull;
+        while (*key)
+        {
+            hash = (hash ^ (uint8_t)*key++) * 0x100000001b3ull;
+        }
+        return HashTraits_Mix(hash);
+    }
+
+    static inline bool Equals(const char* a, const char* b)
+    {
+        return a == b || strcmp(a, b) == 0;
+    }
+};
+
+/// Open addressing hash table, swiss table layout
+/// Each slot has one control byte: empty, deleted, or the low 7 bits of the key hash.
+/// Lookups compare 16 control bytes at once (SSE2 when available), and only touch keys
+/// which 7 bits matched, so probing rarely leave the first group.
+/// @note: entries are moved with memcpy on rehash, TKey and TValue must be trivially relocatable
+template <typename TKey, typename TValue, typename TTraits = HashTraits<TKey>>
 struct HashTable
 {
-struct: // Constants
-    constexpr const char*   TAG                 = "HashTable";
-    constexpr int32_t       DEFAULT_HASH_COUNT  = 64;
+    static constexpr const char*    TAG                 = "HashTable";
+
+    static constexpr int32_t        GROUP_WIDTH         = 16;
+    static constexpr int32_t        MIN_CAPACITY        = 16;
+
+    static constexpr int8_t         CTRL_EMPTY          = (int8_t)0x80;
+    static constexpr int8_t         CTRL_DELETED        = (int8_t)0xfe;
 
-struct: // Fields
     int32_t     count;
-    int32_t     capacity;
-                
-    int32_t*    hashs;
-    int32_t     hashCount;
-                
-    int32_t*    nexts;
-    uint32_t*   keys;
-    T*          values;
-
-struct: // Constructor
-    inline HashTable(int32_t hashCount = DEFAULT_HASH_COUNT)
+    int32_t     capacity;       // Always power of two, or 0
+    int32_t     growthLeft;     // Inserts until next rehash, deleted slots consume it
+
+    int8_t*     ctrls;          // capacity + GROUP_WIDTH, the tail clone the first group
+    TKey*       keys;
+    TValue*     values;
+
+    inline HashTable()
         : count(0)
         , capacity(0)
-        , hashs(nullptr)
-        , hashCount(hashCount)
-        , nexts(nullptr)
+        , growthLeft(0)
+        , ctrls(nullptr)
         , keys(nullptr)
         , values(nullptr)
     {
@@ -39,271 +128,415 @@ struct: // Constructor
 
     inline ~HashTable()
     {
-        assert(hashs    == nullptr);
-        assert(nexts    == nullptr);
+        assert(ctrls    == nullptr);
         assert(keys     == nullptr);
         assert(values   == nullptr);
     }
 
-struct: // Methods
-    // Clear the this
-    inline void Clear(void)
+    // Number of entries
+    inline int32_t Count(void) const
     {
-        this->count = 0;
+        return count;
     }
 
-    // Unref the this
-    inline void Detach(void)
+    // Number of slots, use with IsOccupied/KeyAt/ValueAt to iterate
+    inline int32_t Capacity(void) const
+    {
+        return capacity;
+    }
+
+    // Remove all entries, keep the memory
+    inline void Clear(void)
     {
-        this->count     = 0;
-        this->capacity  = 0;
+        for (int32_t i = 0; i < capacity; i++)
+        {
+            if (IsOccupied(i))
+            {
+                keys[i].~TKey();
+                values[i].~TValue();
+            }
+        }
 
-        this->hashs     = nullptr;
-        this->hashCount = DEFAULT_HASH_COUNT;
+        if (ctrls)
+        {
+            memset(ctrls, CTRL_EMPTY, (size_t)(capacity + GROUP_WIDTH));
+        }
 
-        this->nexts     = nullptr;
-        this->keys      = nullptr;
-        this->values    = nullptr;
+        count = 0;
+        growthLeft = MaxLoad(capacity);
     }
 
     // Clean memory usage
     inline void CleanUp(void)
     {
-        Memory_FreeTag(nexts);
-        Memory_FreeTag(hashs);
+        Clear();
+
+        Memory_FreeTag(TAG, ctrls);
+
+        count       = 0;
+        capacity    = 0;
+        growthLeft  = 0;
+
+        ctrls       = nullptr;
+        keys        = nullptr;
+        values      = nullptr;
+    }
+
+    // Make room for count entries without rehashing
+    inline bool Reserve(int32_t reserveCount)
+    {
+        int32_t newCapacity = capacity > MIN_CAPACITY ? capacity : MIN_CAPACITY;
+        while (MaxLoad(newCapacity) < reserveCount)
+        {
+            newCapacity *= 2;
+        }
+
+        return newCapacity == capacity || Rehash(newCapacity);
+    }
+
+    // Determine if the slot has an entry
+    inline bool IsOccupied(int32_t index) const
+    {
+        assert(index >= 0 && index < capacity);
+        return ctrls[index] >= 0;
+    }
 
-        this->count     = 0;
-        this->capacity  = 0;
+    inline const TKey& KeyAt(int32_t index) const
+    {
+        assert(IsOccupied(index));
+        return keys[index];
+    }
 
-        this->hashs     = nullptr;
-        this->hashCount = DEFAULT_HASH_COUNT;
+    inline TValue& ValueAt(int32_t index)
+    {
+        assert(IsOccupied(index));
+        return values[index];
+    }
 
-        this->nexts     = nullptr;
-        this->keys      = nullptr;
-        this->values    = nullptr;
+    inline const TValue& ValueAt(int32_t index) const
+    {
+        assert(IsOccupied(index));
+        return values[index];
     }
 
-    // Find index of entry with key
-    inline int32_t IndexOf(uint32_t key, int32_t* outHash = nullptr, int32_t* outPrev = nullptr) const
+    // Find slot index of entry with key, -1 if not found
+    inline int32_t IndexOf(const TKey& key) const
     {
-        if (!this->hashs)
+        if (count == 0)
         {
             return -1;
         }
 
-        int hash = (int)(key % (uint32_t)this->hashCount);
-        int curr = this->hashs[hash];
-        int prev = -1;
+        const uint64_t hash = TTraits::Hash(key);
+        const int8_t h2 = (int8_t)(hash & 0x7f);
+        const uint32_t mask = (uint32_t)capacity - 1;
 
-        while (curr > -1)
+        uint32_t position = (uint32_t)(hash >> 7) & mask;
+        for (uint32_t step = GROUP_WIDTH; ; step += GROUP_WIDTH)
         {
-            if (this->keys[curr] == key)
+            for (uint32_t match = MatchByte(ctrls + position, h2); match != 0; match &= match - 1)
+            {
+                const uint32_t index = (position + CountTrailingZeros(match)) & mask;
+                if (TTraits::Equals(keys[index], key))
+                {
+                    return (int32_t)index;
+                }
+            }
+
+            if (MatchByte(ctrls + position, CTRL_EMPTY) != 0)
             {
-                break;
+                return -1;
             }
 
-            prev = curr;
-            curr = this->nexts[curr];
+            // Triangular probing visit every group when capacity is power of two
+            position = (position + step) & mask;
         }
-
-        if (outHash) *outHash = hash;
-        if (outPrev) *outPrev = prev;
-        return curr;
     }
 
     // Determine if hash table contains the entry with key
-    inline bool ContainsKey(uint32_t key) const
+    inline bool ContainsKey(const TKey& key) const
     {
         return IndexOf(key) > -1;
     }
 
-    // Get value of entry with key
-    const T& GetValue(uint32_t key) const
+    // Get value of entry with key, the entry must exist
+    inline const TValue& GetValue(const TKey& key) const
     {
-        int curr = IndexOf(key);
-        return values[curr];
+        const int32_t index = IndexOf(key);
+        assert(index > -1 && "Key is not found");
+        return values[index];
     }
 
     // Get value of entry with key
-    const T& GetValue(uint32_t key, const T& defaultValue) const
+    inline const TValue& GetValue(const TKey& key, const TValue& defaultValue) const
     {
-        int curr = IndexOf(key);
-        return (curr > -1) ? values[curr] : defaultValue;
+        const int32_t index = IndexOf(key);
+        return (index > -1) ? values[index] : defaultValue;
     }
 
     // Get value of entry with key. If entry exists return true, false otherwise.
-    bool TryGetValue(uint32_t key, T* outValue) const
+    inline bool TryGetValue(const TKey& key, TValue* outValue) const
     {
-        int curr = IndexOf(key);
-        if (curr > -1)
+        const int32_t index = IndexOf(key);
+        if (index > -1)
         {
-            *outValue = values[curr];
+            *outValue = values[index];
             return true;
         }
-        else
-        {
-            return false;
-        }
+
+        return false;
     }
 
-    // Get value entry, if not exists create new. 
+    // Get value entry, if not exists create new.
     // Return true if success, false otherwise.
-    bool GetValueOrNewEntry(uint32_t key, T** value)
+    inline bool GetValueOrNewEntry(const TKey& key, TValue** outValue)
     {
-        int hash, prev;
-        int curr = this->IndexOf(key, &hash, &prev);
-
-        if (curr < 0)
+        int32_t index = IndexOf(key);
+        if (index < 0)
         {
-            if (!this->hashs)
-            {
-                assert(this->hashCount > 0, "Your hashCount is invalid, maybe it has been detach or cleanup?");
-                this->hashs = (int*)Memory_AllocTag(TAG, sizeof(int) * hashCount, sizeof(*this->hashs));
-                assert(this->hashs && "Out of memory");
-                
-                for (int i = 0; i < hashCount; i++)
-                {
-                    this->hashs[i] = -1;
-                }
+            const uint64_t hash = TTraits::Hash(key);
 
-                // Re-calculate hash
-                prev = -1;
-                hash = (int)(key % (uint32_t)this->hashCount);
-            }
-
-            if (this->count + 1 > this->capacity)
+            index = FindInsertSlot(hash);
+            if (index < 0 || (growthLeft == 0 && ctrls[index] != CTRL_DELETED))
             {
-                const int oldCapacity = this->capacity;
-                const int newCapactiy = oldCapacity > 0 ? oldCapacity * 2 : 32;
-
-                void* newNexts  = Memory_AllocTag(TAG, newCapactiy * (sizeof(int) + sizeof(uint32_t) + sizeof(T)), alignof(int));
-                void* newKeys   = (char*)newNexts + newCapactiy * sizeof(int);
-                void* newValues = (char*)newKeys + newCapactiy * sizeof(uint32_t);
-
-                if (!newNexts)
+                // Rehash in place to drop tombstones when the table is not really full
+                const int32_t newCapacity = (capacity == 0) ? MIN_CAPACITY
+                    : (count * 32 <= capacity * 25) ? capacity : capacity * 2;
+                if (!Rehash(newCapacity))
                 {
                     return false;
                 }
-                else
-                {
-                    Memory_Move(newNexts, this->nexts, oldCapacity * sizeof(int));
-                    Memory_Move(newKeys, this->keys, oldCapacity * sizeof(uint32_t));
-                    Memory_Move(newValues, this->values, oldCapacity * sizeof(T));
-
-                    Memory_FreeTag(TAG, this->nexts);
-                
-                    this->capacity = newCapactiy;
-                    this->nexts    = (int*)newNexts;
-                    this->keys     = (uint32_t*)newKeys;
-                    this->values   = (T*)newValues;
-                }
-            }
 
-            curr = this->count;
-            if (prev > -1)
-            {
-                this->nexts[prev] = curr;
-            }
-            else
-            {
-                this->hashs[hash] = curr;
+                index = FindInsertSlot(hash);
             }
-            this->nexts[curr] = -1;
-            this->keys[curr] = key;
-            this->count++;
+
+            growthLeft -= (ctrls[index] == CTRL_EMPTY) ? 1 : 0;
+            SetCtrl(index, (int8_t)(hash & 0x7f));
+            count++;
+
+            Memory_NewPlacement(&keys[index]) TKey(key);
+            Memory_NewPlacement(&values[index]) TValue();
         }
 
-        *value = &this->values[curr];
+        *outValue = &values[index];
         return true;
     }
 
     // Get value entry, if not exists create new.
     // Return a reference to value entry if success, otherwise abort the process.
-    inline T& GetValueOrNewEntry(uint32_t key)
+    inline TValue& GetValueOrNewEntry(const TKey& key)
     {
-        T* innerValue;
-        if (!this->GetValueOrNewEntry(key, &innerValue))
+        TValue* value = nullptr;
+        if (!GetValueOrNewEntry(key, &value))
         {
             assert(false && "Out of memory.");
         }
-        return *innerValue;
+        return *value;
     }
 
     // Set entry's value, if not exists create new
-    inline bool SetValue(uint32_t key, const T& value)
+    inline bool SetValue(const TKey& key, const TValue& value)
     {
-        T* innerValue;
-        if (this->GetValueOrNewEntry(key, &innerValue))
+        TValue* innerValue;
+        if (GetValueOrNewEntry(key, &innerValue))
         {
             *innerValue = value;
             return true;
         }
-        else
-        {
-            return false;
-        }
+
+        return false;
     }
 
     // Remove an entry that has given key
-    inline bool Remove(uint32_t key)
+    inline bool Remove(const TKey& key)
     {
-        int prev;
-        int hash;
-        int curr = this->IndexOf(key, &hash, &prev);
-        return this->Erase(curr, hash, prev);
+        return Erase(IndexOf(key));
     }
-    
-    // Remove the entry at given index
+
+    // Remove the entry at given slot index
     inline bool Erase(int32_t index)
     {
-        if (index > -1 && index < this->count)
-        {
-            return this->Remove(this->keys[index]);
-        }
-        else
+        if (index < 0 || index >= capacity || !IsOccupied(index))
         {
             return false;
         }
+
+        keys[index].~TKey();
+        values[index].~TValue();
+
+        // The slot can be empty again if no probe window can have walked over it:
+        // every 16 slots window containing it already has an empty slot.
+        const uint32_t mask = (uint32_t)capacity - 1;
+        const uint32_t emptyBefore = MatchByte(ctrls + (((uint32_t)index - GROUP_WIDTH) & mask), CTRL_EMPTY);
+        const uint32_t emptyAfter = MatchByte(ctrls + index, CTRL_EMPTY);
+        const bool wasNeverFull = emptyBefore != 0 && emptyAfter != 0
+            && (CountLeadingZeros16(emptyBefore) + CountTrailingZeros(emptyAfter)) < GROUP_WIDTH;
+
+        SetCtrl(index, wasNeverFull ? CTRL_EMPTY : CTRL_DELETED);
+        growthLeft += wasNeverFull ? 1 : 0;
+        count--;
+        return true;
     }
 
-    // Remove the entry at given index, hash entry, and previous entry
-    inline bool Erase(int32_t curr, int32_t hash, int32_t prev)
+    // Iterate entries, func(const TKey& key, TValue& value)
+    // @note: entries must not be added or removed inside func
+    template <typename Func>
+    inline void ForEach(Func&& func)
     {
-        if (curr > -1)
+        for (int32_t i = 0; i < capacity; i++)
         {
-            if (prev > -1)
-            {
-                this->nexts[prev] = -1;
-            }
-            else
+            if (ctrls[i] >= 0)
             {
-                this->hashs[hash] = -1;
+                func((const TKey&)keys[i], values[i]);
             }
+        }
+    }
 
-            if (curr < this->count - 1)
-            {
-                int last = this->count - 1;
-                this->nexts[curr]  = this->nexts[last];
-                this->keys[curr]   = this->keys[last];
-                this->values[curr] = this->values[last];
+    // 7/8 max load factor
+    static inline int32_t MaxLoad(int32_t tableCapacity)
+    {
+        return tableCapacity - tableCapacity / 8;
+    }
 
-                this->IndexOf(this->keys[curr], &hash, &prev);
-                if (prev > -1)
-                {
-                    this->nexts[prev] = curr;
-                }
-                else
-                {
-                    this->hashs[hash] = curr;
-                }
+    static inline uint32_t CountTrailingZeros(uint32_t x)
+    {
+    #if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanForward(&index, x);
+        return (uint32_t)index;
+    #else
+        return (uint32_t)__builtin_ctz(x);
+    #endif
+    }
+
+    // Leading zeros of a 16 bits group mask
+    static inline uint32_t CountLeadingZeros16(uint32_t x)
+    {
+    #if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse(&index, x);
+        return 15 - (uint32_t)index;
+    #else
+        return (uint32_t)__builtin_clz(x) - 16;
+    #endif
+    }
+
+    // Bit mask of the bytes in the group which equal to value
+    static inline uint32_t MatchByte(const int8_t* group, int8_t value)
+    {
+    #if HASH_TABLE_USE_SSE2
+        const __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(value)));
+    #else
+        uint32_t mask = 0;
+        for (int32_t i = 0; i < GROUP_WIDTH; i++)
+        {
+            mask |= (uint32_t)(group[i] == value) << i;
+        }
+        return mask;
+    #endif
+    }
+
+    // Bit mask of the bytes in the group which are empty or deleted
+    static inline uint32_t MatchEmptyOrDeleted(const int8_t* group)
+    {
+    #if HASH_TABLE_USE_SSE2
+        return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+    #else
+        uint32_t mask = 0;
+        for (int32_t i = 0; i < GROUP_WIDTH; i++)
+        {
+            mask |= (uint32_t)(group[i] < 0) << i;
+        }
+        return mask;
+    #endif
+    }
+
+    inline void SetCtrl(int32_t index, int8_t ctrl)
+    {
+        ctrls[index] = ctrl;
+
+        // Keep the cloned group in sync, so group loads never wrap around
+        if (index < GROUP_WIDTH)
+        {
+            ctrls[capacity + index] = ctrl;
+        }
+    }
+
+    // First empty or deleted slot in the probe sequence of hash, -1 if the table has no memory
+    inline int32_t FindInsertSlot(uint64_t hash) const
+    {
+        if (capacity == 0)
+        {
+            return -1;
+        }
+
+        const uint32_t mask = (uint32_t)capacity - 1;
+
+        uint32_t position = (uint32_t)(hash >> 7) & mask;
+        for (uint32_t step = GROUP_WIDTH; ; step += GROUP_WIDTH)
+        {
+            const uint32_t match = MatchEmptyOrDeleted(ctrls + position);
+            if (match != 0)
+            {
+                return (int32_t)((position + CountTrailingZeros(match)) & mask);
             }
 
-            this->count = this->count - 1;
-            return true;
+            position = (position + step) & mask;
         }
-        else
+    }
+
+    inline bool Rehash(int32_t newCapacity)
+    {
+        assert(newCapacity >= MIN_CAPACITY && (newCapacity & (newCapacity - 1)) == 0);
+        assert(MaxLoad(newCapacity) >= count);
+
+        constexpr int32_t ALIGN = alignof(TKey) > alignof(TValue)
+            ? (alignof(TKey) > 16 ? (int32_t)alignof(TKey) : 16)
+            : (alignof(TValue) > 16 ? (int32_t)alignof(TValue) : 16);
+
+        const int32_t keysOffset = AlignUp(newCapacity + GROUP_WIDTH, (int32_t)alignof(TKey));
+        const int32_t valuesOffset = AlignUp(keysOffset + newCapacity * (int32_t)sizeof(TKey), (int32_t)alignof(TValue));
+        const int32_t allocSize = valuesOffset + newCapacity * (int32_t)sizeof(TValue);
+
+        uint8_t* buffer = (uint8_t*)Memory_AllocTag(TAG, allocSize, ALIGN);
+        if (!buffer)
         {
             return false;
         }
+
+        int8_t* oldCtrls = ctrls;
+        TKey* oldKeys = keys;
+        TValue* oldValues = values;
+        const int32_t oldCapacity = capacity;
+
+        ctrls = (int8_t*)buffer;
+        keys = (TKey*)(buffer + keysOffset);
+        values = (TValue*)(buffer + valuesOffset);
+        capacity = newCapacity;
+        growthLeft = MaxLoad(newCapacity) - count;
+        memset(ctrls, CTRL_EMPTY, (size_t)(newCapacity + GROUP_WIDTH));
+
+        for (int32_t i = 0; i < oldCapacity; i++)
+        {
+            if (oldCtrls[i] >= 0)
+            {
+                const uint64_t hash = TTraits::Hash(oldKeys[i]);
+                const int32_t index = FindInsertSlot(hash);
+                SetCtrl(index, (int8_t)(hash & 0x7f));
+                Memory_Copy(&keys[index], &oldKeys[i], (int32_t)sizeof(TKey));
+                Memory_Copy(&values[index], &oldValues[i], (int32_t)sizeof(TValue));
+            }
+        }
+
+        Memory_FreeTag(TAG, oldCtrls);
+        return true;
+    }
+
+    static inline int32_t AlignUp(int32_t value, int32_t align)
+    {
+        return (value + align - 1) & ~(align - 1);
     }
 };
+
+//! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
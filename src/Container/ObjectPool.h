@@ -0,0 +1,327 @@
+#pragma once
+
+#include <assert.h>
+#include <stdint.h>
+
+#include "Native/Memory.h"
+#include "Native/HeapLayers.h"
+
+/// Handle to an object living in an ObjectPool.
+/// Low bits are the slot index, high bits are the slot generation.
+/// A handle with generation 0 is never alive, so 0 is the null handle.
+typedef uint32_t ObjectHandle;
+
+constexpr ObjectHandle OBJECT_HANDLE_NONE = 0;
+
+/// Typed pool of objects with generational handles.
+/// Objects are kept densely packed in chunks served by PagedFreeList, so
+/// alloc/free are O(1) and iteration walks contiguous memory.
+/// @note: free swaps the last object into the hole, so T must be trivially relocatable
+///        and raw pointers to objects only live until the next Free.
+template <typename T>
+struct ObjectPool
+{
+    static constexpr const char*    TAG                 = "ObjectPool";
+
+    static constexpr int32_t        INDEX_BITS          = 20;
+    static constexpr int32_t        GENERATION_BITS     = 32 - INDEX_BITS;
+    static constexpr uint32_t       INDEX_MASK          = (1u << INDEX_BITS) - 1;
+    static constexpr uint32_t       GENERATION_MASK     = (1u << GENERATION_BITS) - 1;
+    static constexpr int32_t        MAX_OBJECTS         = 1 << INDEX_BITS;
+    static constexpr uint32_t       NO_SLOT             = 0xffffffffu;
+
+    // Four 16-bytes aligned chunks per PagedFreeList page
+    static constexpr int32_t        CHUNK_SIZE          = ((PagedFreeList::PAGE_SIZE - (int32_t)sizeof(PagedFreeList::Page)) / 4) & ~15;
+
+    static constexpr int32_t FloorPowerOfTwo(int32_t x, int32_t p = 1)
+    {
+        return (p * 2 <= x) ? FloorPowerOfTwo(x, p * 2) : p;
+    }
+
+    // Chunk layout: owners[ITEMS_PER_CHUNK] then items[ITEMS_PER_CHUNK]
+    static constexpr int32_t        ITEMS_PER_CHUNK     = FloorPowerOfTwo(CHUNK_SIZE / (int32_t)(sizeof(T) + sizeof(uint32_t)));
+    static constexpr int32_t        ITEMS_OFFSET        = (int32_t)((ITEMS_PER_CHUNK * sizeof(uint32_t) + alignof(T) - 1) & ~(alignof(T) - 1));
+    static constexpr int32_t        CHUNK_BYTES         = ITEMS_OFFSET + ITEMS_PER_CHUNK * (int32_t)sizeof(T);
+
+    struct Slot
+    {
+        uint32_t    generation;
+        uint32_t    index;          // Dense index when alive, next free slot otherwise
+    };
+
+    static constexpr int32_t        SLOTS_PER_CHUNK     = FloorPowerOfTwo(CHUNK_SIZE / (int32_t)sizeof(Slot));
+
+    static_assert(CHUNK_BYTES <= CHUNK_SIZE, "Object type is too big for ObjectPool chunk");
+    static_assert(alignof(T) <= 16, "ObjectPool only support alignment up to 16 bytes");
+
+    int32_t         count;
+    int32_t         slotCount;
+    uint32_t        freeSlot;
+
+    int32_t         chunkCount;
+    int32_t         slotChunkCount;
+    uint8_t**       chunks;
+    Slot**          slotChunks;
+
+    PagedFreeList   chunkAllocator;
+    PagedFreeList   slotChunkAllocator;
+
+    inline ObjectPool()
+        : count(0)
+        , slotCount(0)
+        , freeSlot(NO_SLOT)
+        , chunkCount(0)
+        , slotChunkCount(0)
+        , chunks(nullptr)
+        , slotChunks(nullptr)
+    {
+    }
+
+    inline ~ObjectPool()
+    {
+        assert(chunks == nullptr);
+        assert(slotChunks == nullptr);
+    }
+
+    // Release all objects and memory
+    inline void CleanUp(void)
+    {
+        for (int32_t i = 0; i < count; i++)
+        {
+            At(i).~T();
+        }
+
+        Memory_FreeTag(TAG, chunks);
+        Memory_FreeTag(TAG, slotChunks);
+
+        chunkAllocator.CleanUp();
+        slotChunkAllocator.CleanUp();
+
+        count           = 0;
+        slotCount       = 0;
+        freeSlot        = NO_SLOT;
+        chunkCount      = 0;
+        slotChunkCount  = 0;
+        chunks          = nullptr;
+        slotChunks      = nullptr;
+    }
+
+    // Number of alive objects
+    inline int32_t Count(void) const
+    {
+        return count;
+    }
+
+    // Get object at dense index, [0, Count())
+    inline T& At(int32_t index)
+    {
+        assert(index >= 0 && index < count);
+        return ((T*)(chunks[index / ITEMS_PER_CHUNK] + ITEMS_OFFSET))[index & (ITEMS_PER_CHUNK - 1)];
+    }
+
+    // Get handle of object at dense index, [0, Count())
+    inline ObjectHandle HandleAt(int32_t index) const
+    {
+        assert(index >= 0 && index < count);
+        const uint32_t slotIndex = Owner(index);
+        return MakeHandle(slotIndex, GetSlot(slotIndex).generation);
+    }
+
+    // Determine if the handle still refer to an alive object
+    inline bool IsAlive(ObjectHandle handle) const
+    {
+        const uint32_t slotIndex = handle & INDEX_MASK;
+        const uint32_t generation = handle >> INDEX_BITS;
+        return generation != 0 && slotIndex < (uint32_t)slotCount && GetSlot(slotIndex).generation == generation;
+    }
+
+    // Get object from handle, nullptr if the handle is stale
+    inline T* Get(ObjectHandle handle)
+    {
+        if (!IsAlive(handle))
+        {
+            return nullptr;
+        }
+
+        return &At((int32_t)GetSlot(handle & INDEX_MASK).index);
+    }
+
+    // Create new object, return OBJECT_HANDLE_NONE when out of memory or handles
+    inline ObjectHandle Alloc(T** outObject = nullptr)
+    {
+        if (count == chunkCount * ITEMS_PER_CHUNK && !NewChunk())
+        {
+            return OBJECT_HANDLE_NONE;
+        }
+
+        uint32_t slotIndex = freeSlot;
+        if (slotIndex != NO_SLOT)
+        {
+            freeSlot = GetSlot(slotIndex).index;
+        }
+        else
+        {
+            if (slotCount == slotChunkCount * SLOTS_PER_CHUNK && !NewSlotChunk())
+            {
+                return OBJECT_HANDLE_NONE;
+            }
+
+            slotIndex = (uint32_t)slotCount++;
+            GetSlot(slotIndex).generation = 1;
+        }
+
+        const int32_t index = count++;
+
+        Slot& slot = GetSlot(slotIndex);
+        slot.index = (uint32_t)index;
+        Owner(index) = slotIndex;
+
+        T* object = Memory_NewPlacement(&At(index)) T();
+        if (outObject)
+        {
+            *outObject = object;
+        }
+
+        return MakeHandle(slotIndex, slot.generation);
+    }
+
+    // Destroy object, return false if the handle is stale
+    inline bool Free(ObjectHandle handle)
+    {
+        if (!IsAlive(handle))
+        {
+            return false;
+        }
+
+        const uint32_t slotIndex = handle & INDEX_MASK;
+        Slot& slot = GetSlot(slotIndex);
+
+        const int32_t index = (int32_t)slot.index;
+        const int32_t last = count - 1;
+
+        At(index).~T();
+        if (index != last)
+        {
+            Memory_Copy(&At(index), &At(last), (int32_t)sizeof(T));
+
+            const uint32_t lastSlotIndex = Owner(last);
+            Owner(index) = lastSlotIndex;
+            GetSlot(lastSlotIndex).index = (uint32_t)index;
+        }
+        count = last;
+
+        // Generation 0 is reserved for null handle
+        slot.generation = (slot.generation + 1) & GENERATION_MASK;
+        slot.generation = slot.generation ? slot.generation : 1;
+
+        slot.index = freeSlot;
+        freeSlot = slotIndex;
+        return true;
+    }
+
+    // Iterate alive objects chunk by chunk, func(T& object)
+    // @note: objects must not be freed inside func, iterate backward with At() instead
+    template <typename Func>
+    inline void ForEach(Func&& func)
+    {
+        for (int32_t chunk = 0, remain = count; remain > 0; chunk++, remain -= ITEMS_PER_CHUNK)
+        {
+            T* items = (T*)(chunks[chunk] + ITEMS_OFFSET);
+            const int32_t itemCount = remain < ITEMS_PER_CHUNK ? remain : ITEMS_PER_CHUNK;
+            for (int32_t i = 0; i < itemCount; i++)
+            {
+                func(items[i]);
+            }
+        }
+    }
+
+    static inline ObjectHandle MakeHandle(uint32_t slotIndex, uint32_t generation)
+    {
+        return (generation << INDEX_BITS) | slotIndex;
+    }
+
+    inline uint32_t& Owner(int32_t index)
+    {
+        return ((uint32_t*)chunks[index / ITEMS_PER_CHUNK])[index & (ITEMS_PER_CHUNK - 1)];
+    }
+
+    inline uint32_t Owner(int32_t index) const
+    {
+        return ((const uint32_t*)chunks[index / ITEMS_PER_CHUNK])[index & (ITEMS_PER_CHUNK - 1)];
+    }
+
+    inline Slot& GetSlot(uint32_t slotIndex)
+    {
+        return slotChunks[slotIndex / SLOTS_PER_CHUNK][slotIndex & (SLOTS_PER_CHUNK - 1)];
+    }
+
+    inline const Slot& GetSlot(uint32_t slotIndex) const
+    {
+        return slotChunks[slotIndex / SLOTS_PER_CHUNK][slotIndex & (SLOTS_PER_CHUNK - 1)];
+    }
+
+    // Chunk tables capacity are 0, 4, 8, 16, ...
+    static inline bool IsTableFull(int32_t tableCount)
+    {
+        return tableCount == 0 || (tableCount >= 4 && (tableCount & (tableCount - 1)) == 0);
+    }
+
+    inline bool NewChunk(void)
+    {
+        if (chunkCount * ITEMS_PER_CHUNK >= MAX_OBJECTS)
+        {
+            return false;
+        }
+
+        // Chunk table only grow in power of two, rarely touch the general allocator
+        if (IsTableFull(chunkCount))
+        {
+            const int32_t newCapacity = chunkCount > 0 ? chunkCount * 2 : 4;
+            uint8_t** newChunks = (uint8_t**)Memory_ReallocTag(TAG, chunks, (int32_t)sizeof(uint8_t*) * newCapacity, alignof(uint8_t*));
+            if (!newChunks)
+            {
+                return false;
+            }
+            chunks = newChunks;
+        }
+
+        uint8_t* chunk = (uint8_t*)chunkAllocator.Alloc(CHUNK_SIZE);
+        if (!chunk)
+        {
+            return false;
+        }
+
+        chunks[chunkCount++] = chunk;
+        return true;
+    }
+
+    inline bool NewSlotChunk(void)
+    {
+        if (slotChunkCount * SLOTS_PER_CHUNK >= MAX_OBJECTS)
+        {
+            return false;
+        }
+
+        if (IsTableFull(slotChunkCount))
+        {
+            const int32_t newCapacity = slotChunkCount > 0 ? slotChunkCount * 2 : 4;
+            Slot** newSlotChunks = (Slot**)Memory_ReallocTag(TAG, slotChunks, (int32_t)sizeof(Slot*) * newCapacity, alignof(Slot*));
+            if (!newSlotChunks)
+            {
+                return false;
+            }
+            slotChunks = newSlotChunks;
+        }
+
+        Slot* slotChunk = (Slot*)slotChunkAllocator.Alloc(CHUNK_SIZE);
+        if (!slotChunk)
+        {
+            return false;
+        }
+
+        slotChunks[slotChunkCount++] = slotChunk;
+        return true;
+    }
+};
+
+//! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
@@ -13,6 +13,26 @@ struct Job
     void*           data;
 };
 
+/// Ranges of a JobSystem::ParallelFor call which are not done yet, guarded by the job system mutex
+struct JobRangeCounter
+{
+    int32_t         remaining;
+};
+
+/// Range of items for JobSystem::ParallelFor
+struct JobRange
+{
+    JobRangeFunc*   func;
+    void*           data;
+    int32_t         start;
+    int32_t         end;
+
+    JobRangeCounter* counter;
+};
+
+/// Set on the worker threads, a ParallelFor called from a job run on its thread
+static thread_local bool tIsWorkerThread = false;
+
 /// The job system for parallel computing. The workers donot steal job.
 /// The JobSystem must be alive long enough before worker threads done,
 /// should allocate JobSystem's memory in global/static scope, main() function, or heap.
@@ -45,8 +65,8 @@ struct JobSystemState
 
     void Create(int32_t requestWorkers)
     {
-        const int32_t threadCount = int32_min(1, ThreadSystem::GetCpuCores());
-        const int32_t workerCount = requestWorkers <= 0 ? threadCount : int32_min(threadCount, int32_min(requestWorkers, JOB_SYSTEM_MAX_WORKERS));
+        const int32_t threadCount = int32_max(1, ThreadSystem::GetCpuCores());
+        const int32_t workerCount = int32_min(requestWorkers <= 0 ? threadCount : int32_min(threadCount, requestWorkers), JOB_SYSTEM_MAX_WORKERS);
 
         this->mutex.Create();
         this->idleSignal.Create();
@@ -145,6 +165,8 @@ struct JobSystemState
 
     void MainLoop()
     {
+        tIsWorkerThread = true;
+
         this->mutex.Lock();
 
         const int workerIndex = this->currentWorkerIndex;
@@ -217,3 +239,64 @@ void JobSystem::Queue(JobFunc* func, void* items)
 {
     gJobSystem.QueueJob(func, items);
 }
+
+static void JobRange_Run(void* items)
+{
+    const JobRange* range = (const JobRange*)items;
+    range->func(range->data, range->start, range->end);
+
+    // The range live on the stack of ParallelFor, it is not touched after the counter
+    gJobSystem.mutex.Lock();
+    JobRangeCounter* counter = range->counter;
+    const bool done = --counter->remaining == 0;
+    gJobSystem.mutex.Unlock();
+
+    if (done)
+    {
+        gJobSystem.idleSignal.Broadcast();
+    }
+}
+
+void JobSystem::ParallelFor(JobRangeFunc* func, void* data, int32_t count, int32_t batchSize)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    // Few ranges per worker, the job rings never overflow
+    constexpr int32_t RANGES_PER_WORKER = 4;
+    static_assert(RANGES_PER_WORKER < JOB_SYSTEM_MAX_JOBS, "Job ring is too small for ParallelFor");
+
+    // A worker would wait on the ranges queued to its own ring, nested calls run on the calling thread
+    const int32_t workerCount = int32_min(gJobSystem.workerCount, JOB_SYSTEM_MAX_WORKERS);
+    const int32_t maxRangeCount = int32_min((count + batchSize - 1) / int32_max(batchSize, 1), workerCount * RANGES_PER_WORKER);
+    if (maxRangeCount <= 1 || tIsWorkerThread)
+    {
+        func(data, 0, count);
+        return;
+    }
+
+    JobRange ranges[JOB_SYSTEM_MAX_WORKERS * RANGES_PER_WORKER];
+    const int32_t rangeSize = (count + maxRangeCount - 1) / maxRangeCount;
+    const int32_t rangeCount = (count + rangeSize - 1) / rangeSize;
+
+    // Only the ranges of this call are waited on, not the other jobs of the queues
+    JobRangeCounter counter = { rangeCount };
+    for (int32_t i = 0; i < rangeCount; i++)
+    {
+        ranges[i].func      = func;
+        ranges[i].data      = data;
+        ranges[i].start     = i * rangeSize;
+        ranges[i].end       = int32_min(count, (i + 1) * rangeSize);
+        ranges[i].counter   = &counter;
+        gJobSystem.QueueJob(JobRange_Run, &ranges[i]);
+    }
+
+    gJobSystem.mutex.Lock();
+    while (counter.remaining > 0)
+    {
+        gJobSystem.idleSignal.Wait(gJobSystem.mutex);
+    }
+    gJobSystem.mutex.Unlock();
+}
@@ -3,6 +3,7 @@
 #include <stdint.h>
 
 typedef void (JobFunc)(void* items);
+typedef void (JobRangeFunc)(void* data, int32_t start, int32_t end);
 
 namespace JobSystem
 {
@@ -13,4 +14,8 @@ namespace JobSystem
     void    WaitIdle(void);
 
     void    Queue(JobFunc* func, void* items);
+
+    // Split [0, count) into ranges of at least batchSize items, run them on the workers,
+    // then wait until these ranges are done. Small counts, and calls from a job, run on the calling thread.
+    void    ParallelFor(JobRangeFunc* func, void* data, int32_t count, int32_t batchSize);
 }
@@ -1,2 +1,403 @@
 #include "Components.h"
 
+#include <string.h>
+#include "Native/Memory.h"
+
+constexpr const char* COMPONENTS_TAG = "Components";
+
+// Grow buffer capacity to at least required, capacity are 0, 32, 64, 128, ...
+static bool GrowBuffer(void** buffer, int32_t* capacity, int32_t required, int32_t elementSize, int32_t elementAlign)
+{
+    if (*capacity >= required)
+    {
+        return true;
+    }
+
+    int32_t newCapacity = *capacity > 0 ? *capacity : 32;
+    while (newCapacity < required)
+    {
+        newCapacity *= 2;
+    }
+
+    void* newBuffer = Memory_ReallocTag(COMPONENTS_TAG, *buffer, newCapacity * elementSize, elementAlign);
+    if (!newBuffer)
+    {
+        return false;
+    }
+
+    *buffer = newBuffer;
+    *capacity = newCapacity;
+    return true;
+}
+
+// -------------------------------------------------------------------
+// EntityRegistry
+// -------------------------------------------------------------------
+
+constexpr uint32_t ENTITY_NO_SLOT = 0xffffffffu;
+
+EntityId EntityRegistry::Create(void)
+{
+    uint32_t index = freeSlot;
+    if (index != ENTITY_NO_SLOT)
+    {
+        freeSlot = nextFreeSlots[index];
+    }
+    else
+    {
+        if (slotCount >= ENTITY_MAX_COUNT)
+        {
+            return ENTITY_NONE;
+        }
+
+        if (slotCount == slotCapacity)
+        {
+            int32_t generationCapacity = slotCapacity;
+            int32_t nextFreeCapacity = slotCapacity;
+            if (!GrowBuffer((void**)&generations, &generationCapacity, slotCount + 1, sizeof(uint32_t), alignof(uint32_t))
+                || !GrowBuffer((void**)&nextFreeSlots, &nextFreeCapacity, slotCount + 1, sizeof(uint32_t), alignof(uint32_t)))
+            {
+                return ENTITY_NONE;
+            }
+
+            assert(generationCapacity == nextFreeCapacity);
+            slotCapacity = generationCapacity;
+        }
+
+        index = (uint32_t)slotCount++;
+        generations[index] = 1;
+    }
+
+    nextFreeSlots[index] = ENTITY_NO_SLOT;
+    count++;
+    return (generations[index] << ENTITY_INDEX_BITS) | index;
+}
+
+bool EntityRegistry::Destroy(EntityId entity)
+{
+    if (!IsAlive(entity))
+    {
+        return false;
+    }
+
+    const uint32_t index = Entity_GetIndex(entity);
+
+    // Generation 0 is reserved for the null entity
+    uint32_t generation = (generations[index] + 1) & ENTITY_GENERATION_MASK;
+    generations[index] = generation ? generation : 1;
+
+    nextFreeSlots[index] = freeSlot;
+    freeSlot = index;
+    count--;
+    return true;
+}
+
+bool EntityRegistry::IsAlive(EntityId entity) const
+{
+    const uint32_t index = Entity_GetIndex(entity);
+    const uint32_t generation = Entity_GetGeneration(entity);
+    return generation != 0
+        && index < (uint32_t)slotCount
+        && generations[index] == generation
+        && nextFreeSlots[index] == ENTITY_NO_SLOT;
+}
+
+void EntityRegistry::CleanUp(void)
+{
+    Memory_FreeTag(COMPONENTS_TAG, generations);
+    Memory_FreeTag(COMPONENTS_TAG, nextFreeSlots);
+
+    count           = 0;
+    slotCount       = 0;
+    slotCapacity    = 0;
+    freeSlot        = ENTITY_NO_SLOT;
+    generations     = nullptr;
+    nextFreeSlots   = nullptr;
+}
+
+// -------------------------------------------------------------------
+// SparseSet
+// -------------------------------------------------------------------
+
+void SparseSet_Init(SparseSet* set, const char* name, int32_t valueSize, int32_t valueAlign)
+{
+    memset(set, 0, sizeof(*set));
+    set->name       = name;
+    set->valueSize  = valueSize;
+    set->valueAlign = valueAlign;
+}
+
+void SparseSet_CleanUp(SparseSet* set)
+{
+    Memory_FreeTag(COMPONENTS_TAG, set->entities);
+    Memory_FreeTag(COMPONENTS_TAG, set->values);
+    Memory_FreeTag(COMPONENTS_TAG, set->sparse);
+    Memory_FreeTag(COMPONENTS_TAG, set->pendingAddEntities);
+    Memory_FreeTag(COMPONENTS_TAG, set->pendingAddValues);
+    Memory_FreeTag(COMPONENTS_TAG, set->pendingRemoves);
+
+    SparseSet_Init(set, set->name, set->valueSize, set->valueAlign);
+}
+
+int32_t SparseSet_IndexOf(const SparseSet* set, EntityId entity)
+{
+    const uint32_t index = Entity_GetIndex(entity);
+    if (index >= (uint32_t)set->sparseCapacity)
+    {
+        return -1;
+    }
+
+    const int32_t denseIndex = set->sparse[index];
+    return (denseIndex > -1 && set->entities[denseIndex] == entity) ? denseIndex : -1;
+}
+
+void* SparseSet_Add(SparseSet* set, EntityId entity, const void* value)
+{
+    assert(entity != ENTITY_NONE);
+
+    int32_t denseIndex = SparseSet_IndexOf(set, entity);
+    if (denseIndex < 0)
+    {
+        const int32_t index = (int32_t)Entity_GetIndex(entity);
+        if (index >= set->sparseCapacity)
+        {
+            const int32_t oldSparseCapacity = set->sparseCapacity;
+            if (!GrowBuffer((void**)&set->sparse, &set->sparseCapacity, index + 1, sizeof(int32_t), alignof(int32_t)))
+            {
+                return nullptr;
+            }
+
+            memset(set->sparse + oldSparseCapacity, 0xff, sizeof(int32_t) * (size_t)(set->sparseCapacity - oldSparseCapacity));
+        }
+
+        if (set->count == set->capacity)
+        {
+            int32_t entityCapacity = set->capacity;
+            int32_t valueCapacity = set->capacity;
+            if (!GrowBuffer((void**)&set->entities, &entityCapacity, set->count + 1, sizeof(EntityId), alignof(EntityId))
+                || !GrowBuffer((void**)&set->values, &valueCapacity, set->count + 1, set->valueSize, set->valueAlign))
+            {
+                return nullptr;
+            }
+
+            set->capacity = entityCapacity < valueCapacity ? entityCapacity : valueCapacity;
+        }
+
+        denseIndex = set->count++;
+        set->entities[denseIndex] = entity;
+        set->sparse[index] = denseIndex;
+    }
+
+    void* denseValue = set->values + (size_t)denseIndex * set->valueSize;
+    memcpy(denseValue, value, (size_t)set->valueSize);
+    return denseValue;
+}
+
+bool SparseSet_Remove(SparseSet* set, EntityId entity)
+{
+    const int32_t denseIndex = SparseSet_IndexOf(set, entity);
+    if (denseIndex < 0)
+    {
+        return false;
+    }
+
+    const int32_t last = set->count - 1;
+    if (denseIndex != last)
+    {
+        const EntityId lastEntity = set->entities[last];
+        set->entities[denseIndex] = lastEntity;
+        set->sparse[Entity_GetIndex(lastEntity)] = denseIndex;
+        memcpy(set->values + (size_t)denseIndex * set->valueSize, set->values + (size_t)last * set->valueSize, (size_t)set->valueSize);
+    }
+
+    set->sparse[Entity_GetIndex(entity)] = -1;
+    set->count = last;
+    return true;
+}
+
+void SparseSet_SwapDense(SparseSet* set, int32_t a, int32_t b)
+{
+    assert(a >= 0 && a < set->count);
+    assert(b >= 0 && b < set->count);
+
+    if (a == b)
+    {
+        return;
+    }
+
+    const EntityId entityA = set->entities[a];
+    const EntityId entityB = set->entities[b];
+    set->entities[a] = entityB;
+    set->entities[b] = entityA;
+    set->sparse[Entity_GetIndex(entityA)] = b;
+    set->sparse[Entity_GetIndex(entityB)] = a;
+
+    uint8_t* valueA = set->values + (size_t)a * set->valueSize;
+    uint8_t* valueB = set->values + (size_t)b * set->valueSize;
+    for (int32_t i = 0; i < set->valueSize; i++)
+    {
+        const uint8_t temp = valueA[i];
+        valueA[i] = valueB[i];
+        valueB[i] = temp;
+    }
+}
+
+bool SparseSet_DeferAdd(SparseSet* set, EntityId entity, const void* value)
+{
+    assert(entity != ENTITY_NONE);
+
+    if (set->pendingAddCount == set->pendingAddCapacity)
+    {
+        int32_t entityCapacity = set->pendingAddCapacity;
+        int32_t valueCapacity = set->pendingAddCapacity;
+        if (!GrowBuffer((void**)&set->pendingAddEntities, &entityCapacity, set->pendingAddCount + 1, sizeof(EntityId), alignof(EntityId))
+            || !GrowBuffer((void**)&set->pendingAddValues, &valueCapacity, set->pendingAddCount + 1, set->valueSize, set->valueAlign))
+        {
+            return false;
+        }
+
+        set->pendingAddCapacity = entityCapacity < valueCapacity ? entityCapacity : valueCapacity;
+    }
+
+    const int32_t pendingIndex = set->pendingAddCount++;
+    set->pendingAddEntities[pendingIndex] = entity;
+    memcpy(set->pendingAddValues + (size_t)pendingIndex * set->valueSize, value, (size_t)set->valueSize);
+    return true;
+}
+
+bool SparseSet_DeferRemove(SparseSet* set, EntityId entity)
+{
+    if (!GrowBuffer((void**)&set->pendingRemoves, &set->pendingRemoveCapacity, set->pendingRemoveCount + 1, sizeof(EntityId), alignof(EntityId)))
+    {
+        return false;
+    }
+
+    set->pendingRemoves[set->pendingRemoveCount++] = entity;
+    return true;
+}
+
+void SparseSet_Sync(SparseSet* set)
+{
+    for (int32_t i = 0; i < set->pendingRemoveCount; i++)
+    {
+        SparseSet_Remove(set, set->pendingRemoves[i]);
+    }
+    set->pendingRemoveCount = 0;
+
+    for (int32_t i = 0; i < set->pendingAddCount; i++)
+    {
+        const void* value = set->pendingAddValues + (size_t)i * set->valueSize;
+        if (!SparseSet_Add(set, set->pendingAddEntities[i], value))
+        {
+            assert(false && "Out of memory");
+        }
+    }
+    set->pendingAddCount = 0;
+}
+
+int32_t SparseSet_Group(SparseSet* const* sets, int32_t setCount)
+{
+    assert(setCount > 0);
+
+    SparseSet* lead = sets[0];
+    for (int32_t i = 1; i < setCount; i++)
+    {
+        lead = sets[i]->count < lead->count ? sets[i] : lead;
+    }
+
+    // Every entity before groupCount is in all sets, at the same dense index
+    int32_t groupCount = 0;
+    for (int32_t i = 0; i < lead->count; i++)
+    {
+        const EntityId entity = lead->entities[i];
+
+        bool containsAll = true;
+        for (int32_t setIndex = 0; setIndex < setCount && containsAll; setIndex++)
+        {
+            containsAll = SparseSet_IndexOf(sets[setIndex], entity) > -1;
+        }
+
+        if (containsAll)
+        {
+            for (int32_t setIndex = 0; setIndex < setCount; setIndex++)
+            {
+                SparseSet_SwapDense(sets[setIndex], SparseSet_IndexOf(sets[setIndex], entity), groupCount);
+            }
+            groupCount++;
+        }
+    }
+
+    return groupCount;
+}
+
+// -------------------------------------------------------------------
+// World
+// -------------------------------------------------------------------
+
+void World_Init(World* world)
+{
+    memset(world, 0, sizeof(*world));
+    world->entities.freeSlot = ENTITY_NO_SLOT;
+}
+
+void World_CleanUp(World* world)
+{
+    for (int32_t i = 0; i < world->poolCount; i++)
+    {
+        SparseSet_CleanUp(world->pools[i]);
+    }
+
+    world->entities.CleanUp();
+    Memory_FreeTag(COMPONENTS_TAG, world->pendingDestroys);
+
+    World_Init(world);
+}
+
+void World_AddPool(World* world, SparseSet* pool)
+{
+    assert(world->poolCount < WORLD_MAX_POOLS);
+    world->pools[world->poolCount++] = pool;
+}
+
+EntityId World_CreateEntity(World* world)
+{
+    return world->entities.Create();
+}
+
+bool World_DeferDestroyEntity(World* world, EntityId entity)
+{
+    if (!GrowBuffer((void**)&world->pendingDestroys, &world->pendingDestroyCapacity, world->pendingDestroyCount + 1, sizeof(EntityId), alignof(EntityId)))
+    {
+        return false;
+    }
+
+    world->pendingDestroys[world->pendingDestroyCount++] = entity;
+    return true;
+}
+
+void World_Sync(World* world)
+{
+    for (int32_t i = 0; i < world->poolCount; i++)
+    {
+        SparseSet_Sync(world->pools[i]);
+    }
+
+    for (int32_t i = 0; i < world->pendingDestroyCount; i++)
+    {
+        const EntityId entity = world->pendingDestroys[i];
+        if (!world->entities.IsAlive(entity))
+        {
+            continue;
+        }
+
+        for (int32_t poolIndex = 0; poolIndex < world->poolCount; poolIndex++)
+        {
+            SparseSet_Remove(world->pools[poolIndex], entity);
+        }
+
+        world->entities.Destroy(entity);
+    }
+    world->pendingDestroyCount = 0;
+}
+
+//! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
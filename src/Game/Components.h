@@ -1,3 +1,273 @@
 #pragma once
 
+#include <stdint.h>
+#include <assert.h>
 #include <vectormath/vectormath_types.h>
+
+// -------------------------------------------------------------------
+// Components
+// Plain data only, pools move them with memcpy
+// -------------------------------------------------------------------
+
+/// Cell of the entity in the collision grid
+struct GridPosition
+{
+    ivec2       value;
+};
+
+/// Position inside the grid cell, [0, 1] on each axis
+struct RatioPosition
+{
+    vec2        value;
+};
+
+/// Velocity in cells per second
+struct RatioVelocity
+{
+    vec2        value;
+};
+
+struct GridBody
+{
+    ivec2       size;
+    float       radius;
+};
+
+// -------------------------------------------------------------------
+// Entities
+// -------------------------------------------------------------------
+
+/// Entity id, low bits are the index, high bits are the generation.
+/// Generation 0 is never alive, so 0 is the null entity.
+typedef uint32_t EntityId;
+
+constexpr EntityId  ENTITY_NONE                 = 0;
+constexpr int32_t   ENTITY_INDEX_BITS           = 20;
+constexpr uint32_t  ENTITY_INDEX_MASK           = (1u << ENTITY_INDEX_BITS) - 1;
+constexpr uint32_t  ENTITY_GENERATION_MASK      = (1u << (32 - ENTITY_INDEX_BITS)) - 1;
+constexpr int32_t   ENTITY_MAX_COUNT            = 1 << ENTITY_INDEX_BITS;
+
+static inline uint32_t Entity_GetIndex(EntityId entity)
+{
+    return entity & ENTITY_INDEX_MASK;
+}
+
+static inline uint32_t Entity_GetGeneration(EntityId entity)
+{
+    return entity >> ENTITY_INDEX_BITS;
+}
+
+/// Allocate entity ids and recycle them with a new generation
+struct EntityRegistry
+{
+    int32_t         count;          // Alive entities
+    int32_t         slotCount;
+    int32_t         slotCapacity;
+    uint32_t        freeSlot;
+
+    uint32_t*       generations;
+    uint32_t*       nextFreeSlots;
+
+    EntityId        Create(void);
+    bool            Destroy(EntityId entity);
+    bool            IsAlive(EntityId entity) const;
+
+    void            CleanUp(void);
+};
+
+// -------------------------------------------------------------------
+// Component storages
+// -------------------------------------------------------------------
+
+/// Sparse set of entities, with one densely packed value per entity.
+/// Values are stored type-erased so every pool share the same code,
+/// ComponentPool<T> is the typed front.
+/// Structural changes can be deferred (Defer*) while systems iterate,
+/// and are applied by SparseSet_Sync at sync points.
+struct SparseSet
+{
+    const char*     name;
+    int32_t         valueSize;
+    int32_t         valueAlign;
+
+    int32_t         count;
+    int32_t         capacity;
+    EntityId*       entities;       // Dense entities
+    uint8_t*        values;         // Dense values, same order as entities
+
+    int32_t         sparseCapacity;
+    int32_t*        sparse;         // Entity index to dense index, -1 if not contained
+
+    // Deferred changes
+    int32_t         pendingAddCount;
+    int32_t         pendingAddCapacity;
+    EntityId*       pendingAddEntities;
+    uint8_t*        pendingAddValues;
+
+    int32_t         pendingRemoveCount;
+    int32_t         pendingRemoveCapacity;
+    EntityId*       pendingRemoves;
+};
+
+void    SparseSet_Init(SparseSet* set, const char* name, int32_t valueSize, int32_t valueAlign);
+void    SparseSet_CleanUp(SparseSet* set);
+
+int32_t SparseSet_IndexOf(const SparseSet* set, EntityId entity);
+
+/// Add entity (or overwrite its value), return the value address, nullptr when out of memory
+void*   SparseSet_Add(SparseSet* set, EntityId entity, const void* value);
+
+/// Remove entity, the last entity is swapped into its place
+bool    SparseSet_Remove(SparseSet* set, EntityId entity);
+
+void    SparseSet_SwapDense(SparseSet* set, int32_t a, int32_t b);
+
+bool    SparseSet_DeferAdd(SparseSet* set, EntityId entity, const void* value);
+bool    SparseSet_DeferRemove(SparseSet* set, EntityId entity);
+
+/// Apply deferred removes, then deferred adds
+void    SparseSet_Sync(SparseSet* set);
+
+/// Reorder the sets so the entities contained in all sets are packed at the front
+/// of every set in the same order. Return the number of these entities,
+/// dense index [0, result) then address the same entity in every set.
+int32_t SparseSet_Group(SparseSet* const* sets, int32_t setCount);
+
+template <typename T>
+struct ComponentPool : SparseSet
+{
+    inline ComponentPool(const char* poolName)
+    {
+        SparseSet_Init(this, poolName, (int32_t)sizeof(T), (int32_t)alignof(T));
+    }
+
+    inline ~ComponentPool()
+    {
+        assert(entities == nullptr);
+        assert(values == nullptr);
+    }
+
+    inline void CleanUp(void)
+    {
+        SparseSet_CleanUp(this);
+    }
+
+    inline int32_t Count(void) const
+    {
+        return count;
+    }
+
+    // Dense values, [0, Count())
+    inline T* Values(void)
+    {
+        return (T*)values;
+    }
+
+    inline bool Contains(EntityId entity) const
+    {
+        return SparseSet_IndexOf(this, entity) > -1;
+    }
+
+    // Get component of entity, nullptr if the entity does not have it
+    inline T* Get(EntityId entity)
+    {
+        const int32_t index = SparseSet_IndexOf(this, entity);
+        return index > -1 ? &((T*)values)[index] : nullptr;
+    }
+
+    // Add component now, must not be called while a system iterate this pool
+    inline T* Add(EntityId entity, const T& value = T())
+    {
+        return (T*)SparseSet_Add(this, entity, &value);
+    }
+
+    inline bool Remove(EntityId entity)
+    {
+        return SparseSet_Remove(this, entity);
+    }
+
+    // Add component at the next sync point
+    inline bool DeferAdd(EntityId entity, const T& value = T())
+    {
+        return SparseSet_DeferAdd(this, entity, &value);
+    }
+
+    // Remove component at the next sync point
+    inline bool DeferRemove(EntityId entity)
+    {
+        return SparseSet_DeferRemove(this, entity);
+    }
+};
+
+/// Iterate entities that have all components, func(EntityId, T0&, T1&, ...)
+/// Walk the smallest pool and look the entity up in the others.
+/// @note: components must not be added or removed inside func, use DeferAdd/DeferRemove then World_Sync
+template <typename... Ts, typename Func>
+inline void View_ForEach(Func&& func, ComponentPool<Ts>&... pools)
+{
+    SparseSet* sets[] = { &pools... };
+
+    SparseSet* lead = sets[0];
+    for (SparseSet* set : sets)
+    {
+        lead = set->count < lead->count ? set : lead;
+    }
+
+    for (int32_t i = lead->count - 1; i >= 0; i--)
+    {
+        const EntityId entity = lead->entities[i];
+
+        bool containsAll = true;
+        for (SparseSet* set : sets)
+        {
+            containsAll = containsAll && SparseSet_IndexOf(set, entity) > -1;
+        }
+
+        if (containsAll)
+        {
+            func(entity, *pools.Get(entity)...);
+        }
+    }
+}
+
+/// Pack entities that have all components at the front of their pools, see SparseSet_Group.
+/// Systems then iterate pools' Values() with the same index, a linear pass over packed arrays.
+template <typename... Ts>
+inline int32_t View_Group(ComponentPool<Ts>&... pools)
+{
+    SparseSet* sets[] = { &pools... };
+    return SparseSet_Group(sets, (int32_t)(sizeof(sets) / sizeof(sets[0])));
+}
+
+// -------------------------------------------------------------------
+// World
+// -------------------------------------------------------------------
+
+constexpr int32_t WORLD_MAX_POOLS = 32;
+
+/// Entities and their component pools
+/// Entity destruction is deferred to World_Sync, like other structural changes
+struct World
+{
+    EntityRegistry  entities;
+
+    int32_t         poolCount;
+    SparseSet*      pools[WORLD_MAX_POOLS];
+
+    int32_t         pendingDestroyCount;
+    int32_t         pendingDestroyCapacity;
+    EntityId*       pendingDestroys;
+};
+
+void        World_Init(World* world);
+void        World_CleanUp(World* world);
+
+void        World_AddPool(World* world, SparseSet* pool);
+
+EntityId    World_CreateEntity(World* world);
+bool        World_DeferDestroyEntity(World* world, EntityId entity);
+
+/// Sync point: apply deferred component changes, then destroy deferred entities
+void        World_Sync(World* world);
+
+//! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
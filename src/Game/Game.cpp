@@ -1,4 +1,7 @@
 #include <time.h>
+#include <stdio.h>
+#include <assert.h>
+#include <string.h>
 #include <memory.h>
 #include <stdlib.h>
 #include <vectormath.h>
@@ -9,6 +12,7 @@
 
 #include "Native/Input.h"
 #include "Native/Window.h"
+#include "Native/Memory.h"
 #include "Native/FileSystem.h"
 
 #include "Graphics/Graphics.h"
@@ -16,22 +20,11 @@
 
 #include "Misc/Logging.h"
 #include "Misc/LDtkParser.h"
+#include "Misc/LDtkCooker.h"
 
-#include "Framework/JobSystem.h"
-
-#include <map>
-#include <string>
-
-struct Entity
-{
-    ivec2       gridSize;
-    ivec2       gridPosition;
-
-    vec2        ratioPosition;
-    vec2        ratioVelocity;
+#include "Text/StringId.h"
 
-    float       radius;
-};
+#include "Framework/JobSystem.h"
 
 static SpriteSheet spriteSheetBackground;
 static SpriteSheet spriteSheetTerrain;
@@ -39,7 +32,7 @@ static SpriteSheet spriteSheetTerrain;
 static int32_t      spritesheetCount;
 static SpriteSheet* spritesheets;
 
-static std::map<std::string, SpriteBatch> spriteBatchs;
+static TileMapRenderList levelRenderList;
 
 int   spriteIndex = 0;
 float spriteTimer = 0.0f;
@@ -61,7 +54,13 @@ SpriteSheet* frogSpriteSheet = &spriteBatch_FrogIdle;
 float gravity = 90.0f;
 float fallSpeed = 0.0f;
 
-Entity          frog;
+static World                        entityWorld;
+static ComponentPool<GridPosition>  gridPositions("GridPosition");
+static ComponentPool<RatioPosition> ratioPositions("RatioPosition");
+static ComponentPool<RatioVelocity> ratioVelocities("RatioVelocity");
+static ComponentPool<GridBody>      gridBodies("GridBody");
+
+EntityId        frog;
 TileMapGrid*    grid;
 
 inline vec2 GetWorldPosition(int32_t gridCellSize, ivec2 gridPosition, vec2 ratioPosition)
@@ -69,9 +68,9 @@ inline vec2 GetWorldPosition(int32_t gridCellSize, ivec2 gridPosition, vec2 rati
     return vec2_new((float)gridCellSize * ((float)gridPosition.x + ratioPosition.x), (float)gridCellSize * ((float)gridPosition.y + ratioPosition.y));
 }
 
-inline vec2 GetWorldPosition(const TileMapGrid* grid, const Entity& entity)
+inline vec2 GetWorldPosition(const TileMapGrid* grid, EntityId entity)
 {
-    return GetWorldPosition(grid->size, entity.gridPosition, entity.ratioPosition);
+    return GetWorldPosition(grid->size, gridPositions.Get(entity)->value, ratioPositions.Get(entity)->value);
 }
 
 inline bool HasGridCollision(const TileMapGrid* grid, ivec2 position)
@@ -79,97 +78,156 @@ inline bool HasGridCollision(const TileMapGrid* grid, ivec2 position)
     return TileMapGrid_SafeGet(grid, position, 0) != 0;
 }
 
-inline bool HasEntityCollision(const Entity& a, const Entity& b)
+inline bool HasEntityCollision(EntityId a, EntityId b)
 {
-    const float zone = a.radius + b.radius;
-    const vec2  posA = GetWorldPosition(1, a.gridPosition, a.ratioPosition);
-    const vec2  posB = GetWorldPosition(1, a.gridPosition, a.ratioPosition);
+    const float zone = gridBodies.Get(a)->radius + gridBodies.Get(b)->radius;
+    const vec2  posA = GetWorldPosition(1, gridPositions.Get(a)->value, ratioPositions.Get(a)->value);
+    const vec2  posB = GetWorldPosition(1, gridPositions.Get(b)->value, ratioPositions.Get(b)->value);
     return vec2_distsqr(posA, posB) <= zone * zone;
 }
 
-inline void UpdateEntity(Entity* entity, const TileMapGrid* grid, float deltaTime)
+/// Arrays of the moving entities, packed by View_Group at the sync point
+struct MovementJob
 {
-    entity->ratioPosition += entity->ratioVelocity * deltaTime + vec2_new(0.0f, -30.0f) * 0.5f * deltaTime * deltaTime;
-    entity->ratioVelocity += vec2_new(0.0f, -30.0f) * deltaTime;
-    entity->ratioVelocity *= vec2_new(0.90f, 0.96f); // Damping
+    GridPosition*       gridPositions;
+    RatioPosition*      ratioPositions;
+    RatioVelocity*      ratioVelocities;
 
-    if (entity->ratioPosition.x > 1.0f)
-    {
-        entity->gridPosition.x += 1;
-        entity->ratioPosition.x -= 1.0f;
-    }
+    const TileMapGrid*  grid;
+    float               deltaTime;
+};
 
-    if (entity->ratioPosition.x < 0.0f)
-    {
-        entity->gridPosition.x -= 1;
-        entity->ratioPosition.x += 1.0f;
-    }
+// Integrate velocity and gravity, a linear pass over packed arrays
+static void MovementSystem_Integrate(void* data, int32_t start, int32_t end)
+{
+    const MovementJob* job = (const MovementJob*)data;
+    RatioPosition* ratioPositions = job->ratioPositions;
+    RatioVelocity* ratioVelocities = job->ratioVelocities;
 
-    if (entity->ratioPosition.y > 1.0f)
-    {
-        entity->gridPosition.y += 1;
-        entity->ratioPosition.y -= 1.0f;
-    }
+    const float deltaTime = job->deltaTime;
+    const vec2 gravity = vec2_new(0.0f, -30.0f);
+    const vec2 positionStep = gravity * 0.5f * deltaTime * deltaTime;
+    const vec2 velocityStep = gravity * deltaTime;
+    const vec2 damping = vec2_new(0.90f, 0.96f);
 
-    if (entity->ratioPosition.y < 0.0f)
+    for (int32_t i = start; i < end; i++)
     {
-        entity->gridPosition.y -= 1;
-        entity->ratioPosition.y += 1.0f;
+        ratioPositions[i].value += ratioVelocities[i].value * deltaTime + positionStep;
+        ratioVelocities[i].value = (ratioVelocities[i].value + velocityStep) * damping;
     }
+}
 
-    // Left
-    if (HasGridCollision(grid, ivec2{entity->gridPosition.x - 1, entity->gridPosition.y}) && entity->ratioPosition.x <= 0.3f)
-    {
-        entity->ratioPosition.x = 0.3f;
-        entity->ratioVelocity.x = 0.0f;
-    }
+// Move entities across cells, then resolve collisions with the grid
+static void MovementSystem_ResolveGrid(void* data, int32_t start, int32_t end)
+{
+    const MovementJob* job = (const MovementJob*)data;
+    const TileMapGrid* grid = job->grid;
 
-    // Right
-    if (HasGridCollision(grid, ivec2{entity->gridPosition.x + 1, entity->gridPosition.y}) && entity->ratioPosition.x >= 0.7f)
+    for (int32_t i = start; i < end; i++)
     {
-        entity->ratioPosition.x = 0.7f;
-        entity->ratioVelocity.x = 0.0f;
-    }
+        ivec2& gridPosition = job->gridPositions[i].value;
+        vec2& ratioPosition = job->ratioPositions[i].value;
+        vec2& ratioVelocity = job->ratioVelocities[i].value;
 
-    // Up
-    if (HasGridCollision(grid, ivec2{entity->gridPosition.x, entity->gridPosition.y + 1}) && entity->ratioPosition.y >= 0.3f)
-    {
-        entity->ratioPosition.y = 0.3f;
-        entity->ratioVelocity.y = 0.0f;
-    }
+        if (ratioPosition.x > 1.0f)
+        {
+            gridPosition.x += 1;
+            ratioPosition.x -= 1.0f;
+        }
 
-    // Down
-    if (HasGridCollision(grid, ivec2{entity->gridPosition.x, entity->gridPosition.y - 1}) && entity->ratioPosition.y <= 0.5f)
-    {
-        entity->ratioPosition.y = 0.5f;
-        entity->ratioVelocity.y = 0.0f;
+        if (ratioPosition.x < 0.0f)
+        {
+            gridPosition.x -= 1;
+            ratioPosition.x += 1.0f;
+        }
+
+        if (ratioPosition.y > 1.0f)
+        {
+            gridPosition.y += 1;
+            ratioPosition.y -= 1.0f;
+        }
+
+        if (ratioPosition.y < 0.0f)
+        {
+            gridPosition.y -= 1;
+            ratioPosition.y += 1.0f;
+        }
+
+        // Left
+        if (HasGridCollision(grid, ivec2{gridPosition.x - 1, gridPosition.y}) && ratioPosition.x <= 0.3f)
+        {
+            ratioPosition.x = 0.3f;
+            ratioVelocity.x = 0.0f;
+        }
+
+        // Right
+        if (HasGridCollision(grid, ivec2{gridPosition.x + 1, gridPosition.y}) && ratioPosition.x >= 0.7f)
+        {
+            ratioPosition.x = 0.7f;
+            ratioVelocity.x = 0.0f;
+        }
+
+        // Up
+        if (HasGridCollision(grid, ivec2{gridPosition.x, gridPosition.y + 1}) && ratioPosition.y >= 0.3f)
+        {
+            ratioPosition.y = 0.3f;
+            ratioVelocity.y = 0.0f;
+        }
+
+        // Down
+        if (HasGridCollision(grid, ivec2{gridPosition.x, gridPosition.y - 1}) && ratioPosition.y <= 0.5f)
+        {
+            ratioPosition.y = 0.5f;
+            ratioVelocity.y = 0.0f;
+        }
     }
 }
 
-inline bool EntityOnGround(const Entity& entity, const TileMapGrid* grid)
+inline void UpdateMovement(int32_t moverCount, const TileMapGrid* grid, float deltaTime)
+{
+    // Entities per job, small worlds run on the calling thread
+    constexpr int32_t MOVEMENT_BATCH_SIZE = 1024;
+
+    MovementJob job;
+    job.gridPositions   = gridPositions.Values();
+    job.ratioPositions  = ratioPositions.Values();
+    job.ratioVelocities = ratioVelocities.Values();
+    job.grid            = grid;
+    job.deltaTime       = deltaTime;
+
+    JobSystem::ParallelFor(MovementSystem_Integrate, &job, moverCount, MOVEMENT_BATCH_SIZE);
+    JobSystem::ParallelFor(MovementSystem_ResolveGrid, &job, moverCount, MOVEMENT_BATCH_SIZE);
+}
+
+inline bool EntityOnGround(EntityId entity, const TileMapGrid* grid)
 {
-    return (HasGridCollision(grid, ivec2{ entity.gridPosition.x, entity.gridPosition.y - 1 }) && entity.ratioPosition.y <= 0.5f);
+    const ivec2 gridPosition = gridPositions.Get(entity)->value;
+    const vec2 ratioPosition = ratioPositions.Get(entity)->value;
+    return (HasGridCollision(grid, ivec2{ gridPosition.x, gridPosition.y - 1 }) && ratioPosition.y <= 0.5f);
 }
 
-inline bool EntityOnReallyCloseToWallLeft(const Entity& entity, const TileMapGrid* grid)
+inline bool EntityOnReallyCloseToWallLeft(EntityId entity, const TileMapGrid* grid)
 {
+    const ivec2 gridPosition = gridPositions.Get(entity)->value;
     return !EntityOnGround(entity, grid)
-        && entity.ratioPosition.x <= 0.05f
-        && HasGridCollision(grid, ivec2{ entity.gridPosition.x - 1, entity.gridPosition.y });
+        && ratioPositions.Get(entity)->value.x <= 0.05f
+        && HasGridCollision(grid, ivec2{ gridPosition.x - 1, gridPosition.y });
 }
 
-inline bool EntityOnReallyCloseToWallRight(const Entity& entity, const TileMapGrid* grid)
+inline bool EntityOnReallyCloseToWallRight(EntityId entity, const TileMapGrid* grid)
 {
+    const ivec2 gridPosition = gridPositions.Get(entity)->value;
     return !EntityOnGround(entity, grid)
-        && entity.ratioPosition.x >= 0.95f
-        && HasGridCollision(grid, ivec2{ entity.gridPosition.x + 1, entity.gridPosition.y });
+        && ratioPositions.Get(entity)->value.x >= 0.95f
+        && HasGridCollision(grid, ivec2{ gridPosition.x + 1, gridPosition.y });
 }
 
-inline bool EntityOnWall(const Entity& entity, const TileMapGrid* grid)
+inline bool EntityOnWall(EntityId entity, const TileMapGrid* grid)
 {
+    const ivec2 gridPosition = gridPositions.Get(entity)->value;
     return !EntityOnGround(entity, grid)
-        && ((HasGridCollision(grid, ivec2{ entity.gridPosition.x - 1, entity.gridPosition.y }))
-        ||  (HasGridCollision(grid, ivec2{ entity.gridPosition.x + 1, entity.gridPosition.y })));
+        && ((HasGridCollision(grid, ivec2{ gridPosition.x - 1, gridPosition.y }))
+        ||  (HasGridCollision(grid, ivec2{ gridPosition.x + 1, gridPosition.y })));
 }
 
 bool CreateSpriteSheet(SpriteSheet* spriteSheet, const LDtkTileset tileset)
@@ -187,33 +245,156 @@ bool CreateSpriteSheet(SpriteSheet* spriteSheet, const LDtkTileset tileset)
     return true;
 }
 
-void CreateSpriteBatch(const int32_t levelHeight, const LDtkLayer* layer)
+// Match a runtime name against a literal, the hash reject most names without touching the string.
+// The hash only filter: a name sharing the hash of the literal is still compared, in every build.
+static bool NameIs(const char* name, StringId id, const char* literal)
 {
-    const LDtkTileset* tileset = &layer->tileset;
-    if (tileset->index < 0 || tileset->index > spritesheetCount || layer->tileCount == 0)
+    return name && StringId_Hash(name) == id && strcmp(name, literal) == 0;
+}
+
+#define NAME_IS(name, literal) NameIs(name, STRING_ID(literal), literal)
+
+// A world cooked by tools/ldtk_cook is mapped instead of parsed, as long as the .ldtk file is not modified after cooking.
+// Otherwise only the level index is parsed, LoadLevel read the layers of the levels in use.
+static bool LoadWorld(const char* worldPath, LDtkWorld* world, LDtkCookedFile* cookedFile, void** worldBuffer)
+{
+    char cookedPath[1024];
+    snprintf(cookedPath, sizeof(cookedPath), "%s.cooked", worldPath);
+
+    *worldBuffer = nullptr;
+    if (LDtkMapCooked(cookedPath, worldPath, LDtkParseFlags_LayerReverseOrder, cookedFile, world).code == LDtkErrorCode_None)
     {
-        return;
+        return true;
     }
 
-    const SpriteSheet spritesheet = spritesheets[tileset->index];
+    // The query read the files in the buffer, it grow to the size the query ask then to the exact size of the world
+    int32_t tempBufferSize = 64 * 1024;
+    void* tempBuffer = Memory_AllocTag("LDtk", tempBufferSize, 16);
 
-    SpriteBatch spriteBatch = {};
-    SpriteBatch_Create(&spriteBatch, &spritesheets[tileset->index], (int32_t)layer->tileCount * 6);
-    
-    SpriteBatch_Begin(&spriteBatch);
-    for (int i = 0; i < layer->tileCount; i++)
+    int32_t worldBufferSize;
+    LDtkError queryError;
+    const LDtkParseFlags flags = (LDtkParseFlags)(LDtkParseFlags_LayerReverseOrder | LDtkParseFlags_LevelIndex);
+    while ((queryError = LDtkQueryMemory(worldPath, LDtkContextDefault(tempBuffer, tempBufferSize), flags, &worldBufferSize)).code == LDtkErrorCode_OutOfMemory
+        && worldBufferSize > tempBufferSize)
+    {
+        tempBufferSize = worldBufferSize;
+        tempBuffer = Memory_ReallocTag("LDtk", tempBuffer, tempBufferSize, 16);
+    }
+
+    if (queryError.code != LDtkErrorCode_None)
+    {
+        fprintf(stderr, "Query ldtk sample content memory failed!: %s\n", queryError.message);
+        Memory_FreeTag("LDtk", tempBuffer);
+        return false;
+    }
+
+    tempBufferSize = worldBufferSize;
+    tempBuffer = Memory_ReallocTag("LDtk", tempBuffer, tempBufferSize, 16);
+
+    LDtkContext ldtkContext = LDtkContextDefault(tempBuffer, tempBufferSize);
+    ldtkContext.parallelFor = JobSystem::ParallelFor;
+
+    LDtkError error = LDtkParse(worldPath, ldtkContext, flags, world);
+    if (error.code != LDtkErrorCode_None)
     {
-        const LDtkTile& tile = layer->tiles[i];
-        const int32_t cols = tile.textureX / tileset->tileSize;
-        const int32_t rows = tile.textureY / tileset->tileSize;
-        const Sprite* sprite = &spritesheet.sprites[rows * spritesheet.cols + cols];
-        const vec2 position = vec2_new(tile.x + tileset->tileSize * 0.5f, levelHeight - tile.y - tileset->tileSize * 0.5f);
-        const vec2 scale = vec2_new(tile.flipX ? -1.0f : 1.0f, tile.flipY ? -1.0f : 1.0f);
-        SpriteBatch_DrawSprite(&spriteBatch, sprite, position, 0.0f, scale, vec3_new1(1.0f));
+        fprintf(stderr, "Parse ldtk sample content failed!: %s\n", error.message);
+        Memory_FreeTag("LDtk", tempBuffer);
+        return false;
     }
-    SpriteBatch_End(&spriteBatch);
 
-    spriteBatchs[layer->name] = spriteBatch;
+    *worldBuffer = tempBuffer;
+    return true;
+}
+
+// Blocks of a loaded level: its first buffer, then the chunks LDtkLoadLevel ask when it is full.
+// Each block start with this header, they are freed together.
+struct alignas(16) LevelBlock
+{
+    LevelBlock* next;
+};
+
+static void* LevelBlock_Alloc(LevelBlock** blocks, int32_t size)
+{
+    LevelBlock* block = (LevelBlock*)Memory_AllocTag("LDtk", (int32_t)sizeof(LevelBlock) + size, 16);
+    if (!block)
+    {
+        return nullptr;
+    }
+
+    block->next = *blocks;
+    *blocks = block;
+    return block + 1;
+}
+
+static void* LevelBlock_AllocChunk(void* userData, int32_t minSize, int32_t* outSize)
+{
+    // Small chunks are rounded up, a level which overflow its first buffer usually overflow it more than once
+    const int32_t chunkSize = minSize > 64 * 1024 ? minSize : 64 * 1024;
+    void* chunk = LevelBlock_Alloc((LevelBlock**)userData, chunkSize);
+
+    *outSize = chunk ? chunkSize : 0;
+    return chunk;
+}
+
+static void LevelBlock_FreeAll(LevelBlock* blocks)
+{
+    while (blocks)
+    {
+        LevelBlock* next = blocks->next;
+        Memory_FreeTag("LDtk", blocks);
+        blocks = next;
+    }
+}
+
+// The layers of a level are read in blocks of their own, the first one sized from the level file and chunks after it.
+// The levels of a cooked world have them already.
+static bool LoadLevel(LDtkWorld* world, int32_t levelIndex, LevelBlock** levelBlocks)
+{
+    *levelBlocks = nullptr;
+    if (world->levels[levelIndex].layers)
+    {
+        return true;
+    }
+
+    LDtkContext context = LDtkContextDefault(nullptr, 0);
+    context.allocChunk = LevelBlock_AllocChunk;
+    context.chunkUserData = levelBlocks;
+
+    // The file and its in situ values, the layers of the levels inside the world file are already parsed
+    int32_t fileSize = 0;
+    const char* externalPath = world->levels[levelIndex].externalPath;
+    if (externalPath && !context.readFileFn(externalPath, nullptr, &fileSize))
+    {
+        fileSize = 0;
+    }
+
+    context.bufferSize = fileSize < INT32_MAX / 4 ? 16 * 1024 + fileSize * 3 : INT32_MAX / 4;
+    context.buffer = LevelBlock_Alloc(levelBlocks, context.bufferSize);
+    if (!context.buffer)
+    {
+        return false;
+    }
+
+    const LDtkError error = LDtkLoadLevel(world, world->levels[levelIndex].id, context, LDtkParseFlags_LayerReverseOrder);
+    if (error.code != LDtkErrorCode_None)
+    {
+        fprintf(stderr, "Load ldtk level failed!: %s\n", error.message);
+        LevelBlock_FreeAll(*levelBlocks);
+        *levelBlocks = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+static void UnloadWorld(LDtkCookedFile* cookedFile, void* worldBuffer, LevelBlock* levelBlocks)
+{
+    LevelBlock_FreeAll(levelBlocks);
+    if (worldBuffer)
+    {
+        Memory_FreeTag("LDtk", worldBuffer);
+    }
+    LDtkUnmapCooked(cookedFile);
 }
 
 bool Game_Setup()
@@ -229,17 +410,11 @@ bool Game_Setup()
         return false;
     }
 
-    int32_t tempBufferSize = 20 * 1024 * 1024;
-    void* tempBuffer = malloc((size_t)tempBufferSize);
-
-    LDtkContext ldtkContext = LDtkContextDefault(tempBuffer, tempBufferSize);
-
     LDtkWorld world;
-    LDtkError error = LDtkParse(worldPath, ldtkContext, LDtkParseFlags_LayerReverseOrder, &world);
-    if (error.code != LDtkErrorCode_None)
+    LDtkCookedFile cookedFile;
+    void* tempBuffer;
+    if (!LoadWorld(worldPath, &world, &cookedFile, &tempBuffer))
     {
-        fprintf(stderr, "Parse ldtk sample content failed!: %s\n", error.message);
-        free(tempBuffer);
         return false;
     }
 
@@ -252,7 +427,7 @@ bool Game_Setup()
         SpriteSheet sheet;
         if (!CreateSpriteSheet(&sheet, tileset))
         {
-            free(tempBuffer);
+            UnloadWorld(&cookedFile, tempBuffer, nullptr);
             return false;
         }
 
@@ -262,17 +437,25 @@ bool Game_Setup()
     int32_t levelIndex = 0;
     for (int32_t i = 0; i < world.levelCount; i++)
     {
-        if (strcmp(world.levels[i].name, "Level0") == 0)
+        if (NAME_IS(world.levels[i].name, "Level0"))
         {
             levelIndex = i;
             break;
         }
     }
 
+    LevelBlock* levelBlocks;
+    if (!LoadLevel(&world, levelIndex, &levelBlocks))
+    {
+        UnloadWorld(&cookedFile, tempBuffer, nullptr);
+        return false;
+    }
+
     LDtkLevel level = world.levels[levelIndex];
-    for (int32_t i = 0; i < level.layerCount; i++)
+    if (!TileMapRenderList_Build(&levelRenderList, &level, spritesheets, spritesheetCount))
     {
-        CreateSpriteBatch(level.height, &level.layers[i]);
+        UnloadWorld(&cookedFile, tempBuffer, levelBlocks);
+        return false;
     }
 
     int spriteCols_FrogIdle = 11;
@@ -301,7 +484,7 @@ bool Game_Setup()
     int32_t collisionLayerIndex = 0;
     for (int32_t i = 0; i < level.layerCount; i++)
     {
-        if (strcmp(level.layers[i].name, "Collisions") == 0)
+        if (NAME_IS(level.layers[i].name, "Collisions"))
         {
             collisionLayerIndex = i;
             break;
@@ -310,16 +493,22 @@ bool Game_Setup()
     const LDtkLayer* collisionLayer = &level.layers[collisionLayerIndex];
     grid = TileMapGrid_FromLDtkLayer(collisionLayer);
 
-    frog.radius = 0.0f;
-    frog.gridSize = ivec2{ 2, 2 };
-    frog.gridPosition = ivec2{ grid->cols >> 1, grid->rows >> 1 };
-    frog.ratioVelocity = vec2_new1(0.0f);
-    frog.ratioPosition = vec2_new1(0.0f);
+    World_Init(&entityWorld);
+    World_AddPool(&entityWorld, &gridPositions);
+    World_AddPool(&entityWorld, &ratioPositions);
+    World_AddPool(&entityWorld, &ratioVelocities);
+    World_AddPool(&entityWorld, &gridBodies);
+
+    frog = World_CreateEntity(&entityWorld);
+    gridPositions.Add(frog, GridPosition{ ivec2{ grid->cols >> 1, grid->rows >> 1 } });
+    ratioPositions.Add(frog, RatioPosition{ vec2_new1(0.0f) });
+    ratioVelocities.Add(frog, RatioVelocity{ vec2_new1(0.0f) });
+    gridBodies.Add(frog, GridBody{ ivec2{ 2, 2 }, 0.0f });
 
     int32_t entitiesLayerIndex = 0;
     for (int32_t i = 0; i < level.layerCount; i++)
     {
-        if (strcmp(level.layers[i].name, "Entities") == 0)
+        if (NAME_IS(level.layers[i].name, "Entities"))
         {
             entitiesLayerIndex = i;
             break;
@@ -330,21 +519,24 @@ bool Game_Setup()
     for (int32_t i = 0; i < entitiesLayer->entityCount; i++)
     {
         const LDtkEntity entity = entitiesLayer->entities[i];
-        frog.radius = 0.0f;
-        frog.gridSize = ivec2{ 2, 2 };
-        frog.gridPosition = ivec2{ entity.gridX, entity.gridY + 2 };
-        frog.ratioVelocity = vec2_new1(0.0f);
-        frog.ratioPosition = vec2_new1(0.0f);
+        gridPositions.Add(frog, GridPosition{ ivec2{ entity.gridX, entity.gridY + 2 } });
+        ratioPositions.Add(frog, RatioPosition{ vec2_new1(0.0f) });
+        ratioVelocities.Add(frog, RatioVelocity{ vec2_new1(0.0f) });
     }
 
-    free(tempBuffer);
+    UnloadWorld(&cookedFile, tempBuffer, levelBlocks);
     return true;
 }
 
 void Game_Shutdown(void)
 {
+    World_CleanUp(&entityWorld);
+    frog = ENTITY_NONE;
+
     TileMapGrid_Destroy(grid);
     grid = nullptr;
+
+    TileMapRenderList_Destroy(&levelRenderList);
 }
 
 void Game_Load(void)
@@ -367,23 +559,29 @@ void Game_Update(float totalTime, float deltaTime)
 
     int32_t stepCount = int32_max((int32_t)(deltaTime / maxStepTime), 1);
 
+    // Sync point: apply structural changes, then pack moving entities for the systems
+    World_Sync(&entityWorld);
+    const int32_t moverCount = View_Group(gridPositions, ratioPositions, ratioVelocities);
+
     float remainDeltaTime = deltaTime;
     while (stepCount--)
     {
         const float stepTime = float_min(maxStepTime, remainDeltaTime);
         remainDeltaTime -= maxStepTime;
 
+        RatioVelocity* frogVelocity = ratioVelocities.Get(frog);
+
         // @todo: create GameInput module
         if (Input_GetKey(KeyCode_LeftArrow))
         {
-            frog.ratioVelocity.x = -4.0f;
+            frogVelocity->value.x = -4.0f;
 
             frogScale.x = -fabsf(frogScale.x);
         }
 
         if (Input_GetKey(KeyCode_RightArrow))
         {
-            frog.ratioVelocity.x = 4.0f;
+            frogVelocity->value.x = 4.0f;
 
             frogScale.x = fabsf(frogScale.x);
         }
@@ -393,12 +591,12 @@ void Game_Update(float totalTime, float deltaTime)
             if (EntityOnGround(frog, grid))
             {
                 fallSpeed += 90.0f;
-                frog.ratioVelocity.y = 20.0f;
+                frogVelocity->value.y = 20.0f;
             }
             else if (EntityOnWall(frog, grid))
             {
-                frog.ratioVelocity.x = -frog.ratioVelocity.x;
-                frog.ratioVelocity.y = 15.0f;
+                frogVelocity->value.x = -frogVelocity->value.x;
+                frogVelocity->value.y = 15.0f;
             }
         }
 
@@ -419,15 +617,15 @@ void Game_Update(float totalTime, float deltaTime)
                 frogScale.x = fabsf(frogScale.x);
             }
         }
-        else if (frog.ratioVelocity.y > 0.0f)
+        else if (frogVelocity->value.y > 0.0f)
         {
             nextSpritesheet = &spriteBatch_FrogJumpUp;
         }
-        else if (frog.ratioVelocity.y < 0.0f)
+        else if (frogVelocity->value.y < 0.0f)
         {
             nextSpritesheet = &spriteBatch_FrogFallDown;
         }
-        else if (fabsf(frog.ratioVelocity.x) > 0.4f)
+        else if (fabsf(frogVelocity->value.x) > 0.4f)
         {
             nextSpritesheet = &spriteBatch_FrogRun;
         }
@@ -449,7 +647,7 @@ void Game_Update(float totalTime, float deltaTime)
             spriteIndex = (spriteIndex + 1) % frogSpriteSheet->spriteCount;
         }
 
-        UpdateEntity(&frog, grid, stepTime);
+        UpdateMovement(moverCount, grid, stepTime);
     }
 
     #if 0
@@ -547,31 +745,11 @@ void Game_Update(float totalTime, float deltaTime)
     #endif
 }
 
-void DrawLayer(const char* layerName)
-{
-    //const ldtk::Layer*      layer       = world.getLevel("Level0")->getLayer(layerName);
-    //const ldtk::Tileset*    tileset     = layer->getTileset();
-    //const SpriteSheet       spritesheet = spritesheets[tileset->uid];
-    //
-    //for (ldtk::Tile tile : layer->allTiles())
-    //{
-    //    const int32_t cols      = tile.texture_position.x / tileset->tile_size;
-    //    const int32_t rows      = tile.texture_position.y / tileset->tile_size;
-    //    const Sprite* sprite    = &spritesheet.sprites[rows * spritesheet.cols + cols];
-    //    Renderer_DrawSprite(sprite, vec2_new(tile.position.x, layer->level->size.y - tile.position.y), 0.0f, vec2_new1(1.0f), vec3_new1(1.0f));
-    //}
-    const SpriteBatch* spriteBatch = &spriteBatchs[layerName];
-    Graphics_DrawSpriteBatch(spriteBatch);
-}
-
 static bool s_drawCollisionGrid = true;
 
 void Game_Render(void)
 {
-    for (auto pair : spriteBatchs)
-    {
-        Graphics_DrawSpriteBatch(&pair.second);
-    }
+    TileMapRenderList_Draw(&levelRenderList);
 
     const float frogWidth = frogSpriteSheet->sprites[spriteIndex].width;
     const float frogHeight = frogSpriteSheet->sprites[spriteIndex].height;
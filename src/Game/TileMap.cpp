@@ -1,4 +1,5 @@
 #include <memory.h>
+#include <vectormath.h>
 
 #include "Game/TileMap.h"
 #include "Native/Memory.h"
@@ -34,4 +35,94 @@ void TileMapGrid_Destroy(TileMapGrid* grid)
     Memory_FreeTag("TileMapGrid", grid);
 }
 
+static bool TileMapRenderList_ShouldDraw(const LDtkLayer* layer, int32_t spriteSheetCount)
+{
+    const int32_t tilesetIndex = layer->tileset.index;
+    return layer->visible
+        && layer->opacity > 0.0f
+        && layer->tileCount > 0
+        && tilesetIndex > -1 && tilesetIndex < spriteSheetCount;
+}
+
+bool TileMapRenderList_Build(TileMapRenderList* renderList, const LDtkLevel* level, const SpriteSheet* spriteSheets, int32_t spriteSheetCount)
+{
+    renderList->count = 0;
+    renderList->items = nullptr;
+
+    int32_t itemCount = 0;
+    for (int32_t i = 0; i < level->layerCount; i++)
+    {
+        itemCount += (int32_t)TileMapRenderList_ShouldDraw(&level->layers[i], spriteSheetCount);
+    }
+
+    if (itemCount == 0)
+    {
+        return true;
+    }
+
+    TileMapDrawItem* items = (TileMapDrawItem*)Memory_AllocTag("TileMapRenderList", itemCount * (int32_t)sizeof(TileMapDrawItem), alignof(TileMapDrawItem));
+    if (!items)
+    {
+        return false;
+    }
+
+    for (int32_t i = 0; i < level->layerCount; i++)
+    {
+        const LDtkLayer* layer = &level->layers[i];
+        if (!TileMapRenderList_ShouldDraw(layer, spriteSheetCount))
+        {
+            continue;
+        }
+
+        const LDtkTileset* tileset = &layer->tileset;
+        const SpriteSheet* spriteSheet = &spriteSheets[tileset->index];
+
+        TileMapDrawItem* item = Memory_NewPlacement(&items[renderList->count]) TileMapDrawItem();
+
+        SpriteBatch* spriteBatch = &item->spriteBatch;
+        SpriteBatch_Create(spriteBatch, spriteSheet, layer->tileCount);
+        spriteBatch->opacity = layer->opacity;
+
+        SpriteBatch_Begin(spriteBatch);
+        for (int32_t t = 0; t < layer->tileCount; t++)
+        {
+            const LDtkTile& tile = layer->tiles[t];
+            const int32_t cols = tile.textureX / tileset->tileSize;
+            const int32_t rows = tile.textureY / tileset->tileSize;
+            const Sprite* sprite = &spriteSheet->sprites[rows * spriteSheet->cols + cols];
+            const vec2 position = vec2_new(tile.x + tileset->tileSize * 0.5f, level->height - tile.y - tileset->tileSize * 0.5f);
+            const vec2 scale = vec2_new(tile.flipX ? -1.0f : 1.0f, tile.flipY ? -1.0f : 1.0f);
+            SpriteBatch_DrawSprite(spriteBatch, sprite, position, 0.0f, scale, vec3_new1(1.0f));
+        }
+        SpriteBatch_End(spriteBatch);
+
+        renderList->count++;
+    }
+
+    renderList->items = items;
+    return true;
+}
+
+void TileMapRenderList_Destroy(TileMapRenderList* renderList)
+{
+    for (int32_t i = 0; i < renderList->count; i++)
+    {
+        SpriteBatch_Destroy(&renderList->items[i].spriteBatch);
+    }
+
+    Memory_FreeTag("TileMapRenderList", renderList->items);
+
+    renderList->count = 0;
+    renderList->items = nullptr;
+}
+
+void TileMapRenderList_Draw(const TileMapRenderList* renderList)
+{
+    const TileMapDrawItem* items = renderList->items;
+    for (int32_t i = 0, n = renderList->count; i < n; i++)
+    {
+        Graphics_DrawSpriteBatch(&items[i].spriteBatch);
+    }
+}
+
 //! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
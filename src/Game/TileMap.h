@@ -49,10 +49,37 @@ typedef struct TileMapGrid
     int32_t         data[];         // Data, item value is zero mean no collision
 } TileMapGrid;
 
+/// TileMapDrawItem
+typedef struct TileMapDrawItem
+{
+    SpriteBatch     spriteBatch;    // Baked tiles of the layer, opacity of the layer included
+} TileMapDrawItem;
+
+/// TileMapRenderList
+/// Drawable layers of a level, compiled once at level load.
+/// Items are stored contiguous in draw order, drawing is a linear walk without lookups.
+typedef struct TileMapRenderList
+{
+    int32_t             count;
+    TileMapDrawItem*    items;
+} TileMapRenderList;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/// Compile the render list of level
+/// Layers are drawn in the order of level->layers (parse with LDtkParseFlags_LayerReverseOrder to draw bottom layer first),
+/// invisible, fully transparent and empty layers are skipped.
+/// spriteSheets are indexed by tileset index.
+bool TileMapRenderList_Build(TileMapRenderList* renderList, const LDtkLevel* level, const SpriteSheet* spriteSheets, int32_t spriteSheetCount);
+
+/// Destroy TileMapRenderList, release its sprite batches
+void TileMapRenderList_Destroy(TileMapRenderList* renderList);
+
+/// Draw all layers
+void TileMapRenderList_Draw(const TileMapRenderList* renderList);
+
 /// Create TileMapGrid from LDtkLayer
 TileMapGrid* TileMapGrid_FromLDtkLayer(const LDtkLayer* layer);
 
@@ -21,6 +21,8 @@ static SDL_GLContext    gGLContext;
 static uint32_t         gProgramDrawText;
 static uint32_t         gProgramDrawSprite;
 static uint32_t         gProgramSpriteBatch;
+static int32_t          gSpriteBatchProjectionLocation;
+static int32_t          gSpriteBatchOpacityLocation;
 
 static uint32_t         gVao;
 static uint32_t         gVbo;
@@ -89,9 +91,10 @@ static const char* fshader_sprite_batch_src =
     "in vec3 Color;"
     "out vec4 FragColor;"
     "uniform sampler2D Image;"
+    "uniform float Opacity;"
     "void main() {"
         //"FragColor = vec4(Color, 1.0);"
-        "FragColor = texture(Image, UV) * vec4(Color, 1.0);"
+        "FragColor = texture(Image, UV) * vec4(Color, Opacity);"
     "}";
 
 static uint32_t CreateShader(uint32_t type, const char* src)
@@ -254,6 +257,8 @@ GraphicsError Graphics_Setup(struct WindowDesc* window)
     gProgramDrawText = CreateProgram(vshader_draw_text_src, fshader_draw_text_src);
     gProgramDrawSprite = CreateProgram(vshader_src, fshader_src);
     gProgramSpriteBatch = CreateProgram(vshader_sprite_batch_src, fshader_sprite_batch_src);
+    gSpriteBatchProjectionLocation = glGetUniformLocation(gProgramSpriteBatch, "Projection");
+    gSpriteBatchOpacityLocation = glGetUniformLocation(gProgramSpriteBatch, "Opacity");
 
     glGenVertexArrays(1, &gVao);
     glGenBuffers(1, &gVbo);
@@ -535,26 +540,17 @@ void Graphics_DrawSpriteBatch(const SpriteBatch* spriteBatch)
 {
     assert(spriteBatch->state == SpriteBatchState_Idle);
 
+    // Vertices were uploaded by SpriteBatch_End, drawing only bind states
     glBindVertexArray(spriteBatch->vertexArrayId);
 
-    int vertexCount = spriteBatch->count * 6;
-
-    glBindBuffer(GL_ARRAY_BUFFER, spriteBatch->verticesBufferId);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vec2) * vertexCount, spriteBatch->vertices, GL_DYNAMIC_DRAW);
-
-    glBindBuffer(GL_ARRAY_BUFFER, spriteBatch->uvsBufferId);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vec2) * vertexCount, spriteBatch->uvs, GL_DYNAMIC_DRAW);
-
-    glBindBuffer(GL_ARRAY_BUFFER, spriteBatch->colorsBufferId);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vec3) * vertexCount, spriteBatch->colors, GL_DYNAMIC_DRAW);
-
     glUseProgram(gProgramSpriteBatch);
-    glUniformMatrix4fv(glGetUniformLocation(gProgramSpriteBatch, "Projection"), 1, false, (const float*)&gProjection);
+    glUniformMatrix4fv(gSpriteBatchProjectionLocation, 1, false, (const float*)&gProjection);
+    glUniform1f(gSpriteBatchOpacityLocation, spriteBatch->opacity);
 
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, spriteBatch->textureId);
 
-    glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+    glDrawArrays(GL_TRIANGLES, 0, spriteBatch->count * 6);
 }
 
 //! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
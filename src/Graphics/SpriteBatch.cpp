@@ -35,6 +35,7 @@ void SpriteBatch_Create(SpriteBatch* spriteBatch, const SpriteSheet* sheet, int3
 
     spriteBatch->count = 0;
     spriteBatch->capacity = capacity;
+    spriteBatch->opacity = 1.0f;
 
     int vertexCapacity = capacity * 6;
 
@@ -83,6 +84,17 @@ void SpriteBatch_End(SpriteBatch* spriteBatch)
 {
     assert(spriteBatch->state == SpriteBatchState_Batching);
 
+    const int32_t vertexCount = spriteBatch->count * 6;
+
+    glBindBuffer(GL_ARRAY_BUFFER, spriteBatch->verticesBufferId);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vec2) * vertexCount, spriteBatch->vertices, GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, spriteBatch->uvsBufferId);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vec2) * vertexCount, spriteBatch->uvs, GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, spriteBatch->colorsBufferId);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vec3) * vertexCount, spriteBatch->colors, GL_STATIC_DRAW);
+
     spriteBatch->state = SpriteBatchState_Idle;
 }
 
@@ -27,6 +27,8 @@ typedef struct SpriteBatch
     int32_t             count               __default_init(0);
     int32_t             capacity            __default_init(0);
 
+    float               opacity             __default_init(1.0f);
+
     vec2*               vertices            __default_init(nullptr);
     vec2*               uvs                 __default_init(nullptr);
     vec3*               colors              __default_init(nullptr);
@@ -40,6 +42,9 @@ void            SpriteBatch_Create(SpriteBatch* spriteBatch, const SpriteSheet*
 void            SpriteBatch_Destroy(SpriteBatch* spriteBatch);
 
 void            SpriteBatch_Begin(SpriteBatch* spriteBatch);
+
+/// Finish batching and upload the vertices to GPU
+/// Batches are meant to be built once and drawn many times
 void            SpriteBatch_End(SpriteBatch* spriteBatch);
 
 void            SpriteBatch_DrawSprite(SpriteBatch* spriteBatch, const Sprite* sprite, vec2 position, float rotation, vec2 scale, vec3 color);
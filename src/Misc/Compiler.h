@@ -6,7 +6,17 @@
 
 #if defined(__GNUC__)
 #   define __vectorcall  /* NO VECTORCALL SUPPORTED */
-#   define __forceinline static __attribute__((always_inline))
+#   if !defined(__forceinline)
+#   define __forceinline static __attribute__((always_inline)) // Same as vectormath, whichever header comes first
+#   endif
+#endif
+
+#if !defined(__noinline)
+#if defined(_MSC_VER)
+#   define __noinline __declspec(noinline)
+#else
+#   define __noinline __attribute__((noinline))
+#endif
 #endif
 
 #if !defined(__cplusplus) && !defined(constexpr)
@@ -7,6 +7,7 @@
 // -------------------------------------------------------------------
 
 #include <math.h>
+#include <float.h>
 #include <ctype.h>
 #include <stdio.h>
 #include <stdarg.h>
@@ -17,6 +18,16 @@
 #include <setjmp.h>
 #include <stdint.h>
 
+#include "Text/Utf8.h"
+#include "Misc/JsonPowers.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSON_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define JSON_USE_SSE2 0
+#endif
+
 // -------------------------------------------------------------------
 // Compiler options
 // -------------------------------------------------------------------
@@ -41,17 +52,118 @@
 #define JSON_ASSERT(cond, msg, ...) assert((cond) && (msg))
 #endif
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+JSON_INLINE int32_t Json_TrailingZeros(uint32_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int32_t)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+JSON_INLINE int32_t Json_TrailingZeros64(uint64_t mask)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return (int32_t)index;
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if ((uint32_t)mask != 0)
+    {
+        _BitScanForward(&index, (uint32_t)mask);
+        return (int32_t)index;
+    }
+
+    _BitScanForward(&index, (uint32_t)(mask >> 32));
+    return (int32_t)index + 32;
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+JSON_INLINE int32_t Json_LeadingZeros64(uint64_t mask)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanReverse64(&index, mask);
+    return 63 - (int32_t)index;
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if ((uint32_t)(mask >> 32) != 0)
+    {
+        _BitScanReverse(&index, (uint32_t)(mask >> 32));
+        return 31 - (int32_t)index;
+    }
+
+    _BitScanReverse(&index, (uint32_t)mask);
+    return 63 - (int32_t)index;
+#else
+    return __builtin_clzll(mask);
+#endif
+}
+
+JSON_INLINE int32_t Json_PopCount64(uint64_t mask)
+{
+#if defined(_MSC_VER)
+    // __popcnt64 need a POPCNT capable CPU
+    mask = mask - ((mask >> 1) & 0x5555555555555555ull);
+    mask = (mask & 0x3333333333333333ull) + ((mask >> 2) & 0x3333333333333333ull);
+    mask = (mask + (mask >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (int32_t)((mask * 0x0101010101010101ull) >> 56);
+#else
+    return __builtin_popcountll(mask);
+#endif
+}
+
+/* Full 64x64 bits product, return the low half */
+JSON_INLINE uint64_t Json_Multiply128(uint64_t a, uint64_t b, uint64_t* high)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    return _umul128(a, b, high);
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+    *high = __umulh(a, b);
+    return a * b;
+#elif defined(__SIZEOF_INT128__)
+    const __uint128_t product = (__uint128_t)a * b;
+    *high = (uint64_t)(product >> 64);
+    return (uint64_t)product;
+#else
+    const uint64_t aLow = (uint32_t)a, aHigh = a >> 32;
+    const uint64_t bLow = (uint32_t)b, bHigh = b >> 32;
+
+    const uint64_t lowLow   = aLow * bLow;
+    const uint64_t lowHigh  = aLow * bHigh;
+    const uint64_t highLow  = aHigh * bLow;
+    const uint64_t highHigh = aHigh * bHigh;
+
+    const uint64_t middle = (lowLow >> 32) + (uint32_t)lowHigh + (uint32_t)highLow;
+    *high = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+    return (middle << 32) | (uint32_t)lowLow;
+#endif
+}
+
 // -----------------------------------------------------------------------
 // Utility
 // -----------------------------------------------------------------------
 
 typedef struct JsonAllocator
 {
-    uint8_t*        buffer;
-    int32_t         length;
+    uint8_t*            buffer;
+    int32_t             length;
 
-    uint8_t*        lowerMarker;
-    uint8_t*        upperMarker;
+    uint8_t*            lowerMarker;
+    uint8_t*            upperMarker;
+
+    JsonAllocChunkFunc  allocChunk;     // Growable chunk mode, NULL for a fixed buffer
+    void*               userData;
+    int32_t             chunkUsage;     // Lower side of the previous chunks
 } JsonAllocator;
 
 static int32_t JsonAllocator_BlockSize(int32_t size)
@@ -78,10 +190,14 @@ static bool JsonAllocator_Init(JsonAllocator* allocator, void* buffer, int32_t b
 		const int32_t	adjustment	= (misalign != 0) * (alignment - misalign);
 
 		buffer = (void*)(address + adjustment);
-		bufferSize = JsonAllocator_BlockSize(bufferSize - adjustment);
+		bufferSize = (bufferSize - adjustment) & ~mask; // Upper blocks never run past the end of the buffer
 
         allocator->lowerMarker = (uint8_t*)buffer;
-        allocator->upperMarker = (uint8_t*)buffer + bufferSize;
+        allocator->upperMarker = (uint8_t*)buffer + (bufferSize > 0 ? bufferSize : 0);
+
+        allocator->allocChunk = NULL;
+        allocator->userData   = NULL;
+        allocator->chunkUsage = 0;
 
         return true;
     }
@@ -89,6 +205,38 @@ static bool JsonAllocator_Init(JsonAllocator* allocator, void* buffer, int32_t b
     return false;
 }
 
+/* @funcdef: JsonAllocator_NextChunk
+ * Growable chunk mode: continue in a new chunk with room for size bytes, the rest of the current chunk is left unused
+ */
+static bool JsonAllocator_NextChunk(JsonAllocator* allocator, int32_t size)
+{
+    const int32_t alignment = sizeof(Json);
+    if (!allocator->allocChunk || size > INT32_MAX - alignment)
+    {
+        return false;
+    }
+
+    // Chunks may be unaligned
+    const int32_t minSize = size + alignment - 1;
+
+    int32_t chunkSize = 0;
+    void* chunk = allocator->allocChunk(allocator->userData, minSize, &chunkSize);
+    if (!chunk || chunkSize < minSize)
+    {
+        return false;
+    }
+
+    const JsonAllocChunkFunc    allocChunk  = allocator->allocChunk;
+    void* const                 userData    = allocator->userData;
+    const int32_t               chunkUsage  = allocator->chunkUsage + (int32_t)(allocator->lowerMarker - allocator->buffer);
+
+    JsonAllocator_Init(allocator, chunk, chunkSize);
+    allocator->allocChunk = allocChunk;
+    allocator->userData   = userData;
+    allocator->chunkUsage = chunkUsage;
+    return true;
+}
+
 static int32_t JsonAllocator_RemainSize(JsonAllocator* allocator)
 {
 	int32_t remain = (int32_t)(allocator->upperMarker - allocator->lowerMarker);
@@ -104,8 +252,8 @@ static bool JsonAllocator_CanAlloc(JsonAllocator* allocator, int32_t size)
 static void JsonAllocator_FreeLower(JsonAllocator* allocator, void* buffer, int32_t size)
 {
 	const int32_t blockSize = JsonAllocator_BlockSize(size);
-	void* lastBuffer = allocator->lowerMarker - blockSize;
-	if (lastBuffer == buffer)
+	uint8_t* lastBuffer = allocator->lowerMarker - blockSize;
+	if (lastBuffer == buffer && lastBuffer >= allocator->buffer) // Blocks of a previous chunk are not freed
 	{
 		allocator->lowerMarker = lastBuffer;
 	}
@@ -121,7 +269,7 @@ static void* JsonAllocator_AllocLower(JsonAllocator* allocator, void* oldBuffer,
     }
 
 	const int32_t blockSize = JsonAllocator_BlockSize(newSize);
-    if (JsonAllocator_CanAlloc(allocator, blockSize))
+    if (JsonAllocator_CanAlloc(allocator, blockSize) || JsonAllocator_NextChunk(allocator, blockSize))
     {
         void* result = allocator->lowerMarker;
         allocator->lowerMarker += blockSize;
@@ -137,7 +285,10 @@ static void JsonAllocator_FreeUpper(JsonAllocator* allocator, void* buffer, int3
     if (lastBuffer == buffer)
     {
 		const int32_t blockSize = JsonAllocator_BlockSize(size);
-        allocator->upperMarker += blockSize;
+        if (allocator->upperMarker + blockSize <= allocator->buffer + allocator->length) // Blocks of a previous chunk are not freed
+        {
+            allocator->upperMarker += blockSize;
+        }
     }
 }
 
@@ -151,7 +302,7 @@ static void* JsonAllocator_AllocUpper(JsonAllocator* allocator, void* oldBuffer,
     }
 
 	const int32_t blockSize = JsonAllocator_BlockSize(newSize);
-    if (JsonAllocator_CanAlloc(allocator, blockSize))
+    if (JsonAllocator_CanAlloc(allocator, blockSize) || JsonAllocator_NextChunk(allocator, blockSize))
     {
         allocator->upperMarker -= blockSize;
         return allocator->upperMarker;
@@ -173,7 +324,7 @@ typedef struct JsonArray
 
 #define JsonArray_GetHeader(a)              ((JsonArray*)(a) - 1)
 #define JsonArray_Init()                    NULL
-#define JsonArray_Free(a, alloc)            JsonAllocator_FreeUpper(alloc, a ? JsonArray_GetHeader(a) : NULL, JsonArray_GetSize(a) * sizeof((a)[0]))
+#define JsonArray_Free(a, alloc)            JsonAllocator_FreeUpper(alloc, a ? JsonArray_GetHeader(a) : NULL, (int32_t)(sizeof(JsonArray) + JsonArray_GetSize(a) * sizeof((a)[0])))
 #define JsonArray_GetSize(a)                ((a) ? JsonArray_GetHeader(a)->size  : 0)
 #define JsonArray_GetCount(a)               ((a) ? JsonArray_GetHeader(a)->count : 0)
 #define JsonArray_GetAllocMemory(a)         (sizeof(JsonArray) + JsonArray_GetSize(a) * sizeof(*(a)))
@@ -198,11 +349,10 @@ JSON_INLINE void* JsonArray_Grow(void* array, int32_t reqsize, int32_t elemsize,
         return array;
     }
 
-    int32_t newSize = size;
-    while (newSize < reqsize)
-    {
-        newSize += 32;
-    }
+    // Grow geometrically, the whole array is copied on every growth (large arrays of numbers would be quadratic)
+    int32_t newSize = size + (size >> 1);
+    newSize = newSize < 32 ? 32 : newSize;
+    newSize = newSize < reqsize ? reqsize : newSize;
 
     JsonArray* newArray = (JsonArray*)JsonAllocator_AllocUpper(allocator, raw, sizeof(JsonArray) + size * elemsize, sizeof(JsonArray) + newSize * elemsize);
     if (newArray)
@@ -212,7 +362,7 @@ JSON_INLINE void* JsonArray_Grow(void* array, int32_t reqsize, int32_t elemsize,
 
         if (raw && count > 0)
         {
-            memcpy(newArray->buffer, raw->buffer, count * elemsize);
+            memmove(newArray->buffer, raw->buffer, count * elemsize); // Blocks overlap when the old one was the last
         }
 
         return newArray->buffer;
@@ -239,6 +389,18 @@ JsonTempArray: memory-wise array for containing parsing value
 #define JsonTempArray_Push(a, v, alloc)   ((a)->count >= (int32_t)(sizeof((a)->buffer) / sizeof((a)->buffer[0])) ? JsonArray_Push((a)->array, v, alloc) : ((a)->buffer[(a)->count++] = v, 1))
 #define JsonTempArray_GetCount(a)         ((a)->count + JsonArray_GetCount((a)->array))
 #define JsonTempArray_ToBuffer(a, alloc)  JsonTempArray_ToBufferFunc((a)->buffer, (a)->count, (a)->array, (int)sizeof((a)->buffer[0]), alloc)
+#define JsonTempArray_CopyTo(a, dest)     JsonTempArray_CopyToFunc(dest, (a)->buffer, (a)->count, (a)->array, (int)sizeof((a)->buffer[0]))
+
+JSON_INLINE void JsonTempArray_CopyToFunc(void* dest, void* buffer, int32_t count, void* dynamicBuffer, int32_t itemSize)
+{
+    const int32_t total = count + JsonArray_GetCount(dynamicBuffer);
+
+    memcpy(dest, buffer, count * itemSize);
+    if (total > count)
+    {
+        memcpy((char*)dest + count * itemSize, dynamicBuffer, (total - count) * itemSize);
+    }
+}
 
 JSON_INLINE void* JsonTempArray_ToBufferFunc(void* buffer, int32_t count, void* dynamicBuffer, int32_t itemSize, JsonAllocator* allocator)
 {
@@ -252,993 +414,5082 @@ JSON_INLINE void* JsonTempArray_ToBufferFunc(void* buffer, int32_t count, void*
         void* array = (JsonArray*)JsonAllocator_AllocLower(allocator, NULL, 0, size);
         if (array)
         {
-            memcpy(array, buffer, count * itemSize);
-            if (total > count)
-            {
-                memcpy((char*)array + count * itemSize, dynamicBuffer, (total - count) * itemSize);
-            }
+            JsonTempArray_CopyToFunc(array, buffer, count, dynamicBuffer, itemSize);
         }
         return array;
     }
     return NULL;
 }
 
-typedef struct JsonParser JsonParser;
-struct JsonParser
-{
-    JsonParseFlags      flags;
-
-    int32_t             line;
-    int32_t             column;
-    int32_t             cursor;
-    //JsonType            parsingType;
-    
-    int32_t             length;         /* Reference only */
-    const char*         buffer;         /* Reference only */
-    
-    JsonError           errnum;
-    char*               errmsg;
-    jmp_buf             errjmp;
-
-    JsonAllocator       allocator;      /* Runtime allocator */
-};
+// -------------------------------------------------------------------
+// Object member index
+// -------------------------------------------------------------------
 
-static void JsonParser_SetErrorWithArgs(JsonParser* parser, JsonType type, JsonError code, const char* fmt, va_list valist)
+/*
+JsonObjectSlot: hash index of the members of large objects
+Objects with JSON_OBJECT_INDEX_MIN members or more are allocated with a table of slots
+right after their members (open addressing, linear probing, at most half full).
+Smaller objects are scanned, a few string compares are cheaper than hashing.
+@note: internal only
+*/
+typedef struct JsonObjectSlot
 {
-    const int errmsg_size = 1024;
+    uint32_t        hash;
+    int32_t         member;             // Index of the member, -1 for empty slots
+} JsonObjectSlot;
 
-    const char* type_name;
-    switch (type)
+/* @funcdef: Json_HashName
+ * FNV-1a
+ */
+JSON_INLINE uint32_t Json_HashName(const char* name, int32_t length)
+{
+    uint32_t hash = 2166136261u;
+    for (int32_t i = 0; i < length; i++)
     {
-    case JsonType_Null:
-        type_name = "null";
-        break;
+        hash ^= (uint8_t)name[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
 
-    case JsonType_Boolean:
-        type_name = "boolean";
-        break;
+JSON_INLINE int32_t JsonObject_SlotCount(int32_t memberCount)
+{
+    int32_t slotCount = JSON_OBJECT_INDEX_MIN * 2;
+    while (slotCount < memberCount * 2)
+    {
+        slotCount *= 2;
+    }
+    return slotCount;
+}
 
-    case JsonType_Number:
-        type_name = "number";
-        break;
+/* @funcdef: JsonObject_AllocSize
+ * Size of the members block of an object, with the index of large objects
+ */
+JSON_INLINE int32_t JsonObject_AllocSize(int32_t memberCount)
+{
+    int32_t size = JsonAllocator_BlockSize(memberCount * (int32_t)sizeof(JsonObjectMember));
+    if (memberCount >= JSON_OBJECT_INDEX_MIN)
+    {
+        size += JsonObject_SlotCount(memberCount) * (int32_t)sizeof(JsonObjectSlot);
+    }
+    return size;
+}
 
-    case JsonType_Array:
-        type_name = "array";
-        break;
+JSON_INLINE JsonObjectSlot* JsonObject_GetIndex(const JsonObjectMember* members, int32_t memberCount)
+{
+    return (JsonObjectSlot*)((uint8_t*)members + JsonAllocator_BlockSize(memberCount * (int32_t)sizeof(JsonObjectMember)));
+}
 
-    case JsonType_String:
-        type_name = "string";
-        break;
+/* @funcdef: JsonObject_NameEquals
+ * Exact match, empty names are stored as NULL, key names are null-terminated
+ */
+JSON_INLINE bool JsonObject_NameEquals(const JsonObjectMember* member, const char* name)
+{
+    const char* memberName = member->name ? member->name : "";
+    return memberName[0] == name[0] && strcmp(memberName, name) == 0;
+}
 
-    case JsonType_Object:
-        type_name = "object";
-        break;
+/* @funcdef: JsonObject_BuildIndex */
+static void JsonObject_BuildIndex(JsonObjectMember* members, int32_t memberCount)
+{
+    JsonObjectSlot* slots = JsonObject_GetIndex(members, memberCount);
+    const int32_t slotCount = JsonObject_SlotCount(memberCount);
+    const int32_t mask = slotCount - 1;
 
-    default:
-        type_name = "unknown";
-        break;
+    for (int32_t i = 0; i < slotCount; i++)
+    {
+        slots[i].hash = 0;
+        slots[i].member = -1;
     }
 
-    parser->errnum = code;
-    if (parser->errmsg == NULL)
+    // Duplicated names probe in member order, lookups find the first one like a scan does
+    for (int32_t i = 0; i < memberCount; i++)
     {
-        parser->errmsg = (char*)JsonAllocator_AllocUpper(&parser->allocator, NULL, 0, errmsg_size);
-    }
+        const char* name = members[i].name ? members[i].name : "";
+        const uint32_t hash = Json_HashName(name, (int32_t)strlen(name));
 
-    char final_format[1024];
-    char templ_format[1024] = "%s\n\tAt line %d, column %d. Parsing token: <%s>.";
+        int32_t slot = (int32_t)(hash & (uint32_t)mask);
+        while (slots[slot].member >= 0)
+        {
+            slot = (slot + 1) & mask;
+        }
 
-#if defined(_MSC_VER) && _MSC_VER >= 1200
-    sprintf_s(final_format, sizeof(final_format), templ_format, fmt, parser->line, parser->column, type_name);
-    sprintf_s(parser->errmsg, errmsg_size, final_format, valist);
-#else
-    sprintf(final_format, templ_format, fmt, parser->line, parser->column, type_name);
-    sprintf(parser->errmsg, final_format, valist);
-#endif
+        slots[slot].hash = hash;
+        slots[slot].member = i;
+    }
 }
 
-/* @funcdef: JsonParser_SetError */
-static void JsonParser_SetError(JsonParser* parser, JsonType type, JsonError code, const char* fmt, ...)
+/* @funcdef: JsonObject_FindMember */
+static const JsonObjectMember* JsonObject_FindMember(const Json parent, const JsonKey* key)
 {
-    va_list varg;
-    va_start(varg, fmt);
-    JsonParser_SetErrorWithArgs(parser, type, code, fmt, varg);
-    va_end(varg);
-}
+    const JsonObjectMember* members = parent.object;
+    const int32_t memberCount = parent.length;
 
-/* funcdef: JsonParser_Panic */
-static void JsonParser_Panic(JsonParser* parser, JsonType type, JsonError code, const char* fmt, ...)
-{
-    va_list varg;
-    va_start(varg, fmt);
-    JsonParser_SetErrorWithArgs(parser, type, code, fmt, varg);
-    va_end(varg);
+    // Only the parser put an index after the members, objects built by hand are scanned
+    if (parent.indexed)
+    {
+        const JsonObjectSlot* slots = JsonObject_GetIndex(members, memberCount);
+        const int32_t mask = JsonObject_SlotCount(memberCount) - 1;
 
-    longjmp(parser->errjmp, code);
+        int32_t slot = (int32_t)(key->hash & (uint32_t)mask);
+        while (slots[slot].member >= 0)
+        {
+            const JsonObjectMember* member = &members[slots[slot].member];
+            if (slots[slot].hash == key->hash && JsonObject_NameEquals(member, key->name))
+            {
+                return member;
+            }
+
+            slot = (slot + 1) & mask;
+        }
+
+        return NULL;
+    }
+
+    for (int32_t i = 0; i < memberCount; i++)
+    {
+        if (JsonObject_NameEquals(&members[i], key->name))
+        {
+            return &members[i];
+        }
+    }
+
+    return NULL;
 }
 
-/* @funcdef: JsonParser_Init */
-static bool JsonParser_Init(JsonParser* parser, const char* jsonCode, int32_t jsonLength, JsonAllocator allocator, JsonParseFlags flags)
-{
-    JSON_ASSERT(parser, "parser mustnot be null");
+// -------------------------------------------------------------------
+// Structural index (stage 1)
+// -------------------------------------------------------------------
 
-    parser->flags        = flags;
+/*
+JsonStructuralIndex: positions of the tokens of the document, found 64 bytes at once
+Every block is classified into bit masks (quotes, backslashes, whitespaces, operators),
+escaped quotes are removed and string ranges are computed with a prefix-xor. The index
+hold the operators and the first byte of every scalar outside strings, the quotes, and
+inside strings the escaping backslashes and the line breaks (errors).
+The parser jump from token to token instead of reading whitespaces and strings byte by byte.
+Positions are produced on demand in a small window, the index never allocate.
+@note: internal only
+*/
 
-	parser->line         = 1;
-	parser->column       = 1;
-	parser->cursor       = 0;
-	parser->buffer       = jsonCode;
-	parser->length       = jsonLength;
+#define JSON_STRUCTURAL_WINDOW  512
+#define JSON_BLOCK_SIZE         64
 
-	parser->errmsg       = "Success!";
-	parser->errnum       = JsonError_None;
+typedef struct JsonStructuralIndex
+{
+    const char*     buffer;
+    int32_t         length;
+    int32_t         blockCursor;        // Start of the next block to classify
 
-    parser->allocator    = allocator;
+    uint64_t        prevInString;       // All ones when the last block end inside a string
+    uint64_t        prevEscaped;        // 1 when the last byte of the last block is an escaping backslash
+    uint64_t        prevScalar;         // 1 when the last byte of the last block is part of a scalar
 
-    return true;
-}
+    int32_t         next;
+    int32_t         count;
+    int32_t         positions[JSON_STRUCTURAL_WINDOW];
+} JsonStructuralIndex;
 
-/* @funcdef: JsonParser_IsAtEnd */
-static int JsonParser_IsAtEnd(const JsonParser* parser)
+typedef struct JsonBlockMasks
 {
-    return parser->cursor >= parser->length || parser->buffer[parser->cursor] <= 0;
-}
+    uint64_t        quote;
+    uint64_t        backslash;
+    uint64_t        space;
+    uint64_t        op;
+    uint64_t        separator;          // ',' and ':', operators too
+    uint64_t        lineBreak;          // '\n', '\r' and '\0', they are not allowed in strings
+} JsonBlockMasks;
+
+typedef struct JsonBlockTokens
+{
+    uint64_t        op;                 // Operators outside strings
+    uint64_t        separator;          // ',' and ':' outside strings
+    uint64_t        value;              // First byte of scalars and strings
+    uint64_t        structural;         // What the index hold
+} JsonBlockTokens;
 
-/* @funcdef: JsonParser_PeekChar */
-static int JsonParser_PeekChar(const JsonParser* parser)
+static void JsonStructuralIndex_Init(JsonStructuralIndex* index, const char* buffer, int32_t length)
 {
-    return parser->buffer[parser->cursor];
+    index->buffer       = buffer;
+    index->length       = length;
+    index->blockCursor  = 0;
+
+    index->prevInString = 0;
+    index->prevEscaped  = 0;
+    index->prevScalar   = 0;
+
+    index->next         = 0;
+    index->count        = 0;
 }
 
-/* @funcdef: JsonParser_NextChar */
-static int JsonParser_NextChar(JsonParser* parser)
+/* @funcdef: JsonStructuralIndex_Seek
+ * Restart indexing at position, it must be outside strings, on an operator or right after one
+ */
+static void JsonStructuralIndex_Seek(JsonStructuralIndex* index, int32_t position)
 {
-    if (JsonParser_IsAtEnd(parser))
-    {
-		return -1;
-    }
-    else
-    {
-		int c = parser->buffer[++parser->cursor];
+    index->blockCursor  = position;
 
-		if (c == '\n')
-		{
-			parser->line++;
-			parser->column = 1;
-		}
-		else
-		{
-			parser->column = parser->column + 1;
-		}
-		
-		return c;
-    }
+    index->prevInString = 0;
+    index->prevEscaped  = 0;
+    index->prevScalar   = 0;
+
+    index->next         = 0;
+    index->count        = 0;
 }
 
-/* @funcdef: JsonParser_NextLine */
-static int JsonParser_NextLine(JsonParser* parser)
+/* @funcdef: JsonStructuralIndex_Classify */
+JSON_INLINE void JsonStructuralIndex_Classify(const char* block, JsonBlockMasks* masks)
 {
-    if (JsonParser_IsAtEnd(parser))
+    masks->quote        = 0;
+    masks->backslash    = 0;
+    masks->space        = 0;
+    masks->op           = 0;
+    masks->separator    = 0;
+    masks->lineBreak    = 0;
+
+#if JSON_USE_SSE2
+    const __m128i quote         = _mm_set1_epi8('"');
+    const __m128i backslash     = _mm_set1_epi8('\\');
+    const __m128i space         = _mm_set1_epi8(' ');
+    const __m128i tab           = _mm_set1_epi8('\t');
+    const __m128i newline       = _mm_set1_epi8('\n');
+    const __m128i carriage      = _mm_set1_epi8('\r');
+    const __m128i lowerCase     = _mm_set1_epi8(0x20);
+    const __m128i openBrace     = _mm_set1_epi8('{');
+    const __m128i closeBrace    = _mm_set1_epi8('}');
+    const __m128i colon         = _mm_set1_epi8(':');
+    const __m128i comma         = _mm_set1_epi8(',');
+    const __m128i zero          = _mm_setzero_si128();
+
+    for (int32_t i = 0; i < JSON_BLOCK_SIZE; i += 16)
     {
-        return -1;
+        const __m128i chars = _mm_loadu_si128((const __m128i*)(block + i));
+
+        const __m128i isNewline = _mm_or_si128(_mm_cmpeq_epi8(chars, newline), _mm_cmpeq_epi8(chars, carriage));
+        const __m128i isLineBreak = _mm_or_si128(isNewline, _mm_cmpeq_epi8(chars, zero));
+        const __m128i isSpace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chars, space), _mm_cmpeq_epi8(chars, tab)), isNewline);
+
+        // '[' and ']' differ from '{' and '}' by the 0x20 bit only
+        const __m128i folded = _mm_or_si128(chars, lowerCase);
+        const __m128i isSeparator = _mm_or_si128(_mm_cmpeq_epi8(chars, colon), _mm_cmpeq_epi8(chars, comma));
+        const __m128i isOp = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(folded, openBrace), _mm_cmpeq_epi8(folded, closeBrace)),
+            isSeparator);
+
+        masks->quote        |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chars, quote)) << i;
+        masks->backslash    |= (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(chars, backslash)) << i;
+        masks->space        |= (uint64_t)(uint32_t)_mm_movemask_epi8(isSpace) << i;
+        masks->op           |= (uint64_t)(uint32_t)_mm_movemask_epi8(isOp) << i;
+        masks->separator    |= (uint64_t)(uint32_t)_mm_movemask_epi8(isSeparator) << i;
+        masks->lineBreak    |= (uint64_t)(uint32_t)_mm_movemask_epi8(isLineBreak) << i;
     }
-    else
+#else
+    for (int32_t i = 0; i < JSON_BLOCK_SIZE; i++)
     {
-        int c = parser->buffer[parser->cursor];
-        while (c != '\n')
+        const uint64_t bit = 1ull << i;
+        switch (block[i])
         {
-            c = parser->buffer[++parser->cursor];
-        }
+        case '"':
+            masks->quote |= bit;
+            break;
 
-        c = parser->buffer[++parser->cursor];
-        parser->line++;
-        parser->column = 1;
-        return c;
+        case '\\':
+            masks->backslash |= bit;
+            break;
+
+        case '\n': case '\r':
+            masks->space |= bit;
+            masks->lineBreak |= bit;
+            break;
+
+        case ' ': case '\t':
+            masks->space |= bit;
+            break;
+
+        case '\0':
+            masks->lineBreak |= bit;
+            break;
+
+        case '{': case '}': case '[': case ']':
+            masks->op |= bit;
+            break;
+
+        case ':': case ',':
+            masks->op |= bit;
+            masks->separator |= bit;
+            break;
+
+        default:
+            break;
+        }
     }
+#endif
 }
 
-/* @funcdef: JsonParser_SkipSpace */
-static int JsonParser_SkipSpace(JsonParser* parser)
+/* @funcdef: JsonStructuralIndex_PrefixXor
+ * Bit i of the result is the parity of the bits 0..i, turn quote bits into string ranges
+ */
+JSON_INLINE uint64_t JsonStructuralIndex_PrefixXor(uint64_t bits)
 {
-    int c = JsonParser_PeekChar(parser);
-    while (c > 0 && isspace(c))
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+/* @funcdef: JsonStructuralIndex_Escaped
+ * Mask of the characters escaped by a backslash, a run of backslashes escape every other one
+ */
+JSON_INLINE uint64_t JsonStructuralIndex_Escaped(JsonStructuralIndex* index, uint64_t backslash)
+{
+    const uint64_t oddBits = 0xAAAAAAAAAAAAAAAAull;
+
+    if (backslash == 0)
     {
-		c = JsonParser_NextChar(parser);
+        const uint64_t escaped = index->prevEscaped;
+        index->prevEscaped = 0;
+        return escaped;
     }
-    return c;
+
+    // Subtracting the start of every run carry through the run, the carry parity tell which bits are escaped
+    const uint64_t potentialEscape  = backslash & ~index->prevEscaped;
+    const uint64_t maybeEscaped     = (potentialEscape << 1) | oddBits;
+    const uint64_t escapeAndTerminal = (maybeEscaped - potentialEscape) ^ oddBits;
+    const uint64_t escaped          = escapeAndTerminal ^ (backslash | index->prevEscaped);
+
+    index->prevEscaped = (escapeAndTerminal & backslash) >> 63;
+    return escaped;
 }
 
-/* @funcdef: JsonParser_MatchChar */
-static int JsonParser_MatchChar(JsonParser* parser, JsonType type, int c)
+/* @funcdef: JsonStructuralIndex_ClassifyNext
+ * Classify the block at blockCursor then move to the next one, bytes past the end of the document are masked out
+ */
+JSON_INLINE void JsonStructuralIndex_ClassifyNext(JsonStructuralIndex* index, JsonBlockTokens* tokens)
 {
-    if (JsonParser_PeekChar(parser) == c)
+    const int32_t   start   = index->blockCursor;
+    const int32_t   remain  = index->length - start;
+    const char*     block   = index->buffer + start;
+
+    // Pad the last block with whitespaces, never read past the end of the document
+    char padded[JSON_BLOCK_SIZE];
+    if (remain < JSON_BLOCK_SIZE)
+    {
+        memset(padded, ' ', sizeof(padded));
+        memcpy(padded, block, (size_t)remain);
+        block = padded;
+    }
+
+    JsonBlockMasks masks;
+    JsonStructuralIndex_Classify(block, &masks);
+
+    const uint64_t escaped  = JsonStructuralIndex_Escaped(index, masks.backslash);
+    const uint64_t quote    = masks.quote & ~escaped;
+
+    // Opening quotes are inside their string range, closing quotes are not
+    const uint64_t inString = JsonStructuralIndex_PrefixXor(quote) ^ index->prevInString;
+    index->prevInString = (uint64_t)(-(int64_t)(inString >> 63));
+
+    // Scalars (numbers, literals, garbage) are indexed by their first byte
+    const uint64_t scalar       = ~(masks.op | masks.space | quote) & ~inString;
+    const uint64_t scalarStart  = scalar & ~((scalar << 1) | index->prevScalar);
+    index->prevScalar = scalar >> 63;
+
+    // Inside strings, only the bytes that stop a string scan are indexed
+    const uint64_t escape       = masks.backslash & ~escaped;
+    const uint64_t stringStops  = (escape | masks.lineBreak) & inString;
+
+    tokens->op          = masks.op & ~inString;
+    tokens->separator   = masks.separator & ~inString;
+    tokens->value       = scalarStart | (quote & inString);
+    tokens->structural  = tokens->op | quote | scalarStart | stringStops;
+    if (remain < JSON_BLOCK_SIZE)
+    {
+        const uint64_t mask = (1ull << remain) - 1;
+        tokens->op          &= mask;
+        tokens->separator   &= mask;
+        tokens->value       &= mask;
+        tokens->structural  &= mask;
+    }
+
+    index->blockCursor = start + JSON_BLOCK_SIZE;
+}
+
+/* @funcdef: JsonStructuralIndex_IndexBlock */
+static void JsonStructuralIndex_IndexBlock(JsonStructuralIndex* index)
+{
+    const int32_t start = index->blockCursor;
+
+    JsonBlockTokens tokens;
+    JsonStructuralIndex_ClassifyNext(index, &tokens);
+
+    uint64_t structurals = tokens.structural;
+    int32_t count = index->count;
+    while (structurals != 0)
+    {
+        index->positions[count++] = start + Json_TrailingZeros64(structurals);
+        structurals &= structurals - 1;
+    }
+
+    index->count = count;
+}
+
+/* @funcdef: JsonStructuralIndex_Refill
+ * Classify blocks until the window is full, return false at the end of the document
+ */
+static bool JsonStructuralIndex_Refill(JsonStructuralIndex* index)
+{
+    if (index->blockCursor >= index->length)
+    {
+        return false;
+    }
+
+    index->next = 0;
+    index->count = 0;
+    while (index->blockCursor < index->length && index->count + JSON_BLOCK_SIZE <= JSON_STRUCTURAL_WINDOW)
+    {
+        JsonStructuralIndex_IndexBlock(index);
+    }
+
+    return true;
+}
+
+/* @funcdef: JsonStructuralIndex_NextAfter
+ * Position of the first token after cursor, length of the document when there is none
+ */
+JSON_INLINE int32_t JsonStructuralIndex_NextAfter(JsonStructuralIndex* index, int32_t cursor)
+{
+    while (true)
+    {
+        while (index->next < index->count)
+        {
+            const int32_t position = index->positions[index->next];
+            if (position > cursor)
+            {
+                return position;
+            }
+
+            index->next++;
+        }
+
+        if (!JsonStructuralIndex_Refill(index))
+        {
+            return index->length;
+        }
+    }
+}
+
+// -------------------------------------------------------------------
+// Parser (stage 2)
+// -------------------------------------------------------------------
+
+typedef struct JsonParser JsonParser;
+struct JsonParser
+{
+    JsonParseFlags      flags;
+
+    int32_t             cursor;
+    //JsonType            parsingType;
+    
+    int32_t             length;         /* Reference only */
+    const char*         buffer;         /* Reference only */
+
+    bool                useIndex;       /* Comments are not indexed, skip whitespaces byte by byte with them */
+    JsonStructuralIndex index;
+    
+    JsonError           errnum;
+    char*               errmsg;
+    jmp_buf             errjmp;
+
+    JsonAllocator       allocator;      /* Runtime allocator */
+
+    JsonParallelForFunc parallelFor;    /* Large arrays are split across workers when set */
+    int32_t             serialUntil;    /* End of the last array too small to be split, its children are not scanned again */
+    bool                inWorker;       /* Chunk of a parallel array, errors get their position on the calling thread */
+    JsonType            errtype;
+
+    JsonSkipFunc        skip;           /* Arrays and objects it return true for are parsed as null */
+    void*               skipUserData;
+    int32_t             depth;          /* Arrays and objects around the one being parsed, tracked for skip only */
+    const char*         name;           /* Member name of the one being parsed, tracked for skip only */
+};
+
+static void JsonParser_SetErrorWithArgs(JsonParser* parser, JsonType type, JsonError code, const char* fmt, va_list valist)
+{
+    const int errmsg_size = 1024;
+
+    const char* type_name;
+    switch (type)
+    {
+    case JsonType_Null:
+        type_name = "null";
+        break;
+
+    case JsonType_Boolean:
+        type_name = "boolean";
+        break;
+
+    case JsonType_Number:
+        type_name = "number";
+        break;
+
+    case JsonType_Array:
+        type_name = "array";
+        break;
+
+    case JsonType_String:
+        type_name = "string";
+        break;
+
+    case JsonType_Object:
+        type_name = "object";
+        break;
+
+    default:
+        type_name = "unknown";
+        break;
+    }
+
+    parser->errnum = code;
+    parser->errtype = type;
+    if (parser->errmsg == NULL)
+    {
+        parser->errmsg = (char*)JsonAllocator_AllocUpper(&parser->allocator, NULL, 0, errmsg_size);
+        if (parser->errmsg == NULL)
+        {
+            return; // No room left for the message, JsonParse report the error code only
+        }
+    }
+
+    // Other chunks may be decoded in situ meanwhile, lines are counted after the workers are done
+    if (parser->inWorker)
+    {
+        vsnprintf(parser->errmsg, errmsg_size, fmt, valist);
+        return;
+    }
+
+    // Lines are only counted on error, the parser jump over whitespaces
+    int32_t line = 1;
+    int32_t lineStart = 0;
+    for (int32_t i = 0; i < parser->cursor && i < parser->length; i++)
+    {
+        if (parser->buffer[i] == '\n')
+        {
+            line++;
+            lineStart = i + 1;
+        }
+    }
+    const int32_t column = parser->cursor - lineStart + 1;
+
+    char final_format[1024];
+    char templ_format[1024] = "%s\n\tAt line %d, column %d. Parsing token: <%s>.";
+
+    snprintf(final_format, sizeof(final_format), templ_format, fmt, line, column, type_name);
+    vsnprintf(parser->errmsg, errmsg_size, final_format, valist);
+}
+
+/* @funcdef: JsonParser_SetError */
+static void JsonParser_SetError(JsonParser* parser, JsonType type, JsonError code, const char* fmt, ...)
+{
+    va_list varg;
+    va_start(varg, fmt);
+    JsonParser_SetErrorWithArgs(parser, type, code, fmt, varg);
+    va_end(varg);
+}
+
+/* funcdef: JsonParser_Panic */
+static void JsonParser_Panic(JsonParser* parser, JsonType type, JsonError code, const char* fmt, ...)
+{
+    va_list varg;
+    va_start(varg, fmt);
+    JsonParser_SetErrorWithArgs(parser, type, code, fmt, varg);
+    va_end(varg);
+
+    longjmp(parser->errjmp, code);
+}
+
+/* @funcdef: JsonParser_Init */
+static bool JsonParser_Init(JsonParser* parser, const char* jsonCode, int32_t jsonLength, JsonAllocator allocator, JsonParseFlags flags)
+{
+    JSON_ASSERT(parser, "parser mustnot be null");
+
+    parser->flags        = flags;
+
+	parser->cursor       = 0;
+	parser->buffer       = jsonCode;
+	parser->length       = jsonLength;
+
+    parser->useIndex     = !(flags & JsonParseFlags_SupportComment);
+    JsonStructuralIndex_Init(&parser->index, jsonCode, jsonLength);
+
+	parser->errmsg       = NULL;
+	parser->errnum       = JsonError_None;
+
+    parser->allocator    = allocator;
+
+    parser->parallelFor  = NULL;
+    parser->serialUntil  = 0;
+    parser->inWorker     = false;
+    parser->errtype      = JsonType_Null;
+
+    parser->skip         = NULL;
+    parser->skipUserData = NULL;
+    parser->depth        = 0;
+    parser->name         = NULL;
+
+    return true;
+}
+
+/* @funcdef: JsonParser_IsAtEnd */
+static int JsonParser_IsAtEnd(const JsonParser* parser)
+{
+    return parser->cursor >= parser->length || parser->buffer[parser->cursor] == '\0';
+}
+
+/* @funcdef: JsonParser_PeekChar */
+static int JsonParser_PeekChar(const JsonParser* parser)
+{
+    // Bytes are unsigned, so UTF-8 sequences are not mistaken for the end
+    return JsonParser_IsAtEnd(parser) ? -1 : (uint8_t)parser->buffer[parser->cursor];
+}
+
+/* @funcdef: JsonParser_NextChar */
+static int JsonParser_NextChar(JsonParser* parser)
+{
+    if (JsonParser_IsAtEnd(parser))
+    {
+		return -1;
+    }
+    else
+    {
+		parser->cursor++;
+		return JsonParser_PeekChar(parser);
+    }
+}
+
+/* @funcdef: JsonParser_NextLine */
+static int JsonParser_NextLine(JsonParser* parser)
+{
+    int c = JsonParser_PeekChar(parser);
+    while (c > 0 && c != '\n')
+    {
+        parser->cursor++;
+        c = JsonParser_PeekChar(parser);
+    }
+
+    if (c == '\n')
+    {
+        parser->cursor++;
+    }
+
+    return JsonParser_PeekChar(parser);
+}
+
+/* @funcdef: JsonParser_SkipComment
+ * Skip one comment, cursor is at its first '/'
+ */
+static void JsonParser_SkipComment(JsonParser* parser)
+{
+    const int c = JsonParser_NextChar(parser);
+    if (c == '/')
+    {
+        JsonParser_NextLine(parser);
+    }
+    else if (c == '*')
+    {
+        int c0 = JsonParser_NextChar(parser);
+        int c1 = JsonParser_NextChar(parser);
+        while (c0 != '*' || c1 != '/')
+        {
+            if (c1 < 0)
+            {
+                JsonParser_Panic(parser, JsonType_Null, JsonError_UnmatchToken, "Unterminated comment");
+            }
+
+            c0 = c1;
+            c1 = JsonParser_NextChar(parser);
+        }
+
+        JsonParser_NextChar(parser);
+    }
+    else
+    {
+        JsonParser_Panic(parser, JsonType_Null, JsonError_UnexpectedToken, "Unexpected token '%c'", c);
+    }
+}
+
+/* @funcdef: JsonParser_IsSpace */
+JSON_INLINE bool JsonParser_IsSpace(int c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/* @funcdef: JsonParser_SkipSpace
+ * With the structural index, a whitespace is always followed by whitespaces up to the next token.
+ * Comments are not indexed, documents with comments are read byte by byte.
+ */
+static int JsonParser_SkipSpace(JsonParser* parser)
+{
+    int c = JsonParser_PeekChar(parser);
+    if (parser->useIndex)
+    {
+        if (JsonParser_IsSpace(c))
+        {
+            parser->cursor = JsonStructuralIndex_NextAfter(&parser->index, parser->cursor);
+            c = JsonParser_PeekChar(parser);
+        }
+
+        return c;
+    }
+
+    while (true)
+    {
+        while (JsonParser_IsSpace(c))
+        {
+            c = JsonParser_NextChar(parser);
+        }
+
+        if (c != '/' || !(parser->flags & JsonParseFlags_SupportComment))
+        {
+            return c;
+        }
+
+        JsonParser_SkipComment(parser);
+        c = JsonParser_PeekChar(parser);
+    }
+}
+
+/* @funcdef: JsonParser_MatchChar */
+static int JsonParser_MatchChar(JsonParser* parser, JsonType type, int c)
+{
+    if (JsonParser_PeekChar(parser) == c)
     {
 		return JsonParser_NextChar(parser);
     }
     else
     {
-        JsonParser_Panic(parser, type, JsonError_UnmatchToken, "Expected '%c'", (char)c);
-		return -1;
+        JsonParser_Panic(parser, type, JsonError_UnmatchToken, "Expected '%c'", (char)c);
+		return -1;
+    }
+}
+
+/* All parse functions declaration */
+
+static void JsonParser_ParseArray(JsonParser* parser, Json* outValue);
+static void JsonParser_ParseSingle(JsonParser* parser, Json* outValue);
+static void JsonParser_ParseObject(JsonParser* parser, Json* outValue);
+static void JsonParser_ParseNumber(JsonParser* parser, Json* outValue);
+static void JsonParser_ParseString(JsonParser* parser, Json* outValue);
+static bool JsonParser_ParseArrayParallel(JsonParser* parser, Json* outValue);
+
+// -------------------------------------------------------------------
+// Number parsing
+// -------------------------------------------------------------------
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define JSON_USE_SWAR 0
+#else
+#define JSON_USE_SWAR 1
+#endif
+
+#define JSON_MAX_MANTISSA_DIGITS    19
+#define JSON_MAX_NUMBER_LENGTH      1024
+
+/* @funcdef: Json_IsEightDigits
+ * All the 8 bytes of chunk are '0'..'9'
+ */
+JSON_INLINE bool Json_IsEightDigits(uint64_t chunk)
+{
+    return ((chunk & 0xF0F0F0F0F0F0F0F0ull) | (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+}
+
+/* @funcdef: Json_ParseEightDigits
+ * Value of 8 digits loaded in little-endian order, digits are combined by pairs, then quads, then the halves
+ */
+JSON_INLINE uint32_t Json_ParseEightDigits(uint64_t chunk)
+{
+    const uint64_t mask = 0x000000FF000000FFull;
+    const uint64_t mul1 = 100 + (1000000ull << 32);
+    const uint64_t mul2 = 1 + (10000ull << 32);
+
+    chunk -= 0x3030303030303030ull;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+    return (uint32_t)chunk;
+}
+
+JSON_INLINE bool Json_IsDigit(int c)
+{
+    return (unsigned)(c - '0') < 10;
+}
+
+/* @funcdef: JsonParser_ParseDigits
+ * Accumulate the digits from cursor into value (wrap on overflow, digits are counted by the caller)
+ * Return the position of the first byte that is not a digit
+ */
+JSON_INLINE int32_t JsonParser_ParseDigits(const char* buffer, int32_t length, int32_t cursor, uint64_t* value)
+{
+    uint64_t result = *value;
+
+#if JSON_USE_SWAR
+    while (cursor + 8 <= length)
+    {
+        uint64_t chunk;
+        memcpy(&chunk, buffer + cursor, sizeof(chunk));
+        if (!Json_IsEightDigits(chunk))
+        {
+            break;
+        }
+
+        result = result * 100000000 + Json_ParseEightDigits(chunk);
+        cursor += 8;
+    }
+#endif
+
+    while (cursor < length && Json_IsDigit(buffer[cursor]))
+    {
+        result = result * 10 + (uint64_t)(buffer[cursor] - '0');
+        cursor++;
+    }
+
+    *value = result;
+    return cursor;
+}
+
+/* @funcdef: Json_EiselLemire
+ * Round mantissa * 10^exponent to the nearest double (mantissa has at most 19 digits)
+ * Return the bits of the double without the sign
+ */
+static uint64_t Json_EiselLemire(uint64_t mantissa, int32_t exponent)
+{
+    const int32_t mantissaBits  = 52;
+    const int32_t minExponent   = -1023;
+    const int32_t infinitePower = 0x7FF;
+
+    if (mantissa == 0 || exponent < JSON_SMALLEST_POWER_OF_TEN)
+    {
+        return 0;
+    }
+
+    if (exponent > JSON_LARGEST_POWER_OF_TEN)
+    {
+        return (uint64_t)infinitePower << mantissaBits;
+    }
+
+    // Normalize the mantissa, multiply by the truncated power of five
+    const int32_t leadingZeros = Json_LeadingZeros64(mantissa);
+    mantissa <<= leadingZeros;
+
+    const uint64_t* power = &JSON_POWERS_OF_FIVE[2 * (exponent - JSON_SMALLEST_POWER_OF_TEN)];
+
+    uint64_t high;
+    uint64_t low = Json_Multiply128(mantissa, power[0], &high);
+
+    // The lower bits of the product can only be wrong when they are all ones, refine with the low word of the power
+    const uint64_t precisionMask = 0xFFFFFFFFFFFFFFFFull >> (mantissaBits + 3);
+    if ((high & precisionMask) == precisionMask)
+    {
+        uint64_t secondHigh;
+        Json_Multiply128(mantissa, power[1], &secondHigh);
+
+        low += secondHigh;
+        if (secondHigh > low)
+        {
+            high++;
+        }
+    }
+
+    const int32_t upperBit  = (int32_t)(high >> 63);
+    const int32_t shift     = upperBit + 64 - mantissaBits - 3;
+
+    uint64_t    bits        = high >> shift;
+    int32_t     power2      = (int32_t)((((152170 + 65536) * exponent) >> 16) + 63) + upperBit - leadingZeros - minExponent;
+
+    // Subnormal numbers
+    if (power2 <= 0)
+    {
+        if (-power2 + 1 >= 64)
+        {
+            return 0;
+        }
+
+        bits >>= -power2 + 1;
+        bits += (bits & 1);
+        bits >>= 1;
+
+        power2 = bits < (1ull << mantissaBits) ? 0 : 1;
+        return (bits & ~(1ull << mantissaBits)) | ((uint64_t)power2 << mantissaBits);
+    }
+
+    // Exactly halfway between two doubles (only possible for small exponents): round to even
+    if (low <= 1 && exponent >= -4 && exponent <= 23 && (bits & 3) == 1 && (bits << shift) == high)
+    {
+        bits &= ~1ull;
+    }
+
+    bits += (bits & 1);
+    bits >>= 1;
+
+    if (bits >= (2ull << mantissaBits))
+    {
+        bits = 1ull << mantissaBits;
+        power2++;
+    }
+
+    bits &= ~(1ull << mantissaBits);
+    if (power2 >= infinitePower)
+    {
+        return (uint64_t)infinitePower << mantissaBits;
+    }
+
+    return bits | ((uint64_t)power2 << mantissaBits);
+}
+
+/* @funcdef: Json_DoubleFromBits */
+JSON_INLINE double Json_DoubleFromBits(uint64_t bits, bool negative)
+{
+    bits |= (uint64_t)negative << 63;
+
+    double result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+/* @funcdef: JsonParser_ParseNumber
+ * Integers without fraction and exponent are stored exactly (JsonNumberKind_Integer).
+ * Other numbers are rounded correctly: exact double arithmetic when mantissa and power
+ * of ten are small enough, Eisel-Lemire otherwise, strtod for more than 19 significant digits
+ * when the first 19 digits are not enough to decide the rounding.
+ */
+static void JsonParser_ParseNumber(JsonParser* parser, Json* outValue)
+{
+    int c = JsonParser_SkipSpace(parser);
+    if (c < 0)
+    {
+        JsonParser_Panic(parser, JsonType_Number, JsonError_UnexpectedToken, "Reached the end of json!");
+    }
+
+    const char*     buffer  = parser->buffer;
+    const int32_t   length  = parser->length;
+    const int32_t   start   = parser->cursor;
+    int32_t         cursor  = start;
+
+    if (c == '+')
+    {
+        JsonParser_Panic(parser, JsonType_Number, JsonError_UnexpectedToken, "JSON does not support number start with '+'");
+    }
+
+    const bool negative = (c == '-');
+    if (negative)
+    {
+        cursor++;
+    }
+
+    // Integer part
+    uint64_t        mantissa        = 0;
+    const int32_t   integerStart    = cursor;
+    if (cursor < length && buffer[cursor] == '0')
+    {
+        cursor++;
+        if (cursor < length && Json_IsDigit(buffer[cursor]))
+        {
+            parser->cursor = cursor;
+            JsonParser_Panic(parser, JsonType_Number, JsonError_UnexpectedToken, "JSON does not support number start with '0' (only standalone '0' is accepted)");
+        }
+    }
+    else
+    {
+        cursor = JsonParser_ParseDigits(buffer, length, cursor, &mantissa);
+    }
+
+    const int32_t integerEnd = cursor;
+    if (integerEnd == integerStart)
+    {
+        parser->cursor = cursor;
+        JsonParser_Panic(parser, JsonType_Number, JsonError_UnexpectedToken, "Expected digits in <number>, found '%c'", cursor < length ? buffer[cursor] : ' ');
+    }
+
+    // Fraction part
+    bool            isInteger       = true;
+    int32_t         fractionStart   = cursor;
+    int32_t         fractionEnd     = cursor;
+    if (cursor < length && buffer[cursor] == '.')
+    {
+        isInteger = false;
+        fractionStart = cursor + 1;
+        fractionEnd = JsonParser_ParseDigits(buffer, length, fractionStart, &mantissa);
+        cursor = fractionEnd;
+
+        if (fractionEnd == fractionStart)
+        {
+            parser->cursor = cursor;
+            JsonParser_Panic(parser, JsonType_Number, JsonError_UnexpectedToken, "'.' is presented in number token, but require a digit after '.'");
+        }
+    }
+
+    // Exponent part
+    int64_t explicitExponent = 0;
+    if (cursor < length && (buffer[cursor] | 0x20) == 'e')
+    {
+        isInteger = false;
+        cursor++;
+
+        bool negativeExponent = false;
+        if (cursor < length && (buffer[cursor] == '-' || buffer[cursor] == '+'))
+        {
+            negativeExponent = (buffer[cursor] == '-');
+            cursor++;
+        }
+
+        if (cursor >= length || !Json_IsDigit(buffer[cursor]))
+        {
+            parser->cursor = cursor;
+            JsonParser_Panic(parser, JsonType_Number, JsonError_UnexpectedToken, "'e' is presented in number token, but require a digit after 'e'");
+        }
+
+        while (cursor < length && Json_IsDigit(buffer[cursor]))
+        {
+            // Saturate, the result is zero or infinity long before
+            if (explicitExponent < 0x10000000)
+            {
+                explicitExponent = explicitExponent * 10 + (buffer[cursor] - '0');
+            }
+            cursor++;
+        }
+
+        if (negativeExponent)
+        {
+            explicitExponent = -explicitExponent;
+        }
+    }
+
+    parser->cursor = cursor;
+
+    // Count significant digits, leading zeros do not count
+    int32_t digitCount = (integerEnd - integerStart) + (fractionEnd - fractionStart);
+    if (digitCount > JSON_MAX_MANTISSA_DIGITS)
+    {
+        for (int32_t i = integerStart; i < fractionEnd && (buffer[i] == '0' || buffer[i] == '.'); i++)
+        {
+            digitCount -= (buffer[i] == '0');
+        }
+    }
+
+    Json value;
+    value.type = JsonType_Number;
+
+    if (isInteger && digitCount <= JSON_MAX_MANTISSA_DIGITS)
+    {
+        // -0 is kept as a float, it has no integer representation
+        const uint64_t limit = negative ? (1ull << 63) : (uint64_t)INT64_MAX;
+        if (mantissa <= limit && !(negative && mantissa == 0))
+        {
+            value.length = JsonNumberKind_Integer;
+            value.integer = negative ? (int64_t)(0ull - mantissa) : (int64_t)mantissa;
+
+            *outValue = value;
+            return;
+        }
+    }
+
+    value.length = JsonNumberKind_Float;
+
+    if (digitCount <= JSON_MAX_MANTISSA_DIGITS)
+    {
+        const int64_t exponent = explicitExponent - (fractionEnd - fractionStart);
+
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+        // Both mantissa and power of ten are exact doubles, a single rounding give the correct result
+        static const double POWERS_OF_TEN[] = {
+            1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+        };
+
+        if (mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22)
+        {
+            const double number = (double)mantissa;
+            value.number = exponent < 0 ? number / POWERS_OF_TEN[-exponent] : number * POWERS_OF_TEN[exponent];
+            value.number = negative ? -value.number : value.number;
+
+            *outValue = value;
+            return;
+        }
+#endif
+
+        const int32_t clampedExponent = exponent < -100000 ? -100000 : (exponent > 100000 ? 100000 : (int32_t)exponent);
+        value.number = Json_DoubleFromBits(Json_EiselLemire(mantissa, clampedExponent), negative);
+
+        *outValue = value;
+        return;
+    }
+
+    // Too many digits: round with the first 19 significant digits, and with the next mantissa up.
+    // Both agree for almost every number, the rest go to strtod.
+    const uint64_t minNineteenDigits = 1000000000000000000ull;
+
+    uint64_t truncated = 0;
+    int64_t exponent;
+    int32_t i = integerStart;
+    while (truncated < minNineteenDigits && i < integerEnd)
+    {
+        truncated = truncated * 10 + (uint64_t)(buffer[i] - '0');
+        i++;
+    }
+
+    if (truncated >= minNineteenDigits)
+    {
+        exponent = explicitExponent + (integerEnd - i);
+    }
+    else
+    {
+        i = fractionStart;
+        while (truncated < minNineteenDigits && i < fractionEnd)
+        {
+            truncated = truncated * 10 + (uint64_t)(buffer[i] - '0');
+            i++;
+        }
+
+        exponent = explicitExponent - (i - fractionStart);
+    }
+
+    const int32_t clampedExponent = exponent < -100000 ? -100000 : (exponent > 100000 ? 100000 : (int32_t)exponent);
+    const uint64_t bits = Json_EiselLemire(truncated, clampedExponent);
+    if (bits == Json_EiselLemire(truncated + 1, clampedExponent))
+    {
+        value.number = Json_DoubleFromBits(bits, negative);
+
+        *outValue = value;
+        return;
+    }
+
+    const int32_t numberLength = cursor - start;
+    if (numberLength >= JSON_MAX_NUMBER_LENGTH)
+    {
+        parser->cursor = start;
+        JsonParser_Panic(parser, JsonType_Number, JsonError_UnsupportedToken, "<number> has too many digits");
+    }
+
+    // The document is not null-terminated, strtod work on a copy
+    char text[JSON_MAX_NUMBER_LENGTH];
+    memcpy(text, buffer + start, (size_t)numberLength);
+    text[numberLength] = '\0';
+
+    value.number = strtod(text, NULL);
+    *outValue = value;
+}
+
+/* @funcdef: JsonParser_ParseNumberJump
+ * Errors of the parser jump back here
+ */
+static void JsonParser_ParseNumberJump(JsonParser* parser, Json* outValue)
+{
+    if (setjmp(parser->errjmp) == 0)
+    {
+        JsonParser_ParseNumber(parser, outValue);
+    }
+}
+
+/* @funcdef: Json_ParseNumberText
+ * Parse the number at the start of text outside of JsonParse (JsonReader, JsonTape)
+ * outLength receive the length of the number, or the error position.
+ * message receive the first line of the error message, it may be null.
+ */
+static JsonError Json_ParseNumberText(const char* text, int32_t length, JsonParseFlags flags, Json* outValue, int32_t* outLength, char* message, int32_t messageSize)
+{
+    // Room for the error message of the parser
+    Json errorBuffer[72];
+    JsonAllocator allocator;
+    JsonAllocator_Init(&allocator, errorBuffer, (int32_t)sizeof(errorBuffer));
+
+    JsonParser parser;
+    JsonParser_Init(&parser, text, length, allocator, flags);
+    parser.useIndex = false;
+
+    JsonParser_ParseNumberJump(&parser, outValue);
+    *outLength = parser.cursor;
+
+    if (parser.errnum != JsonError_None && message && messageSize > 0)
+    {
+        const char* errmsg = parser.errmsg ? parser.errmsg : "Invalid <number>";
+        snprintf(message, (size_t)messageSize, "%.*s", (int)strcspn(errmsg, "\n"), errmsg);
+    }
+
+    return parser.errnum;
+}
+
+/* @funcdef: JsonParser_SkipContainer
+ * Move the cursor past the array or object at the cursor without building it, only the nesting of the brackets is checked
+ */
+static void JsonParser_SkipContainer(JsonParser* parser)
+{
+    const char* buffer = parser->buffer;
+    int32_t     depth  = 0;
+
+    // Brackets inside strings are not indexed, the tokens are counted as they are
+    if (parser->useIndex)
+    {
+        int32_t cursor = parser->cursor;
+        while (true)
+        {
+            if (cursor >= parser->length || buffer[cursor] == '\0')
+            {
+                parser->cursor = cursor;
+                JsonParser_Panic(parser, JsonType_Null, JsonError_UnmatchToken, "Expected ']' or '}'");
+            }
+
+            const char c = buffer[cursor];
+            if (c == '[' || c == '{')
+            {
+                depth++;
+            }
+            else if ((c == ']' || c == '}') && --depth == 0)
+            {
+                break;
+            }
+
+            cursor = JsonStructuralIndex_NextAfter(&parser->index, cursor);
+        }
+
+        parser->cursor = cursor + 1;
+        return;
+    }
+
+    // Comments are not indexed, read byte by byte
+    do
+    {
+        int c = JsonParser_SkipSpace(parser);
+        if (c < 0)
+        {
+            JsonParser_Panic(parser, JsonType_Null, JsonError_UnmatchToken, "Expected ']' or '}'");
+        }
+
+        if (c == '"')
+        {
+            c = JsonParser_NextChar(parser);
+            while (c != '"')
+            {
+                if (c < 0)
+                {
+                    JsonParser_Panic(parser, JsonType_String, JsonError_UnmatchToken, "Expected '\"'");
+                }
+
+                if (c == '\\')
+                {
+                    JsonParser_NextChar(parser);
+                }
+                c = JsonParser_NextChar(parser);
+            }
+        }
+        else if (c == '[' || c == '{')
+        {
+            depth++;
+        }
+        else if (c == ']' || c == '}')
+        {
+            depth--;
+        }
+
+        parser->cursor++;
+    } while (depth > 0);
+}
+
+/* @funcdef: JsonParser_ParseChild
+ * Member value or array item, the skip hook see the arrays and objects before they are parsed
+ */
+static void JsonParser_ParseChild(JsonParser* parser, const char* name, bool isItem, Json* outValue)
+{
+    if (!parser->skip)
+    {
+        JsonParser_ParseSingle(parser, outValue);
+        return;
+    }
+
+    const int c = JsonParser_SkipSpace(parser);
+    if (c == '[' || c == '{')
+    {
+        const JsonSkipTarget target = { parser->depth + 1, name, isItem, parser->buffer + parser->cursor, parser->length - parser->cursor };
+        if (parser->skip(parser->skipUserData, &target))
+        {
+            JsonParser_SkipContainer(parser);
+            *outValue = JSON_NULL;
+            return;
+        }
+    }
+
+    const char* parentName = parser->name;
+    parser->name = name;
+    parser->depth++;
+
+    JsonParser_ParseSingle(parser, outValue);
+
+    parser->name = parentName;
+    parser->depth--;
+}
+
+/* @funcdef: JsonParser_ParseArray */
+static void JsonParser_ParseArray(JsonParser* parser, Json* outValue)
+{
+    if (JsonParser_SkipSpace(parser) > 0)
+    {
+        if (parser->parallelFor && parser->cursor >= parser->serialUntil && JsonParser_ParseArrayParallel(parser, outValue))
+        {
+            return;
+        }
+
+	    JsonParser_MatchChar(parser, JsonType_Array, '[');
+
+        JsonTempArray(Json, 64) values = JsonTempArray_Init(NULL);
+	    while (JsonParser_SkipSpace(parser) > 0 && JsonParser_PeekChar(parser) != ']')
+	    {
+	        if (values.count > 0)
+	        {
+                JsonParser_MatchChar(parser, JsonType_Array, ',');
+	        }
+	    
+            Json value;
+            JsonParser_ParseChild(parser, parser->name, true, &value);
+
+            JsonTempArray_Push(&values, value, &parser->allocator);
+	    }
+
+	    JsonParser_SkipSpace(parser);
+	    JsonParser_MatchChar(parser, JsonType_Array, ']');
+
+        outValue->type   = JsonType_Array;
+        outValue->length = JsonTempArray_GetCount(&values);
+        outValue->array  = (Json*)JsonTempArray_ToBuffer(&values, &parser->allocator);
+        if (outValue->length > 0 && !outValue->array)
+        {
+            JsonParser_Panic(parser, JsonType_Array, JsonError_OutOfMemory, "Out of memory");
+        }
+
+        JsonTempArray_Free(&values, &parser->allocator);
+    }
+}
+
+/* JsonState_ParseSingle */
+static void JsonParser_ParseSingle(JsonParser* parser, Json* outValue)
+{
+    if (JsonParser_SkipSpace(parser) > 0)
+    {
+	    int c = JsonParser_PeekChar(parser);
+	
+	    switch (c)
+	    {
+	    case '[':
+	        JsonParser_ParseArray(parser, outValue);
+            break;
+	    
+	    case '{':
+	        JsonParser_ParseObject(parser, outValue);
+            break;
+	    
+	    case '"':
+	        JsonParser_ParseString(parser, outValue);
+            break;
+
+	    case '+': case '-': case '0': 
+        case '1': case '2': case '3': 
+        case '4': case '5': case '6': 
+        case '7': case '8': case '9':
+	        JsonParser_ParseNumber(parser, outValue);
+            break;
+	    
+        default:
+	    {
+	        int length = 0;
+	        while (c > 0 && isalpha(c))
+	        {
+                length++;
+                c = JsonParser_NextChar(parser);
+	        }
+
+	        const char* token = parser->buffer + parser->cursor - length;
+            if (length == 4 && strncmp(token, "null", length) == 0)
+            {
+                *outValue = JSON_NULL;
+            }
+            else if (length == 4 && strncmp(token, "true", length) == 0)
+	        {
+                *outValue = JSON_TRUE;
+	        }
+	        else if (length == 5 && strncmp(token, "false", length) == 0)
+	        {
+                *outValue = JSON_FALSE;
+	        }
+	        else
+	        {
+                char tmp[256];
+                tmp[length] = 0;
+                while (length--)
+                {
+                    tmp[length] = token[length]; 
+                }
+
+                JsonParser_Panic(parser, JsonType_Null, JsonError_UnexpectedToken, "Unexpected token '%s'", tmp);
+	        }
+	    } break;
+	    /* END OF SWITCH STATEMENT */
+        }
+    }
+}
+
+/* @funcdef: JsonParser_FindStringSpecial
+ * Length of the run of plain string bytes: stop at '"', '\\' or a control character
+ */
+JSON_INLINE int32_t JsonParser_FindStringSpecial(const char* string, int32_t length)
+{
+    int32_t i = 0;
+
+#if JSON_USE_SSE2
+    const __m128i quote     = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control   = _mm_set1_epi8(0x1F);
+    for (; i + 16 <= length; i += 16)
+    {
+        const __m128i chars = _mm_loadu_si128((const __m128i*)(string + i));
+        const __m128i isQuote = _mm_cmpeq_epi8(chars, quote);
+        const __m128i isBackslash = _mm_cmpeq_epi8(chars, backslash);
+        const __m128i isControl = _mm_cmpeq_epi8(_mm_min_epu8(chars, control), chars);
+
+        const uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(isQuote, isBackslash), isControl));
+        if (mask != 0)
+        {
+            return i + Json_TrailingZeros(mask);
+        }
+    }
+#endif
+
+    for (; i < length; i++)
+    {
+        const uint8_t c = (uint8_t)string[i];
+        if (c == '"' || c == '\\' || c < 0x20)
+        {
+            break;
+        }
+    }
+
+    return i;
+}
+
+/* @funcdef: JsonParser_DecodeEscapes
+ * Copy string to output, replace escape sequences with their characters, output never run ahead of string
+ * Return length of output, -1 on unknown or malformed escape
+ */
+static int32_t JsonParser_DecodeEscapes(const char* string, int32_t length, char* output)
+{
+    int32_t outputLength = 0;
+    int32_t i = 0;
+    while (i < length)
+    {
+        const char* escape = (const char*)memchr(string + i, '\\', (size_t)(length - i));
+        const int32_t runLength = escape ? (int32_t)(escape - (string + i)) : length - i;
+
+        // output may be string itself, JsonReader decode in place
+        memmove(output + outputLength, string + i, (size_t)runLength);
+        outputLength += runLength;
+        i += runLength;
+
+        if (!escape)
+        {
+            break;
+        }
+
+        char c;
+        switch (string[i + 1])
+        {
+        case 'n':  c = '\n'; break;
+        case 't':  c = '\t'; break;
+        case 'r':  c = '\r'; break;
+        case 'b':  c = '\b'; break;
+        case 'f':  c = '\f'; break;
+        case '/':  c = '/';  break;
+        case '\\': c = '\\'; break;
+        case '"':  c = '"';  break;
+
+        case 'u':
+        {
+            int32_t consumed;
+            const int32_t written = Utf8_DecodeUnicodeEscape(string + i, length - i, output + outputLength, &consumed);
+            if (written == 0)
+            {
+                return -1;
+            }
+
+            outputLength += written;
+            i += consumed;
+            continue;
+        }
+
+        default:
+            return -1;
+        }
+
+        output[outputLength++] = c;
+        i += 2;
+    }
+
+    return outputLength;
+}
+
+/* @funcdef: JsonParser_ParseStringNoToken
+ * Strings are scanned for their end first (jumping with the structural index, or whole runs
+ * of plain bytes at once), then copied once, escapes are decoded only when present.
+ * The document is valid UTF-8 already.
+ */
+static char* JsonParser_ParseStringNoToken(JsonParser* parser, int32_t* outLength)
+{
+    JsonParser_MatchChar(parser, JsonType_String, '"');
+
+    const char*     buffer      = parser->buffer;
+    const int32_t   start       = parser->cursor;
+    int32_t         cursor      = start;
+    int32_t         escapeCount = 0;
+
+    while (true)
+    {
+        if (parser->useIndex)
+        {
+            cursor = JsonStructuralIndex_NextAfter(&parser->index, cursor - 1);
+        }
+        else
+        {
+            cursor += JsonParser_FindStringSpecial(buffer + cursor, parser->length - cursor);
+        }
+
+        if (cursor >= parser->length || buffer[cursor] == '\0')
+        {
+            parser->cursor = cursor;
+            JsonParser_Panic(parser, JsonType_String, JsonError_UnmatchToken, "Expected '\"'");
+        }
+
+        const char c = buffer[cursor];
+        if (c == '"')
+        {
+            break;
+        }
+        else if (c == '\\')
+        {
+            // The escaped character is checked when decoding, only the end matter here
+            escapeCount++;
+            cursor += 2;
+        }
+        else if (c == '\r' || c == '\n')
+        {
+            parser->cursor = cursor;
+            JsonParser_Panic(parser, JsonType_String, JsonError_UnexpectedToken, "Unexpected newline characters '%c'", c);
+        }
+        else
+        {
+            cursor++;
+        }
+    }
+
+    const int32_t rawLength = cursor - start;
+    parser->cursor = cursor;
+    JsonParser_MatchChar(parser, JsonType_String, '"');
+
+    if (rawLength == 0)
+    {
+        if (outLength) *outLength = 0;
+        return NULL;
+    }
+
+    // The closing quote is indexed and consumed already, the document can be rewritten up to it
+    if (parser->flags & JsonParseFlags_InSitu)
+    {
+        char* string = (char*)buffer + start;
+
+        int32_t length = rawLength;
+        if (escapeCount > 0)
+        {
+            length = JsonParser_DecodeEscapes(string, rawLength, string);
+            if (length < 0)
+            {
+                JsonParser_Panic(parser, JsonType_String, JsonError_UnknownToken, "Invalid escape sequence in string");
+            }
+        }
+
+        string[length] = '\0';
+
+        if (outLength) *outLength = length;
+        return string;
+    }
+
+    // Decoded strings never grow, allocate the raw length and give back the rest
+    char* string = (char*)JsonAllocator_AllocLower(&parser->allocator, NULL, 0, rawLength + 1);
+    if (!string)
+    {
+        JsonParser_Panic(parser, JsonType_String, JsonError_OutOfMemory, "Out of memory");
+    }
+
+    int32_t length = rawLength;
+    if (escapeCount == 0)
+    {
+        memcpy(string, buffer + start, (size_t)rawLength);
+    }
+    else
+    {
+        length = JsonParser_DecodeEscapes(buffer + start, rawLength, string);
+        if (length < 0)
+        {
+            JsonParser_Panic(parser, JsonType_String, JsonError_UnknownToken, "Invalid escape sequence in string");
+        }
+
+        JsonAllocator_AllocLower(&parser->allocator, string, rawLength + 1, length + 1);
+    }
+
+    string[length] = '\0';
+
+    if (outLength) *outLength = length;
+    return string;
+}
+
+/* @funcdef: JsonParser_ParseString */
+static void JsonParser_ParseString(JsonParser* parser, Json* outValue)
+{
+    if (JsonParser_SkipSpace(parser) > 0)
+    {
+        int length;
+        const char* string = JsonParser_ParseStringNoToken(parser, &length);
+
+        outValue->type   = JsonType_String;
+        outValue->string = string;
+        outValue->length = length;
+    }
+}
+
+/* @funcdef: JsonParser_ParseObject */
+static void JsonParser_ParseObject(JsonParser* parser, Json* outValue)
+{
+    if (JsonParser_SkipSpace(parser) > 0)
+    {
+        JsonParser_MatchChar(parser, JsonType_Object, '{');
+
+        JsonTempArray(JsonObjectMember, 32) values = JsonTempArray_Init(NULL);
+        while (JsonParser_SkipSpace(parser) > 0 && JsonParser_PeekChar(parser) != '}')
+        {
+            if (values.count > 0)
+            {
+                JsonParser_MatchChar(parser, JsonType_Object, ',');
+            }
+
+            if (JsonParser_SkipSpace(parser) != '"')
+            {
+                JsonParser_Panic(parser, JsonType_Object, JsonError_UnexpectedToken, "Expected <string> for <member-key> of <object>");
+            }
+
+            int32_t nameLength;
+            const char* name = JsonParser_ParseStringNoToken(parser, &nameLength);
+
+            JsonParser_SkipSpace(parser);
+            JsonParser_MatchChar(parser, JsonType_Object, ':');
+
+            // Empty names are NULL in the members, the skip hook get ""
+            Json value;
+            JsonParser_ParseChild(parser, nameLength < JSON_SKIP_NAME_SIZE ? (name ? name : "") : NULL, false, &value);
+
+            /* Well done */
+            JsonObjectMember member;
+            member.name  = name;
+            member.value = value;
+            JsonTempArray_Push(&values, member, &parser->allocator);
+        }
+
+        JsonParser_SkipSpace(parser);
+        JsonParser_MatchChar(parser, JsonType_Object, '}');
+
+        // Members and index are allocated together, the index is found from the members
+        const int32_t memberCount = JsonTempArray_GetCount(&values);
+        JsonObjectMember* members = NULL;
+        if (memberCount > 0)
+        {
+            members = (JsonObjectMember*)JsonAllocator_AllocLower(&parser->allocator, NULL, 0, JsonObject_AllocSize(memberCount));
+            if (!members)
+            {
+                JsonParser_Panic(parser, JsonType_Object, JsonError_OutOfMemory, "Out of memory");
+            }
+
+            JsonTempArray_CopyTo(&values, members);
+            if (memberCount >= JSON_OBJECT_INDEX_MIN)
+            {
+                JsonObject_BuildIndex(members, memberCount);
+            }
+        }
+
+        outValue->type    = JsonType_Object;
+        outValue->length  = memberCount;
+        outValue->indexed = memberCount >= JSON_OBJECT_INDEX_MIN;
+        outValue->object  = members;
+
+        JsonTempArray_Free(&values, &parser->allocator);
+    }
+}
+
+// -------------------------------------------------------------------
+// Parallel arrays
+// -------------------------------------------------------------------
+
+/*
+Large arrays are scanned first with a structural index of their own: their end and their top
+level commas are found without parsing, items are grouped in chunks of JSON_PARALLEL_CHUNK_SIZE bytes.
+Chunks are parsed on the workers by parsers of their own, each one in a slice of the free buffer,
+and their items go straight to the final array. The slices are moved back together after,
+the pointers into them are rebased.
+@note: internal only
+*/
+
+#define JSON_PARALLEL_MIN_SIZE      (128 * 1024)    // Smaller arrays are parsed serially
+#define JSON_PARALLEL_CHUNK_SIZE    (32 * 1024)
+#define JSON_PARALLEL_MIN_CHUNKS    4               // No chunk is bigger than the array size over this
+#define JSON_PARALLEL_TOKEN_COST    64              // Estimated bytes of values and temporaries per token
+#define JSON_PARALLEL_CHUNK_COST    2048            // Error message and alignment of a chunk
+
+typedef struct JsonParallelChunk
+{
+    int32_t         start;              // First byte after '[' or ','
+    int32_t         end;                // ',' after the last item, or the closing ']'
+    int32_t         first;              // Index of the first item in the array
+    int32_t         count;
+    int64_t         cost;               // Estimated memory usage
+
+    uint8_t*        base;               // Slice of the free buffer
+    uint8_t*        target;             // Where the slice is moved after parsing
+    JsonAllocator   allocator;
+
+    JsonError       errnum;
+    JsonType        errtype;
+    int32_t         cursor;
+    const char*     errmsg;
+} JsonParallelChunk;
+
+typedef struct JsonParallelArray
+{
+    const char*         buffer;
+    JsonParseFlags      flags;
+    Json*               items;
+    JsonParallelChunk*  chunks;
+
+    JsonSkipFunc        skip;           // Of the parser, with the depth and the name of the array
+    void*               skipUserData;
+    int32_t             depth;
+    const char*         name;
+} JsonParallelArray;
+
+/* @funcdef: JsonParser_ScanArray
+ * Find the end of the array at the cursor and split its items in chunks, the chunks are on the upper side of the allocator.
+ * Blocks without brackets are counted with their masks, only brackets and the commas of the split are visited.
+ * Return the chunk count, 0 when the array must be parsed serially (small, malformed, or made of a few big items)
+ */
+static int32_t JsonParser_ScanArray(JsonParser* parser, JsonParallelChunk** outChunks, int32_t* outItemCount)
+{
+    const char* buffer = parser->buffer;
+    if (buffer[parser->cursor] != '[')
+    {
+        return 0;
+    }
+
+    JsonStructuralIndex index;
+    JsonStructuralIndex_Init(&index, buffer, parser->length);
+    JsonStructuralIndex_Seek(&index, parser->cursor);
+
+    const int64_t bytesCost = (parser->flags & JsonParseFlags_InSitu) ? 0 : 1;
+
+    JsonParallelChunk* chunks = JsonArray_Init();
+
+    JsonParallelChunk chunk;
+    memset(&chunk, 0, sizeof(chunk));
+    chunk.start = parser->cursor + 1;
+
+    int32_t end         = -1;
+    int32_t depth       = 0;
+    int32_t commaCount  = 0;            // Top level commas before the current block
+    int64_t tokenCount  = 0;            // Values and brackets of the current chunk, for its cost
+    while (end < 0 && index.blockCursor < parser->length)
+    {
+        const int32_t blockStart = index.blockCursor;
+
+        JsonBlockTokens tokens;
+        JsonStructuralIndex_ClassifyNext(&index, &tokens);
+
+        const uint64_t brackets = tokens.op & ~tokens.separator;
+        tokenCount += Json_PopCount64(tokens.value | brackets);
+
+        // Walk the brackets and the separators when the depth change in the block, or when the chunk end in it
+        uint64_t events = 0;
+        if (brackets != 0)
+        {
+            events = brackets | tokens.separator;
+        }
+        else if (depth == 1 && blockStart + JSON_BLOCK_SIZE > chunk.start + JSON_PARALLEL_CHUNK_SIZE)
+        {
+            events = tokens.separator;
+        }
+        else
+        {
+            commaCount += (depth == 1) * Json_PopCount64(tokens.separator);
+            continue;
+        }
+
+        while (events != 0)
+        {
+            const int32_t position = blockStart + Json_TrailingZeros64(events);
+            events &= events - 1;
+
+            const char c = buffer[position];
+            if (c == '[' || c == '{')
+            {
+                depth++;
+            }
+            else if (c == ']' || c == '}')
+            {
+                if (--depth == 0)
+                {
+                    end = position;
+                    break;
+                }
+            }
+            else if (depth == 1)
+            {
+                // Colons at the top level are reported by the chunk parser
+                commaCount++;
+                if (position - chunk.start >= JSON_PARALLEL_CHUNK_SIZE)
+                {
+                    chunk.end   = position;
+                    chunk.count = commaCount - chunk.first;
+                    chunk.cost  = tokenCount * JSON_PARALLEL_TOKEN_COST + (position - chunk.start) * bytesCost + JSON_PARALLEL_CHUNK_COST;
+                    if (!JsonArray_Push(chunks, chunk, &parser->allocator))
+                    {
+                        JsonArray_Free(chunks, &parser->allocator);
+                        return 0;
+                    }
+
+                    chunk.start = position + 1;
+                    chunk.first = commaCount;
+                    tokenCount  = 0;
+                }
+            }
+        }
+    }
+
+    // Unterminated and mismatched brackets are reported by the serial parser
+    if (end < 0 || buffer[end] != ']')
+    {
+        JsonArray_Free(chunks, &parser->allocator);
+        return 0;
+    }
+
+    if (end - parser->cursor < JSON_PARALLEL_MIN_SIZE)
+    {
+        parser->serialUntil = end;
+
+        JsonArray_Free(chunks, &parser->allocator);
+        return 0;
+    }
+
+    // Without commas there is one chunk at most, it is never split. Empty items are reported by the chunk parser.
+    const int32_t itemCount = commaCount + 1;
+
+    chunk.end   = end;
+    chunk.count = itemCount - chunk.first;
+    chunk.cost  = tokenCount * JSON_PARALLEL_TOKEN_COST + (end - chunk.start) * bytesCost + JSON_PARALLEL_CHUNK_COST;
+    if (!JsonArray_Push(chunks, chunk, &parser->allocator))
+    {
+        JsonArray_Free(chunks, &parser->allocator);
+        return 0;
+    }
+
+    // A few big items would keep one worker busy, their own arrays are split instead
+    const int32_t chunkCount = JsonArray_GetCount(chunks);
+    const int32_t maxChunkSize = (end - parser->cursor) / JSON_PARALLEL_MIN_CHUNKS;
+    for (int32_t i = 0; i < chunkCount; i++)
+    {
+        if (chunkCount < JSON_PARALLEL_MIN_CHUNKS || chunks[i].end - chunks[i].start > maxChunkSize)
+        {
+            JsonArray_Free(chunks, &parser->allocator);
+            return 0;
+        }
+    }
+
+    *outChunks = chunks;
+    *outItemCount = itemCount;
+    return chunkCount;
+}
+
+/* @funcdef: JsonParser_ParseChunk
+ * The chunk parser stop at the end of the chunk, it never read the bytes other workers may rewrite in situ
+ */
+static void JsonParser_ParseChunk(const JsonParallelArray* array, JsonParallelChunk* chunk)
+{
+    JsonParser parser;
+    JsonParser_Init(&parser, array->buffer, chunk->end + 1, chunk->allocator, array->flags);
+    JsonStructuralIndex_Seek(&parser.index, chunk->start);
+
+    parser.cursor       = chunk->start;
+    parser.inWorker     = true;
+    parser.skip         = array->skip;
+    parser.skipUserData = array->skipUserData;
+    parser.depth        = array->depth;
+    parser.name         = array->name;
+
+    Json* items = array->items + chunk->first;
+    if (setjmp(parser.errjmp) == 0)
+    {
+        for (int32_t i = 0; i < chunk->count; i++)
+        {
+            if (i > 0)
+            {
+                JsonParser_SkipSpace(&parser);
+                JsonParser_MatchChar(&parser, JsonType_Array, ',');
+            }
+
+            JsonParser_ParseChild(&parser, parser.name, true, &items[i]);
+        }
+
+        JsonParser_SkipSpace(&parser);
+        if (parser.cursor != chunk->end)
+        {
+            JsonParser_Panic(&parser, JsonType_Array, JsonError_UnexpectedToken, "Expected ',' or ']'");
+        }
+    }
+
+    chunk->allocator    = parser.allocator;
+    chunk->errnum       = parser.errnum;
+    chunk->errtype      = parser.errtype;
+    chunk->cursor       = parser.cursor;
+    chunk->errmsg       = parser.errmsg;
+}
+
+/* @funcdef: JsonParser_ParseChunks */
+static void JsonParser_ParseChunks(void* data, int32_t start, int32_t end)
+{
+    JsonParallelArray* array = (JsonParallelArray*)data;
+    for (int32_t i = start; i < end; i++)
+    {
+        JsonParser_ParseChunk(array, &array->chunks[i]);
+    }
+}
+
+/* @funcdef: Json_Rebase
+ * Move the pointers of value and its children that point into [begin, end), children are rebased before their parent
+ */
+static void Json_Rebase(Json* value, uintptr_t begin, uintptr_t end, intptr_t offset)
+{
+#define JSON_REBASE(T, pointer) ((uintptr_t)(pointer) - begin < end - begin ? (T)((uintptr_t)(pointer) + (uintptr_t)offset) : (pointer))
+
+    switch (value->type)
+    {
+    case JsonType_String:
+        value->string = JSON_REBASE(const char*, value->string);
+        break;
+
+    case JsonType_Array:
+        for (int32_t i = 0; i < value->length; i++)
+        {
+            Json_Rebase(&value->array[i], begin, end, offset);
+        }
+        value->array = JSON_REBASE(Json*, value->array);
+        break;
+
+    case JsonType_Object:
+        for (int32_t i = 0; i < value->length; i++)
+        {
+            value->object[i].name = JSON_REBASE(const char*, value->object[i].name);
+            Json_Rebase(&value->object[i].value, begin, end, offset);
+        }
+        value->object = JSON_REBASE(JsonObjectMember*, value->object);
+        break;
+
+    default:
+        break;
+    }
+
+#undef JSON_REBASE
+}
+
+/* @funcdef: JsonParser_RebaseChunks
+ * The items and the slice of a chunk are only visited by the chunk, the slices are moved after
+ */
+static void JsonParser_RebaseChunks(void* data, int32_t start, int32_t end)
+{
+    JsonParallelArray* array = (JsonParallelArray*)data;
+    for (int32_t i = start; i < end; i++)
+    {
+        const JsonParallelChunk* chunk = &array->chunks[i];
+        const uintptr_t begin = (uintptr_t)chunk->base;
+        const uintptr_t usage = (uintptr_t)(chunk->allocator.lowerMarker - chunk->base);
+        if (usage > 0 && chunk->base != chunk->target)
+        {
+            const intptr_t offset = (intptr_t)((uintptr_t)chunk->target - begin);
+            for (int32_t j = 0; j < chunk->count; j++)
+            {
+                Json_Rebase(&array->items[chunk->first + j], begin, begin + usage, offset);
+            }
+        }
+    }
+}
+
+/* @funcdef: JsonParser_ParseArrayParallel
+ * Return false when the array must be parsed serially, the parser is left untouched then
+ */
+static bool JsonParser_ParseArrayParallel(JsonParser* parser, Json* outValue)
+{
+    if (parser->length - parser->cursor < JSON_PARALLEL_MIN_SIZE)
+    {
+        return false;
+    }
+
+    JsonParallelChunk* chunks = NULL;
+    int32_t itemCount = 0;
+    const int32_t chunkCount = JsonParser_ScanArray(parser, &chunks, &itemCount);
+    if (chunkCount == 0)
+    {
+        return false;
+    }
+
+    const int32_t end = chunks[chunkCount - 1].end;
+    if (itemCount > INT32_MAX / (int32_t)sizeof(Json))
+    {
+        JsonArray_Free(chunks, &parser->allocator);
+        return false;
+    }
+
+    // Items first, the slices of the chunks share the rest
+    uint8_t* const lowerMarker = parser->allocator.lowerMarker;
+    Json* items = (Json*)JsonAllocator_AllocLower(&parser->allocator, NULL, 0, itemCount * (int32_t)sizeof(Json));
+
+    int64_t totalCost = 0;
+    for (int32_t i = 0; i < chunkCount; i++)
+    {
+        totalCost += chunks[i].cost;
+    }
+
+    const int64_t freeSize = JsonAllocator_RemainSize(&parser->allocator);
+    if (!items || totalCost > freeSize)
+    {
+        parser->allocator.lowerMarker = lowerMarker;
+        JsonArray_Free(chunks, &parser->allocator);
+        return false;
+    }
+
+    uint8_t* const  freeStart   = parser->allocator.lowerMarker;
+    const int64_t   alignMask   = (int64_t)sizeof(Json) - 1;
+    int64_t         costBefore  = 0;
+    for (int32_t i = 0; i < chunkCount; i++)
+    {
+        JsonParallelChunk* chunk = &chunks[i];
+
+        const int64_t sliceStart = (freeSize * costBefore / totalCost) & ~alignMask;
+        costBefore += chunk->cost;
+        const int64_t sliceEnd = (freeSize * costBefore / totalCost) & ~alignMask;
+
+        chunk->base = freeStart + sliceStart;
+        JsonAllocator_Init(&chunk->allocator, chunk->base, (int32_t)(sliceEnd - sliceStart));
+
+        chunk->errnum = JsonError_None;
+        chunk->errmsg = NULL;
+    }
+
+    JsonParallelArray array;
+    array.buffer        = parser->buffer;
+    array.flags         = parser->flags;
+    array.items         = items;
+    array.chunks        = chunks;
+    array.skip          = parser->skip;
+    array.skipUserData  = parser->skipUserData;
+    array.depth         = parser->depth;
+    array.name          = parser->name;
+    parser->parallelFor(JsonParser_ParseChunks, &array, chunkCount, 1);
+
+    // The first error in document order is reported
+    for (int32_t i = 0; i < chunkCount; i++)
+    {
+        const JsonParallelChunk* chunk = &chunks[i];
+        if (chunk->errnum == JsonError_None)
+        {
+            continue;
+        }
+
+        // The slices are too unbalanced for this array, the document is untouched without JsonParseFlags_InSitu
+        if (chunk->errnum == JsonError_OutOfMemory && !(parser->flags & JsonParseFlags_InSitu))
+        {
+            parser->serialUntil = end;
+            parser->allocator.lowerMarker = lowerMarker;
+            JsonArray_Free(chunks, &parser->allocator);
+            return false;
+        }
+
+        // The message live in the free buffer, the error message of the parser may be allocated over it
+        char message[1024];
+        snprintf(message, sizeof(message), "%s", chunk->errmsg ? chunk->errmsg : "Parallel parsing failed");
+
+        parser->cursor = chunk->cursor;
+        JsonParser_Panic(parser, chunk->errtype, chunk->errnum, "%s", message);
+    }
+
+    // Move the slices back together, the pointers are rebased in parallel first
+    uint8_t* lowerEnd = freeStart;
+    for (int32_t i = 0; i < chunkCount; i++)
+    {
+        chunks[i].target = lowerEnd;
+        lowerEnd += chunks[i].allocator.lowerMarker - chunks[i].base;
+    }
+
+    parser->parallelFor(JsonParser_RebaseChunks, &array, chunkCount, 1);
+
+    for (int32_t i = 0; i < chunkCount; i++)
+    {
+        const JsonParallelChunk* chunk = &chunks[i];
+        const size_t usage = (size_t)(chunk->allocator.lowerMarker - chunk->base);
+        if (usage > 0 && chunk->base != chunk->target)
+        {
+            memmove(chunk->target, chunk->base, usage);
+        }
+    }
+
+    parser->allocator.lowerMarker = lowerEnd;
+    JsonArray_Free(chunks, &parser->allocator);
+
+    // The index of the parser was behind the array, the array may be rewritten in situ now
+    parser->cursor = end + 1;
+    JsonStructuralIndex_Seek(&parser->index, parser->cursor);
+
+    outValue->type   = JsonType_Array;
+    outValue->length = itemCount;
+    outValue->array  = items;
+    return true;
+}
+         
+/* Internal parsing function
+ */
+static Json* JsonState_ParseTopLevel(JsonParser* parser)
+{
+    JSON_ASSERT(parser, "parser mustnot be null");
+
+    Json* value = (Json*)JsonAllocator_AllocLower(&parser->allocator, NULL, 0, sizeof(Json));
+    if (!value)
+    {
+        JsonParser_SetError(parser, JsonType_Null, JsonError_OutOfMemory, "Out of memory");
+        return NULL;
+    }
+    *value = JSON_NULL;
+
+    // Use setjmp for quick exit when parse error happend
+    if (setjmp(parser->errjmp) == 0)
+    {
+        // Validate the whole document at once, strings are copied without checking them
+        if (!Utf8_Validate(parser->buffer, parser->length))
+        {
+            parser->cursor = Utf8_ValidPrefix(parser->buffer, parser->length);
+            JsonParser_Panic(parser, JsonType_String, JsonError_WrongFormat, "Invalid UTF-8 sequence");
+        }
+
+        // Just parse value from the top level
+        if (parser->flags & JsonParseFlags_NoStrictTopLevel)
+        {
+            JsonParser_ParseSingle(parser, value);
+        }
+        // Make sure the toplevel is JsonType_Object
+        else if (JsonParser_SkipSpace(parser) == '{')
+        {
+            JsonParser_ParseObject(parser, value);
+
+            JsonParser_SkipSpace(parser);
+            if (!JsonParser_IsAtEnd(parser))
+            {
+                JsonParser_Panic(parser, JsonType_Null, JsonError_WrongFormat, "JSON is not well-formed. JSON is start with <object>.");
+            }
+        }
+        // Make sure the toplevel is JsonType_Array
+        else if (JsonParser_SkipSpace(parser) == '[')
+        {
+            JsonParser_ParseArray(parser, value);
+
+            JsonParser_SkipSpace(parser);
+            if (!JsonParser_IsAtEnd(parser))
+            {
+                JsonParser_Panic(parser, JsonType_Null, JsonError_WrongFormat, "JSON is not well-formed. JSON is start with <array>.");
+            }
+        }
+        else
+        {
+            JsonParser_SetError(parser, JsonType_Null, JsonError_WrongFormat, "JSON must be starting with '{' or '[', first character is '%c'", JsonParser_PeekChar(parser));
+        }
+    }
+
+    return value;
+}
+
+/* @funcdef: JsonParse */
+JsonResult JsonParse(const char* jsonCode, int32_t jsonCodeLength, JsonParseFlags flags, void* buffer, int32_t bufferSize, Json* outValue)
+{
+    return JsonParseParallel(jsonCode, jsonCodeLength, flags, NULL, buffer, bufferSize, outValue);
+}
+
+/* @funcdef: JsonParser_ParseDocument
+ * Shared by the entry points, allocChunk is set for the growable chunk mode
+ */
+static JsonResult JsonParser_ParseDocument(const char* jsonCode, int32_t jsonCodeLength, JsonParseFlags flags, JsonSkipFunc skip, void* skipUserData, JsonParallelForFunc parallelFor,
+                                           JsonAllocChunkFunc allocChunk, void* userData, void* buffer, int32_t bufferSize, Json* outValue)
+{
+    JSON_ASSERT(outValue, "outValue mustnot be null");
+
+    // Validate json input
+    if (!jsonCode || jsonCodeLength <= 0)
+    {
+        //const JsonResult result = { JsonError_WrongFormat, "Json code is empty", NULL, 0 };
+        const JsonResult result = { JsonError_WrongFormat, "Json code is empty", 0 };
+        return result;
+    }
+    
+    // Create new allocator, chunks are asked for on the first allocation when there is no buffer
+    JsonAllocator allocator;
+    if (!JsonAllocator_Init(&allocator, buffer, bufferSize))
+    {
+        if (!allocChunk)
+        {
+            //const JsonResult result = { JsonError_OutOfMemory, "Buffer is too small", NULL, 0 };
+            const JsonResult result = { JsonError_OutOfMemory, "Buffer is too small", 0 };
+            return result;
+        }
+
+        memset(&allocator, 0, sizeof(allocator));
+    }
+
+    allocator.allocChunk = allocChunk;
+    allocator.userData   = userData;
+
+    // Create parser
+    JsonParser parser;
+    if (!JsonParser_Init(&parser, jsonCode, jsonCodeLength, allocator, flags))
+    {
+        //const JsonResult result = { JsonError_InternalFatal, "Wrong behaviour when create new parser", NULL, 0 };
+        const JsonResult result = { JsonError_InternalFatal, "Wrong behaviour when create new parser", 0 };
+        return result;
+    }
+
+    // Comments are not indexed, the arrays cannot be scanned
+    parser.parallelFor = (flags & JsonParseFlags_SupportComment) ? NULL : parallelFor;
+
+    parser.skip         = skip;
+    parser.skipUserData = skipUserData;
+    
+    // Parse the top level
+    Json* value = JsonState_ParseTopLevel(&parser);
+    *outValue = value ? *value : JSON_NULL;
+
+    // Done!
+	JsonResult result;
+	result.error = parser.errnum;
+	result.message = parser.errmsg ? parser.errmsg : (parser.errnum == JsonError_None ? "Success!" : "Not enough memory for the error message");
+
+    //result.parser = NULL;
+	result.memoryUsage = parser.allocator.chunkUsage + (int32_t)(parser.allocator.lowerMarker - parser.allocator.buffer);
+    return result;
+}
+
+/* @funcdef: JsonParseParallel */
+JsonResult JsonParseParallel(const char* jsonCode, int32_t jsonCodeLength, JsonParseFlags flags, JsonParallelForFunc parallelFor, void* buffer, int32_t bufferSize, Json* outValue)
+{
+    return JsonParser_ParseDocument(jsonCode, jsonCodeLength, flags, NULL, NULL, parallelFor, NULL, NULL, buffer, bufferSize, outValue);
+}
+
+/* @funcdef: JsonParseChunked */
+JsonResult JsonParseChunked(const char* jsonCode, int32_t jsonCodeLength, JsonParseFlags flags, JsonAllocChunkFunc allocChunk, void* userData, void* buffer, int32_t bufferSize, Json* outValue)
+{
+    JSON_ASSERT(allocChunk, "allocChunk mustnot be null");
+    return JsonParser_ParseDocument(jsonCode, jsonCodeLength, flags, NULL, NULL, NULL, allocChunk, userData, buffer, bufferSize, outValue);
+}
+
+/* @funcdef: JsonParseSkipping */
+JsonResult JsonParseSkipping(const char* jsonCode, int32_t jsonCodeLength, JsonParseFlags flags, JsonSkipFunc skip, void* skipUserData,
+                             JsonParallelForFunc parallelFor, JsonAllocChunkFunc allocChunk, void* chunkUserData,
+                             void* buffer, int32_t bufferSize, Json* outValue)
+{
+    JSON_ASSERT(!parallelFor || !allocChunk, "parallelFor and allocChunk mustnot be both set");
+    return JsonParser_ParseDocument(jsonCode, jsonCodeLength, flags, skip, skipUserData, parallelFor, allocChunk, chunkUserData, buffer, bufferSize, outValue);
+}
+
+// -------------------------------------------------------------------
+// Memory query
+// -------------------------------------------------------------------
+
+/*
+JsonMemoryQuery: replay the allocations of the serial parser on the structural index
+Containers are counted and strings measured in document order, no value is built. The lower side,
+the temporary arrays of the open containers on the upper side and the peak of both are tracked
+with the same block sizes and growth steps as JsonAllocator and JsonTempArray.
+Malformed documents may be reported by JsonParse only, the structure is checked, not the scalars.
+@note: internal only
+*/
+typedef struct JsonMemoryQuery
+{
+    const char*         buffer;
+    int32_t             length;
+    JsonParseFlags      flags;
+
+    JsonStructuralIndex index;
+    int32_t             cursor;         // Current token
+
+    int64_t             lower;
+    int64_t             upper;
+    int64_t             peak;
+
+    JsonError           errnum;
+    const char*         errmsg;
+    jmp_buf             errjmp;
+
+    JsonSkipFunc        skip;           // Like the parser, skipped values allocate nothing
+    void*               skipUserData;
+    int32_t             depth;
+    const char*         name;
+} JsonMemoryQuery;
+
+JSON_INLINE void JsonMemoryQuery_Panic(JsonMemoryQuery* query, JsonError code, const char* message)
+{
+    query->errnum = code;
+    query->errmsg = message;
+    longjmp(query->errjmp, code);
+}
+
+/* @funcdef: JsonMemoryQuery_Next
+ * Move to the next token, return its first byte, 0 at the end of the document
+ */
+JSON_INLINE char JsonMemoryQuery_Next(JsonMemoryQuery* query)
+{
+    query->cursor = JsonStructuralIndex_NextAfter(&query->index, query->cursor);
+    return query->cursor < query->length ? query->buffer[query->cursor] : 0;
+}
+
+JSON_INLINE void JsonMemoryQuery_Track(JsonMemoryQuery* query)
+{
+    const int64_t usage = query->lower + query->upper;
+    query->peak = usage > query->peak ? usage : query->peak;
+}
+
+/* @funcdef: JsonMemoryQuery_Push
+ * Item count of the container after the push, the temporary array move to the upper side past its fixed capacity
+ */
+JSON_INLINE void JsonMemoryQuery_Push(JsonMemoryQuery* query, int32_t count, int32_t capacity, int32_t itemSize, int32_t* size, int64_t* block)
+{
+    const int32_t dynamicCount = count - capacity - 1;   // Before the push
+    if (dynamicCount < 0 || *size >= dynamicCount + 1)
+    {
+        return;
+    }
+
+    // JsonArray_EnsureSize then JsonArray_Grow, the block is the last one of the upper side
+    int32_t newSize = *size + (*size >> 1);
+    newSize = newSize < 32 ? 32 : newSize;
+    newSize = newSize < dynamicCount + 2 ? dynamicCount + 2 : newSize;
+
+    query->upper -= *block;
+    *block = ((int64_t)sizeof(JsonArray) + (int64_t)newSize * itemSize + (int64_t)sizeof(Json) - 1) & ~((int64_t)sizeof(Json) - 1);
+    query->upper += *block;
+    *size = newSize;
+
+    JsonMemoryQuery_Track(query);
+}
+
+/* @funcdef: Json_DecodedLength
+ * Length of a string once its escape sequences are decoded, -1 on unknown or malformed escape (JsonParser_DecodeEscapes)
+ */
+static int32_t Json_DecodedLength(const char* string, int32_t length)
+{
+    int32_t decodedLength = 0;
+    int32_t i = 0;
+    while (i < length)
+    {
+        const char* escape = (const char*)memchr(string + i, '\\', (size_t)(length - i));
+        if (!escape)
+        {
+            return decodedLength + length - i;
+        }
+
+        decodedLength += (int32_t)(escape - (string + i));
+        i = (int32_t)(escape - string);
+
+        if (string[i + 1] == 'u')
+        {
+            char output[8];
+            int32_t consumed;
+            const int32_t written = Utf8_DecodeUnicodeEscape(string + i, length - i, output, &consumed);
+            if (written == 0)
+            {
+                return -1;
+            }
+
+            decodedLength += written;
+            i += consumed;
+        }
+        else if (strchr("ntrbf/\\\"", string[i + 1]) && string[i + 1] != '\0')
+        {
+            decodedLength++;
+            i += 2;
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
+    return decodedLength;
+}
+
+/* @funcdef: JsonMemoryQuery_String
+ * The cursor is on the opening quote, move it to the closing one (JsonParser_ParseStringNoToken)
+ */
+static void JsonMemoryQuery_String(JsonMemoryQuery* query)
+{
+    const int32_t start = query->cursor + 1;
+
+    int32_t escapeCount = 0;
+    while (true)
+    {
+        const char c = JsonMemoryQuery_Next(query);
+        if (c == '"')
+        {
+            break;
+        }
+        else if (c == '\\')
+        {
+            escapeCount++;
+        }
+        else
+        {
+            JsonMemoryQuery_Panic(query, JsonError_UnmatchToken, "Expected '\"'");
+        }
+    }
+
+    const int32_t rawLength = query->cursor - start;
+    if (rawLength == 0 || (query->flags & JsonParseFlags_InSitu))
+    {
+        return;
+    }
+
+    // The raw length is allocated first, then given back down to the decoded length
+    const int64_t rawBlock = JsonAllocator_BlockSize(rawLength + 1);
+    query->lower += rawBlock;
+    JsonMemoryQuery_Track(query);
+
+    if (escapeCount > 0)
+    {
+        const int32_t length = Json_DecodedLength(query->buffer + start, rawLength);
+        if (length < 0)
+        {
+            JsonMemoryQuery_Panic(query, JsonError_UnknownToken, "Invalid escape sequence in string");
+        }
+
+        query->lower += JsonAllocator_BlockSize(length + 1) - rawBlock;
+    }
+}
+
+static void JsonMemoryQuery_Value(JsonMemoryQuery* query);
+
+/* @funcdef: JsonMemoryQuery_SkipContainer
+ * The cursor is on the bracket opening the value, it is left on the one closing it (JsonParser_SkipContainer)
+ */
+static void JsonMemoryQuery_SkipContainer(JsonMemoryQuery* query)
+{
+    int32_t depth = 0;
+    char c = query->buffer[query->cursor];
+    while (true)
+    {
+        if (c == '[' || c == '{')
+        {
+            depth++;
+        }
+        else if ((c == ']' || c == '}') && --depth == 0)
+        {
+            break;
+        }
+        else if (c == 0)
+        {
+            JsonMemoryQuery_Panic(query, JsonError_UnmatchToken, "Expected ']' or '}'");
+        }
+
+        c = JsonMemoryQuery_Next(query);
+    }
+}
+
+/* @funcdef: JsonMemoryQuery_Child
+ * Member value or array item, the skip hook see the arrays and objects like JsonParser_ParseChild
+ */
+static void JsonMemoryQuery_Child(JsonMemoryQuery* query, const char* name, bool isItem)
+{
+    if (!query->skip)
+    {
+        JsonMemoryQuery_Value(query);
+        return;
+    }
+
+    const char c = query->cursor < query->length ? query->buffer[query->cursor] : 0;
+    if (c == '[' || c == '{')
+    {
+        const JsonSkipTarget target = { query->depth + 1, name, isItem, query->buffer + query->cursor, query->length - query->cursor };
+        if (query->skip(query->skipUserData, &target))
+        {
+            JsonMemoryQuery_SkipContainer(query);
+            return;
+        }
+    }
+
+    const char* parentName = query->name;
+    query->name = name;
+    query->depth++;
+
+    JsonMemoryQuery_Value(query);
+
+    query->name = parentName;
+    query->depth--;
+}
+
+/* @funcdef: JsonMemoryQuery_Array */
+static void JsonMemoryQuery_Array(JsonMemoryQuery* query)
+{
+    int32_t count = 0;
+    int32_t size  = 0;
+    int64_t block = 0;
+
+    char c = JsonMemoryQuery_Next(query);
+    while (c != ']')
+    {
+        if (count > 0)
+        {
+            if (c != ',')
+            {
+                JsonMemoryQuery_Panic(query, JsonError_UnexpectedToken, "Expected ',' or ']'");
+            }
+            JsonMemoryQuery_Next(query);
+        }
+
+        JsonMemoryQuery_Child(query, query->name, true);
+        JsonMemoryQuery_Push(query, ++count, 64, (int32_t)sizeof(Json), &size, &block);
+        c = JsonMemoryQuery_Next(query);
+    }
+
+    if (count > 0)
+    {
+        query->lower += JsonAllocator_BlockSize(count * (int32_t)sizeof(Json));
+        JsonMemoryQuery_Track(query);
+    }
+    query->upper -= block;
+}
+
+/* @funcdef: JsonMemoryQuery_Object */
+static void JsonMemoryQuery_Object(JsonMemoryQuery* query)
+{
+    int32_t count = 0;
+    int32_t size  = 0;
+    int64_t block = 0;
+
+    char        name[JSON_SKIP_NAME_SIZE];
+    const char* skipName = NULL;
+
+    char c = JsonMemoryQuery_Next(query);
+    while (c != '}')
+    {
+        if (count > 0)
+        {
+            if (c != ',')
+            {
+                JsonMemoryQuery_Panic(query, JsonError_UnexpectedToken, "Expected ',' or '}'");
+            }
+            c = JsonMemoryQuery_Next(query);
+        }
+
+        if (c != '"')
+        {
+            JsonMemoryQuery_Panic(query, JsonError_UnexpectedToken, "Expected <string> for <member-key> of <object>");
+        }
+        const int32_t nameStart = query->cursor + 1;
+        JsonMemoryQuery_String(query);
+
+        // The parser give the skip hook the decoded name
+        if (query->skip)
+        {
+            const int32_t rawLength = query->cursor - nameStart;
+            const int32_t nameLength = Json_DecodedLength(query->buffer + nameStart, rawLength);
+            skipName = NULL;
+            if (nameLength >= 0 && nameLength < JSON_SKIP_NAME_SIZE)
+            {
+                JsonParser_DecodeEscapes(query->buffer + nameStart, rawLength, name);
+                name[nameLength] = '\0';
+                skipName = name;
+            }
+        }
+
+        if (JsonMemoryQuery_Next(query) != ':')
+        {
+            JsonMemoryQuery_Panic(query, JsonError_UnexpectedToken, "Expected ':'");
+        }
+
+        JsonMemoryQuery_Next(query);
+        JsonMemoryQuery_Child(query, skipName, false);
+        JsonMemoryQuery_Push(query, ++count, 32, (int32_t)sizeof(JsonObjectMember), &size, &block);
+        c = JsonMemoryQuery_Next(query);
+    }
+
+    if (count > 0)
+    {
+        query->lower += JsonAllocator_BlockSize(JsonObject_AllocSize(count));
+        JsonMemoryQuery_Track(query);
+    }
+    query->upper -= block;
+}
+
+/* @funcdef: JsonMemoryQuery_Value
+ * The cursor is on the first token of the value, it is left on its last one
+ */
+static void JsonMemoryQuery_Value(JsonMemoryQuery* query)
+{
+    switch (query->cursor < query->length ? query->buffer[query->cursor] : 0)
+    {
+    case '[':
+        JsonMemoryQuery_Array(query);
+        break;
+
+    case '{':
+        JsonMemoryQuery_Object(query);
+        break;
+
+    case '"':
+        JsonMemoryQuery_String(query);
+        break;
+
+    case ']': case '}': case ',': case ':': case 0:
+        JsonMemoryQuery_Panic(query, JsonError_UnexpectedToken, "Expected a value");
+        break;
+
+    // Numbers and literals do not allocate
+    default:
+        break;
+    }
+}
+
+/* @funcdef: JsonMemoryQuery_Run
+ * Shared by the entry points, skip is set for JsonQueryMemorySkipping
+ */
+static JsonResult JsonMemoryQuery_Run(const char* jsonCode, int32_t jsonCodeLength, JsonParseFlags flags, JsonSkipFunc skip, void* skipUserData, int32_t* outBufferSize)
+{
+    if (outBufferSize)
+    {
+        *outBufferSize = 0;
+    }
+
+    if (!jsonCode || jsonCodeLength <= 0)
+    {
+        const JsonResult result = { JsonError_WrongFormat, "Json code is empty", 0 };
+        return result;
+    }
+
+    // Comments are not in the structural index
+    if (flags & JsonParseFlags_SupportComment)
+    {
+        const JsonResult result = { JsonError_UnsupportedToken, "JsonQueryMemory does not support comments", 0 };
+        return result;
+    }
+
+    JsonMemoryQuery query;
+    query.buffer    = jsonCode;
+    query.length    = jsonCodeLength;
+    query.flags     = flags;
+    query.cursor    = -1;
+    query.errnum    = JsonError_None;
+    query.errmsg    = "Success!";
+    JsonStructuralIndex_Init(&query.index, jsonCode, jsonCodeLength);
+
+    query.skip          = skip;
+    query.skipUserData  = skipUserData;
+    query.depth         = 0;
+    query.name          = NULL;
+
+    // The top level value come first
+    query.lower     = sizeof(Json);
+    query.upper     = 0;
+    query.peak      = query.lower;
+
+    if (setjmp(query.errjmp) == 0)
+    {
+        const char c = JsonMemoryQuery_Next(&query);
+        if (!(flags & JsonParseFlags_NoStrictTopLevel) && c != '{' && c != '[')
+        {
+            JsonMemoryQuery_Panic(&query, JsonError_WrongFormat, "JSON must be starting with '{' or '['");
+        }
+
+        // Like JsonParse, the first value is the whole document without strict top level, nothing is null
+        if (c != 0 || !(flags & JsonParseFlags_NoStrictTopLevel))
+        {
+            JsonMemoryQuery_Value(&query);
+        }
+
+        if (!(flags & JsonParseFlags_NoStrictTopLevel) && JsonMemoryQuery_Next(&query) != 0)
+        {
+            JsonMemoryQuery_Panic(&query, JsonError_WrongFormat, "JSON is not well-formed");
+        }
+
+        if (query.peak > INT32_MAX)
+        {
+            JsonMemoryQuery_Panic(&query, JsonError_OutOfMemory, "JSON is too large");
+        }
+    }
+
+    JsonResult result;
+    result.error = query.errnum;
+    result.message = query.errmsg;
+    result.memoryUsage = query.errnum == JsonError_None ? (int32_t)query.lower : 0;
+    if (outBufferSize && query.errnum == JsonError_None)
+    {
+        *outBufferSize = (int32_t)query.peak;
+    }
+    return result;
+}
+
+/* @funcdef: JsonQueryMemory */
+JsonResult JsonQueryMemory(const char* jsonCode, int32_t jsonCodeLength, JsonParseFlags flags, int32_t* outBufferSize)
+{
+    return JsonMemoryQuery_Run(jsonCode, jsonCodeLength, flags, NULL, NULL, outBufferSize);
+}
+
+/* @funcdef: JsonQueryMemorySkipping */
+JsonResult JsonQueryMemorySkipping(const char* jsonCode, int32_t jsonCodeLength, JsonParseFlags flags, JsonSkipFunc skip, void* skipUserData, int32_t* outBufferSize)
+{
+    return JsonMemoryQuery_Run(jsonCode, jsonCodeLength, flags, skip, skipUserData, outBufferSize);
+}
+
+/* @funcdef: JsonEquals */
+bool JsonEquals(const Json a, const Json b)
+{
+    if (a.type != b.type)
+    {
+        return false;
+    }
+
+    switch (a.type)
+    {
+    case JsonType_Null:
+        return true;
+
+    case JsonType_Number:
+        if (a.length == JsonNumberKind_Integer && b.length == JsonNumberKind_Integer)
+        {
+            return a.integer == b.integer;
+        }
+        return JsonNumber(a) == JsonNumber(b);
+
+    case JsonType_Boolean:
+        return a.boolean == b.boolean;
+
+    case JsonType_Array: {
+        if (a.length != b.length)
+        {
+            return false;
+        }
+
+        for (int32_t i = 0, n = a.length; i < n; i++)
+        {
+            if (!JsonEquals(a.array[i], b.array[i]))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    case JsonType_Object: {
+        if (a.length != b.length)
+        {
+            return false;
+        }
+
+        for (int32_t i = 0, n = a.length; i < n; i++)
+        {
+            const char* name = b.object[i].name ? b.object[i].name : "";
+            if (!JsonObject_NameEquals(&a.object[i], name))
+            {
+                return false;
+            }
+
+            if (!JsonEquals(a.object[i].value, b.object[i].value))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    case JsonType_String:
+        return a.length == b.length && (a.length == 0 || memcmp(a.string, b.string, (size_t)a.length) == 0);
+
+    default:
+        JSON_ASSERT(false, "invalid json type");
+        break;
+    }
+
+    return false;
+}
+
+/* @funcdef: JsonMakeKey */
+JsonKey JsonMakeKey(const char* name)
+{
+    JSON_ASSERT(name, "Attempt using nullptr as string");
+
+    JsonKey key;
+    key.name    = name;
+    key.length  = (int32_t)strlen(name);
+    key.hash    = Json_HashName(name, key.length);
+    return key;
+}
+
+/* @funcdef: Json_MakeFindKey
+ * Small objects are scanned without the hash, skip hashing the name for them
+ */
+JSON_INLINE JsonKey Json_MakeFindKey(const Json parent, const char* name)
+{
+    JSON_ASSERT(name, "Attempt using nullptr as string");
+
+    if (parent.type == JsonType_Object && !parent.indexed)
+    {
+        JsonKey key;
+        key.name    = name;
+        key.length  = (int32_t)strlen(name);
+        key.hash    = 0;
+        return key;
+    }
+
+    return JsonMakeKey(name);
+}
+
+/* @funcdef: JsonFind */
+bool JsonFind(const Json parent, const char* name, Json* outResult)
+{
+    const JsonKey key = Json_MakeFindKey(parent, name);
+    return JsonFindKey(parent, key, outResult);
+}
+
+/* @funcdef: JsonFindWithType */
+JsonError JsonFindWithType(const Json parent, const char* name, JsonType type, Json* outResult)
+{
+    const JsonKey key = Json_MakeFindKey(parent, name);
+    return JsonFindKeyWithType(parent, key, type, outResult);
+}
+
+/* @funcdef: JsonFindKey */
+bool JsonFindKey(const Json parent, const JsonKey key, Json* outResult)
+{
+    JSON_ASSERT(outResult, "outResult mustnot be null");
+    JSON_ASSERT(JsonValidType(parent), "invalid json type");
+
+    if (parent.type == JsonType_Object)
+    {
+        const JsonObjectMember* member = JsonObject_FindMember(parent, &key);
+        if (member)
+        {
+            JSON_ASSERT(JsonValidType(member->value), "invalid json type");
+
+            *outResult = member->value;
+            return true;
+        }
+    }
+
+    *outResult = JSON_NULL;
+    return false;
+}
+
+/* @funcdef: JsonFindKeyWithType */
+JsonError JsonFindKeyWithType(const Json parent, const JsonKey key, JsonType type, Json* outResult)
+{
+    JSON_ASSERT(outResult, "outResult mustnot be null");
+    JSON_ASSERT(JsonValidType(parent), "invalid json type");
+
+    if (parent.type == JsonType_Object)
+    {
+        const JsonObjectMember* member = JsonObject_FindMember(parent, &key);
+        if (member)
+        {
+            JSON_ASSERT(JsonValidType(member->value), "invalid json type");
+
+            *outResult = member->value;
+            return member->value.type == type ? JsonError_None : JsonError_WrongType;
+        }
+
+        *outResult = JSON_NULL;
+        return JsonError_MissingField;
+    }
+
+    *outResult = JSON_NULL;
+    return JsonError_WrongType;
+}
+
+// -------------------------------------------------------------------
+// Streaming reader
+// -------------------------------------------------------------------
+
+/* What come next in the document */
+typedef enum JsonReaderExpect
+{
+    JsonReaderExpect_TopLevel,
+    JsonReaderExpect_Value,                 // After ':' or ',' in an array
+    JsonReaderExpect_ValueOrArrayEnd,       // After '['
+    JsonReaderExpect_NameOrObjectEnd,       // After '{'
+    JsonReaderExpect_Colon,                 // After a name, ':' is consumed with the value so the name stay in the buffer
+    JsonReaderExpect_Separator,             // After a value, ',' or the end of its parent
+    JsonReaderExpect_End,
+} JsonReaderExpect;
+
+/* @funcdef: JsonReader_SetError
+ * Keep the first error, the reader stop there
+ */
+static JsonToken JsonReader_SetError(JsonReader* reader, JsonError code, const char* fmt, ...)
+{
+    if (reader->error == JsonError_None)
+    {
+        char text[192];
+
+        va_list varg;
+        va_start(varg, fmt);
+        vsnprintf(text, sizeof(text), fmt, varg);
+        va_end(varg);
+
+        snprintf(reader->message, sizeof(reader->message), "%s\n\tAt offset %lld.", text, (long long)(reader->offset + reader->cursor));
+        reader->error = code;
+    }
+
+    reader->token = JsonToken_Error;
+    reader->value = JSON_NULL;
+    return JsonToken_Error;
+}
+
+/* @funcdef: JsonReader_Fill
+ * Move the unread bytes to the start of the buffer, then read more after them.
+ * Return the number of bytes read, 0 at the end of input or when the buffer is full.
+ */
+static int32_t JsonReader_Fill(JsonReader* reader)
+{
+    if (reader->isEndOfInput || reader->error != JsonError_None)
+    {
+        return 0;
+    }
+
+    if (reader->cursor > 0)
+    {
+        const int32_t remain = reader->length - reader->cursor;
+        memmove(reader->buffer, reader->buffer + reader->cursor, (size_t)remain);
+
+        reader->offset += reader->cursor;
+        reader->length  = remain;
+        reader->cursor  = 0;
+    }
+
+    const int32_t space = reader->bufferSize - reader->length;
+    if (space == 0)
+    {
+        return 0;
+    }
+
+    const int32_t count = reader->read(reader->userData, reader->buffer + reader->length, space);
+    if (count <= 0)
+    {
+        reader->isEndOfInput = true;
+        if (count < 0)
+        {
+            JsonReader_SetError(reader, JsonError_InternalFatal, "Failed to read the input");
+        }
+        return 0;
+    }
+
+    reader->length += count;
+    return count;
+}
+
+/* @funcdef: JsonReader_Ensure
+ * Make count bytes after the cursor available when the input has them, return the available count
+ */
+static int32_t JsonReader_Ensure(JsonReader* reader, int32_t count)
+{
+    while (reader->length - reader->cursor < count && JsonReader_Fill(reader) > 0)
+    {
+    }
+
+    return reader->length - reader->cursor;
+}
+
+/* @funcdef: JsonReader_PeekByte */
+JSON_INLINE int JsonReader_PeekByte(JsonReader* reader)
+{
+    if (reader->cursor >= reader->length && JsonReader_Fill(reader) == 0)
+    {
+        return -1;
+    }
+
+    return (uint8_t)reader->buffer[reader->cursor];
+}
+
+/* @funcdef: JsonReader_SkipSpace
+ * Skip whitespaces and comments, return the next byte, -1 at the end of input or on error
+ */
+static int JsonReader_SkipSpace(JsonReader* reader)
+{
+    while (true)
+    {
+        int c = JsonReader_PeekByte(reader);
+        while (JsonParser_IsSpace(c))
+        {
+            reader->cursor++;
+            c = JsonReader_PeekByte(reader);
+        }
+
+        if (c != '/' || !(reader->flags & JsonParseFlags_SupportComment))
+        {
+            return c;
+        }
+
+        reader->cursor++;
+        c = JsonReader_PeekByte(reader);
+        if (c == '/')
+        {
+            while (c >= 0 && c != '\n')
+            {
+                reader->cursor++;
+                c = JsonReader_PeekByte(reader);
+            }
+        }
+        else if (c == '*')
+        {
+            int prev = 0;
+            reader->cursor++;
+            c = JsonReader_PeekByte(reader);
+            while (prev != '*' || c != '/')
+            {
+                if (c < 0)
+                {
+                    JsonReader_SetError(reader, JsonError_UnmatchToken, "Unterminated comment");
+                    return -1;
+                }
+
+                prev = c;
+                reader->cursor++;
+                c = JsonReader_PeekByte(reader);
+            }
+
+            reader->cursor++;
+        }
+        else
+        {
+            JsonReader_SetError(reader, JsonError_UnexpectedToken, "Unexpected token '%c'", c);
+            return -1;
+        }
+    }
+}
+
+/* @funcdef: JsonReader_InObject */
+JSON_INLINE bool JsonReader_InObject(const JsonReader* reader)
+{
+    const int32_t level = reader->depth - 1;
+    return (reader->stack[level >> 6] >> (level & 63)) & 1;
+}
+
+/* @funcdef: JsonReader_Push */
+static bool JsonReader_Push(JsonReader* reader, bool isObject)
+{
+    if (reader->depth >= JSON_READER_MAX_DEPTH)
+    {
+        JsonReader_SetError(reader, JsonError_UnsupportedToken, "Nesting is deeper than %d levels", JSON_READER_MAX_DEPTH);
+        return false;
+    }
+
+    const int32_t   level   = reader->depth++;
+    const uint64_t  bit     = 1ull << (level & 63);
+    if (isObject)
+    {
+        reader->stack[level >> 6] |= bit;
+    }
+    else
+    {
+        reader->stack[level >> 6] &= ~bit;
+    }
+
+    return true;
+}
+
+/* @funcdef: JsonReader_ReadString
+ * The whole string is brought in the buffer, then decoded in place and null-terminated
+ */
+static bool JsonReader_ReadString(JsonReader* reader)
+{
+    int32_t scanned     = 1;                // Opening quote
+    int32_t escapeCount = 0;
+
+    while (true)
+    {
+        const int32_t   available   = reader->length - reader->cursor;
+        const char*     string      = reader->buffer + reader->cursor;
+
+        scanned += JsonParser_FindStringSpecial(string + scanned, available - scanned);
+        if (scanned >= available || (string[scanned] == '\\' && scanned + 1 >= available))
+        {
+            if (JsonReader_Ensure(reader, available + 1) > available)
+            {
+                continue;
+            }
+
+            if (reader->error != JsonError_None)
+            {
+                return false;
+            }
+
+            if (reader->isEndOfInput)
+            {
+                reader->cursor = reader->length;
+                JsonReader_SetError(reader, JsonError_UnmatchToken, "Expected '\"'");
+            }
+            else
+            {
+                JsonReader_SetError(reader, JsonError_OutOfMemory, "<string> is larger than the reader buffer (%d bytes)", reader->bufferSize);
+            }
+            return false;
+        }
+
+        const char c = string[scanned];
+        if (c == '"')
+        {
+            break;
+        }
+        else if (c == '\\')
+        {
+            // The escaped character is checked when decoding, only the end matter here
+            escapeCount++;
+            scanned += 2;
+        }
+        else if (c == '\r' || c == '\n')
+        {
+            reader->cursor += scanned;
+            JsonReader_SetError(reader, JsonError_UnexpectedToken, "Unexpected newline characters '%c'", c);
+            return false;
+        }
+        else if (c == '\0')
+        {
+            reader->cursor += scanned;
+            JsonReader_SetError(reader, JsonError_UnmatchToken, "Expected '\"'");
+            return false;
+        }
+        else
+        {
+            scanned++;
+        }
+    }
+
+    char* string = reader->buffer + reader->cursor + 1;
+    const int32_t rawLength = scanned - 1;
+    if (!Utf8_Validate(string, rawLength))
+    {
+        reader->cursor += 1 + Utf8_ValidPrefix(string, rawLength);
+        JsonReader_SetError(reader, JsonError_WrongFormat, "Invalid UTF-8 sequence");
+        return false;
+    }
+
+    int32_t length = rawLength;
+    if (escapeCount > 0)
+    {
+        length = JsonParser_DecodeEscapes(string, rawLength, string);
+        if (length < 0)
+        {
+            JsonReader_SetError(reader, JsonError_UnknownToken, "Invalid escape sequence in string");
+            return false;
+        }
+    }
+
+    // The closing quote is consumed, there is always room for the terminator
+    string[length] = '\0';
+    reader->cursor += scanned + 1;
+
+    reader->value.type   = JsonType_String;
+    reader->value.length = length;
+    reader->value.string = string;
+    return true;
+}
+
+/* @funcdef: Json_IsNumberChar */
+JSON_INLINE bool Json_IsNumberChar(int c)
+{
+    return Json_IsDigit(c) || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+/* @funcdef: JsonReader_ReadNumber */
+static bool JsonReader_ReadNumber(JsonReader* reader)
+{
+    int32_t length = 0;
+    while (true)
+    {
+        const int32_t   available   = reader->length - reader->cursor;
+        const char*     text        = reader->buffer + reader->cursor;
+        while (length < available && Json_IsNumberChar(text[length]))
+        {
+            length++;
+        }
+
+        if (length < available)
+        {
+            break;
+        }
+
+        if (JsonReader_Ensure(reader, available + 1) <= available)
+        {
+            if (reader->error != JsonError_None)
+            {
+                return false;
+            }
+
+            if (reader->isEndOfInput)
+            {
+                break;
+            }
+
+            JsonReader_SetError(reader, JsonError_OutOfMemory, "<number> is larger than the reader buffer (%d bytes)", reader->bufferSize);
+            return false;
+        }
+    }
+
+    char message[128];
+    int32_t numberLength;
+    const JsonError error = Json_ParseNumberText(reader->buffer + reader->cursor, length, reader->flags, &reader->value, &numberLength, message, (int32_t)sizeof(message));
+    if (error != JsonError_None)
+    {
+        reader->cursor += numberLength;
+        JsonReader_SetError(reader, error, "%s", message);
+        return false;
+    }
+
+    if (numberLength != length)
+    {
+        reader->cursor += numberLength;
+        JsonReader_SetError(reader, JsonError_UnexpectedToken, "Unexpected character '%c' in <number>", reader->buffer[reader->cursor]);
+        return false;
+    }
+
+    reader->cursor += length;
+    return true;
+}
+
+/* @funcdef: JsonReader_ReadLiteral */
+static bool JsonReader_ReadLiteral(JsonReader* reader)
+{
+    const int32_t   available   = JsonReader_Ensure(reader, 6);
+    const char*     text        = reader->buffer + reader->cursor;
+
+    int32_t length = 0;
+    while (length < available && length < 6 && isalpha((uint8_t)text[length]))
+    {
+        length++;
+    }
+
+    if (length == 4 && memcmp(text, "null", 4) == 0)
+    {
+        reader->value = JSON_NULL;
+    }
+    else if (length == 4 && memcmp(text, "true", 4) == 0)
+    {
+        reader->value = JSON_TRUE;
+    }
+    else if (length == 5 && memcmp(text, "false", 5) == 0)
+    {
+        reader->value = JSON_FALSE;
+    }
+    else if (length > 0)
+    {
+        JsonReader_SetError(reader, JsonError_UnexpectedToken, "Unexpected token '%.*s'", (int)length, text);
+        return false;
+    }
+    else
+    {
+        JsonReader_SetError(reader, JsonError_UnexpectedToken, "Unexpected token '%c'", available > 0 ? text[0] : ' ');
+        return false;
+    }
+
+    reader->cursor += length;
+    return true;
+}
+
+/* @funcdef: JsonReader_ReadValue
+ * c is the first byte of the value, not consumed yet
+ */
+static JsonToken JsonReader_ReadValue(JsonReader* reader, int c)
+{
+    switch (c)
+    {
+    case '{':
+    case '[':
+        if (!JsonReader_Push(reader, c == '{'))
+        {
+            return JsonToken_Error;
+        }
+
+        reader->cursor++;
+        reader->value = JSON_NULL;
+        reader->expect = c == '{' ? JsonReaderExpect_NameOrObjectEnd : JsonReaderExpect_ValueOrArrayEnd;
+        return c == '{' ? JsonToken_ObjectBegin : JsonToken_ArrayBegin;
+
+    case '"':
+        if (!JsonReader_ReadString(reader))
+        {
+            return JsonToken_Error;
+        }
+        break;
+
+    case '+': case '-': case '0':
+    case '1': case '2': case '3':
+    case '4': case '5': case '6':
+    case '7': case '8': case '9':
+        if (!JsonReader_ReadNumber(reader))
+        {
+            return JsonToken_Error;
+        }
+        break;
+
+    case -1:
+        return JsonReader_SetError(reader, JsonError_UnexpectedToken, "Reached the end of json!");
+
+    default:
+        if (!JsonReader_ReadLiteral(reader))
+        {
+            return JsonToken_Error;
+        }
+        break;
+    }
+
+    reader->expect = JsonReaderExpect_Separator;
+    return JsonToken_Value;
+}
+
+/* @funcdef: JsonReader_ReadName */
+static JsonToken JsonReader_ReadName(JsonReader* reader, int c)
+{
+    if (c != '"')
+    {
+        return JsonReader_SetError(reader, JsonError_UnexpectedToken, "Expected <string> for <member-key> of <object>");
+    }
+
+    if (!JsonReader_ReadString(reader))
+    {
+        return JsonToken_Error;
+    }
+
+    reader->expect = JsonReaderExpect_Colon;
+    return JsonToken_Name;
+}
+
+/* @funcdef: JsonReader_CloseContainer
+ * c is '}' or ']', check it against the current container
+ */
+static JsonToken JsonReader_CloseContainer(JsonReader* reader, int c)
+{
+    const bool inObject = JsonReader_InObject(reader);
+    if (inObject != (c == '}'))
+    {
+        return JsonReader_SetError(reader, JsonError_UnmatchToken, "Expected '%c'", inObject ? '}' : ']');
+    }
+
+    reader->cursor++;
+    reader->depth--;
+    reader->value = JSON_NULL;
+    reader->expect = JsonReaderExpect_Separator;
+    return inObject ? JsonToken_ObjectEnd : JsonToken_ArrayEnd;
+}
+
+/* @funcdef: JsonReader_ReadToken */
+static JsonToken JsonReader_ReadToken(JsonReader* reader)
+{
+    int c = JsonReader_SkipSpace(reader);
+    if (reader->error != JsonError_None)
+    {
+        return JsonToken_Error;
+    }
+
+    switch (reader->expect)
+    {
+    case JsonReaderExpect_TopLevel:
+        if (c < 0)
+        {
+            return JsonReader_SetError(reader, JsonError_WrongFormat, "Json code is empty");
+        }
+
+        if (!(reader->flags & JsonParseFlags_NoStrictTopLevel) && c != '{' && c != '[')
+        {
+            return JsonReader_SetError(reader, JsonError_WrongFormat, "JSON must be starting with '{' or '[', first character is '%c'", c);
+        }
+        return JsonReader_ReadValue(reader, c);
+
+    case JsonReaderExpect_Value:
+        return JsonReader_ReadValue(reader, c);
+
+    case JsonReaderExpect_ValueOrArrayEnd:
+        return c == ']' ? JsonReader_CloseContainer(reader, c) : JsonReader_ReadValue(reader, c);
+
+    case JsonReaderExpect_NameOrObjectEnd:
+        return c == '}' ? JsonReader_CloseContainer(reader, c) : JsonReader_ReadName(reader, c);
+
+    case JsonReaderExpect_Colon:
+        if (c != ':')
+        {
+            return JsonReader_SetError(reader, JsonError_UnmatchToken, "Expected ':'");
+        }
+
+        reader->cursor++;
+        c = JsonReader_SkipSpace(reader);
+        if (reader->error != JsonError_None)
+        {
+            return JsonToken_Error;
+        }
+        return JsonReader_ReadValue(reader, c);
+
+    case JsonReaderExpect_Separator:
+        if (reader->depth == 0)
+        {
+            // Like JsonParse, the first value is the whole document without strict top level
+            if (c >= 0 && !(reader->flags & JsonParseFlags_NoStrictTopLevel))
+            {
+                return JsonReader_SetError(reader, JsonError_WrongFormat, "JSON is not well-formed, unexpected '%c' after the top level value", c);
+            }
+
+            reader->expect = JsonReaderExpect_End;
+            reader->value = JSON_NULL;
+            return JsonToken_End;
+        }
+
+        if (c == '}' || c == ']')
+        {
+            return JsonReader_CloseContainer(reader, c);
+        }
+
+        if (c != ',')
+        {
+            return JsonReader_SetError(reader, JsonError_UnmatchToken, "Expected ','");
+        }
+
+        reader->cursor++;
+        c = JsonReader_SkipSpace(reader);
+        if (reader->error != JsonError_None)
+        {
+            return JsonToken_Error;
+        }
+        return JsonReader_InObject(reader) ? JsonReader_ReadName(reader, c) : JsonReader_ReadValue(reader, c);
+
+    case JsonReaderExpect_End:
+    default:
+        reader->value = JSON_NULL;
+        return JsonToken_End;
+    }
+}
+
+/* @funcdef: JsonReader_SkipString
+ * Strings of skipped values are consumed chunk by chunk, they never need to fit in the buffer
+ */
+static bool JsonReader_SkipString(JsonReader* reader)
+{
+    reader->cursor++;
+
+    while (true)
+    {
+        if (JsonReader_PeekByte(reader) < 0)
+        {
+            JsonReader_SetError(reader, JsonError_UnmatchToken, "Expected '\"'");
+            return false;
+        }
+
+        const char*     string      = reader->buffer + reader->cursor;
+        const int32_t   available   = reader->length - reader->cursor;
+        const int32_t   run         = JsonParser_FindStringSpecial(string, available);
+
+        reader->cursor += run;
+        if (run == available)
+        {
+            continue;
+        }
+
+        const char c = string[run];
+        reader->cursor++;
+        if (c == '"')
+        {
+            return true;
+        }
+        else if (c == '\\' && JsonReader_PeekByte(reader) >= 0)
+        {
+            reader->cursor++;
+        }
+    }
+}
+
+/* @funcdef: JsonReader_SkipContainer
+ * Match brackets and skip strings, other tokens are not checked
+ */
+static bool JsonReader_SkipContainer(JsonReader* reader)
+{
+    const int32_t parentDepth = reader->depth - 1;
+    while (reader->depth > parentDepth)
+    {
+        const int c = JsonReader_SkipSpace(reader);
+        if (reader->error != JsonError_None)
+        {
+            return false;
+        }
+
+        switch (c)
+        {
+        case -1:
+            JsonReader_SetError(reader, JsonError_UnmatchToken, "Expected '%c'", JsonReader_InObject(reader) ? '}' : ']');
+            return false;
+
+        case '{':
+        case '[':
+            if (!JsonReader_Push(reader, c == '{'))
+            {
+                return false;
+            }
+            reader->cursor++;
+            break;
+
+        case '}':
+        case ']':
+            if (JsonReader_CloseContainer(reader, c) == JsonToken_Error)
+            {
+                return false;
+            }
+            break;
+
+        case '"':
+            if (!JsonReader_SkipString(reader))
+            {
+                return false;
+            }
+            break;
+
+        default:
+            reader->cursor++;
+            break;
+        }
+    }
+
+    reader->expect = JsonReaderExpect_Separator;
+    return true;
+}
+
+/* @funcdef: JsonReader_Init */
+bool JsonReader_Init(JsonReader* reader, JsonParseFlags flags, void* buffer, int32_t bufferSize, JsonReadFunc read, void* userData)
+{
+    JSON_ASSERT(reader, "reader mustnot be null");
+    JSON_ASSERT(read, "read mustnot be null");
+
+    memset(reader, 0, sizeof(*reader));
+    reader->flags       = flags;
+    reader->read        = read;
+    reader->userData    = userData;
+    reader->buffer      = (char*)buffer;
+    reader->bufferSize  = bufferSize;
+    reader->expect      = JsonReaderExpect_TopLevel;
+    reader->token       = JsonToken_None;
+    reader->value       = JSON_NULL;
+
+    // Literals are read whole, 6 bytes at least
+    if (!buffer || bufferSize < 16)
+    {
+        JsonReader_SetError(reader, JsonError_OutOfMemory, "Buffer is too small");
+        return false;
+    }
+
+    return true;
+}
+
+/* @funcdef: JsonReader_Next */
+JsonToken JsonReader_Next(JsonReader* reader)
+{
+    JSON_ASSERT(reader, "reader mustnot be null");
+
+    if (reader->error != JsonError_None)
+    {
+        return JsonToken_Error;
+    }
+
+    reader->token = JsonReader_ReadToken(reader);
+    return reader->token;
+}
+
+/* @funcdef: JsonReader_EnterObject */
+bool JsonReader_EnterObject(JsonReader* reader)
+{
+    const JsonToken token = JsonReader_Next(reader);
+    if (token != JsonToken_ObjectBegin && token != JsonToken_Error)
+    {
+        JsonReader_SetError(reader, JsonError_WrongType, "Expected <object>");
+    }
+
+    return token == JsonToken_ObjectBegin;
+}
+
+/* @funcdef: JsonReader_EnterArray */
+bool JsonReader_EnterArray(JsonReader* reader)
+{
+    const JsonToken token = JsonReader_Next(reader);
+    if (token != JsonToken_ArrayBegin && token != JsonToken_Error)
+    {
+        JsonReader_SetError(reader, JsonError_WrongType, "Expected <array>");
+    }
+
+    return token == JsonToken_ArrayBegin;
+}
+
+/* @funcdef: JsonReader_NextMember */
+bool JsonReader_NextMember(JsonReader* reader, const char** outName)
+{
+    const JsonToken token = JsonReader_Next(reader);
+    if (token == JsonToken_Name)
+    {
+        if (outName) *outName = reader->value.string;
+        return true;
+    }
+
+    if (token != JsonToken_ObjectEnd && token != JsonToken_Error)
+    {
+        JsonReader_SetError(reader, JsonError_UnexpectedToken, "Expected <member-key> of <object>");
+    }
+
+    return false;
+}
+
+/* @funcdef: JsonReader_NextItem
+ * Consume ',' or ']', the item itself is left to the caller
+ */
+bool JsonReader_NextItem(JsonReader* reader)
+{
+    JSON_ASSERT(reader, "reader mustnot be null");
+
+    if (reader->error != JsonError_None)
+    {
+        return false;
+    }
+
+    const bool afterItem = reader->expect == JsonReaderExpect_Separator;
+    if (reader->depth == 0 || JsonReader_InObject(reader) || (!afterItem && reader->expect != JsonReaderExpect_ValueOrArrayEnd))
+    {
+        JsonReader_SetError(reader, JsonError_UnexpectedToken, "Expected <array>");
+        return false;
+    }
+
+    const int c = JsonReader_SkipSpace(reader);
+    if (reader->error != JsonError_None)
+    {
+        return false;
+    }
+
+    if (c == ']')
+    {
+        reader->token = JsonReader_CloseContainer(reader, c);
+        return false;
+    }
+
+    if (afterItem)
+    {
+        if (c != ',')
+        {
+            JsonReader_SetError(reader, JsonError_UnmatchToken, "Expected ','");
+            return false;
+        }
+
+        reader->cursor++;
+    }
+
+    reader->expect = JsonReaderExpect_Value;
+    return true;
+}
+
+/* @funcdef: JsonReader_SkipValue */
+bool JsonReader_SkipValue(JsonReader* reader)
+{
+    JSON_ASSERT(reader, "reader mustnot be null");
+
+    if (reader->error != JsonError_None)
+    {
+        return false;
+    }
+
+    // ':' of members, the value itself is peeked to skip strings without reading them whole
+    int c = JsonReader_SkipSpace(reader);
+    if (reader->expect == JsonReaderExpect_Colon && c == ':')
+    {
+        reader->cursor++;
+        reader->expect = JsonReaderExpect_Value;
+        c = JsonReader_SkipSpace(reader);
+    }
+
+    if (reader->error != JsonError_None)
+    {
+        return false;
+    }
+
+    if ((reader->expect == JsonReaderExpect_Value || reader->expect == JsonReaderExpect_ValueOrArrayEnd) && c == '"')
+    {
+        if (!JsonReader_SkipString(reader))
+        {
+            return false;
+        }
+
+        reader->token = JsonToken_Value;
+        reader->value = JSON_NULL;
+        reader->expect = JsonReaderExpect_Separator;
+        return true;
+    }
+
+    const JsonToken token = JsonReader_Next(reader);
+    switch (token)
+    {
+    case JsonToken_Value:
+        return true;
+
+    case JsonToken_ObjectBegin:
+    case JsonToken_ArrayBegin:
+        return JsonReader_SkipContainer(reader);
+
+    case JsonToken_Error:
+        return false;
+
+    default:
+        JsonReader_SetError(reader, JsonError_UnexpectedToken, "Expected <value>");
+        return false;
+    }
+}
+
+// -------------------------------------------------------------------
+// On-demand tape
+// -------------------------------------------------------------------
+
+#define JSON_TAPE_ESCAPED       0x80000000u     // Strings with escape sequences, in JsonTapeEntry::length
+#define JSON_TAPE_NAME_LENGTH   1024            // Longest escaped name JsonTape_Find compare
+
+struct JsonTapeEntry
+{
+    uint32_t            offset;                 // First byte of the value in the document
+    uint32_t            next;                   // Node after the value and its children
+    uint32_t            length;                 // Children count of arrays and objects, raw length of strings
+};
+
+/* What come next in the document */
+typedef enum JsonTapeExpect
+{
+    JsonTapeExpect_TopLevel,
+    JsonTapeExpect_Value,                   // After ':' or ',' in an array
+    JsonTapeExpect_ValueOrArrayEnd,         // After '['
+    JsonTapeExpect_Name,                    // After ',' in an object
+    JsonTapeExpect_NameOrObjectEnd,         // After '{'
+    JsonTapeExpect_Colon,
+    JsonTapeExpect_Separator,               // After a value, ',' or the end of its parent
+} JsonTapeExpect;
+
+/* @funcdef: Json_IsDelimiter
+ * Bytes that can follow a number or a literal
+ */
+JSON_INLINE bool Json_IsDelimiter(int c)
+{
+    return c == ',' || c == ']' || c == '}' || c == '\0' || JsonParser_IsSpace(c);
+}
+
+/* @funcdef: JsonTape_PushEntry
+ * Entries grow from the lower end of the buffer, the stack of open containers from the upper end
+ */
+JSON_INLINE JsonTapeEntry* JsonTape_PushEntry(JsonParser* parser, int32_t offset)
+{
+    if (!JsonAllocator_CanAlloc(&parser->allocator, (int32_t)sizeof(JsonTapeEntry)))
+    {
+        JsonParser_Panic(parser, JsonType_Null, JsonError_OutOfMemory, "Out of memory");
+    }
+
+    JsonTapeEntry* entry = (JsonTapeEntry*)parser->allocator.lowerMarker;
+    parser->allocator.lowerMarker += sizeof(JsonTapeEntry);
+
+    entry->offset = (uint32_t)offset;
+    entry->length = 0;
+    return entry;
+}
+
+/* @funcdef: JsonTape_ScanString
+ * Return the position of the closing quote, start is the opening quote
+ */
+static int32_t JsonTape_ScanString(JsonParser* parser, int32_t start, bool* outEscaped)
+{
+    const char* json = parser->buffer;
+
+    int32_t cursor = start;
+    while (true)
+    {
+        cursor = JsonStructuralIndex_NextAfter(&parser->index, cursor);
+        if (cursor >= parser->length || json[cursor] == '\0')
+        {
+            parser->cursor = cursor;
+            JsonParser_Panic(parser, JsonType_String, JsonError_UnmatchToken, "Expected '\"'");
+        }
+
+        const char c = json[cursor];
+        if (c == '"')
+        {
+            return cursor;
+        }
+        else if (c == '\\')
+        {
+            // The escaped character is checked when decoding
+            *outEscaped = true;
+            cursor++;
+        }
+        else
+        {
+            parser->cursor = cursor;
+            JsonParser_Panic(parser, JsonType_String, JsonError_UnexpectedToken, "Unexpected newline characters '%c'", c);
+        }
+    }
+}
+
+/* @funcdef: JsonTape_BuildEntries
+ * Walk the structural index once, check the structure and record values and names
+ */
+static void JsonTape_BuildEntries(JsonParser* parser, int32_t* outCount)
+{
+    const char*     json    = parser->buffer;
+    const int32_t   length  = parser->length;
+
+    JsonTapeEntry*  entries = (JsonTapeEntry*)parser->allocator.lowerMarker;
+    int32_t         count   = 0;
+    int32_t         depth   = 0;
+    bool            inObject = false;
+    JsonTapeExpect  expect  = JsonTapeExpect_TopLevel;
+
+    if (!Utf8_Validate(json, length))
+    {
+        parser->cursor = Utf8_ValidPrefix(json, length);
+        JsonParser_Panic(parser, JsonType_String, JsonError_WrongFormat, "Invalid UTF-8 sequence");
+    }
+
+    int32_t cursor = -1;
+    while (true)
+    {
+        cursor = JsonStructuralIndex_NextAfter(&parser->index, cursor);
+        parser->cursor = cursor;
+        if (cursor >= length || json[cursor] == '\0')
+        {
+            break;
+        }
+
+        const char c = json[cursor];
+        switch (c)
+        {
+        case ':':
+            if (expect != JsonTapeExpect_Colon)
+            {
+                JsonParser_Panic(parser, JsonType_Object, JsonError_UnexpectedToken, "Unexpected token ':'");
+            }
+            expect = JsonTapeExpect_Value;
+            continue;
+
+        case ',':
+            if (expect != JsonTapeExpect_Separator || depth == 0)
+            {
+                JsonParser_Panic(parser, JsonType_Null, JsonError_UnexpectedToken, "Unexpected token ','");
+            }
+            expect = inObject ? JsonTapeExpect_Name : JsonTapeExpect_Value;
+            continue;
+
+        case '}':
+        case ']':
+        {
+            if (depth == 0 || inObject != (c == '}'))
+            {
+                JsonParser_Panic(parser, JsonType_Null, JsonError_UnmatchToken, depth == 0 ? "Unexpected token '%c'" : "Expected '%c'", depth == 0 ? c : (inObject ? '}' : ']'));
+            }
+
+            if (expect != JsonTapeExpect_Separator && expect != JsonTapeExpect_NameOrObjectEnd && expect != JsonTapeExpect_ValueOrArrayEnd)
+            {
+                JsonParser_Panic(parser, inObject ? JsonType_Object : JsonType_Array, JsonError_UnexpectedToken, "Unexpected token '%c'", c);
+            }
+
+            const int32_t open = *(int32_t*)parser->allocator.upperMarker;
+            parser->allocator.upperMarker += sizeof(int32_t);
+            depth--;
+
+            entries[open].next = (uint32_t)count;
+            inObject = depth > 0 && json[entries[*(int32_t*)parser->allocator.upperMarker].offset] == '{';
+            expect = JsonTapeExpect_Separator;
+
+            // Without strict top level, the first value is the whole document like JsonParse
+            if (depth == 0 && (parser->flags & JsonParseFlags_NoStrictTopLevel))
+            {
+                *outCount = count;
+                return;
+            }
+            continue;
+        }
+
+        case '"':
+            if (expect == JsonTapeExpect_Name || expect == JsonTapeExpect_NameOrObjectEnd)
+            {
+                bool escaped = false;
+                JsonTapeEntry* entry = JsonTape_PushEntry(parser, cursor);
+                const int32_t end = JsonTape_ScanString(parser, cursor, &escaped);
+
+                entry->next = (uint32_t)(count + 1);
+                entry->length = (uint32_t)(end - cursor - 1) | (escaped ? JSON_TAPE_ESCAPED : 0);
+                entries[*(int32_t*)parser->allocator.upperMarker].length++;
+                count++;
+
+                cursor = end;
+                expect = JsonTapeExpect_Colon;
+                continue;
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        // Values
+        if (expect == JsonTapeExpect_TopLevel)
+        {
+            if (!(parser->flags & JsonParseFlags_NoStrictTopLevel) && c != '{' && c != '[')
+            {
+                JsonParser_Panic(parser, JsonType_Null, JsonError_WrongFormat, "JSON must be starting with '{' or '[', first character is '%c'", c);
+            }
+        }
+        else if (expect == JsonTapeExpect_Separator)
+        {
+            JsonParser_Panic(parser, JsonType_Null, depth == 0 ? JsonError_WrongFormat : JsonError_UnmatchToken, depth == 0 ? "JSON is not well-formed, unexpected '%c' after the top level value" : "Expected ','", c);
+        }
+        else if (expect != JsonTapeExpect_Value && expect != JsonTapeExpect_ValueOrArrayEnd)
+        {
+            JsonParser_Panic(parser, JsonType_Object, JsonError_UnexpectedToken, expect == JsonTapeExpect_Colon ? "Expected ':'" : "Expected <string> for <member-key> of <object>");
+        }
+
+        if (depth > 0 && !inObject)
+        {
+            entries[*(int32_t*)parser->allocator.upperMarker].length++;
+        }
+
+        JsonTapeEntry* entry = JsonTape_PushEntry(parser, cursor);
+        entry->next = (uint32_t)(count + 1);
+        count++;
+
+        if (c == '{' || c == '[')
+        {
+            if (!JsonAllocator_CanAlloc(&parser->allocator, (int32_t)sizeof(int32_t)))
+            {
+                JsonParser_Panic(parser, JsonType_Null, JsonError_OutOfMemory, "Out of memory");
+            }
+
+            parser->allocator.upperMarker -= sizeof(int32_t);
+            *(int32_t*)parser->allocator.upperMarker = count - 1;
+            depth++;
+
+            inObject = (c == '{');
+            expect = inObject ? JsonTapeExpect_NameOrObjectEnd : JsonTapeExpect_ValueOrArrayEnd;
+            continue;
+        }
+
+        if (c == '"')
+        {
+            bool escaped = false;
+            const int32_t end = JsonTape_ScanString(parser, cursor, &escaped);
+            entry->length = (uint32_t)(end - cursor - 1) | (escaped ? JSON_TAPE_ESCAPED : 0);
+            cursor = end;
+        }
+        else if (!Json_IsDigit(c) && c != '-' && c != 't' && c != 'f' && c != 'n')
+        {
+            JsonParser_Panic(parser, JsonType_Null, JsonError_UnexpectedToken, "Unexpected token '%c'", c);
+        }
+
+        expect = JsonTapeExpect_Separator;
+        if (depth == 0 && (parser->flags & JsonParseFlags_NoStrictTopLevel))
+        {
+            break;
+        }
+    }
+
+    if (depth > 0)
+    {
+        JsonParser_Panic(parser, inObject ? JsonType_Object : JsonType_Array, JsonError_UnmatchToken, "Expected '%c'", inObject ? '}' : ']');
+    }
+
+    if (expect == JsonTapeExpect_TopLevel)
+    {
+        JsonParser_Panic(parser, JsonType_Null, JsonError_WrongFormat, "JSON must be starting with '{' or '['");
+    }
+
+    *outCount = count;
+}
+
+/* @funcdef: JsonTape_BuildJump
+ * Errors of the builder jump back here
+ */
+static void JsonTape_BuildJump(JsonParser* parser, int32_t* outCount)
+{
+    *outCount = 0;
+    if (setjmp(parser->errjmp) == 0)
+    {
+        JsonTape_BuildEntries(parser, outCount);
+    }
+}
+
+/* @funcdef: JsonTape_Build */
+JsonResult JsonTape_Build(const char* jsonCode, int32_t jsonCodeLength, JsonParseFlags flags, void* buffer, int32_t bufferSize, JsonTape* outTape)
+{
+    JSON_ASSERT(outTape, "outTape mustnot be null");
+
+    outTape->json       = jsonCode;
+    outTape->length     = jsonCodeLength;
+    outTape->entries    = NULL;
+    outTape->count      = 0;
+
+    if (!jsonCode || jsonCodeLength <= 0)
+    {
+        const JsonResult result = { JsonError_WrongFormat, "Json code is empty", 0 };
+        return result;
+    }
+
+    // Comments are not in the structural index
+    if (flags & JsonParseFlags_SupportComment)
+    {
+        const JsonResult result = { JsonError_UnsupportedToken, "JsonTape does not support comments", 0 };
+        return result;
+    }
+
+    JsonAllocator allocator;
+    if (!JsonAllocator_Init(&allocator, buffer, bufferSize))
+    {
+        const JsonResult result = { JsonError_OutOfMemory, "Buffer is too small", 0 };
+        return result;
+    }
+
+    JsonParser parser;
+    JsonParser_Init(&parser, jsonCode, jsonCodeLength, allocator, flags);
+
+    const JsonTapeEntry* entries = (const JsonTapeEntry*)parser.allocator.lowerMarker;
+    int32_t count;
+    JsonTape_BuildJump(&parser, &count);
+
+    JsonResult result;
+    result.error = parser.errnum;
+    result.message = parser.errmsg ? parser.errmsg : (parser.errnum == JsonError_None ? "Success!" : "Not enough memory for the error message");
+    result.memoryUsage = (int32_t)(parser.allocator.lowerMarker - (uint8_t*)buffer);
+
+    if (result.error == JsonError_None)
+    {
+        outTape->entries = entries;
+        outTape->count = count;
+    }
+
+    return result;
+}
+
+/* @funcdef: JsonTape_GetType */
+JsonType JsonTape_GetType(const JsonTape* tape, int32_t node)
+{
+    JSON_ASSERT(tape && node >= 0 && node < tape->count, "node is out of range");
+
+    switch (tape->json[tape->entries[node].offset])
+    {
+    case '{': return JsonType_Object;
+    case '[': return JsonType_Array;
+    case '"': return JsonType_String;
+    case 't': return JsonType_Boolean;
+    case 'f': return JsonType_Boolean;
+    case 'n': return JsonType_Null;
+    default:  return JsonType_Number;
+    }
+}
+
+/* @funcdef: JsonTape_GetLength */
+int32_t JsonTape_GetLength(const JsonTape* tape, int32_t node)
+{
+    JSON_ASSERT(tape && node >= 0 && node < tape->count, "node is out of range");
+    return (int32_t)(tape->entries[node].length & ~JSON_TAPE_ESCAPED);
+}
+
+/* @funcdef: JsonTape_Skip */
+int32_t JsonTape_Skip(const JsonTape* tape, int32_t node)
+{
+    JSON_ASSERT(tape && node >= 0 && node < tape->count, "node is out of range");
+    return (int32_t)tape->entries[node].next;
+}
+
+/* @funcdef: JsonTape_GetItem */
+int32_t JsonTape_GetItem(const JsonTape* tape, int32_t array, int32_t index)
+{
+    if (JsonTape_GetType(tape, array) != JsonType_Array || index < 0 || index >= JsonTape_GetLength(tape, array))
+    {
+        return -1;
+    }
+
+    int32_t node = array + 1;
+    for (int32_t i = 0; i < index; i++)
+    {
+        node = (int32_t)tape->entries[node].next;
+    }
+
+    return node;
+}
+
+/* @funcdef: JsonTape_Find
+ * Names without escapes are compared in the document, without copying them
+ */
+int32_t JsonTape_Find(const JsonTape* tape, int32_t object, const char* name)
+{
+    JSON_ASSERT(name, "Attempt using nullptr as string");
+
+    if (JsonTape_GetType(tape, object) != JsonType_Object)
+    {
+        return -1;
+    }
+
+    const int32_t nameLength = (int32_t)strlen(name);
+    const int32_t end = (int32_t)tape->entries[object].next;
+
+    int32_t node = object + 1;
+    while (node < end)
+    {
+        const JsonTapeEntry*    entry       = &tape->entries[node];
+        const char*             memberName  = tape->json + entry->offset + 1;
+        const int32_t           rawLength   = (int32_t)(entry->length & ~JSON_TAPE_ESCAPED);
+
+        if (!(entry->length & JSON_TAPE_ESCAPED))
+        {
+            if (rawLength == nameLength && memcmp(memberName, name, (size_t)nameLength) == 0)
+            {
+                return node + 1;
+            }
+        }
+        else if (rawLength >= nameLength && rawLength <= JSON_TAPE_NAME_LENGTH)
+        {
+            char decoded[JSON_TAPE_NAME_LENGTH];
+            const int32_t decodedLength = JsonParser_DecodeEscapes(memberName, rawLength, decoded);
+            if (decodedLength == nameLength && memcmp(decoded, name, (size_t)nameLength) == 0)
+            {
+                return node + 1;
+            }
+        }
+
+        node = (int32_t)tape->entries[node + 1].next;
+    }
+
+    return -1;
+}
+
+/* @funcdef: JsonTape_GetValue */
+JsonError JsonTape_GetValue(const JsonTape* tape, int32_t node, Json* outValue)
+{
+    JSON_ASSERT(outValue, "outValue mustnot be null");
+    JSON_ASSERT(tape && node >= 0 && node < tape->count, "node is out of range");
+
+    const int32_t   offset  = (int32_t)tape->entries[node].offset;
+    const char*     text    = tape->json + offset;
+    const int32_t   remain  = tape->length - offset;
+
+    *outValue = JSON_NULL;
+
+    int32_t length;
+    switch (text[0])
+    {
+    case '{':
+    case '[':
+    case '"':
+        return JsonError_WrongType;
+
+    case 'n':
+        length = 4;
+        if (remain < 4 || memcmp(text, "null", 4) != 0)
+        {
+            return JsonError_UnexpectedToken;
+        }
+        break;
+
+    case 't':
+        length = 4;
+        if (remain < 4 || memcmp(text, "true", 4) != 0)
+        {
+            return JsonError_UnexpectedToken;
+        }
+        *outValue = JSON_TRUE;
+        break;
+
+    case 'f':
+        length = 5;
+        if (remain < 5 || memcmp(text, "false", 5) != 0)
+        {
+            return JsonError_UnexpectedToken;
+        }
+        *outValue = JSON_FALSE;
+        break;
+
+    default:
+    {
+        const JsonError error = Json_ParseNumberText(text, remain, JsonParseFlags_None, outValue, &length, NULL, 0);
+        if (error != JsonError_None)
+        {
+            *outValue = JSON_NULL;
+            return error;
+        }
+    } break;
+    }
+
+    if (length < remain && !Json_IsDelimiter((uint8_t)text[length]))
+    {
+        *outValue = JSON_NULL;
+        return JsonError_UnexpectedToken;
+    }
+
+    return JsonError_None;
+}
+
+/* @funcdef: JsonTape_GetString */
+int32_t JsonTape_GetString(const JsonTape* tape, int32_t node, char* buffer, int32_t bufferSize)
+{
+    JSON_ASSERT(tape && node >= 0 && node < tape->count, "node is out of range");
+
+    const JsonTapeEntry*    entry       = &tape->entries[node];
+    const char*             string      = tape->json + entry->offset + 1;
+    const int32_t           rawLength   = (int32_t)(entry->length & ~JSON_TAPE_ESCAPED);
+
+    if (string[-1] != '"' || !buffer || bufferSize <= rawLength)
+    {
+        return -1;
+    }
+
+    int32_t length = rawLength;
+    if (entry->length & JSON_TAPE_ESCAPED)
+    {
+        length = JsonParser_DecodeEscapes(string, rawLength, buffer);
+        if (length < 0)
+        {
+            return -1;
+        }
+    }
+    else
+    {
+        memcpy(buffer, string, (size_t)rawLength);
+    }
+
+    buffer[length] = '\0';
+    return length;
+}
+
+/* @funcdef: JsonTape_Parse
+ * The text of the subtree run to the next node, JsonParse stop after its first value
+ */
+JsonResult JsonTape_Parse(const JsonTape* tape, int32_t node, JsonParseFlags flags, void* buffer, int32_t bufferSize, Json* outValue)
+{
+    JSON_ASSERT(tape && node >= 0 && node < tape->count, "node is out of range");
+
+    const int32_t start = (int32_t)tape->entries[node].offset;
+    const int32_t next = (int32_t)tape->entries[node].next;
+    const int32_t end = next < tape->count ? (int32_t)tape->entries[next].offset : tape->length;
+
+    // The document is shared by the other nodes, strings are always copied
+    const JsonParseFlags subtreeFlags = (JsonParseFlags)((flags | JsonParseFlags_NoStrictTopLevel) & ~JsonParseFlags_InSitu);
+    return JsonParse(tape->json + start, end - start, subtreeFlags, buffer, bufferSize, outValue);
+}
+
+// -------------------------------------------------------------------
+// Writer
+// -------------------------------------------------------------------
+
+#define JSON_WRITER_RESERVE     32              // Longest number, escape sequence or separator put at once
+
+/* @funcdef: JsonWriter_SetError
+ * Keep the first error, the writer stop there
+ */
+static bool JsonWriter_SetError(JsonWriter* writer, JsonError code)
+{
+    if (writer->error == JsonError_None)
+    {
+        writer->error = code;
+    }
+
+    return false;
+}
+
+/* @funcdef: JsonWriter_Flush
+ * Give the buffer to write, without write function the buffer is full
+ */
+static bool JsonWriter_Flush(JsonWriter* writer)
+{
+    if (!writer->write)
+    {
+        return JsonWriter_SetError(writer, JsonError_OutOfMemory);
+    }
+
+    if (writer->length > 0)
+    {
+        if (writer->write(writer->userData, writer->buffer, writer->length) != writer->length)
+        {
+            return JsonWriter_SetError(writer, JsonError_InternalFatal);
+        }
+
+        writer->written += writer->length;
+        writer->length   = 0;
+    }
+
+    return true;
+}
+
+/* @funcdef: JsonWriter_Reserve
+ * Make room for count bytes, count is at most JSON_WRITER_RESERVE
+ */
+JSON_INLINE bool JsonWriter_Reserve(JsonWriter* writer, int32_t count)
+{
+    return writer->length + count <= writer->bufferSize || JsonWriter_Flush(writer);
+}
+
+/* @funcdef: JsonWriter_Put
+ * Copy bytes of any size, flush between the chunks
+ */
+static bool JsonWriter_Put(JsonWriter* writer, const char* data, int32_t size)
+{
+    while (size > 0)
+    {
+        if (writer->length == writer->bufferSize && !JsonWriter_Flush(writer))
+        {
+            return false;
+        }
+
+        const int32_t space = writer->bufferSize - writer->length;
+        const int32_t count = size < space ? size : space;
+        memcpy(writer->buffer + writer->length, data, (size_t)count);
+
+        writer->length += count;
+        data           += count;
+        size           -= count;
+    }
+
+    return true;
+}
+
+JSON_INLINE bool JsonWriter_PutChar(JsonWriter* writer, char c)
+{
+    if (!JsonWriter_Reserve(writer, 1))
+    {
+        return false;
+    }
+
+    writer->buffer[writer->length++] = c;
+    return true;
+}
+
+/* @funcdef: JsonWriter_PutIndent
+ * New line then 4 spaces per level, pretty output only
+ */
+static bool JsonWriter_PutIndent(JsonWriter* writer, int32_t depth)
+{
+    static const char spaces[] = "\n                                ";
+
+    if (!(writer->flags & JsonWriteFlags_Pretty))
+    {
+        return true;
+    }
+
+    if (!JsonWriter_Put(writer, spaces, 1))
+    {
+        return false;
+    }
+
+    for (int32_t count = depth * 4; count > 0; count -= (int32_t)sizeof(spaces) - 2)
+    {
+        const int32_t run = count < (int32_t)sizeof(spaces) - 2 ? count : (int32_t)sizeof(spaces) - 2;
+        if (!JsonWriter_Put(writer, spaces + 1, run))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+JSON_INLINE bool JsonWriter_GetBit(const uint64_t* bits, int32_t index)
+{
+    return (bits[index >> 6] >> (index & 63)) & 1u;
+}
+
+JSON_INLINE void JsonWriter_SetBit(uint64_t* bits, int32_t index, bool value)
+{
+    const uint64_t mask = (uint64_t)1u << (index & 63);
+    bits[index >> 6] = value ? (bits[index >> 6] | mask) : (bits[index >> 6] & ~mask);
+}
+
+/* @funcdef: JsonWriter_BeginValue
+ * Check that a value can come here, write the separator before it.
+ * Level 0 is the top level, it hold one value.
+ */
+static bool JsonWriter_BeginValue(JsonWriter* writer)
+{
+    if (writer->error != JsonError_None)
+    {
+        return false;
+    }
+
+    const int32_t depth = writer->depth;
+    if (JsonWriter_GetBit(writer->objects, depth))
+    {
+        // Name put the separator
+        if (!writer->afterName)
+        {
+            return JsonWriter_SetError(writer, JsonError_UnexpectedToken);
+        }
+
+        writer->afterName = false;
+        return true;
+    }
+
+    const bool hasItems = JsonWriter_GetBit(writer->nonEmpty, depth);
+    if (depth == 0)
+    {
+        if (hasItems)
+        {
+            return JsonWriter_SetError(writer, JsonError_UnexpectedToken);
+        }
+    }
+    else if ((hasItems && !JsonWriter_PutChar(writer, ',')) || !JsonWriter_PutIndent(writer, depth))
+    {
+        return false;
+    }
+
+    JsonWriter_SetBit(writer->nonEmpty, depth, true);
+    return true;
+}
+
+/* @funcdef: JsonWriter_Begin */
+static bool JsonWriter_Begin(JsonWriter* writer, bool isObject)
+{
+    if (!JsonWriter_BeginValue(writer))
+    {
+        return false;
+    }
+
+    if (writer->depth + 1 >= JSON_WRITER_MAX_DEPTH)
+    {
+        return JsonWriter_SetError(writer, JsonError_OutOfMemory);
+    }
+
+    if (!JsonWriter_PutChar(writer, isObject ? '{' : '['))
+    {
+        return false;
+    }
+
+    writer->depth++;
+    JsonWriter_SetBit(writer->objects, writer->depth, isObject);
+    JsonWriter_SetBit(writer->nonEmpty, writer->depth, false);
+    return true;
+}
+
+/* @funcdef: JsonWriter_End */
+static bool JsonWriter_End(JsonWriter* writer, bool isObject)
+{
+    if (writer->error != JsonError_None)
+    {
+        return false;
+    }
+
+    const int32_t depth = writer->depth;
+    if (depth == 0 || writer->afterName || JsonWriter_GetBit(writer->objects, depth) != isObject)
+    {
+        return JsonWriter_SetError(writer, JsonError_UnmatchToken);
+    }
+
+    if (JsonWriter_GetBit(writer->nonEmpty, depth) && !JsonWriter_PutIndent(writer, depth - 1))
+    {
+        return false;
     }
+
+    writer->depth--;
+    return JsonWriter_PutChar(writer, isObject ? '}' : ']');
 }
 
-/* @funcdef: JsonParser_SkipComments */
-static int JsonParser_SkipComments(JsonParser* parser)
+/* @funcdef: JsonWriter_PutString
+ * Quoted and escaped, runs of plain bytes are found 16 at a time and copied at once
+ */
+static bool JsonWriter_PutString(JsonWriter* writer, const char* string, int32_t length)
 {
-    while (true)
+    static const char hex[] = "0123456789abcdef";
+
+    if (!JsonWriter_PutChar(writer, '"'))
     {
-        int c = JsonParser_NextChar(parser);
-        if (c == '/')
+        return false;
+    }
+
+    while (length > 0)
+    {
+        const int32_t run = JsonParser_FindStringSpecial(string, length);
+        if (!JsonWriter_Put(writer, string, run))
         {
-            c = JsonParser_NextChar(parser);
-            if (c == '/')
-            {
-                JsonParser_NextLine(parser);
-            }    
-            else if (c == '*')
-            {
-                int c0 = JsonParser_NextChar(parser);
-                int c1 = JsonParser_NextChar(parser);
-                while (c0 != '*' || c1 != '/')
-                {
-                    c0 = c1;
-                    c1 = JsonParser_NextChar(parser);
-                }
-            }
-            else
-            {
-                JsonParser_Panic(parser, JsonType_Null, JsonError_UnexpectedToken, "Unexpected token '%c'", c);
-            }
+            return false;
         }
-        else
+
+        if (run == length)
         {
             break;
         }
-    }
-    
-    return JsonParser_PeekChar(parser);
-}
 
-/* All parse functions declaration */
+        if (!JsonWriter_Reserve(writer, 6))
+        {
+            return false;
+        }
 
-static void JsonParser_ParseArray(JsonParser* parser, Json* outValue);
-static void JsonParser_ParseSingle(JsonParser* parser, Json* outValue);
-static void JsonParser_ParseObject(JsonParser* parser, Json* outValue);
-static void JsonParser_ParseNumber(JsonParser* parser, Json* outValue);
-static void JsonParser_ParseString(JsonParser* parser, Json* outValue);
+        const uint8_t c = (uint8_t)string[run];
+        char* output = writer->buffer + writer->length;
+        output[0] = '\\';
+        switch (c)
+        {
+        case '"':  output[1] = '"';  writer->length += 2; break;
+        case '\\': output[1] = '\\'; writer->length += 2; break;
+        case '\b': output[1] = 'b';  writer->length += 2; break;
+        case '\f': output[1] = 'f';  writer->length += 2; break;
+        case '\n': output[1] = 'n';  writer->length += 2; break;
+        case '\r': output[1] = 'r';  writer->length += 2; break;
+        case '\t': output[1] = 't';  writer->length += 2; break;
 
-/* @funcdef: JsonParser_ParseNumber */
-static void JsonParser_ParseNumber(JsonParser* parser, Json* outValue)
+        default:
+            output[1] = 'u';
+            output[2] = '0';
+            output[3] = '0';
+            output[4] = hex[c >> 4];
+            output[5] = hex[c & 15];
+            writer->length += 6;
+            break;
+        }
+
+        string += run + 1;
+        length -= run + 1;
+    }
+
+    return JsonWriter_PutChar(writer, '"');
+}
+
+/* @funcdef: JsonWriter_FormatInteger
+ * Two digits at a time from the end, return the length
+ */
+static int32_t JsonWriter_FormatInteger(char* output, int64_t value)
 {
-    int c = JsonParser_SkipSpace(parser);
-    if (c > 0)
-    {
-		int sign = 1;
-		
-		if (c == '+')
-		{
-			c = JsonParser_NextChar(parser);
-			JsonParser_Panic(parser, JsonType_Number, JsonError_UnexpectedToken, "JSON does not support number start with '+'");
-		}
-		else if (c == '-')
-		{
-			sign = -1;
-			c = JsonParser_NextChar(parser);
-		}
-		else if (c == '0')
-		{
-			c = JsonParser_NextChar(parser);
-			if (!isspace(c) && !ispunct(c))
-			{
-				JsonParser_Panic(parser, JsonType_Number, JsonError_UnexpectedToken, "JSON does not support number start with '0' (only standalone '0' is accepted)");
-			}
-		}
-		else if (!isdigit(c))
-		{
-			JsonParser_Panic(parser, JsonType_Number, JsonError_UnexpectedToken, "Unexpected '%c'", c);
-		}
-
-		int    dot    = 0;
-        int    exp    = 0;
-        int    expsgn = 0;
-        int    exppow = 0;
-        int    expchk = 0;
-		int    numpow = 1;
-		double number = 0;
-
-		while (c > 0)
-		{
-            if (c == 'e')
-            {
-                if (exp)
-                {
-                    JsonParser_Panic(parser, JsonType_Number, JsonError_UnexpectedToken, "Too many 'e' are presented in a <number>");
-                }
-                else if (dot && numpow == 1)
-                {
-                    JsonParser_Panic(parser, JsonType_Number, JsonError_UnexpectedToken,
-                                "'.' is presented in number token, but require a digit after '.' ('%c')", c);
-                }
-                else
-                {
-                    exp    = 1;
-                    expchk = 0;
-                }
-            }
-			else if (c == '.')
-			{
-                if (exp)
-                {
-                    JsonParser_Panic(parser, JsonType_Number, JsonError_UnexpectedToken, "Cannot has '.' after 'e' is presented in a <number>");
-                }
-				else if (dot)
-				{
-					JsonParser_Panic(parser, JsonType_Number, JsonError_UnexpectedToken, "Too many '.' are presented in a <number>");
-				}
-				else
-				{
-					dot = 1;
-				}
-			}
-            else if (exp && (c == '-' || c == '+'))
-            {
-                if (expchk)
-                {
-                    JsonParser_Panic(parser, JsonType_Number, JsonError_UnexpectedToken, "'%c' is presented after digits are presented of exponent part", c);
-                }
-                else if (expsgn)
-                {
-                    JsonParser_Panic(parser, JsonType_Number, JsonError_UnexpectedToken, "Too many signed characters are presented after 'e'");
-                }
-                else
-                {
-                    expsgn = (c == '-' ? -1 : 1);
-                }
-            }
-			else if (!isdigit(c))
-			{
-				break;
-			}
-			else
-			{
-                if (exp)
-                {
-                    expchk = 1;
-                    exppow = exppow * 10 + (c - '0');
-                }
-                else
-                {
-                    if (dot)
-                    {
-                        numpow *= 10;
-                        number += (c - '0') / (double)numpow;
-                    }
-                    else
-                    {
-                        number = number * 10 + (c - '0');
-                    }
-                }
-			}
+    static const char digits[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
 
-			c = JsonParser_NextChar(parser);
-		}
+    char        text[24];
+    char*       cursor      = text + sizeof(text);
+    uint64_t    magnitude   = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
 
-        if (exp && !expchk)
-        {
-            JsonParser_Panic(parser, JsonType_Number, JsonError_UnexpectedToken, "'e' is presented in number token, but require a digit after 'e' ('%c')", (char)c);
-        }
-		if (dot && numpow == 1)
-		{
-			JsonParser_Panic(parser, JsonType_Number, JsonError_UnexpectedToken, "'.' is presented in number token, but require a digit after '.' ('%c')", (char)c);
-		}
-		else
-		{
-            if (exp)
-            {
-                int i;
-                double tmp = 1;
-                for (i = 0; i < exppow; i++)
-                {
-                    tmp *= 10;
-                }
-                
-                if (expsgn < 0)
-                {
-                    number /= tmp;
-                }
-                else
-                {
-                    number *= tmp;
-                }
-            }
+    while (magnitude >= 100)
+    {
+        const uint32_t pair = (uint32_t)(magnitude % 100);
+        magnitude /= 100;
 
-            Json value;
-            value.type = JsonType_Number;
-            value.length = 0;
-            value.number = sign * number;
+        cursor -= 2;
+        memcpy(cursor, digits + pair * 2, 2);
+    }
 
-            *outValue = value;
-		}
+    if (magnitude >= 10)
+    {
+        cursor -= 2;
+        memcpy(cursor, digits + magnitude * 2, 2);
     }
     else
     {
-        JsonParser_Panic(parser, JsonType_Number, JsonError_UnexpectedToken, "Reached the end of json!");
+        *--cursor = (char)('0' + magnitude);
+    }
+
+    if (value < 0)
+    {
+        *--cursor = '-';
     }
+
+    const int32_t length = (int32_t)(text + sizeof(text) - cursor);
+    memcpy(output, cursor, (size_t)length);
+    return length;
 }
 
-/* @funcdef: JsonParser_ParseArray */
-static void JsonParser_ParseArray(JsonParser* parser, Json* outValue)
+/* Grisu2 by Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers".
+ * The digits always read back to the same double, they are the shortest in about 99.9% of the cases.
+ */
+typedef struct JsonDiyFp
 {
-    if (JsonParser_SkipSpace(parser) > 0)
-    {
-	    JsonParser_MatchChar(parser, JsonType_Array, '[');
+    uint64_t    f;
+    int32_t     e;
+} JsonDiyFp;
 
-        JsonTempArray(Json, 64) values = JsonTempArray_Init(NULL);
-	    while (JsonParser_SkipSpace(parser) > 0 && JsonParser_PeekChar(parser) != ']')
-	    {
-	        if (values.count > 0)
-	        {
-                JsonParser_MatchChar(parser, JsonType_Array, ',');
-	        }
-	    
-            Json value;
-            JsonParser_ParseSingle(parser, &value);
+JSON_INLINE JsonDiyFp JsonDiyFp_Make(uint64_t f, int32_t e)
+{
+    JsonDiyFp result = { f, e };
+    return result;
+}
 
-            JsonTempArray_Push(&values, value, &parser->allocator);
-	    }
+/* Product rounded to 64 bits */
+JSON_INLINE JsonDiyFp JsonDiyFp_Multiply(JsonDiyFp a, JsonDiyFp b)
+{
+    uint64_t high;
+    const uint64_t low = Json_Multiply128(a.f, b.f, &high);
+    return JsonDiyFp_Make(high + (low >> 63), a.e + b.e + 64);
+}
 
-	    JsonParser_SkipSpace(parser);
-	    JsonParser_MatchChar(parser, JsonType_Array, ']');
+JSON_INLINE JsonDiyFp JsonDiyFp_Normalize(JsonDiyFp x)
+{
+    const int32_t shift = Json_LeadingZeros64(x.f);
+    return JsonDiyFp_Make(x.f << shift, x.e - shift);
+}
 
-        outValue->type   = JsonType_Array;
-        outValue->length = JsonTempArray_GetCount(&values);
-        outValue->array  = (Json*)JsonTempArray_ToBuffer(&values, &parser->allocator);
+static const uint64_t JSON_POWERS_OF_TEN_U64[] =
+{
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+    10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull, 100000000000000ull,
+    1000000000000000ull, 10000000000000000ull, 100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull,
+};
 
-        JsonTempArray_Free(&values, &parser->allocator);
+/* @funcdef: JsonWriter_GrisuRound
+ * Move the last digit toward the value while it stay inside the boundaries
+ */
+JSON_INLINE void JsonWriter_GrisuRound(char* digits, int32_t length, uint64_t delta, uint64_t rest, uint64_t tenKappa, uint64_t distance)
+{
+    while (rest < distance && delta - rest >= tenKappa
+        && (rest + tenKappa < distance || distance - rest > rest + tenKappa - distance))
+    {
+        digits[length - 1]--;
+        rest += tenKappa;
     }
 }
 
-/* JsonState_ParseSingle */
-static void JsonParser_ParseSingle(JsonParser* parser, Json* outValue)
+/* @funcdef: JsonWriter_GrisuDigits
+ * Shortest digits of high that stay above high - delta, value is the scaled double
+ */
+static int32_t JsonWriter_GrisuDigits(JsonDiyFp value, JsonDiyFp high, uint64_t delta, char* digits, int32_t* exponent)
 {
-    if (JsonParser_SkipSpace(parser) > 0)
-    {
-	    int c = JsonParser_PeekChar(parser);
-	
-	    switch (c)
-	    {
-	    case '[':
-	        JsonParser_ParseArray(parser, outValue);
-            break;
-	    
-	    case '{':
-	        JsonParser_ParseObject(parser, outValue);
-            break;
-	    
-	    case '"':
-	        JsonParser_ParseString(parser, outValue);
-            break;
+    const int32_t   shift       = -high.e;
+    const uint64_t  one         = (uint64_t)1u << shift;
+    const uint64_t  distance    = high.f - value.f;
 
-	    case '+': case '-': case '0': 
-        case '1': case '2': case '3': 
-        case '4': case '5': case '6': 
-        case '7': case '8': case '9':
-	        JsonParser_ParseNumber(parser, outValue);
-            break;
+    uint32_t        integral    = (uint32_t)(high.f >> shift);
+    uint64_t        fraction    = high.f & (one - 1);
+    int32_t         length      = 0;
 
+    int32_t kappa = 1;
+    while (kappa < 10 && integral >= JSON_POWERS_OF_TEN_U64[kappa])
+    {
+        kappa++;
+    }
 
-        case '/':
-            if (parser->flags & JsonParseFlags_SupportComment)
-            {
-                JsonParser_SkipComments(parser);
-                JsonParser_ParseSingle(parser, outValue);
-            }
-            else
-            {
-                JsonParser_Panic(parser, JsonType_String, JsonError_UnknownToken, "Unknown token '%c'", c);
-            }
-            break;
-	    
-        default:
-	    {
-	        int length = 0;
-	        while (c > 0 && isalpha(c))
-	        {
-                length++;
-                c = JsonParser_NextChar(parser);
-	        }
+    while (kappa > 0)
+    {
+        const uint32_t divisor = (uint32_t)JSON_POWERS_OF_TEN_U64[kappa - 1];
+        const uint32_t digit = integral / divisor;
+        integral %= divisor;
 
-	        const char* token = parser->buffer + parser->cursor - length;
-            if (length == 4 && strncmp(token, "null", length) == 0)
-            {
-                *outValue = JSON_NULL;
-            }
-            else if (length == 4 && strncmp(token, "true", length) == 0)
-	        {
-                *outValue = JSON_TRUE;
-	        }
-	        else if (length == 5 && strncmp(token, "false", length) == 0)
-	        {
-                *outValue = JSON_FALSE;
-	        }
-	        else
-	        {
-                char tmp[256];
-                tmp[length] = 0;
-                while (length--)
-                {
-                    tmp[length] = token[length]; 
-                }
+        if (digit != 0 || length != 0)
+        {
+            digits[length++] = (char)('0' + digit);
+        }
+        kappa--;
 
-                JsonParser_Panic(parser, JsonType_Null, JsonError_UnexpectedToken, "Unexpected token '%s'", tmp);
-	        }
-	    } break;
-	    /* END OF SWITCH STATEMENT */
+        const uint64_t rest = ((uint64_t)integral << shift) + fraction;
+        if (rest <= delta)
+        {
+            *exponent += kappa;
+            JsonWriter_GrisuRound(digits, length, delta, rest, JSON_POWERS_OF_TEN_U64[kappa] << shift, distance);
+            return length;
         }
     }
-}
-
-static char* JsonParser_ParseStringNoToken(JsonParser* parser, int32_t* outLength)
-{
-    JsonParser_MatchChar(parser, JsonType_String, '"');
-
-    int32_t i;
-    int32_t c0, c1;
-    int32_t length = 0;
 
-    JsonTempArray(char, 2048) buffer = JsonTempArray_Init(NULL);
-    while (!JsonParser_IsAtEnd(parser) && (c0 = JsonParser_PeekChar(parser)) != '"')
+    for (;;)
     {
-        if (c0 == '\\')
-        {
-            c0 = JsonParser_NextChar(parser);
-            switch (c0)
-            {
-            case 'n':
-                JsonTempArray_Push(&buffer, '\n', &parser->allocator);
-                length++;
-                break;
+        fraction *= 10;
+        delta *= 10;
 
-            case 't':
-                JsonTempArray_Push(&buffer, '\t', &parser->allocator);
-                length++;
-                break;
-
-            case 'r':
-                JsonTempArray_Push(&buffer, '\r', &parser->allocator);
-                length++;
-                break;
+        const char digit = (char)(fraction >> shift);
+        if (digit != 0 || length != 0)
+        {
+            digits[length++] = (char)('0' + digit);
+        }
 
-            case 'b':
-                JsonTempArray_Push(&buffer, '\b', &parser->allocator);
-                length++;
-                break;
+        fraction &= one - 1;
+        kappa--;
 
-            case '\\':
-                JsonTempArray_Push(&buffer, '\\', &parser->allocator);
-                length++;
-                break;
+        if (fraction < delta)
+        {
+            *exponent += kappa;
+            JsonWriter_GrisuRound(digits, length, delta, fraction, one, -kappa < 20 ? distance * JSON_POWERS_OF_TEN_U64[-kappa] : 0);
+            return length;
+        }
+    }
+}
 
-            case '"':
-                JsonTempArray_Push(&buffer, '\"', &parser->allocator);
-                length++;
-                break;
+/* @funcdef: JsonWriter_Grisu2
+ * Digits of a positive finite double, value = digits * 10^exponent
+ */
+static int32_t JsonWriter_Grisu2(double number, char* digits, int32_t* exponent)
+{
+    uint64_t bits;
+    memcpy(&bits, &number, sizeof(bits));
 
-            case 'u':
-                c1 = 0;
-                for (i = 0; i < 4; i++)
-                {
-                    if (isxdigit((c0 = JsonParser_NextChar(parser))))
-                    {
-                        c1 = c1 * 10 + (isdigit(c0) ? c0 - '0' : c0 < 'a' ? c0 - 'A' : c0 - 'a');
-                    }
-                    else
-                    {
-                        JsonParser_Panic(parser, JsonType_String, JsonError_UnknownToken, "Expected hexa character in unicode character");
-                    }
-                }
+    const int32_t biasedExponent = (int32_t)((bits >> 52) & 0x7FF);
+    const uint64_t significand = bits & 0x000FFFFFFFFFFFFFull;
 
-                if (c1 <= 0x7F)
-                {
-                    JsonTempArray_Push(&buffer, (char)c1, &parser->allocator);
-                }
-                else if (c1 <= 0x7FF)
-                {
-                    char c2 = (char)(0xC0 | (c1 >> 6));            /* 110xxxxx */
-                    char c3 = (char)(0x80 | (c1 & 0x3F));          /* 10xxxxxx */
-                    JsonTempArray_Push(&buffer, c2, &parser->allocator);
-                    JsonTempArray_Push(&buffer, c3, &parser->allocator);
-                }
-                else if (c1 <= 0xFFFF)
-                {
-                    char c2 = (char)(0xE0 | (c1 >> 12));           /* 1110xxxx */
-                    char c3 = (char)(0x80 | ((c1 >> 6) & 0x3F));   /* 10xxxxxx */
-                    char c4 = (char)(0x80 | (c1 & 0x3F));          /* 10xxxxxx */
-                    JsonTempArray_Push(&buffer, c2, &parser->allocator);
-                    JsonTempArray_Push(&buffer, c3, &parser->allocator);
-                    JsonTempArray_Push(&buffer, c4, &parser->allocator);
-                }
-                else if (c1 <= 0x10FFFF)
-                {
-                    char c2 = 0xF0 | (c1 >> 18);           /* 11110xxx */
-                    char c3 = 0x80 | ((c1 >> 12) & 0x3F);  /* 10xxxxxx */
-                    char c4 = 0x80 | ((c1 >> 6) & 0x3F);   /* 10xxxxxx */
-                    char c5 = 0x80 | (c1 & 0x3F);          /* 10xxxxxx */
-                    JsonTempArray_Push(&buffer, c2, &parser->allocator);
-                    JsonTempArray_Push(&buffer, c3, &parser->allocator);
-                    JsonTempArray_Push(&buffer, c4, &parser->allocator);
-                    JsonTempArray_Push(&buffer, c5, &parser->allocator);
-                }
-                
-                length++;
-                break;
+    const JsonDiyFp value = biasedExponent != 0
+        ? JsonDiyFp_Make(significand | 0x0010000000000000ull, biasedExponent - 1075)
+        : JsonDiyFp_Make(significand, -1074);
 
-            default:
-                JsonParser_Panic(parser, JsonType_String, JsonError_UnknownToken, "Unknown escape character");
-                break;
-            }
-        }
-        else
-        {
-            switch (c0)
-            {
-            case '\r':
-            case '\n':
-                JsonParser_Panic(parser, JsonType_String, JsonError_UnexpectedToken, "Unexpected newline characters '%c'", c0);
-                break;
+    // Boundaries half way to the neighbour doubles, with the same exponent
+    JsonDiyFp high = JsonDiyFp_Make((value.f << 1) + 1, value.e - 1);
+    while (!(high.f & (0x0010000000000000ull << 1)))
+    {
+        high.f <<= 1;
+        high.e--;
+    }
+    high.f <<= 10;
+    high.e  -= 10;
+
+    JsonDiyFp low = value.f == 0x0010000000000000ull
+        ? JsonDiyFp_Make((value.f << 2) - 1, value.e - 2)
+        : JsonDiyFp_Make((value.f << 1) - 1, value.e - 1);
+    low.f <<= low.e - high.e;
+    low.e   = high.e;
+
+    // Cached power that bring the exponent of high in [-60, -32]
+    const double    estimate    = (-61 - high.e) * 0.30102999566398114 + 347;
+    int32_t         k           = (int32_t)estimate;
+    if (estimate - k > 0.0)
+    {
+        k++;
+    }
 
-            default:
-                JsonTempArray_Push(&buffer, (char)c0, &parser->allocator);
-                break;
-            }
-        }
+    const int32_t           index   = (k >> 3) + 1;
+    const JsonCachedPower   cached  = JSON_CACHED_POWERS[index];
+    const JsonDiyFp         power   = JsonDiyFp_Make(cached.significand, cached.exponent);
+    *exponent = -(JSON_SMALLEST_CACHED_POWER + index * JSON_CACHED_POWER_STEP);
 
-        JsonParser_NextChar(parser);
+    const JsonDiyFp scaled = JsonDiyFp_Multiply(JsonDiyFp_Normalize(value), power);
+    JsonDiyFp scaledHigh = JsonDiyFp_Multiply(high, power);
+    JsonDiyFp scaledLow = JsonDiyFp_Multiply(low, power);
+    scaledLow.f++;
+    scaledHigh.f--;
+
+    return JsonWriter_GrisuDigits(scaled, scaledHigh, scaledHigh.f - scaledLow.f, digits, exponent);
+}
+
+/* @funcdef: JsonWriter_FormatNumber
+ * Shortest digits as plain decimal or with exponent, integral values end with ".0".
+ * output must hold 32 bytes, return the length.
+ */
+static int32_t JsonWriter_FormatNumber(char* output, double number)
+{
+    int32_t length = 0;
+    if (signbit(number))
+    {
+        output[length++] = '-';
+        number = -number;
     }
 
-    JsonParser_MatchChar(parser, JsonType_String, '"');
-    if (buffer.count > 0)
+    if (number == 0.0)
     {
-        if (outLength) *outLength = length;
-        JsonTempArray_Push(&buffer, 0, &parser->allocator);
+        memcpy(output + length, "0.0", 3);
+        return length + 3;
+    }
 
-        char* string = (char*)JsonTempArray_ToBuffer(&buffer, &parser->allocator);
-        JsonTempArray_Free(&buffer, &parser->allocator);
+    char* buffer = output + length;
 
-        return string;
+    int32_t exponent;
+    const int32_t count = JsonWriter_Grisu2(number, buffer, &exponent);
+    const int32_t point = count + exponent;     // 10^(point - 1) <= number < 10^point
+
+    if (exponent >= 0 && point <= 21)
+    {
+        // 1234e7 -> 12340000000.0
+        memset(buffer + count, '0', (size_t)(point - count));
+        buffer[point]     = '.';
+        buffer[point + 1] = '0';
+        return length + point + 2;
     }
-    else
+
+    if (point > 0 && point <= 21)
     {
-        if (outLength) *outLength = 0;
-        return NULL;
+        // 1234e-2 -> 12.34
+        memmove(buffer + point + 1, buffer + point, (size_t)(count - point));
+        buffer[point] = '.';
+        return length + count + 1;
     }
-}
 
-/* @funcdef: JsonParser_ParseString */
-static void JsonParser_ParseString(JsonParser* parser, Json* outValue)
-{
-    if (JsonParser_SkipSpace(parser) > 0)
+    if (point > -6 && point <= 0)
     {
-        int length;
-        const char* string = JsonParser_ParseStringNoToken(parser, &length);
+        // 1234e-6 -> 0.001234
+        const int32_t offset = 2 - point;
+        memmove(buffer + offset, buffer, (size_t)count);
+        buffer[0] = '0';
+        buffer[1] = '.';
+        memset(buffer + 2, '0', (size_t)(offset - 2));
+        return length + count + offset;
+    }
 
-        outValue->type   = JsonType_String;
-        outValue->string = string;
-        outValue->length = length;
+    // 1234e30 -> 1.234e33, 1e30 stay 1e30
+    int32_t cursor = 1;
+    if (count > 1)
+    {
+        memmove(buffer + 2, buffer + 1, (size_t)(count - 1));
+        buffer[1] = '.';
+        cursor = count + 1;
     }
-}
+    buffer[cursor++] = 'e';
 
-/* @funcdef: JsonParser_ParseObject */
-static void JsonParser_ParseObject(JsonParser* parser, Json* outValue)
-{
-    if (JsonParser_SkipSpace(parser) > 0)
+    int32_t power = point - 1;
+    if (power < 0)
     {
-        JsonParser_MatchChar(parser, JsonType_Object, '{');
+        buffer[cursor++] = '-';
+        power = -power;
+    }
 
-        JsonTempArray(JsonObjectMember, 32) values = JsonTempArray_Init(NULL);
-        while (JsonParser_SkipSpace(parser) > 0 && JsonParser_PeekChar(parser) != '}')
-        {
-            if (values.count > 0)
-            {
-                JsonParser_MatchChar(parser, JsonType_Object, ',');
-            }
+    if (power >= 100)
+    {
+        buffer[cursor++] = (char)('0' + power / 100);
+        power %= 100;
+        buffer[cursor++] = (char)('0' + power / 10);
+    }
+    else if (power >= 10)
+    {
+        buffer[cursor++] = (char)('0' + power / 10);
+    }
+    buffer[cursor++] = (char)('0' + power % 10);
 
-            if (JsonParser_SkipSpace(parser) != '"')
-            {
-                JsonParser_Panic(parser, JsonType_Object, JsonError_UnexpectedToken, "Expected <string> for <member-key> of <object>");
-            }
+    return length + cursor;
+}
 
-            const char* name = JsonParser_ParseStringNoToken(parser, 0);
+/* @funcdef: JsonWriter_Init */
+bool JsonWriter_Init(JsonWriter* writer, JsonWriteFlags flags, void* buffer, int32_t bufferSize, JsonWriteFunc write, void* userData)
+{
+    JSON_ASSERT(writer, "writer mustnot be null");
 
-            JsonParser_SkipSpace(parser);
-            JsonParser_MatchChar(parser, JsonType_Object, ':');
+    memset(writer, 0, sizeof(*writer));
+    writer->flags       = flags;
+    writer->write       = write;
+    writer->userData    = userData;
+    writer->buffer      = (char*)buffer;
+    writer->bufferSize  = bufferSize;
 
-            Json value;
-            JsonParser_ParseSingle(parser, &value);
+    // Numbers and escapes are put whole
+    if (!buffer || bufferSize < JSON_WRITER_RESERVE)
+    {
+        return JsonWriter_SetError(writer, JsonError_OutOfMemory);
+    }
 
-            /* Well done */
-            JsonObjectMember member;
-            member.name  = name;
-            member.value = value;
-            JsonTempArray_Push(&values, member, &parser->allocator);
-        }
+    return true;
+}
 
-        JsonParser_SkipSpace(parser);
-        JsonParser_MatchChar(parser, JsonType_Object, '}');
+/* @funcdef: JsonWriter_BeginObject */
+bool JsonWriter_BeginObject(JsonWriter* writer)
+{
+    JSON_ASSERT(writer, "writer mustnot be null");
+    return JsonWriter_Begin(writer, true);
+}
 
-        outValue->type   = JsonType_Object;
-        outValue->length = JsonTempArray_GetCount(&values);
-        outValue->object = (JsonObjectMember*)JsonTempArray_ToBuffer(&values, &parser->allocator);
+/* @funcdef: JsonWriter_EndObject */
+bool JsonWriter_EndObject(JsonWriter* writer)
+{
+    JSON_ASSERT(writer, "writer mustnot be null");
+    return JsonWriter_End(writer, true);
+}
 
-        JsonTempArray_Free(&values, &parser->allocator);
-    }
+/* @funcdef: JsonWriter_BeginArray */
+bool JsonWriter_BeginArray(JsonWriter* writer)
+{
+    JSON_ASSERT(writer, "writer mustnot be null");
+    return JsonWriter_Begin(writer, false);
 }
-         
-/* Internal parsing function
- */
-static Json* JsonState_ParseTopLevel(JsonParser* parser)
+
+/* @funcdef: JsonWriter_EndArray */
+bool JsonWriter_EndArray(JsonWriter* writer)
 {
-    JSON_ASSERT(parser, "parser mustnot be null");
+    JSON_ASSERT(writer, "writer mustnot be null");
+    return JsonWriter_End(writer, false);
+}
 
-    Json* value = (Json*)JsonAllocator_AllocLower(&parser->allocator, NULL, 0, sizeof(Json));
-    value->type = JsonType_Null;
+/* @funcdef: JsonWriter_Name */
+bool JsonWriter_Name(JsonWriter* writer, const char* name)
+{
+    JSON_ASSERT(writer, "writer mustnot be null");
+    JSON_ASSERT(name, "name mustnot be null");
 
-    // Skip meta comment in header of the file
-    if (parser->flags & JsonParseFlags_SupportComment)
+    if (writer->error != JsonError_None)
     {
-        JsonParser_SkipSpace(parser);
-        JsonParser_SkipComments(parser);
+        return false;
     }
 
-    // Use setjmp for quick exit when parse error happend
-    if (setjmp(parser->errjmp) == 0)
+    const int32_t depth = writer->depth;
+    if (!JsonWriter_GetBit(writer->objects, depth) || writer->afterName)
     {
-        // Just parse value from the top level
-        if (parser->flags & JsonParseFlags_NoStrictTopLevel)
-        {
-            JsonParser_ParseSingle(parser, value);
-        }
-        // Make sure the toplevel is JsonType_Object
-        else if (JsonParser_SkipSpace(parser) == '{')
-        {
-            JsonParser_ParseObject(parser, value);
+        return JsonWriter_SetError(writer, JsonError_UnexpectedToken);
+    }
 
-            JsonParser_SkipSpace(parser);
-            if (!JsonParser_IsAtEnd(parser))
-            {
-                JsonParser_Panic(parser, JsonType_Null, JsonError_WrongFormat, "JSON is not well-formed. JSON is start with <object>.");
-            }
-        }
-        // Make sure the toplevel is JsonType_Array
-        else if (JsonParser_SkipSpace(parser) == '[')
-        {
-            JsonParser_ParseArray(parser, value);
+    if ((JsonWriter_GetBit(writer->nonEmpty, depth) && !JsonWriter_PutChar(writer, ','))
+        || !JsonWriter_PutIndent(writer, depth)
+        || !JsonWriter_PutString(writer, name, (int32_t)strlen(name)))
+    {
+        return false;
+    }
 
-            JsonParser_SkipSpace(parser);
-            if (!JsonParser_IsAtEnd(parser))
-            {
-                JsonParser_Panic(parser, JsonType_Null, JsonError_WrongFormat, "JSON is not well-formed. JSON is start with <array>.");
-            }
-        }
-        else
-        {
-            JsonParser_SetError(parser, JsonType_Null, JsonError_WrongFormat, "JSON must be starting with '{' or '[', first character is '%c'", JsonParser_PeekChar(parser));
-        }
+    const bool pretty = (writer->flags & JsonWriteFlags_Pretty) != 0;
+    if (!JsonWriter_Put(writer, ": ", pretty ? 2 : 1))
+    {
+        return false;
     }
 
-    return value;
+    JsonWriter_SetBit(writer->nonEmpty, depth, true);
+    writer->afterName = true;
+    return true;
 }
 
-/* @funcdef: JsonParse */
-JsonResult JsonParse(const char* jsonCode, int32_t jsonCodeLength, JsonParseFlags flags, void* buffer, int32_t bufferSize, Json* outValue)
+/* @funcdef: JsonWriter_Null */
+bool JsonWriter_Null(JsonWriter* writer)
 {
-    JSON_ASSERT(outValue, "outValue mustnot be null");
+    JSON_ASSERT(writer, "writer mustnot be null");
+    return JsonWriter_BeginValue(writer) && JsonWriter_Put(writer, "null", 4);
+}
 
-    // Validate json input
-    if (!jsonCode || jsonCodeLength <= 0)
-    {
-        //const JsonResult result = { JsonError_WrongFormat, "Json code is empty", NULL, 0 };
-        const JsonResult result = { JsonError_WrongFormat, "Json code is empty", 0 };
-        return result;
-    }
-    
-    // Create new allocator
-    JsonAllocator allocator;
-    if (!JsonAllocator_Init(&allocator, buffer, bufferSize))
+/* @funcdef: JsonWriter_Boolean */
+bool JsonWriter_Boolean(JsonWriter* writer, bool value)
+{
+    JSON_ASSERT(writer, "writer mustnot be null");
+    return JsonWriter_BeginValue(writer) && (value ? JsonWriter_Put(writer, "true", 4) : JsonWriter_Put(writer, "false", 5));
+}
+
+/* @funcdef: JsonWriter_Number
+ * JSON has no NaN and infinities, they are written as null
+ */
+bool JsonWriter_Number(JsonWriter* writer, double value)
+{
+    JSON_ASSERT(writer, "writer mustnot be null");
+
+    if (!isfinite(value))
     {
-        //const JsonResult result = { JsonError_OutOfMemory, "Buffer is too small", NULL, 0 };
-        const JsonResult result = { JsonError_OutOfMemory, "Buffer is too small", 0 };
-        return result;
+        return JsonWriter_Null(writer);
     }
 
-    // Create parser
-    JsonParser parser;
-    if (!JsonParser_Init(&parser, jsonCode, jsonCodeLength, allocator, flags))
+    if (!JsonWriter_BeginValue(writer) || !JsonWriter_Reserve(writer, JSON_WRITER_RESERVE))
     {
-        //const JsonResult result = { JsonError_InternalFatal, "Wrong behaviour when create new parser", NULL, 0 };
-        const JsonResult result = { JsonError_InternalFatal, "Wrong behaviour when create new parser", 0 };
-        return result;
+        return false;
     }
-    
-    // Parse the top level
-    Json* value = JsonState_ParseTopLevel(&parser);
-    JSON_ASSERT(value, "value mustnot be null");
-    *outValue = *value;
-
-    // Done!
-	JsonResult result;
-	result.error = parser.errnum;
-	result.message = parser.errmsg;
 
-    //result.parser = NULL;
-	result.memoryUsage = (int32_t)(parser.allocator.lowerMarker - (uint8_t*)buffer);
-    return result;
+    writer->length += JsonWriter_FormatNumber(writer->buffer + writer->length, value);
+    return true;
 }
 
-/* @funcdef: JsonContinueParse */
-//JsonResult JsonContinueParse(JsonParser* parser, Json* outValue)
-//{
-//    JSON_ASSERT(outValue, "outValue mustnot be null");
-//
-//    // Validate json input
-//    if (!jsonCode || jsonCodeLength <= 0)
-//    {
-//        const JsonResult result = { JsonError_WrongFormat, "Json code is empty", 0 };
-//        return result;
-//    }
-//
-//    // Create new allocator
-//    JsonAllocator allocator;
-//    if (!JsonAllocator_Init(&allocator, buffer, bufferSize))
-//    {
-//        const JsonResult result = { JsonError_OutOfMemory, "Buffer is too small", 0 };
-//        return result;
-//    }
-//
-//    // Create parser
-//    JsonParser parser;
-//    if (!JsonParser_Init(&parser, jsonCode, jsonCodeLength, allocator, flags))
-//    {
-//        const JsonResult result = { JsonError_InternalFatal, "Wrong behaviour when create new parser", 0 };
-//        return result;
-//    }
-//
-//    // Parse the top level
-//    Json* value = JsonState_ParseTopLevel(&parser);
-//    JSON_ASSERT(value, "value mustnot be null");
-//    *outValue = *value;
-//
-//    // Done!
-//    JsonResult result;
-//    result.error = parser.errnum;
-//    result.message = parser.errmsg;
-//    result.memoryUsage = (int32_t)(parser.allocator.lowerMarker - (uint8_t*)buffer);
-//    return result;
-//}
-
-/* @funcdef: JsonEquals */
-bool JsonEquals(const Json a, const Json b)
+/* @funcdef: JsonWriter_Integer */
+bool JsonWriter_Integer(JsonWriter* writer, int64_t value)
 {
-    if (a.type != b.type)
+    JSON_ASSERT(writer, "writer mustnot be null");
+
+    if (!JsonWriter_BeginValue(writer) || !JsonWriter_Reserve(writer, JSON_WRITER_RESERVE))
     {
         return false;
     }
 
-    switch (a.type)
+    writer->length += JsonWriter_FormatInteger(writer->buffer + writer->length, value);
+    return true;
+}
+
+/* @funcdef: JsonWriter_String
+ * Negative length for null-terminated strings
+ */
+bool JsonWriter_String(JsonWriter* writer, const char* string, int32_t length)
+{
+    JSON_ASSERT(writer, "writer mustnot be null");
+    JSON_ASSERT(string || length == 0, "string mustnot be null");
+
+    return JsonWriter_BeginValue(writer) && JsonWriter_PutString(writer, string, length < 0 ? (int32_t)strlen(string) : length);
+}
+
+/* @funcdef: JsonWriter_Value */
+bool JsonWriter_Value(JsonWriter* writer, const Json value)
+{
+    JSON_ASSERT(writer, "writer mustnot be null");
+
+    switch (value.type)
     {
     case JsonType_Null:
-        return true;
+        return JsonWriter_Null(writer);
+
+    case JsonType_Boolean:
+        return JsonWriter_Boolean(writer, value.boolean);
 
     case JsonType_Number:
-        return a.number == b.number;
+        return JsonIsInteger(value) ? JsonWriter_Integer(writer, value.integer) : JsonWriter_Number(writer, value.number);
 
-    case JsonType_Boolean:
-        return a.boolean == b.boolean;
+    case JsonType_String:
+        return JsonWriter_String(writer, value.string, value.length);
 
-    case JsonType_Array: {
-        int32_t n;
-        if ((n = a.length) == a.length)
+    case JsonType_Array:
+        if (!JsonWriter_BeginArray(writer))
+        {
+            return false;
+        }
+
+        for (int32_t i = 0; i < value.length; i++)
         {
-            for (int32_t i = 0; i < n; i++)
+            if (!JsonWriter_Value(writer, value.array[i]))
             {
-                if (!JsonEquals(a.array[i], b.array[i]))
-                {
-                    return false;
-                }
+                return false;
             }
         }
 
-        return true;
-    }
+        return JsonWriter_EndArray(writer);
 
-    case JsonType_Object: {
-        int32_t n;
-        if ((n = a.length) == b.length)
+    case JsonType_Object:
+        if (!JsonWriter_BeginObject(writer))
         {
-            for (int32_t i = 0; i < n; i++)
-            {
-                if (strncmp(a.object[i].name, b.object[i].name, n) != 0)
-                {
-                    return false;
-                }
+            return false;
+        }
 
-                if (!JsonEquals(a.object[i].value, b.object[i].value))
-                {
-                    return false;
-                }
+        for (int32_t i = 0; i < value.length; i++)
+        {
+            // Empty names are parsed as null
+            const char* name = value.object[i].name ? value.object[i].name : "";
+            if (!JsonWriter_Name(writer, name) || !JsonWriter_Value(writer, value.object[i].value))
+            {
+                return false;
             }
         }
 
-        return true;
-    }
-
-    case JsonType_String:
-        return a.length == b.length && strncmp(a.string, b.string, a.length) == 0;
+        return JsonWriter_EndObject(writer);
 
     default:
-        JSON_ASSERT(false, "invalid json type");
-        break;
+        return JsonWriter_SetError(writer, JsonError_InvalidValue);
     }
-
-    return false;
 }
 
-/* @funcdef: JsonFind */
-bool JsonFind(const Json parent, const char* name, Json* outResult)
+/* @funcdef: JsonWriter_Finish
+ * Without write function the output stay in the buffer, null-terminated when there is room
+ */
+bool JsonWriter_Finish(JsonWriter* writer)
 {
-    JSON_ASSERT(outResult, "outResult mustnot be null");
-    JSON_ASSERT(JsonValidType(parent), "invalid json type");
-    JSON_ASSERT(name, "Attempt using nullptr as string");
+    JSON_ASSERT(writer, "writer mustnot be null");
 
-    if (parent.type == JsonType_Object)
+    if (writer->error != JsonError_None)
     {
-        const int32_t nameLength = (int32_t)strlen(name);
-        for (int32_t i = 0, n = parent.length; i < n; i++)
-        {
-            const JsonObjectMember* member = &parent.object[i];
-            JSON_ASSERT(member && JsonValidType(member->value), "invalid json type");
-
-            if (strncmp(name, member->name, nameLength) == 0)
-            {
-                *outResult = member->value;
-                return true;
-            }
-        }
+        return false;
     }
 
-    *outResult = JSON_NULL;
-    return false;
-}
-
-/* @funcdef: JsonFindWithType */
-JsonError JsonFindWithType(const Json parent, const char* name, JsonType type, Json* outResult)
-{
-    JSON_ASSERT(outResult, "outResult mustnot be null");
-    JSON_ASSERT(JsonValidType(parent), "invalid json type");
-    JSON_ASSERT(name, "Attempt using nullptr as string");
+    if (writer->depth != 0 || !JsonWriter_GetBit(writer->nonEmpty, 0))
+    {
+        return JsonWriter_SetError(writer, JsonError_UnmatchToken);
+    }
 
-    if (parent.type == JsonType_Object)
+    if (!writer->write)
     {
-        const int32_t nameLength = (int32_t)strlen(name);
-        for (int32_t i = 0, n = parent.length; i < n; i++)
+        if (writer->length < writer->bufferSize)
         {
-            const JsonObjectMember* member = &parent.object[i];
-            JSON_ASSERT(member && JsonValidType(member->value), "invalid json type");
-
-            if (strncmp(name, member->name, nameLength) == 0)
-            {
-                *outResult = member->value;
-                return member->value.type == type ? JsonError_None : JsonError_WrongType;
-            }
+            writer->buffer[writer->length] = '\0';
         }
-
-
-        *outResult = JSON_NULL;
-        return JsonError_MissingField;
+        return true;
     }
 
-    *outResult = JSON_NULL;
-    return JsonError_WrongType;
+    return JsonWriter_Flush(writer);
 }
 
 // -------------------------------------------------------------------
@@ -75,6 +75,7 @@ typedef enum JsonParseFlags
     JsonParseFlags_None             = 0,
     JsonParseFlags_SupportComment   = 1 << 0,
     JsonParseFlags_NoStrictTopLevel = 1 << 1,
+    JsonParseFlags_InSitu           = 1 << 2,   // Strings stay in the document: it must be writable and outlive the values, closing quotes become null terminators and escapes are decoded in place
 
     JsonParseFlags_Default          = JsonParseFlags_None,
 } JsonParseFlags;
@@ -83,12 +84,21 @@ typedef struct Json             Json;
 //typedef struct JsonParser       JsonParser;
 typedef struct JsonObjectMember JsonObjectMember;
 
+/// Kind of a JsonType_Number value, stored in Json::length
+typedef enum JsonNumberKind
+{
+    JsonNumberKind_Float,                   // Json::number is valid
+    JsonNumberKind_Integer,                 // Json::integer is valid, the number has no fraction, no exponent and fit in int64_t
+} JsonNumberKind;
+
 struct Json
 {
     JsonType                type;       // Type of value: number, boolean, string, array, object
-    int32_t                 length;     // Length of value, always 1 on primitive types, UTF8 string length
+    int32_t                 length  : 31;   // Length of value: item count of arrays and objects, UTF8 string length in bytes, JsonNumberKind of numbers
+    uint32_t                indexed : 1;    // Objects from JsonParse with JSON_OBJECT_INDEX_MIN members or more: a hash index of the names follow the members
     union
     {
+        int64_t             integer;    // First member, so constants can initialize booleans
         double              number;
         bool                boolean;
 
@@ -106,6 +116,15 @@ struct JsonObjectMember
     Json                    value;
 };
 
+/// Member name with its hash and length, make keys once for names that are looked up often
+/// name must be null-terminated, use JsonMakeKey
+typedef struct JsonKey
+{
+    const char*             name;
+    int32_t                 length;
+    uint32_t                hash;
+} JsonKey;
+
 // -------------------------------------------------------------------
 // Constants
 // -------------------------------------------------------------------
@@ -115,8 +134,12 @@ struct JsonObjectMember
 #endif
 
 JSON_CONST Json JSON_NULL     = { JsonType_Null   , 0             };
-JSON_CONST Json JSON_TRUE     = { JsonType_Boolean, 0, { true  }  };
-JSON_CONST Json JSON_FALSE    = { JsonType_Boolean, 0, { false }  };
+JSON_CONST Json JSON_TRUE     = { JsonType_Boolean, 0, 0, { true  }  };
+JSON_CONST Json JSON_FALSE    = { JsonType_Boolean, 0, 0, { false }  };
+
+/// Objects with this many members or more are parsed with a hash index of their names after the members, and Json::indexed set.
+/// Objects built by hand leave indexed 0 (start from JSON_NULL), JsonFind scan them.
+JSON_CONST int32_t JSON_OBJECT_INDEX_MIN = 8;
 
 #if defined(__GNUC__)
 #pragma GCC diagnostic warning "-Wmissing-field-initializers"
@@ -127,18 +150,270 @@ JSON_CONST Json JSON_FALSE    = { JsonType_Boolean, 0, { false }  };
 // -------------------------------------------------------------------
 
 JSON_API JsonResult JsonParse(const char* jsonCode, int32_t jsonCodeLength, JsonParseFlags flags, void* buffer, int32_t bufferSize, Json* outValue);
-//JSON_API JsonResult JsonContinueParse(JsonParser* parser, Json* outValue);
+
+/// Run func over [0, count) in ranges of at least batchSize items, return when all ranges are done (JobSystem::ParallelFor)
+typedef void (*JsonRangeFunc)(void* data, int32_t start, int32_t end);
+typedef void (*JsonParallelForFunc)(JsonRangeFunc func, void* data, int32_t count, int32_t batchSize);
+
+/// Same as JsonParse, large arrays are split at item boundaries and their chunks are parsed with parallelFor.
+/// Chunks share the free part of the buffer in proportion to their estimated size, arrays that would not fit are parsed serially.
+/// JsonParseFlags_SupportComment disable the parallel mode. parallelFor must not be called from one of its workers.
+JSON_API JsonResult JsonParseParallel(const char* jsonCode, int32_t jsonCodeLength, JsonParseFlags flags, JsonParallelForFunc parallelFor, void* buffer, int32_t bufferSize, Json* outValue);
+
+/// Get a chunk of at least minSize bytes for JsonParseChunked, store its size in outSize, return NULL when out of memory
+typedef void* (*JsonAllocChunkFunc)(void* userData, int32_t minSize, int32_t* outSize);
+
+/// Same as JsonParse, but a chunk is asked to allocChunk when the buffer is full instead of failing (growable chunk mode).
+/// buffer may be NULL, values then live in the chunks only. The caller own the chunks and free them after use.
+/// JsonResult::memoryUsage is the sum of the used parts of the buffer and the chunks.
+JSON_API JsonResult JsonParseChunked(const char* jsonCode, int32_t jsonCodeLength, JsonParseFlags flags, JsonAllocChunkFunc allocChunk, void* userData, void* buffer, int32_t bufferSize, Json* outValue);
+
+/// Exact bufferSize JsonParse need for this document in outBufferSize, from a structural scan without building values.
+/// JsonResult::memoryUsage is the one JsonParse will report, temporaries make the buffer size larger.
+/// The sizes are for a 16 bytes aligned buffer (add 15 bytes otherwise), JsonParseParallel may need more with JsonParseFlags_InSitu.
+/// Scalars are not checked, JsonParse may still report an error. JsonParseFlags_SupportComment is not supported.
+JSON_API JsonResult JsonQueryMemory(const char* jsonCode, int32_t jsonCodeLength, JsonParseFlags flags, int32_t* outBufferSize);
+
+/// Decoded member names this long or longer are given as NULL to JsonSkipFunc
+#define JSON_SKIP_NAME_SIZE 64
+
+/// Array or object about to be parsed, see JsonSkipFunc
+typedef struct JsonSkipTarget
+{
+    int32_t         depth;          // Arrays and objects around it, 1 for the members or items of the top level value
+    const char*     name;           // Its member name, or the member name of its array for an item. NULL in the top level array and for long names.
+    bool            isItem;
+    const char*     text;           // Its first byte in the document, not parsed yet
+    int32_t         length;         // Bytes that can be read from text, they hold the whole value
+} JsonSkipTarget;
+
+/// Return true to parse the array or object as null without building it, only its brackets are checked then.
+/// Called for every array and object but the top level value, from the workers of parallelFor too.
+typedef bool (*JsonSkipFunc)(void* userData, const JsonSkipTarget* target);
+
+/// JsonParse with a skip hook. parallelFor or allocChunk (not both) work like in JsonParseParallel and JsonParseChunked, they may be NULL.
+JSON_API JsonResult JsonParseSkipping(const char* jsonCode, int32_t jsonCodeLength, JsonParseFlags flags, JsonSkipFunc skip, void* skipUserData,
+                                      JsonParallelForFunc parallelFor, JsonAllocChunkFunc allocChunk, void* chunkUserData,
+                                      void* buffer, int32_t bufferSize, Json* outValue);
+
+/// JsonQueryMemory of a document parsed with JsonParseSkipping, the hook make the same decisions
+JSON_API JsonResult JsonQueryMemorySkipping(const char* jsonCode, int32_t jsonCodeLength, JsonParseFlags flags, JsonSkipFunc skip, void* skipUserData, int32_t* outBufferSize);
 
 JSON_API bool       JsonEquals(const Json a, const Json b);
 
+/// Find member by exact name, O(1) on indexed objects
 JSON_API bool       JsonFind(const Json parent, const char* name, Json* outResult);
 JSON_API JsonError  JsonFindWithType(const Json parent, const char* name, JsonType type, Json* outResult);
 
+/// Same as JsonFind, without hashing the name again
+JSON_API JsonKey    JsonMakeKey(const char* name);
+JSON_API bool       JsonFindKey(const Json parent, const JsonKey key, Json* outResult);
+JSON_API JsonError  JsonFindKeyWithType(const Json parent, const JsonKey key, JsonType type, Json* outResult);
+
 static inline bool JsonValidType(const Json json)
 {
     return json.type >= JsonType_Null && json.type <= JsonType_Boolean;
 }
 
+/// Integers are stored exactly, read numbers with these functions instead of Json::number
+static inline bool JsonIsInteger(const Json json)
+{
+    return json.type == JsonType_Number && json.length == JsonNumberKind_Integer;
+}
+
+static inline double JsonNumber(const Json json)
+{
+    return json.length == JsonNumberKind_Integer ? (double)json.integer : json.number;
+}
+
+static inline int64_t JsonInteger(const Json json)
+{
+    return json.length == JsonNumberKind_Integer ? json.integer : (int64_t)json.number;
+}
+
+// -------------------------------------------------------------------
+// Streaming reader
+// -------------------------------------------------------------------
+
+/// Maximum nesting of arrays and objects for JsonReader
+#define JSON_READER_MAX_DEPTH 256
+
+/// Token of JsonReader
+typedef enum JsonToken
+{
+    JsonToken_None,
+    JsonToken_ObjectBegin,
+    JsonToken_ObjectEnd,
+    JsonToken_ArrayBegin,
+    JsonToken_ArrayEnd,
+    JsonToken_Name,                         // Member name, JsonReader::value is a string
+    JsonToken_Value,                        // Null, boolean, number or string in JsonReader::value
+    JsonToken_End,                          // End of the document
+    JsonToken_Error,                        // JsonReader::error and JsonReader::message
+} JsonToken;
+
+/// Read at most bufferSize bytes, return the number of bytes read, 0 at the end of input, negative on error
+typedef int32_t (*JsonReadFunc)(void* userData, void* buffer, int32_t bufferSize);
+
+/// Pull reader: read the document token by token over chunked input, without building values
+/// Memory is the caller buffer plus the depth stack, whatever the document size.
+/// A name, string or number token must fit in the buffer.
+typedef struct JsonReader
+{
+    JsonParseFlags          flags;
+
+    JsonReadFunc            read;
+    void*                   userData;
+
+    char*                   buffer;         // Window on the document
+    int32_t                 bufferSize;
+    int32_t                 length;         // Bytes read in buffer
+    int32_t                 cursor;
+    int64_t                 offset;         // Offset of buffer[0] in the document
+    bool                    isEndOfInput;
+
+    int32_t                 expect;         // Internal state, what come next
+    int32_t                 depth;
+    uint64_t                stack[JSON_READER_MAX_DEPTH / 64];  // One bit per level, set for objects
+
+    JsonToken               token;          // Last token
+    Json                    value;          // Name or value of the last token, strings are null-terminated and live in buffer until the next call
+
+    JsonError               error;
+    char                    message[256];
+} JsonReader;
+
+/// Start reading, buffer hold the current chunk of the document
+JSON_API bool       JsonReader_Init(JsonReader* reader, JsonParseFlags flags, void* buffer, int32_t bufferSize, JsonReadFunc read, void* userData);
+
+/// Read the next token
+JSON_API JsonToken  JsonReader_Next(JsonReader* reader);
+
+/// Read the next token, return true when it begin an object or an array
+JSON_API bool       JsonReader_EnterObject(JsonReader* reader);
+JSON_API bool       JsonReader_EnterArray(JsonReader* reader);
+
+/// Inside an object: read the next member name, return false at the end of the object (consumed) or on error
+JSON_API bool       JsonReader_NextMember(JsonReader* reader, const char** outName);
+
+/// Inside an array: return true when an item follow, false at the end of the array (consumed) or on error
+JSON_API bool       JsonReader_NextItem(JsonReader* reader);
+
+/// Skip the next value with all its children, strings of skipped values are not decoded nor validated
+JSON_API bool       JsonReader_SkipValue(JsonReader* reader);
+
+// -------------------------------------------------------------------
+// On-demand tape
+// -------------------------------------------------------------------
+
+typedef struct JsonTapeEntry JsonTapeEntry;
+
+/// Values and member names of a document in document order, built in one pass without decoding them.
+/// Nodes are indices in the tape, node 0 is the top level value. Items of an array follow it,
+/// members of an object follow it as a name node then its value node. Skipping a subtree is O(1).
+/// Structure is checked when building, numbers and literals when they are read.
+typedef struct JsonTape
+{
+    const char*             json;           // Reference only, must outlive the tape
+    int32_t                 length;
+
+    const JsonTapeEntry*    entries;        // In the buffer given to JsonTape_Build
+    int32_t                 count;
+} JsonTape;
+
+/// Build the tape of a document, JsonParseFlags_SupportComment is not supported
+JSON_API JsonResult JsonTape_Build(const char* jsonCode, int32_t jsonCodeLength, JsonParseFlags flags, void* buffer, int32_t bufferSize, JsonTape* outTape);
+
+JSON_API JsonType   JsonTape_GetType(const JsonTape* tape, int32_t node);
+
+/// Item count of arrays, member count of objects, raw byte length of strings (upper bound of the decoded length), 0 otherwise
+JSON_API int32_t    JsonTape_GetLength(const JsonTape* tape, int32_t node);
+
+/// Node after node and all its children: next item of an array, name of the next member of an object
+JSON_API int32_t    JsonTape_Skip(const JsonTape* tape, int32_t node);
+
+/// Item of an array, -1 when out of range
+JSON_API int32_t    JsonTape_GetItem(const JsonTape* tape, int32_t array, int32_t index);
+
+/// Value node of the member with this exact name, -1 when missing
+JSON_API int32_t    JsonTape_Find(const JsonTape* tape, int32_t object, const char* name);
+
+/// Decode a null, boolean or number, JsonError_WrongType for other values
+JSON_API JsonError  JsonTape_GetValue(const JsonTape* tape, int32_t node, Json* outValue);
+
+/// Decode a string or a member name, null-terminated, buffer must hold JsonTape_GetLength() + 1 bytes
+/// Return the decoded length, -1 on error
+JSON_API int32_t    JsonTape_GetString(const JsonTape* tape, int32_t node, char* buffer, int32_t bufferSize);
+
+/// Parse a subtree into values, like JsonParse, JsonParseFlags_InSitu is ignored
+JSON_API JsonResult JsonTape_Parse(const JsonTape* tape, int32_t node, JsonParseFlags flags, void* buffer, int32_t bufferSize, Json* outValue);
+
+// -------------------------------------------------------------------
+// Writer
+// -------------------------------------------------------------------
+
+/// Maximum nesting of arrays and objects for JsonWriter
+#define JSON_WRITER_MAX_DEPTH 256
+
+/// Json write flags
+typedef enum JsonWriteFlags
+{
+    JsonWriteFlags_None             = 0,
+    JsonWriteFlags_Pretty           = 1 << 0,   // New lines and 4 spaces indentation
+
+    JsonWriteFlags_Default          = JsonWriteFlags_None,
+} JsonWriteFlags;
+
+/// Write size bytes, return the number of bytes written, less than size on error
+typedef int32_t (*JsonWriteFunc)(void* userData, const void* data, int32_t size);
+
+/// Streaming writer: output is gathered in the caller buffer and given to write when full.
+/// Without write function the whole document must fit in the buffer (JsonWriter::buffer, JsonWriter::length).
+/// Doubles are written with Grisu2: they always read back to the same value, the digits are the shortest in most cases,
+/// with ".0" for integral values so they read back as floats. NaN and infinities are written as null.
+/// Strings must be valid UTF-8, they are not checked.
+typedef struct JsonWriter
+{
+    JsonWriteFlags          flags;
+
+    JsonWriteFunc           write;
+    void*                   userData;
+
+    char*                   buffer;
+    int32_t                 bufferSize;
+    int32_t                 length;         // Bytes in buffer, not given to write yet
+    int64_t                 written;        // Bytes given to write
+
+    int32_t                 depth;
+    uint64_t                objects[JSON_WRITER_MAX_DEPTH / 64];    // One bit per level, set for objects
+    uint64_t                nonEmpty[JSON_WRITER_MAX_DEPTH / 64];   // One bit per level, set when it has an item
+    bool                    afterName;
+
+    JsonError               error;
+} JsonWriter;
+
+JSON_API bool       JsonWriter_Init(JsonWriter* writer, JsonWriteFlags flags, void* buffer, int32_t bufferSize, JsonWriteFunc write, void* userData);
+
+JSON_API bool       JsonWriter_BeginObject(JsonWriter* writer);
+JSON_API bool       JsonWriter_EndObject(JsonWriter* writer);
+JSON_API bool       JsonWriter_BeginArray(JsonWriter* writer);
+JSON_API bool       JsonWriter_EndArray(JsonWriter* writer);
+
+/// Member name, must be followed by its value
+JSON_API bool       JsonWriter_Name(JsonWriter* writer, const char* name);
+
+JSON_API bool       JsonWriter_Null(JsonWriter* writer);
+JSON_API bool       JsonWriter_Boolean(JsonWriter* writer, bool value);
+JSON_API bool       JsonWriter_Number(JsonWriter* writer, double value);
+JSON_API bool       JsonWriter_Integer(JsonWriter* writer, int64_t value);
+JSON_API bool       JsonWriter_String(JsonWriter* writer, const char* string, int32_t length);
+
+/// Write a value with all its children
+JSON_API bool       JsonWriter_Value(JsonWriter* writer, const Json value);
+
+/// Give the rest of the buffer to write, the document must be complete
+JSON_API bool       JsonWriter_Finish(JsonWriter* writer);
+
 /* END OF EXTERN "C" */
 #ifdef __cplusplus
 }
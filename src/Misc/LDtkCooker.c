@@ -0,0 +1,742 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "LDtkCooker.h"
+
+// Any change of a structure size give another layout, blobs of older builds are stale then
+static uint32_t LDtkCookedLayout(void)
+{
+    const uint32_t sizes[] = {
+        (uint32_t)sizeof(void*),
+        (uint32_t)sizeof(LDtkWorld),
+        (uint32_t)sizeof(LDtkTileset),
+        (uint32_t)sizeof(LDtkEnum),
+        (uint32_t)sizeof(LDtkEnumValue),
+        (uint32_t)sizeof(LDtkLayerDef),
+        (uint32_t)sizeof(LDtkEntityDef),
+        (uint32_t)sizeof(LDtkLevel),
+        (uint32_t)sizeof(LDtkLayer),
+        (uint32_t)sizeof(LDtkTile),
+        (uint32_t)sizeof(LDtkIntGridValue),
+        (uint32_t)sizeof(LDtkEntity),
+        (uint32_t)sizeof(LDtkLevelSource),
+    };
+
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (int32_t i = 0; i < (int32_t)(sizeof(sizes) / sizeof(sizes[0])); i++)
+    {
+        hash = (hash ^ sizes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+bool LDtkGetSourceStamp(const char* path, LDtkSourceStamp* outStamp)
+{
+    struct stat info;
+    if (stat(path, &info) != 0)
+    {
+        return false;
+    }
+
+    outStamp->size = (int64_t)info.st_size;
+    outStamp->time = (int64_t)info.st_mtime;
+    return true;
+}
+
+int32_t LDtkGetLevelSources(const LDtkWorld* levelIndex, LDtkLevelSource* outSources, int32_t maxCount)
+{
+    int32_t count = 0;
+    for (int32_t i = 0; i < levelIndex->levelCount; i++)
+    {
+        const char* path = levelIndex->levels[i].externalPath;
+        if (!path)
+        {
+            continue;
+        }
+
+        if (count < maxCount)
+        {
+            LDtkLevelSource* source = &outSources[count];
+            source->path = path;
+            if (!LDtkGetSourceStamp(path, &source->stamp))
+            {
+                source->stamp.size = -1;
+                source->stamp.time = -1;
+            }
+        }
+        count++;
+    }
+
+    return count;
+}
+
+// -------------------------------------------------------------------
+// Cooking
+// -------------------------------------------------------------------
+
+// Blocks are placed twice: once to measure the blob, then to write it
+typedef struct LDtkCooker
+{
+    uint8_t*        buffer;         // NULL when measuring
+    int64_t         cursor;         // Blocks with pointers
+    int64_t         bulkCursor;     // Strings and tiles, after the blocks with pointers
+    int64_t         bulkOffset;
+} LDtkCooker;
+
+static int64_t LDtkCooker_Place(int64_t* cursor, int64_t size, int64_t alignment)
+{
+    const int64_t offset = (*cursor + alignment - 1) & ~(alignment - 1);
+    *cursor = offset + size;
+    return offset;
+}
+
+// Offset of a copy of the array, stored in place of its pointer, 0 for empty arrays
+static uintptr_t LDtkCooker_Array(LDtkCooker* cooker, bool bulk, const void* items, int32_t count, int32_t itemSize)
+{
+    if (!items || count <= 0)
+    {
+        return 0;
+    }
+
+    const int64_t size = (int64_t)count * itemSize;
+    const int64_t offset = LDtkCooker_Place(bulk ? &cooker->bulkCursor : &cooker->cursor, size, 16);
+    if (cooker->buffer)
+    {
+        memcpy(cooker->buffer + offset, items, (size_t)size);
+    }
+    return (uintptr_t)offset;
+}
+
+static const char* LDtkCooker_String(LDtkCooker* cooker, const char* string)
+{
+    if (!string)
+    {
+        return NULL;
+    }
+
+    const int64_t size = (int64_t)strlen(string) + 1;
+    const int64_t offset = LDtkCooker_Place(&cooker->bulkCursor, size, 1);
+    if (cooker->buffer)
+    {
+        memcpy(cooker->buffer + offset, string, (size_t)size);
+    }
+    return (const char*)(uintptr_t)offset;
+}
+
+// Items are cooked in a copy then stored over the copy of their array
+static void LDtkCooker_Store(LDtkCooker* cooker, uintptr_t arrayOffset, int32_t index, const void* item, int32_t itemSize)
+{
+    if (cooker->buffer)
+    {
+        memcpy(cooker->buffer + arrayOffset + (int64_t)index * itemSize, item, (size_t)itemSize);
+    }
+}
+
+static void LDtkCook_Tileset(LDtkCooker* cooker, LDtkTileset* tileset)
+{
+    tileset->name = LDtkCooker_String(cooker, tileset->name);
+    tileset->path = LDtkCooker_String(cooker, tileset->path);
+}
+
+static LDtkIntGridValue* LDtkCook_IntGridValues(LDtkCooker* cooker, const LDtkIntGridValue* values, int32_t count)
+{
+    const uintptr_t offset = LDtkCooker_Array(cooker, false, values, count, sizeof(LDtkIntGridValue));
+    for (int32_t i = 0; i < count; i++)
+    {
+        LDtkIntGridValue value = values[i];
+        value.name = LDtkCooker_String(cooker, value.name);
+        LDtkCooker_Store(cooker, offset, i, &value, sizeof(value));
+    }
+    return (LDtkIntGridValue*)offset;
+}
+
+static LDtkTileset* LDtkCook_Tilesets(LDtkCooker* cooker, const LDtkTileset* tilesets, int32_t count)
+{
+    const uintptr_t offset = LDtkCooker_Array(cooker, false, tilesets, count, sizeof(LDtkTileset));
+    for (int32_t i = 0; i < count; i++)
+    {
+        LDtkTileset tileset = tilesets[i];
+        LDtkCook_Tileset(cooker, &tileset);
+        LDtkCooker_Store(cooker, offset, i, &tileset, sizeof(tileset));
+    }
+    return (LDtkTileset*)offset;
+}
+
+static LDtkEnum* LDtkCook_Enums(LDtkCooker* cooker, const LDtkEnum* enums, int32_t count)
+{
+    const uintptr_t offset = LDtkCooker_Array(cooker, false, enums, count, sizeof(LDtkEnum));
+    for (int32_t i = 0; i < count; i++)
+    {
+        LDtkEnum enumDef = enums[i];
+        enumDef.name = LDtkCooker_String(cooker, enumDef.name);
+        enumDef.externalPath = LDtkCooker_String(cooker, enumDef.externalPath);
+        enumDef.externalChecksum = LDtkCooker_String(cooker, enumDef.externalChecksum);
+
+        const uintptr_t valuesOffset = LDtkCooker_Array(cooker, false, enumDef.values, enumDef.valueCount, sizeof(LDtkEnumValue));
+        for (int32_t j = 0; j < enumDef.valueCount; j++)
+        {
+            LDtkEnumValue value = enumDef.values[j];
+            value.name = LDtkCooker_String(cooker, value.name);
+            LDtkCooker_Store(cooker, valuesOffset, j, &value, sizeof(value));
+        }
+        enumDef.values = (LDtkEnumValue*)valuesOffset;
+
+        LDtkCooker_Store(cooker, offset, i, &enumDef, sizeof(enumDef));
+    }
+    return (LDtkEnum*)offset;
+}
+
+static LDtkLayerDef* LDtkCook_LayerDefs(LDtkCooker* cooker, const LDtkLayerDef* layerDefs, int32_t count)
+{
+    const uintptr_t offset = LDtkCooker_Array(cooker, false, layerDefs, count, sizeof(LDtkLayerDef));
+    for (int32_t i = 0; i < count; i++)
+    {
+        LDtkLayerDef layerDef = layerDefs[i];
+        layerDef.name = LDtkCooker_String(cooker, layerDef.name);
+        layerDef.intGridValues = LDtkCook_IntGridValues(cooker, layerDef.intGridValues, layerDef.intGridValueCount);
+        LDtkCooker_Store(cooker, offset, i, &layerDef, sizeof(layerDef));
+    }
+    return (LDtkLayerDef*)offset;
+}
+
+static LDtkEntityDef* LDtkCook_EntityDefs(LDtkCooker* cooker, const LDtkEntityDef* entityDefs, int32_t count)
+{
+    const uintptr_t offset = LDtkCooker_Array(cooker, false, entityDefs, count, sizeof(LDtkEntityDef));
+    for (int32_t i = 0; i < count; i++)
+    {
+        LDtkEntityDef entityDef = entityDefs[i];
+        entityDef.name = LDtkCooker_String(cooker, entityDef.name);
+
+        const uintptr_t tagsOffset = LDtkCooker_Array(cooker, false, entityDef.tags, entityDef.tagCount, sizeof(const char*));
+        for (int32_t j = 0; j < entityDef.tagCount; j++)
+        {
+            const char* tag = LDtkCooker_String(cooker, entityDef.tags[j]);
+            LDtkCooker_Store(cooker, tagsOffset, j, &tag, sizeof(tag));
+        }
+        entityDef.tags = (const char**)tagsOffset;
+
+        LDtkCooker_Store(cooker, offset, i, &entityDef, sizeof(entityDef));
+    }
+    return (LDtkEntityDef*)offset;
+}
+
+static LDtkLayer* LDtkCook_Layers(LDtkCooker* cooker, const LDtkLayer* layers, int32_t count)
+{
+    const uintptr_t offset = LDtkCooker_Array(cooker, false, layers, count, sizeof(LDtkLayer));
+    for (int32_t i = 0; i < count; i++)
+    {
+        LDtkLayer layer = layers[i];
+        layer.name = LDtkCooker_String(cooker, layer.name);
+        LDtkCook_Tileset(cooker, &layer.tileset);
+
+        // Tiles have no pointer, they are never written when the blob is relocated
+        layer.tiles = (LDtkTile*)LDtkCooker_Array(cooker, true, layer.tiles, layer.tileCount, sizeof(LDtkTile));
+        layer.values = LDtkCook_IntGridValues(cooker, layer.values, layer.valueCount);
+
+        const uintptr_t entitiesOffset = LDtkCooker_Array(cooker, false, layer.entities, layer.entityCount, sizeof(LDtkEntity));
+        for (int32_t j = 0; j < layer.entityCount; j++)
+        {
+            LDtkEntity entity = layer.entities[j];
+            entity.name = LDtkCooker_String(cooker, entity.name);
+            LDtkCooker_Store(cooker, entitiesOffset, j, &entity, sizeof(entity));
+        }
+        layer.entities = (LDtkEntity*)entitiesOffset;
+
+        LDtkCooker_Store(cooker, offset, i, &layer, sizeof(layer));
+    }
+    return (LDtkLayer*)offset;
+}
+
+static LDtkLevel* LDtkCook_Levels(LDtkCooker* cooker, const LDtkLevel* levels, int32_t count)
+{
+    const uintptr_t offset = LDtkCooker_Array(cooker, false, levels, count, sizeof(LDtkLevel));
+    for (int32_t i = 0; i < count; i++)
+    {
+        LDtkLevel level = levels[i];
+        level.name = LDtkCooker_String(cooker, level.name);
+        level.bgPath = LDtkCooker_String(cooker, level.bgPath);
+        level.layers = LDtkCook_Layers(cooker, level.layers, level.layerCount);
+
+        // A cooked level is whole, the level index fields point into the world buffer
+        level.externalPath = NULL;
+        level.source = NULL;
+        level.memoryUsage = 0;
+        LDtkCooker_Store(cooker, offset, i, &level, sizeof(level));
+    }
+    return (LDtkLevel*)offset;
+}
+
+// Level files are only read before relocating, they are bulk blocks
+static uintptr_t LDtkCook_LevelSources(LDtkCooker* cooker, const LDtkLevelSource* sources, int32_t count)
+{
+    const uintptr_t offset = LDtkCooker_Array(cooker, true, sources, count, sizeof(LDtkLevelSource));
+    for (int32_t i = 0; i < count; i++)
+    {
+        LDtkLevelSource source = sources[i];
+        source.path = LDtkCooker_String(cooker, source.path);
+        LDtkCooker_Store(cooker, offset, i, &source, sizeof(source));
+    }
+    return offset;
+}
+
+static void LDtkCook_World(LDtkCooker* cooker, const LDtkWorld* source, LDtkParseFlags flags, LDtkSourceStamp stamp, const LDtkLevelSource* levelSources, int32_t levelSourceCount)
+{
+    const int64_t worldOffset = LDtkCooker_Place(&cooker->cursor, sizeof(LDtkWorld), 16);
+
+    LDtkWorld world = *source;
+    world.tilesets = LDtkCook_Tilesets(cooker, world.tilesets, world.tilesetCount);
+    world.enums = LDtkCook_Enums(cooker, world.enums, world.enumCount);
+    world.layerDefs = LDtkCook_LayerDefs(cooker, world.layerDefs, world.layerDefCount);
+    world.entityDefs = LDtkCook_EntityDefs(cooker, world.entityDefs, world.entityDefCount);
+    world.levels = LDtkCook_Levels(cooker, world.levels, world.levelCount);
+
+    const uintptr_t sourceOffset = LDtkCook_LevelSources(cooker, levelSources, levelSourceCount);
+
+    if (cooker->buffer)
+    {
+        const LDtkCookedHeader header = {
+            .magic          = LDTK_COOKED_MAGIC,
+            .version        = LDTK_COOKED_VERSION,
+            .layout         = LDtkCookedLayout(),
+            .flags          = (uint32_t)flags,
+            .size           = (int32_t)cooker->bulkCursor,
+            .worldOffset    = (int32_t)worldOffset,
+            .bulkOffset     = (int32_t)cooker->bulkOffset,
+            .sourceOffset   = (int32_t)sourceOffset,
+            .sourceCount    = sourceOffset ? levelSourceCount : 0,
+            .reserved       = 0,
+            .stamp          = stamp,
+        };
+
+        memcpy(cooker->buffer, &header, sizeof(header));
+        memcpy(cooker->buffer + worldOffset, &world, sizeof(world));
+    }
+}
+
+LDtkError LDtkCook(const LDtkWorld* world, LDtkParseFlags flags, LDtkSourceStamp stamp, const LDtkLevelSource* levelSources, int32_t levelSourceCount,
+                   void* buffer, int32_t bufferSize, int32_t* outSize)
+{
+    assert(world);
+    assert(outSize);
+
+    // Measure, the bulk blocks come after the others
+    LDtkCooker cooker = { NULL, sizeof(LDtkCookedHeader), 0, 0 };
+    LDtkCook_World(&cooker, world, flags, stamp, levelSources, levelSourceCount);
+
+    const int64_t bulkOffset = (cooker.cursor + 15) & ~15;
+    const int64_t size = bulkOffset + cooker.bulkCursor;
+    if (size > INT32_MAX)
+    {
+        *outSize = 0;
+
+        const LDtkError error = { LDtkErrorCode_OutOfMemory, "World is too large" };
+        return error;
+    }
+
+    *outSize = (int32_t)size;
+    if (!buffer)
+    {
+        const LDtkError error = { LDtkErrorCode_None, "" };
+        return error;
+    }
+
+    if (bufferSize < size)
+    {
+        const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
+        return error;
+    }
+
+    // Padding and unused bytes are zero, a world is always cooked to the same bytes
+    memset(buffer, 0, (size_t)size);
+
+    const LDtkCooker writer = { (uint8_t*)buffer, sizeof(LDtkCookedHeader), bulkOffset, bulkOffset };
+    cooker = writer;
+    LDtkCook_World(&cooker, world, flags, stamp, levelSources, levelSourceCount);
+    assert(cooker.bulkCursor == size);
+
+    const LDtkError error = { LDtkErrorCode_None, "" };
+    return error;
+}
+
+// -------------------------------------------------------------------
+// Loading
+// -------------------------------------------------------------------
+
+// Offsets are checked against the blob, a corrupted blob is reported instead of read out of bounds.
+// Blocks with pointers must follow each other in the order they are relocated: none is relocated twice,
+// and the strings and tiles after them are never written.
+typedef struct LDtkRelocator
+{
+    uint8_t*        blob;
+    int32_t         size;
+    int32_t         cursor;         // End of the last relocated block
+    int32_t         bulkOffset;
+    bool            invalid;
+} LDtkRelocator;
+
+static void* LDtkRelocator_Block(LDtkRelocator* relocator, bool bulk, const void* pointer, int32_t count, int32_t itemSize)
+{
+    const uintptr_t offset = (uintptr_t)pointer;
+    const uintptr_t start = (uintptr_t)(bulk ? relocator->bulkOffset : relocator->cursor);
+    const uintptr_t end = (uintptr_t)(bulk ? relocator->size : relocator->bulkOffset);
+    if (count < 0 || (offset == 0) != (count == 0))
+    {
+        relocator->invalid = true;
+        return NULL;
+    }
+
+    if (offset == 0)
+    {
+        return NULL;
+    }
+
+    if ((offset & 15) != 0 || offset < start || offset > end || (uint64_t)count * (uint64_t)itemSize > (uint64_t)(end - offset))
+    {
+        relocator->invalid = true;
+        return NULL;
+    }
+
+    if (!bulk)
+    {
+        relocator->cursor = (int32_t)(offset + (uintptr_t)count * (uintptr_t)itemSize);
+    }
+    return relocator->blob + offset;
+}
+
+static void* LDtkRelocator_Array(LDtkRelocator* relocator, const void* pointer, int32_t count, int32_t itemSize)
+{
+    return LDtkRelocator_Block(relocator, false, pointer, count, itemSize);
+}
+
+// Only set strings are written, pages without them stay shared with the file
+static void LDtkRelocator_String(LDtkRelocator* relocator, const char** string)
+{
+    const uintptr_t offset = (uintptr_t)*string;
+    if (offset == 0)
+    {
+        return;
+    }
+
+    if (offset < (uintptr_t)relocator->bulkOffset || offset >= (uintptr_t)relocator->size || !memchr(relocator->blob + offset, 0, (size_t)relocator->size - offset))
+    {
+        relocator->invalid = true;
+        *string = NULL;
+        return;
+    }
+
+    *string = (const char*)(relocator->blob + offset);
+}
+
+static void LDtkRelocate_IntGridValues(LDtkRelocator* relocator, LDtkIntGridValue** values, int32_t count)
+{
+    *values = (LDtkIntGridValue*)LDtkRelocator_Array(relocator, *values, count, sizeof(LDtkIntGridValue));
+    for (int32_t i = 0; i < count && !relocator->invalid; i++)
+    {
+        LDtkRelocator_String(relocator, &(*values)[i].name);
+    }
+}
+
+static void LDtkRelocate_World(LDtkRelocator* relocator, LDtkWorld* world)
+{
+    world->tilesets = (LDtkTileset*)LDtkRelocator_Array(relocator, world->tilesets, world->tilesetCount, sizeof(LDtkTileset));
+    for (int32_t i = 0; i < world->tilesetCount && !relocator->invalid; i++)
+    {
+        LDtkRelocator_String(relocator, &world->tilesets[i].name);
+        LDtkRelocator_String(relocator, &world->tilesets[i].path);
+    }
+
+    world->enums = (LDtkEnum*)LDtkRelocator_Array(relocator, world->enums, world->enumCount, sizeof(LDtkEnum));
+    for (int32_t i = 0; i < world->enumCount && !relocator->invalid; i++)
+    {
+        LDtkEnum* enumDef = &world->enums[i];
+        LDtkRelocator_String(relocator, &enumDef->name);
+        LDtkRelocator_String(relocator, &enumDef->externalPath);
+        LDtkRelocator_String(relocator, &enumDef->externalChecksum);
+
+        enumDef->values = (LDtkEnumValue*)LDtkRelocator_Array(relocator, enumDef->values, enumDef->valueCount, sizeof(LDtkEnumValue));
+        for (int32_t j = 0; j < enumDef->valueCount && !relocator->invalid; j++)
+        {
+            LDtkRelocator_String(relocator, &enumDef->values[j].name);
+        }
+    }
+
+    world->layerDefs = (LDtkLayerDef*)LDtkRelocator_Array(relocator, world->layerDefs, world->layerDefCount, sizeof(LDtkLayerDef));
+    for (int32_t i = 0; i < world->layerDefCount && !relocator->invalid; i++)
+    {
+        LDtkLayerDef* layerDef = &world->layerDefs[i];
+        LDtkRelocator_String(relocator, &layerDef->name);
+        LDtkRelocate_IntGridValues(relocator, &layerDef->intGridValues, layerDef->intGridValueCount);
+    }
+
+    world->entityDefs = (LDtkEntityDef*)LDtkRelocator_Array(relocator, world->entityDefs, world->entityDefCount, sizeof(LDtkEntityDef));
+    for (int32_t i = 0; i < world->entityDefCount && !relocator->invalid; i++)
+    {
+        LDtkEntityDef* entityDef = &world->entityDefs[i];
+        LDtkRelocator_String(relocator, &entityDef->name);
+
+        entityDef->tags = (const char**)LDtkRelocator_Array(relocator, entityDef->tags, entityDef->tagCount, sizeof(const char*));
+        for (int32_t j = 0; j < entityDef->tagCount && !relocator->invalid; j++)
+        {
+            LDtkRelocator_String(relocator, &entityDef->tags[j]);
+        }
+    }
+
+    world->levels = (LDtkLevel*)LDtkRelocator_Array(relocator, world->levels, world->levelCount, sizeof(LDtkLevel));
+    for (int32_t i = 0; i < world->levelCount && !relocator->invalid; i++)
+    {
+        LDtkLevel* level = &world->levels[i];
+        LDtkRelocator_String(relocator, &level->name);
+        LDtkRelocator_String(relocator, &level->bgPath);
+        level->externalPath = NULL;
+        level->source = NULL;
+
+        level->layers = (LDtkLayer*)LDtkRelocator_Array(relocator, level->layers, level->layerCount, sizeof(LDtkLayer));
+        for (int32_t j = 0; j < level->layerCount && !relocator->invalid; j++)
+        {
+            LDtkLayer* layer = &level->layers[j];
+            LDtkRelocator_String(relocator, &layer->name);
+            LDtkRelocator_String(relocator, &layer->tileset.name);
+            LDtkRelocator_String(relocator, &layer->tileset.path);
+
+            layer->tiles = (LDtkTile*)LDtkRelocator_Block(relocator, true, layer->tiles, layer->tileCount, sizeof(LDtkTile));
+            LDtkRelocate_IntGridValues(relocator, &layer->values, layer->valueCount);
+
+            layer->entities = (LDtkEntity*)LDtkRelocator_Array(relocator, layer->entities, layer->entityCount, sizeof(LDtkEntity));
+            for (int32_t k = 0; k < layer->entityCount && !relocator->invalid; k++)
+            {
+                LDtkRelocator_String(relocator, &layer->entities[k].name);
+            }
+        }
+    }
+}
+
+// Compare the stamps of the external level files, the blob is only read
+static LDtkError LDtkCheckLevelSources(const uint8_t* blob, int32_t blobSize, const LDtkCookedHeader* header)
+{
+    const int64_t offset = header->sourceOffset;
+    const int64_t count = header->sourceCount;
+    if (count < 0 || (offset == 0) != (count == 0) || (offset & 15) != 0
+        || (count > 0 && (offset < header->bulkOffset || count * (int64_t)sizeof(LDtkLevelSource) > blobSize - offset)))
+    {
+        const LDtkError error = { LDtkErrorCode_InvalidCookedWorld, "Cooked world is corrupted" };
+        return error;
+    }
+
+    for (int64_t i = 0; i < count; i++)
+    {
+        LDtkLevelSource source;
+        memcpy(&source, blob + offset + i * (int64_t)sizeof(LDtkLevelSource), sizeof(source));
+
+        const uintptr_t pathOffset = (uintptr_t)source.path;
+        if (pathOffset < (uintptr_t)header->bulkOffset || pathOffset >= (uintptr_t)blobSize || !memchr(blob + pathOffset, 0, (size_t)blobSize - pathOffset))
+        {
+            const LDtkError error = { LDtkErrorCode_InvalidCookedWorld, "Cooked world is corrupted" };
+            return error;
+        }
+
+        LDtkSourceStamp stamp;
+        if (!LDtkGetSourceStamp((const char*)(blob + pathOffset), &stamp) || stamp.size != source.stamp.size || stamp.time != source.stamp.time)
+        {
+            const LDtkError error = { LDtkErrorCode_StaleCookedWorld, "A level file of the cooked world is modified" };
+            return error;
+        }
+    }
+
+    const LDtkError error = { LDtkErrorCode_None, "" };
+    return error;
+}
+
+LDtkError LDtkLoadCooked(void* blob, int32_t blobSize, LDtkParseFlags flags, LDtkSourceStamp stamp, LDtkWorld* outWorld)
+{
+    assert(outWorld);
+
+    if (!blob || ((uintptr_t)blob & 15) != 0 || blobSize < (int32_t)sizeof(LDtkCookedHeader))
+    {
+        const LDtkError error = { LDtkErrorCode_InvalidCookedWorld, "Cooked world is not 16 bytes aligned or too small" };
+        return error;
+    }
+
+    LDtkCookedHeader header;
+    memcpy(&header, blob, sizeof(header));
+    if (header.magic != LDTK_COOKED_MAGIC || header.size != blobSize)
+    {
+        const LDtkError error = { LDtkErrorCode_InvalidCookedWorld, "Not a cooked world" };
+        return error;
+    }
+
+    if (header.version != LDTK_COOKED_VERSION || header.layout != LDtkCookedLayout() || header.flags != (uint32_t)flags
+        || header.stamp.size != stamp.size || header.stamp.time != stamp.time)
+    {
+        const LDtkError error = { LDtkErrorCode_StaleCookedWorld, "Cooked world is stale" };
+        return error;
+    }
+
+    if (header.bulkOffset < (int32_t)sizeof(LDtkCookedHeader) || header.bulkOffset > blobSize)
+    {
+        const LDtkError error = { LDtkErrorCode_InvalidCookedWorld, "Cooked world is corrupted" };
+        return error;
+    }
+
+    const LDtkError sourceError = LDtkCheckLevelSources((const uint8_t*)blob, blobSize, &header);
+    if (sourceError.code != LDtkErrorCode_None)
+    {
+        return sourceError;
+    }
+
+    LDtkRelocator relocator = { (uint8_t*)blob, blobSize, sizeof(LDtkCookedHeader), header.bulkOffset, false };
+
+    LDtkWorld* world = (LDtkWorld*)LDtkRelocator_Array(&relocator, (const void*)(uintptr_t)header.worldOffset, 1, sizeof(LDtkWorld));
+    if (world)
+    {
+        LDtkRelocate_World(&relocator, world);
+    }
+
+    if (!world || relocator.invalid)
+    {
+        const LDtkError error = { LDtkErrorCode_InvalidCookedWorld, "Cooked world is corrupted" };
+        return error;
+    }
+
+    *outWorld = *world;
+
+    const LDtkError error = { LDtkErrorCode_None, "" };
+    return error;
+}
+
+// -------------------------------------------------------------------
+// Mapping
+// -------------------------------------------------------------------
+
+#if defined(_WIN32)
+#define VC_EXTRA_CLEAN
+#define WIN32_CLEAN_AND_MEAN
+#include <Windows.h>
+
+static bool LDtkMapFile(const char* path, LDtkCookedFile* outFile)
+{
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    const DWORD fileSize = GetFileSize(file, NULL);
+    HANDLE mapping = fileSize > 0 && fileSize <= INT32_MAX ? CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL) : NULL;
+    CloseHandle(file);
+    if (!mapping)
+    {
+        return false;
+    }
+
+    // Copy-on-write, relocated pages are private to the process
+    void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    if (!data)
+    {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    outFile->data = data;
+    outFile->size = (int32_t)fileSize;
+    outFile->handle = mapping;
+    return true;
+}
+
+void LDtkUnmapCooked(LDtkCookedFile* file)
+{
+    if (file->data)
+    {
+        UnmapViewOfFile(file->data);
+        CloseHandle((HANDLE)file->handle);
+    }
+
+    file->data = NULL;
+    file->size = 0;
+    file->handle = NULL;
+}
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+static bool LDtkMapFile(const char* path, LDtkCookedFile* outFile)
+{
+    int file = open(path, O_RDONLY);
+    if (file == -1)
+    {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size <= 0 || info.st_size > INT32_MAX)
+    {
+        close(file);
+        return false;
+    }
+
+    // Copy-on-write, relocated pages are private to the process
+    void* data = mmap(NULL, (size_t)info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    outFile->data = data;
+    outFile->size = (int32_t)info.st_size;
+    outFile->handle = NULL;
+    return true;
+}
+
+void LDtkUnmapCooked(LDtkCookedFile* file)
+{
+    if (file->data)
+    {
+        munmap(file->data, (size_t)file->size);
+    }
+
+    file->data = NULL;
+    file->size = 0;
+    file->handle = NULL;
+}
+#endif
+
+LDtkError LDtkMapCooked(const char* cookedPath, const char* ldtkPath, LDtkParseFlags flags, LDtkCookedFile* outFile, LDtkWorld* outWorld)
+{
+    assert(outFile);
+
+    outFile->data = NULL;
+    outFile->size = 0;
+    outFile->handle = NULL;
+
+    LDtkSourceStamp stamp;
+    if (!LDtkGetSourceStamp(ldtkPath, &stamp))
+    {
+        const LDtkError error = { LDtkErrorCode_StaleCookedWorld, "Source of the cooked world is missing" };
+        return error;
+    }
+
+    if (!LDtkMapFile(cookedPath, outFile))
+    {
+        const LDtkError error = { LDtkErrorCode_StaleCookedWorld, "Cannot map the cooked world" };
+        return error;
+    }
+
+    const LDtkError error = LDtkLoadCooked(outFile->data, outFile->size, flags, stamp, outWorld);
+    if (error.code != LDtkErrorCode_None)
+    {
+        LDtkUnmapCooked(outFile);
+    }
+
+    return error;
+}
+
+//! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
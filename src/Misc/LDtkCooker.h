@@ -0,0 +1,80 @@
+#pragma once
+
+#include "LDtkParser.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define LDTK_COOKED_MAGIC       0x4B54444Cu     // "LDTK"
+#define LDTK_COOKED_VERSION     3               // Bump it when a field of the LDtk structures change
+
+/// Size and modification time of a file a world is cooked from
+typedef struct LDtkSourceStamp
+{
+    int64_t         size;
+    int64_t         time;
+} LDtkSourceStamp;
+
+/// External level file (.ldtkl) a world read layers from, with its stamp
+typedef struct LDtkLevelSource
+{
+    const char*     path;
+    LDtkSourceStamp stamp;
+} LDtkLevelSource;
+
+/// Cooked world: the LDtkWorld and all it point to in one blob, pointers are stored as offsets from the start of the blob.
+/// Blocks with pointers come first, strings and tiles last: relocating a blob only write its first pages,
+/// tiles are read from the file when they are used.
+typedef struct LDtkCookedHeader
+{
+    uint32_t        magic;
+    uint32_t        version;
+    uint32_t        layout;         // Pointer and structure sizes, a blob is only loaded by a build with the same layout
+    uint32_t        flags;          // LDtkParseFlags of the world
+    int32_t         size;           // Bytes of the blob
+    int32_t         worldOffset;
+    int32_t         bulkOffset;     // Strings and tiles, the blocks before it are laid out in the order they are relocated
+    int32_t         sourceOffset;   // LDtkLevelSource array, in the bulk blocks: its paths stay offsets
+    int32_t         sourceCount;
+    int32_t         reserved;
+    LDtkSourceStamp stamp;          // Of the .ldtk file
+} LDtkCookedHeader;
+
+/// Cooked file mapped in memory
+typedef struct LDtkCookedFile
+{
+    void*           data;
+    int32_t         size;
+    void*           handle;         // File mapping on Windows
+} LDtkCookedFile;
+
+/// Stamp of a file, false when it does not exist
+bool            LDtkGetSourceStamp(const char* path, LDtkSourceStamp* outStamp);
+
+/// Write the cooked world in buffer, outSize is the size of the blob. With a NULL buffer only outSize is computed.
+/// The levels of a level index are cooked as they are, the ones not loaded have no layers.
+/// The flags are stored in the blob, the layer filter of the context is not: a filtered world is cooked with the layers it kept.
+/// levelSources are the external level files of the world, stamped before it is parsed (see LDtkGetLevelSources).
+LDtkError       LDtkCook(const LDtkWorld* world, LDtkParseFlags flags, LDtkSourceStamp stamp, const LDtkLevelSource* levelSources, int32_t levelSourceCount,
+                         void* buffer, int32_t bufferSize, int32_t* outSize);
+
+/// Stamp the external level files of a level index (parsed with LDtkParseFlags_LevelIndex), the paths point into the world.
+/// Return the number of files, at most maxCount are written. A missing file get a stamp no file has.
+int32_t         LDtkGetLevelSources(const LDtkWorld* levelIndex, LDtkLevelSource* outSources, int32_t maxCount);
+
+/// Relocate a 16 bytes aligned blob in place, outWorld point into it.
+/// LDtkErrorCode_StaleCookedWorld when the blob is cooked from another source, flags or build, or one of its external level files changed since,
+/// LDtkErrorCode_InvalidCookedWorld when it is corrupted. The level files are checked before the blob is touched.
+LDtkError       LDtkLoadCooked(void* blob, int32_t blobSize, LDtkParseFlags flags, LDtkSourceStamp stamp, LDtkWorld* outWorld);
+
+/// Map cookedPath copy-on-write and relocate it, it must be cooked from ldtkPath as it is now. Release it with LDtkUnmapCooked.
+LDtkError       LDtkMapCooked(const char* cookedPath, const char* ldtkPath, LDtkParseFlags flags, LDtkCookedFile* outFile, LDtkWorld* outWorld);
+void            LDtkUnmapCooked(LDtkCookedFile* file);
+
+#ifdef __cplusplus
+}
+#endif
+
+//! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
@@ -15,6 +15,12 @@ typedef struct Allocator
 
     uint8_t*        lowerMarker;
     uint8_t*        upperMarker;
+
+    // Growable mode, blocks continue in the chunks of the caller when the buffer is full
+    LDtkAllocChunkFn*   allocChunk;
+    void*               chunkUserData;
+    int32_t             chunkCount;
+    int32_t             chunkTotalSize;
 } Allocator;
 
 static bool InitAllocator(Allocator* allocator, void* buffer, int32_t bufferSize)
@@ -22,15 +28,14 @@ static bool InitAllocator(Allocator* allocator, void* buffer, int32_t bufferSize
 	const int32_t alignment = 16;
 	const int32_t mask = alignment - 1;
 
-    if (buffer && bufferSize > 0)
+    if (buffer && bufferSize >= 0)
     {
 		const uintptr_t address = (uintptr_t)buffer;
 		const int32_t	misalign = address & mask;
-		const int32_t	adjustment = alignment - misalign;
+		const int32_t	adjustment = (alignment - misalign) & mask;
 
 		buffer = (void*)(address + adjustment);
-		bufferSize = bufferSize - adjustment;
-		bufferSize = bufferSize - (alignment - (bufferSize & mask));
+		bufferSize = bufferSize > adjustment ? (bufferSize - adjustment) & ~mask : 0;
 		
         allocator->buffer       = (uint8_t*)buffer;
         allocator->bufferSize   = bufferSize;
@@ -49,15 +54,58 @@ static int32_t AllocatorRemainSize(Allocator* allocator)
 	return  remain;
 }
 
+// Blocks keep the 16 bytes alignment of the buffer
+static int32_t AlignAllocSize(int32_t size)
+{
+    return (size + 15) & ~15;
+}
+
 static bool CanAlloc(Allocator* allocator, int32_t size)
 {
     return AllocatorRemainSize(allocator) >= size;
 }
 
+// Chunks are counted in the memory usage of the world, the JSON parser ask them here too
+static void* LDtkAllocChunk(void* userData, int32_t minSize, int32_t* outSize)
+{
+    Allocator* allocator = (Allocator*)userData;
+
+    int32_t chunkSize = 0;
+    void* chunk = allocator->allocChunk(allocator->chunkUserData, minSize, &chunkSize);
+    if (chunk)
+    {
+        allocator->chunkCount++;
+        allocator->chunkTotalSize += chunkSize;
+    }
+
+    *outSize = chunkSize;
+    return chunk;
+}
+
+// Continue in a new chunk, what remain of the current buffer is left
+static bool AllocatorNextChunk(Allocator* allocator, int32_t size)
+{
+    if (!allocator->allocChunk)
+    {
+        return false;
+    }
+
+    int32_t chunkSize;
+    void* chunk = LDtkAllocChunk(allocator, size + 15, &chunkSize);
+    if (!chunk || !InitAllocator(allocator, chunk, chunkSize))
+    {
+        return false;
+    }
+
+    return CanAlloc(allocator, size);
+}
+
 static void DeallocLower(Allocator* allocator, void* buffer, int32_t size)
 {
+    size = AlignAllocSize(size);
+
     void* lastBuffer = allocator->lowerMarker - size;
-    if (lastBuffer == buffer)
+    if (lastBuffer == buffer && (uint8_t*)lastBuffer >= allocator->buffer)
     {
         allocator->lowerMarker -= size;
     }
@@ -72,7 +120,9 @@ static void* AllocLower(Allocator* allocator, void* oldBuffer, int32_t oldSize,
         return NULL;
     }
 
-    if (CanAlloc(allocator, newSize))
+    newSize = AlignAllocSize(newSize);
+
+    if (CanAlloc(allocator, newSize) || AllocatorNextChunk(allocator, newSize))
     {
         void* result = allocator->lowerMarker;
         allocator->lowerMarker += newSize;
@@ -84,8 +134,10 @@ static void* AllocLower(Allocator* allocator, void* oldBuffer, int32_t oldSize,
 
 static void DeallocUpper(Allocator* allocator, void* buffer, int32_t size)
 {
+    size = AlignAllocSize(size);
+
     void* lastBuffer = allocator->upperMarker;
-    if (lastBuffer == buffer)
+    if (lastBuffer == buffer && allocator->upperMarker + size <= allocator->buffer + allocator->bufferSize)
     {
         allocator->upperMarker += size;
     }
@@ -100,7 +152,9 @@ static void* AllocUpper(Allocator* allocator, void* oldBuffer, int32_t oldSize,
         return NULL;
     }
 
-    if (CanAlloc(allocator, newSize))
+    newSize = AlignAllocSize(newSize);
+
+    if (CanAlloc(allocator, newSize) || AllocatorNextChunk(allocator, newSize))
     {
         allocator->upperMarker -= newSize;
         return allocator->upperMarker;
@@ -109,6 +163,18 @@ static void* AllocUpper(Allocator* allocator, void* oldBuffer, int32_t oldSize,
     return NULL;
 }
 
+// Item of a fixed size array (positions, sizes), null when the array is too short
+static Json LDtkArrayItem(const Json array, int32_t index)
+{
+    return index >= 0 && index < array.length ? array.array[index] : JSON_NULL;
+}
+
+// Empty strings are parsed as NULL, read them as ""
+static const char* LDtkStringOf(const Json json)
+{
+    return json.type == JsonType_String && json.string ? json.string : "";
+}
+
 static inline uint8_t HexFromChar(char x)
 {
     return (x >= 'a' && x <= 'f') * (x - 'a') + (x >= 'A' && x <= 'F') * (x - 'A') + (x >= '0' && x <= '9') * (x - '0');
@@ -157,6 +223,228 @@ static LDtkColor LDtkColorFromString(const char* value)
     return color;
 }
 
+// Files are read with a JsonReader over their text, to count the memory of a parse or to find the layers a selective parse skip
+
+#define LDTK_READER_WINDOW_SIZE 4096
+
+typedef struct LDtkReaderSource
+{
+    const char*     content;
+    int32_t         length;
+    int32_t         cursor;
+} LDtkReaderSource;
+
+static int32_t LDtkReaderRead(void* userData, void* buffer, int32_t bufferSize)
+{
+    LDtkReaderSource* source = (LDtkReaderSource*)userData;
+
+    const int32_t remain = source->length - source->cursor;
+    const int32_t count = remain < bufferSize ? remain : bufferSize;
+    memcpy(buffer, source->content + source->cursor, (size_t)count);
+    source->cursor += count;
+    return count;
+}
+
+// Consume the rest of a value whose first token is read
+static void LDtkReaderSkip(JsonReader* reader, JsonToken token)
+{
+    if (token == JsonToken_ArrayBegin)
+    {
+        while (JsonReader_NextItem(reader) && JsonReader_SkipValue(reader)) {}
+    }
+    else if (token == JsonToken_ObjectBegin)
+    {
+        while (JsonReader_NextMember(reader, NULL) && JsonReader_SkipValue(reader)) {}
+    }
+}
+
+// Selective parse: the flags and the layer filter of the context, for all that read the layers of the levels
+
+typedef struct LDtkLevelOptions
+{
+    LDtkParseFlags      flags;
+    LDtkLayerFilterFn*  layerFilter;
+    void*               layerFilterUserData;
+} LDtkLevelOptions;
+
+static LDtkLevelOptions LDtkLevelOptionsOf(LDtkContext context, LDtkParseFlags flags)
+{
+    const LDtkLevelOptions options = { flags, context.layerFilter, context.layerFilterUserData };
+    return options;
+}
+
+// True when some layers or values of the levels are skipped, the files are parsed with the skip hook then
+static bool LDtkLevelOptions_Selective(const LDtkLevelOptions* options)
+{
+    const LDtkParseFlags skipFlags = (LDtkParseFlags)(LDtkParseFlags_SkipEntityLayers | LDtkParseFlags_SkipAutoLayerTiles | LDtkParseFlags_SkipIntGridValues | LDtkParseFlags_SkipBackground);
+    return (options->flags & skipFlags) || options->layerFilter;
+}
+
+static bool LDtkLayerTypeFromName(const char* typeName, LDtkLayerType* outType)
+{
+	if (strcmp(typeName, "Tiles") == 0)
+	{
+		*outType = LDtkLayerType_Tiles;
+	}
+	else if (strcmp(typeName, "Entities") == 0)
+	{
+		*outType = LDtkLayerType_Entities;
+	}
+	else if (strcmp(typeName, "IntGrid") == 0)
+	{
+		*outType = LDtkLayerType_IntGrid;
+	}
+	else if (strcmp(typeName, "AutoLayer") == 0)
+	{
+		*outType = LDtkLayerType_AutoLayer;
+	}
+	else
+	{
+		return false;
+	}
+
+	return true;
+}
+
+// Name and type are NULL when they are not strings, the layer is kept so reading it report the error
+static bool LDtkLevelOptions_KeepLayer(const LDtkLevelOptions* options, const char* layerName, const char* typeName)
+{
+    LDtkLayerType type;
+    if (!layerName || !typeName || !LDtkLayerTypeFromName(typeName, &type))
+    {
+        return true;
+    }
+
+    if (type == LDtkLayerType_Entities && (options->flags & LDtkParseFlags_SkipEntityLayers))
+    {
+        return false;
+    }
+
+    return !options->layerFilter || options->layerFilter(options->layerFilterUserData, layerName, type);
+}
+
+// Skip hook of the JSON parser: what the options leave out of the levels is parsed as null and never built.
+// The readers take null for missing, LDtkQueryMemory ask the same hook to count what the parse keep.
+
+typedef struct LDtkLevelSkip
+{
+    const LDtkLevelOptions* options;
+    int32_t                 levelDepth;     // Of the level objects: 2 in a world file (root, "levels"), 0 in a level file
+} LDtkLevelSkip;
+
+// Read the identifier and the type of the layer object at text, the first members of their name like JsonFind
+static bool LDtkLevelSkip_KeepLayer(const LDtkLevelOptions* options, const char* text, int32_t length)
+{
+    char window[LDTK_READER_WINDOW_SIZE];
+    LDtkReaderSource source = { text, length, 0 };
+
+    JsonReader reader;
+    JsonReader_Init(&reader, JsonParseFlags_None, window, sizeof(window), LDtkReaderRead, &source);
+    if (!JsonReader_EnterObject(&reader))
+    {
+        return true;
+    }
+
+    char layerName[LDTK_READER_WINDOW_SIZE];
+    char typeName[16];
+    bool foundName = false, foundType = false;
+    bool nameIsString = false, typeIsString = false;
+
+    // LDtk write them first, the rest of the layer is not read then
+    const char* name;
+    while ((!foundName || !foundType) && JsonReader_NextMember(&reader, &name))
+    {
+        if (!foundName && strcmp(name, "__identifier") == 0)
+        {
+            foundName = true;
+            if (JsonReader_Next(&reader) == JsonToken_Value && reader.value.type == JsonType_String)
+            {
+                const char* string = reader.value.string ? reader.value.string : "";
+                nameIsString = strlen(string) < sizeof(layerName);
+                if (nameIsString)
+                {
+                    strcpy(layerName, string);
+                }
+            }
+            else
+            {
+                LDtkReaderSkip(&reader, reader.token);
+            }
+        }
+        else if (!foundType && strcmp(name, "__type") == 0)
+        {
+            foundType = true;
+            if (JsonReader_Next(&reader) == JsonToken_Value && reader.value.type == JsonType_String)
+            {
+                // Longer names are unknown types, the layer is kept
+                const char* string = reader.value.string ? reader.value.string : "";
+                typeIsString = strlen(string) < sizeof(typeName);
+                if (typeIsString)
+                {
+                    strcpy(typeName, string);
+                }
+            }
+            else
+            {
+                LDtkReaderSkip(&reader, reader.token);
+            }
+        }
+        else
+        {
+            JsonReader_SkipValue(&reader);
+        }
+    }
+
+    // The parse report the errors
+    if (reader.error != JsonError_None)
+    {
+        return true;
+    }
+
+    return LDtkLevelOptions_KeepLayer(options, nameIsString ? layerName : NULL, typeIsString ? typeName : NULL);
+}
+
+static bool LDtkLevelSkip_Func(void* userData, const JsonSkipTarget* target)
+{
+    const LDtkLevelSkip*    skip = (const LDtkLevelSkip*)userData;
+    const LDtkParseFlags    flags = skip->options->flags;
+    const int32_t           layerDepth = skip->levelDepth + 2;
+    if (!target->name)
+    {
+        return false;
+    }
+
+    // Items of the layer instances of a level
+    if (target->depth == layerDepth && target->isItem)
+    {
+        const bool filtered = (flags & LDtkParseFlags_SkipEntityLayers) || skip->options->layerFilter;
+        return filtered && strcmp(target->name, "layerInstances") == 0 && !LDtkLevelSkip_KeepLayer(skip->options, target->text, target->length);
+    }
+
+    // Members of a layer
+    if (target->depth == layerDepth + 1 && !target->isItem)
+    {
+        return ((flags & LDtkParseFlags_SkipAutoLayerTiles) && strcmp(target->name, "autoLayerTiles") == 0)
+            || ((flags & LDtkParseFlags_SkipIntGridValues) && (strcmp(target->name, "intGridCsv") == 0 || strcmp(target->name, "intGrid") == 0));
+    }
+
+    // Members of a level
+    if (target->depth == skip->levelDepth + 1 && !target->isItem)
+    {
+        return (flags & LDtkParseFlags_SkipBackground) && strcmp(target->name, "__bgPos") == 0;
+    }
+
+    return false;
+}
+
+// Hook of a world file or a level file, NULL when the options skip nothing
+static JsonSkipFunc LDtkLevelSkipOf(const LDtkLevelOptions* options, bool levelFile, LDtkLevelSkip* outSkip)
+{
+    outSkip->options = options;
+    outSkip->levelDepth = levelFile ? 0 : 2;
+    return LDtkLevelOptions_Selective(options) ? LDtkLevelSkip_Func : NULL;
+}
+
 static LDtkError LDtkReadWorldProperties(const Json json, LDtkWorld* world)
 {
     const Json jsonDefaultPivotX;
@@ -165,7 +453,7 @@ static LDtkError LDtkReadWorldProperties(const Json json, LDtkWorld* world)
         const LDtkError error = { LDtkErrorCode_MissingWorldProperties, "'defaultPivotX' is not found" };
         return error;
     }
-    world->defaultPivotX = (float)jsonDefaultPivotX.number;
+    world->defaultPivotX = (float)JsonNumber(jsonDefaultPivotX);
 
     const Json jsonDefaultPivotY;
     if (!JsonFind(json, "defaultPivotY", (Json*)&jsonDefaultPivotY))
@@ -173,7 +461,7 @@ static LDtkError LDtkReadWorldProperties(const Json json, LDtkWorld* world)
         const LDtkError error = { LDtkErrorCode_MissingWorldProperties, "'defaultPivotY' is not found" };
         return error;
     }
-    world->defaultPivotY = (float)jsonDefaultPivotY.number;
+    world->defaultPivotY = (float)JsonNumber(jsonDefaultPivotY);
 
     const Json jsonDefaultGridSize;
     if (!JsonFind(json, "defaultGridSize", (Json*)&jsonDefaultGridSize))
@@ -181,7 +469,7 @@ static LDtkError LDtkReadWorldProperties(const Json json, LDtkWorld* world)
         const LDtkError error = { LDtkErrorCode_MissingWorldProperties, "'defaultGridSize' is not found" };
         return error;
     }
-    world->defaultGridSize = (int32_t)jsonDefaultGridSize.number;
+    world->defaultGridSize = (int32_t)JsonInteger(jsonDefaultGridSize);
 
     const Json jsonBackgroundColor;
     if (!JsonFind(json, "bgColor", (Json*)&jsonBackgroundColor))
@@ -189,7 +477,7 @@ static LDtkError LDtkReadWorldProperties(const Json json, LDtkWorld* world)
         const LDtkError error = { LDtkErrorCode_MissingWorldProperties, "'bgColor' is not found" };
         return error;
     }
-    world->backgroundColor = LDtkColorFromString(jsonBackgroundColor.string);
+    world->backgroundColor = LDtkColorFromString(LDtkStringOf(jsonBackgroundColor));
 
     const Json jsonWorldLayoutName;
     if (!JsonFind(json, "worldLayout", (Json*)&jsonWorldLayoutName))
@@ -197,7 +485,7 @@ static LDtkError LDtkReadWorldProperties(const Json json, LDtkWorld* world)
         const LDtkError error = { LDtkErrorCode_MissingWorldProperties, "'worldLayout' is not found" };
         return error;
     }
-    const char* worldLayoutName = jsonWorldLayoutName.string;
+    const char* worldLayoutName = LDtkStringOf(jsonWorldLayoutName);
     if (strcmp(worldLayoutName, "Free") == 0)
     {
         world->layout = LDtkWorldLayout_Free;
@@ -235,14 +523,21 @@ static LDtkError LDtkReadEnums(const Json jsonDefs, Allocator* allocator, LDtkWo
 
     const int32_t   enumCount = (int32_t)jsonEnums.length;
     LDtkEnum*       enums = (LDtkEnum*)AllocLower(allocator, NULL, 0, sizeof(LDtkEnum) * enumCount);
+    if (!enums && enumCount > 0)
+    {
+        const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
+        return error;
+    }
+
     for (int32_t i = 0; i < enumCount; i++)
     {
         LDtkEnum* enumDef = &enums[i];
+        memset(enumDef, 0, sizeof(*enumDef)); // Padding too, the defs are cooked to the same bytes whatever the buffer held
         const Json jsonEnum = jsonEnums.array[i];
 
         const Json jsonUid;
         JsonFind(jsonEnum, "uid", (Json*)&jsonUid);
-        enumDef->id = (int32_t)jsonUid.number;
+        enumDef->id = (int32_t)JsonInteger(jsonUid);
 
         const Json jsonIdentifier;
         JsonFind(jsonEnum, "identifier", (Json*)&jsonIdentifier);
@@ -250,7 +545,7 @@ static LDtkError LDtkReadEnums(const Json jsonDefs, Allocator* allocator, LDtkWo
 
         const Json jsonIconTilesetUid;
         JsonFind(jsonEnum, "iconTilesetUid", (Json*)&jsonIconTilesetUid);
-        enumDef->tilesetId = (int32_t)jsonIconTilesetUid.number;
+        enumDef->tilesetId = (int32_t)JsonInteger(jsonIconTilesetUid);
 
         const Json jsonExternalRelPath;
         JsonFind(jsonEnum, "externalRelPath", (Json*)&jsonExternalRelPath);
@@ -265,6 +560,12 @@ static LDtkError LDtkReadEnums(const Json jsonDefs, Allocator* allocator, LDtkWo
 
         const int32_t valueCount = (int32_t)jsonValues.length;
         LDtkEnumValue* values = (LDtkEnumValue*)AllocLower(allocator, NULL, 0, sizeof(LDtkEnumValue) * valueCount);
+        if (!values && valueCount > 0)
+        {
+            const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
+            return error;
+        }
+
         for (int32_t j = 0; j < valueCount; j++)
         {
             LDtkEnumValue* value = &values[j];
@@ -276,11 +577,11 @@ static LDtkError LDtkReadEnums(const Json jsonDefs, Allocator* allocator, LDtkWo
 
             const Json jsonTileId;
             JsonFind(jsonValue, "tileId", (Json*)&jsonTileId);
-            value->tileId = (int32_t)jsonTileId.number;
+            value->tileId = (int32_t)JsonInteger(jsonTileId);
 
             const Json jsonColor;
             JsonFind(jsonValue, "color", (Json*)&jsonColor);
-            value->color = LDtkColorFromUInt32((uint32_t)jsonColor.number);
+            value->color = LDtkColorFromUInt32((uint32_t)JsonInteger(jsonColor));
         }
 
         enumDef->valueCount = valueCount;
@@ -305,14 +606,21 @@ static LDtkError LDtkReadTilesets(const Json jsonDefs, Allocator* allocator, LDt
 
     const int32_t   tilesetCount = (int32_t)jsonTilesets.length;
     LDtkTileset*    tilesets = (LDtkTileset*)AllocLower(allocator, NULL, 0, sizeof(LDtkTileset) * tilesetCount);
+    if (!tilesets && tilesetCount > 0)
+    {
+        const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
+        return error;
+    }
+
     for (int32_t i = 0; i < tilesetCount; i++)
     {
         LDtkTileset* tileset = &tilesets[i];
+        memset(tileset, 0, sizeof(*tileset));
         const Json jsonTileset = jsonTilesets.array[i];
 
         const Json jsonUid;
         JsonFind(jsonTileset, "uid", (Json*)&jsonUid);
-        tileset->id = (int32_t)jsonUid.number;
+        tileset->id = (int32_t)JsonInteger(jsonUid);
 		tileset->index = i;
 
         const Json jsonIdentifier;
@@ -325,28 +633,28 @@ static LDtkError LDtkReadTilesets(const Json jsonDefs, Allocator* allocator, LDt
 
         const Json jsonPxWid;
         JsonFind(jsonTileset, "pxWid", (Json*)&jsonPxWid);
-        tileset->width = (int32_t)jsonPxWid.number;
+        tileset->width = (int32_t)JsonInteger(jsonPxWid);
 
         const Json jsonPxHei;
         JsonFind(jsonTileset, "pxHei", (Json*)&jsonPxHei);
-        tileset->height = (int32_t)jsonPxHei.number;
+        tileset->height = (int32_t)JsonInteger(jsonPxHei);
 
         const Json jsonTileGridSize;
         JsonFind(jsonTileset, "tileGridSize", (Json*)&jsonTileGridSize);
-        tileset->tileSize = (int32_t)jsonTileGridSize.number;
+        tileset->tileSize = (int32_t)JsonInteger(jsonTileGridSize);
 
         const Json jsonSpacing;
         JsonFind(jsonTileset, "spacing", (Json*)&jsonSpacing);
-        tileset->spacing = (int32_t)jsonSpacing.number;
+        tileset->spacing = (int32_t)JsonInteger(jsonSpacing);
 
         const Json jsonPadding;
         JsonFind(jsonTileset, "padding", (Json*)&jsonPadding);
-        tileset->padding = (int32_t)jsonPadding.number;
+        tileset->padding = (int32_t)JsonInteger(jsonPadding);
 
         const Json jsonTagsSourceEnumUid;
         if (JsonFind(jsonTileset, "tagsSourceEnumUid", (Json*)&jsonTagsSourceEnumUid))
         {
-            tileset->tagsEnumId = (int32_t)jsonTagsSourceEnumUid.number;
+            tileset->tagsEnumId = (int32_t)JsonInteger(jsonTagsSourceEnumUid);
         }
         else
         {
@@ -372,17 +680,24 @@ static LDtkError LDtkReadLayerDefs(const Json jsonDefs, Allocator* allocator, LD
 
     const int32_t layerDefCount = jsonLayerDefs.length;
     LDtkLayerDef* layerDefs = AllocLower(allocator, NULL, 0, sizeof(LDtkLayerDef) * layerDefCount);
+    if (!layerDefs && layerDefCount > 0)
+    {
+        const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
+        return error;
+    }
+
 
     for (int32_t i = 0; i < layerDefCount; i++)
     {
         LDtkLayerDef* layerDef = &layerDefs[i];
+        memset(layerDef, 0, sizeof(*layerDef));
 
         const Json jsonLayerDef = jsonLayerDefs.array[i];
 
-        const Json jsonType;
-        JsonFind(jsonLayerDef, "type", (Json*)&jsonType);
+        Json jsonType = JSON_NULL;
+        JsonFind(jsonLayerDef, "type", &jsonType);
 
-        const char* typeName = jsonType.string;
+        const char* typeName = LDtkStringOf(jsonType);
         if (strcmp(typeName, "Tiles") == 0)
         {
             layerDef->type = LDtkLayerType_Tiles;
@@ -406,43 +721,43 @@ static LDtkError LDtkReadLayerDefs(const Json jsonDefs, Allocator* allocator, LD
 
         const Json jsonUid;
         JsonFind(jsonLayerDef, "uid", (Json*)&jsonUid);
-        layerDef->id = (int32_t)jsonUid.number;
+        layerDef->id = (int32_t)JsonInteger(jsonUid);
 
         const Json jsonGridSize;
         JsonFind(jsonLayerDef, "gridSize", (Json*)&jsonGridSize);
-        layerDef->gridSize = (int32_t)jsonGridSize.number;
+        layerDef->gridSize = (int32_t)JsonInteger(jsonGridSize);
 
         const Json jsonDisplayOpacity;
         JsonFind(jsonLayerDef, "displayOpacity", (Json*)&jsonDisplayOpacity);
-        layerDef->opacity = (float)jsonDisplayOpacity.number;
+        layerDef->opacity = (float)JsonNumber(jsonDisplayOpacity);
 
         const Json jsonPxOffsetX;
         JsonFind(jsonLayerDef, "pxOffsetX", (Json*)&jsonPxOffsetX);
-        layerDef->offsetX = (int32_t)jsonPxOffsetX.number;
+        layerDef->offsetX = (int32_t)JsonInteger(jsonPxOffsetX);
 
         const Json jsonPxOffsetY;
         JsonFind(jsonLayerDef, "pxOffsetY", (Json*)&jsonPxOffsetY);
-        layerDef->offsetY = (int32_t)jsonPxOffsetY.number;
+        layerDef->offsetY = (int32_t)JsonInteger(jsonPxOffsetY);
 
         const Json jsonTilePivotX;
         JsonFind(jsonLayerDef, "tilePivotX", (Json*)&jsonTilePivotX);
-        layerDef->tilePivotX = (int32_t)jsonTilePivotX.number;
+        layerDef->tilePivotX = (int32_t)JsonInteger(jsonTilePivotX);
 
         const Json jsonTilePivotY;
         JsonFind(jsonLayerDef, "tilePivotY", (Json*)&jsonTilePivotY);
-        layerDef->tilePivotY = (int32_t)jsonTilePivotY.number;
+        layerDef->tilePivotY = (int32_t)JsonInteger(jsonTilePivotY);
 
         int32_t tilesetDefId = -1;
         const Json jsonTilesetDefUid;
         if (JsonFind(jsonLayerDef, "tilesetDefUid", (Json*)&jsonTilesetDefUid))
         {
-            tilesetDefId = (int32_t)jsonTilesetDefUid.number;
+            tilesetDefId = (int32_t)JsonInteger(jsonTilesetDefUid);
         }
 
         const Json jsonAutoTilesetDefUid;
         if (JsonFind(jsonLayerDef, "autoTilesetDefUid", (Json*)&jsonAutoTilesetDefUid))
         {
-            tilesetDefId = (int32_t)jsonAutoTilesetDefUid.number;
+            tilesetDefId = (int32_t)JsonInteger(jsonAutoTilesetDefUid);
         }
 
         if (tilesetDefId == -1)
@@ -460,6 +775,12 @@ static LDtkError LDtkReadLayerDefs(const Json jsonDefs, Allocator* allocator, LD
 
 		int32_t intGridValueCount = jsonIntGridValues.length;
 		LDtkIntGridValue* intGridValues = (LDtkIntGridValue*)AllocLower(allocator, NULL, 0, intGridValueCount * sizeof(LDtkIntGridValue));
+		if (!intGridValues && intGridValueCount > 0)
+		{
+			const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
+			return error;
+		}
+
 		for (int32_t i = 0; i < intGridValueCount; i++)
 		{
 			Json jsonIntGridValue = jsonIntGridValues.array[i];
@@ -488,8 +809,8 @@ static LDtkError LDtkReadLayerDefs(const Json jsonDefs, Allocator* allocator, LD
 			LDtkIntGridValue* intGridValue = &intGridValues[i];
 
 			intGridValue->name = jsonIdentifier.string;
-			intGridValue->value = (int32_t)jsonValue.number;
-			intGridValue->color = LDtkColorFromString(jsonColor.string);
+			intGridValue->value = (int32_t)JsonInteger(jsonValue);
+			intGridValue->color = LDtkColorFromString(LDtkStringOf(jsonColor));
 		}
 
 		layerDef->intGridValueCount = intGridValueCount;
@@ -514,15 +835,22 @@ static LDtkError LDtkReadEntityDefs(const Json jsonDefs, Allocator* allocator, L
 
     const int32_t   entityDefCount = (int32_t)jsonEntityDefs.length;
     LDtkEntityDef*  entityDefs = (LDtkEntityDef*)AllocLower(allocator, NULL, 0, sizeof(LDtkEntityDef) * entityDefCount);
+    if (!entityDefs && entityDefCount > 0)
+    {
+        const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
+        return error;
+    }
+
 
     for (int32_t i = 0; i < entityDefCount; i++)
     {
         LDtkEntityDef* entityDef = &entityDefs[i];
+        memset(entityDef, 0, sizeof(*entityDef));
         const Json jsonEntityDef = jsonEntityDefs.array[i];
 
         const Json jsonUid;
         JsonFind(jsonEntityDef, "uid", (Json*)&jsonUid);
-        entityDef->id = (int32_t)jsonUid.number;
+        entityDef->id = (int32_t)JsonInteger(jsonUid);
         
         const Json jsonIdentifier;
         JsonFind(jsonEntityDef, "identifier", (Json*)&jsonIdentifier);
@@ -530,36 +858,42 @@ static LDtkError LDtkReadEntityDefs(const Json jsonDefs, Allocator* allocator, L
 
         const Json jsonWidth;
         JsonFind(jsonEntityDef, "width", (Json*)&jsonWidth);
-        entityDef->width = (int32_t)jsonWidth.number;
+        entityDef->width = (int32_t)JsonInteger(jsonWidth);
 
         const Json jsonHeight;
         JsonFind(jsonEntityDef, "height", (Json*)&jsonHeight);
-        entityDef->height = (int32_t)jsonHeight.number;
+        entityDef->height = (int32_t)JsonInteger(jsonHeight);
 
         const Json jsonColor;
         JsonFind(jsonEntityDef, "color", (Json*)&jsonColor);
-        entityDef->color = LDtkColorFromString(jsonColor.string);
+        entityDef->color = LDtkColorFromString(LDtkStringOf(jsonColor));
 
         const Json jsonPivotX;
         JsonFind(jsonEntityDef, "pivotX", (Json*)&jsonPivotX);
-        entityDef->pivotX = (int32_t)jsonPivotX.number;
+        entityDef->pivotX = (int32_t)JsonInteger(jsonPivotX);
 
         const Json jsonPivotY;
         JsonFind(jsonEntityDef, "pivotY", (Json*)&jsonPivotY);
-        entityDef->pivotY = (int32_t)jsonPivotY.number;
+        entityDef->pivotY = (int32_t)JsonInteger(jsonPivotY);
 
         const Json jsonTilesetId;
         JsonFind(jsonEntityDef, "tilesetId", (Json*)&jsonTilesetId);
-        entityDef->tilesetId = (int32_t)jsonTilesetId.number;
+        entityDef->tilesetId = (int32_t)JsonInteger(jsonTilesetId);
 
         const Json jsonTileId;
         JsonFind(jsonEntityDef, "tileId", (Json*)&jsonTileId);
-        entityDef->tileId = (int32_t)jsonTileId.number;
+        entityDef->tileId = (int32_t)JsonInteger(jsonTileId);
 
         const Json jsonTags;
         JsonFind(jsonEntityDef, "tags", (Json*)&jsonTags);
         entityDef->tagCount = (int32_t)jsonTags.length;
         entityDef->tags = AllocLower(allocator, NULL, 0, sizeof(const char*) * entityDef->tagCount);
+        if (!entityDef->tags && entityDef->tagCount > 0)
+        {
+            const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
+            return error;
+        }
+
         for (int32_t i = 0; i < entityDef->tagCount; i++)
         {
             entityDef->tags[i] = jsonTags.array[i].string;
@@ -576,6 +910,7 @@ static LDtkError LDtkReadEntityDefs(const Json jsonDefs, Allocator* allocator, L
 static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel* level, LDtkWorld* world)
 {
 	LDtkLayer* layer = &level->layers[level->layerCount++];
+	memset(layer, 0, sizeof(*layer));
 
 	// Name & type
 
@@ -594,23 +929,7 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 		return error;
 	}
 
-	if (strcmp(type.string, "Tiles") == 0)
-	{
-		layer->type = LDtkLayerType_Tiles;
-	}
-	else if (strcmp(type.string, "Entities") == 0)
-	{
-		layer->type = LDtkLayerType_Entities;
-	}
-	else if (strcmp(type.string, "IntGrid") == 0)
-	{
-		layer->type = LDtkLayerType_IntGrid;
-	}
-	else if (strcmp(type.string, "AutoLayer") == 0)
-	{
-		layer->type = LDtkLayerType_AutoLayer;
-	}
-	else
+	if (!LDtkLayerTypeFromName(LDtkStringOf(type), &layer->type))
 	{
 		const LDtkError error = { LDtkErrorCode_UnknownLayerType, "" };
 		return error;
@@ -624,7 +943,7 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 		const LDtkError error = { LDtkErrorCode_UnnameError, "" };
 		return error;
 	}
-	layer->levelId = (int32_t)jsonLevelId.number;
+	layer->levelId = (int32_t)JsonInteger(jsonLevelId);
 
 	Json jsonLayerDefUid;
 	if (JsonFindWithType(json, "layerDefUid", JsonType_Number, &jsonLayerDefUid) != JsonError_None)
@@ -632,7 +951,7 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 		const LDtkError error = { LDtkErrorCode_UnnameError, "" };
 		return error;
 	}
-	layer->layerDefId = (int32_t)jsonLayerDefUid.number;
+	layer->layerDefId = (int32_t)JsonInteger(jsonLayerDefUid);
 
 	// Base properties
 
@@ -642,7 +961,7 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 		const LDtkError error = { LDtkErrorCode_UnnameError, "" };
 		return error;
 	}
-    layer->cols = (int32_t)jsonCWid.number;
+    layer->cols = (int32_t)JsonInteger(jsonCWid);
 
 	Json jsonCHei;
 	if (JsonFindWithType(json, "__cHei", JsonType_Number, &jsonCHei) != JsonError_None)
@@ -650,7 +969,7 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 		const LDtkError error = { LDtkErrorCode_UnnameError, "" };
 		return error;
 	}
-    layer->rows = (int32_t)jsonCHei.number;
+    layer->rows = (int32_t)JsonInteger(jsonCHei);
 
 	Json jsonGridSize;
 	if (JsonFindWithType(json, "__gridSize", JsonType_Number, &jsonGridSize) != JsonError_None)
@@ -658,7 +977,7 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 		const LDtkError error = { LDtkErrorCode_UnnameError, "" };
 		return error;
 	}
-	layer->tileSize = (int32_t)jsonGridSize.number;
+	layer->tileSize = (int32_t)JsonInteger(jsonGridSize);
 
 	Json jsonOpacity;
 	if (JsonFindWithType(json, "__opacity", JsonType_Number, &jsonOpacity) != JsonError_None)
@@ -666,7 +985,7 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 		const LDtkError error = { LDtkErrorCode_UnnameError, "" };
 		return error;
 	}
-	layer->opacity = (float)jsonOpacity.number;
+	layer->opacity = (float)JsonNumber(jsonOpacity);
 
 	Json jsonPxTotalOffsetX;
 	if (JsonFindWithType(json, "__pxTotalOffsetX", JsonType_Number, &jsonPxTotalOffsetX) != JsonError_None)
@@ -674,7 +993,7 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 		const LDtkError error = { LDtkErrorCode_UnnameError, "" };
 		return error;
 	}
-	layer->offsetX = (int32_t)jsonPxTotalOffsetX.number;
+	layer->offsetX = (int32_t)JsonInteger(jsonPxTotalOffsetX);
 
 	Json jsonPxTotalOffsetY;
 	if (JsonFindWithType(json, "__pxTotalOffsetY", JsonType_Number, &jsonPxTotalOffsetY) != JsonError_None)
@@ -682,7 +1001,7 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 		const LDtkError error = { LDtkErrorCode_UnnameError, "" };
 		return error;
 	}
-	layer->offsetY = (int32_t)jsonPxTotalOffsetY.number;
+	layer->offsetY = (int32_t)JsonInteger(jsonPxTotalOffsetY);
 
 	Json jsonVisible;
 	if (JsonFindWithType(json, "visible", JsonType_Boolean, &jsonVisible) != JsonError_None)
@@ -710,7 +1029,7 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
         if (haveTileset)
         {
 		    int32_t tilesetIndex = -1;
-            const uint32_t tilesetId = (int32_t)jsonTilesetDefUid.number;
+            const uint32_t tilesetId = (int32_t)JsonInteger(jsonTilesetDefUid);
             for (int32_t i = 0; i < world->tilesetCount; i++)
             {
                 if (world->tilesets[i].id == tilesetId)
@@ -726,8 +1045,13 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
                 return error;
             }
 
+            // Empty strings are parsed as null
             const LDtkTileset tileset = world->tilesets[tilesetIndex];
-		    assert(strcmp(tileset.path, jsonTilesetRelPath.string) == 0);
+            if (strcmp(tileset.path ? tileset.path : "", jsonTilesetRelPath.string ? jsonTilesetRelPath.string : "") != 0)
+            {
+                const LDtkError error = { LDtkErrorCode_UnnameError, "'__tilesetRelPath' does not match the tileset" };
+                return error;
+            }
 		    layer->tileset = tileset;
         }
         else
@@ -755,6 +1079,12 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 	{
         int32_t tileCount = jsonGridTiles.length;
 	    LDtkTile* tiles = (LDtkTile*)AllocLower(allocator, NULL, 0, tileCount * sizeof(LDtkTile));
+	    if (!tiles && tileCount > 0)
+	    {
+		    const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
+		    return error;
+	    }
+
 	    for (int32_t i = 0; i < tileCount; i++)
 	    {
 		    const Json jsonTile = jsonGridTiles.array[i];
@@ -767,7 +1097,7 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 			    const LDtkError error = { LDtkErrorCode_UnnameError, "" };
 			    return error;
 		    }
-		    int32_t tileId = (int32_t)jsonTileId.number;
+		    int32_t tileId = (int32_t)JsonInteger(jsonTileId);
 
 		    Json jsonD;
 		    if (JsonFindWithType(jsonTile, "d", JsonType_Array, &jsonD) != JsonError_None)
@@ -776,13 +1106,13 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 			    return error;
 		    }
 
-		    Json jsonCoordId = jsonD.array[coordIdIndex];
+		    Json jsonCoordId = LDtkArrayItem(jsonD, coordIdIndex);
 		    if (jsonCoordId.type != JsonType_Number)
 		    {
 			    const LDtkError error = { LDtkErrorCode_UnnameError, "" };
 			    return error;
 		    }
-		    int32_t coordId = (int32_t)jsonCoordId.number;
+		    int32_t coordId = (int32_t)JsonInteger(jsonCoordId);
 
 		    Json jsonPx;
 		    if (JsonFindWithType(jsonTile, "px", JsonType_Array, &jsonPx) != JsonError_None)
@@ -793,15 +1123,15 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 
             // Parse fields to create LDtkTile
 
-		    Json jsonX = jsonPx.array[0];
-		    Json jsonY = jsonPx.array[1];
+		    Json jsonX = LDtkArrayItem(jsonPx, 0);
+		    Json jsonY = LDtkArrayItem(jsonPx, 1);
 		    if (jsonX.type != JsonType_Number || jsonY.type != JsonType_Number)
 		    {
 			    const LDtkError error = { LDtkErrorCode_UnnameError, "" };
 			    return error;
 		    }
-		    int32_t x = (int32_t)jsonX.number;
-		    int32_t y = (int32_t)jsonY.number;
+		    int32_t x = (int32_t)JsonInteger(jsonX);
+		    int32_t y = (int32_t)JsonInteger(jsonY);
 		    int32_t worldX = level->worldX + x;
 		    int32_t worldY = level->worldY + y;
 
@@ -812,15 +1142,15 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 			    return error;
 		    }
 
-		    Json jsonTextureX = jsonSrc.array[0];
-		    Json jsonTextureY = jsonSrc.array[1];
+		    Json jsonTextureX = LDtkArrayItem(jsonSrc, 0);
+		    Json jsonTextureY = LDtkArrayItem(jsonSrc, 1);
 		    if (jsonTextureX.type != JsonType_Number || jsonTextureY.type != JsonType_Number)
 		    {
 			    const LDtkError error = { LDtkErrorCode_UnnameError, "" };
 			    return error;
 		    }
-		    int32_t textureX = (int32_t)jsonTextureX.number;
-		    int32_t textureY = (int32_t)jsonTextureY.number;
+		    int32_t textureX = (int32_t)JsonInteger(jsonTextureX);
+		    int32_t textureY = (int32_t)JsonInteger(jsonTextureY);
 
 		    Json jsonF;
 		    if (JsonFindWithType(jsonTile, "f", JsonType_Number, &jsonF) != JsonError_None)
@@ -828,23 +1158,23 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 			    const LDtkError error = { LDtkErrorCode_UnnameError, "" };
 			    return error;
 		    }
-		    uint32_t flip = (uint32_t)jsonF.number;
+		    uint32_t flip = (uint32_t)JsonInteger(jsonF);
 		    bool flipX = (flip  & 1u);
 		    bool flipY = (flip >> 1u) & 1u;
 
-		    const LDtkTile tile = {
-			    .id         = tileId,
-			    .coordId    = coordId,
-			    .x          = x,
-			    .y          = y,
-			    .worldX     = worldX,
-			    .worldY     = worldY,
-			    .textureX   = textureX,
-			    .textureY   = textureY,
-			    .flipX      = flipX,
-			    .flipY      = flipY
-		    };
-		    tiles[i] = tile;
+		    // Padding is zero too, a level is read to the same bytes whatever the buffer held
+		    LDtkTile* tile = &tiles[i];
+		    memset(tile, 0, sizeof(*tile));
+		    tile->id        = tileId;
+		    tile->coordId   = coordId;
+		    tile->x         = x;
+		    tile->y         = y;
+		    tile->worldX    = worldX;
+		    tile->worldY    = worldY;
+		    tile->textureX  = textureX;
+		    tile->textureY  = textureY;
+		    tile->flipX     = flipX;
+		    tile->flipY     = flipY;
 	    }
 	    layer->tileCount = tileCount;
 	    layer->tiles = tiles;
@@ -857,7 +1187,7 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 
     // Read IntGrid
 
-    LDtkLayerDef layerDef;
+    LDtkLayerDef layerDef = { 0 };
     for (int32_t i = 0; i < world->layerDefCount; i++)
     {
         if (world->layerDefs[i].id == layer->layerDefId)
@@ -872,6 +1202,12 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 	{
         int32_t intGridCount = jsonIntGrid.length;
         LDtkIntGridValue* intGridValues = (LDtkIntGridValue*)AllocLower(allocator, NULL, 0, intGridCount * sizeof(LDtkIntGridValue));
+        if (!intGridValues && intGridCount > 0)
+        {
+            const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
+            return error;
+        }
+
         for (int32_t i = 0; i < intGridCount; i++)
         {
             const Json jsonIntGridValueIndex = jsonIntGrid.array[i];
@@ -881,8 +1217,9 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
                 return error;
             }
 
-            //intGridValues[i] = layerDef.intGridValues[(int32_t)jsonIntGridValueIndex.number - 1];
-            intGridValues[i].value = (int32_t)jsonIntGridValueIndex.number;
+            //intGridValues[i] = layerDef.intGridValues[(int32_t)JsonInteger(jsonIntGridValueIndex) - 1];
+            const LDtkIntGridValue intGridValue = { NULL, (int32_t)JsonInteger(jsonIntGridValueIndex), { 0 } };
+            intGridValues[i] = intGridValue;
         }
         layer->valueCount = intGridCount;
         layer->values = intGridValues;
@@ -891,6 +1228,19 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
     {
         int32_t intGridCount = jsonIntGrid.length;
         LDtkIntGridValue* intGridValues = (LDtkIntGridValue*)AllocLower(allocator, NULL, 0, intGridCount * sizeof(LDtkIntGridValue));
+        if (!intGridValues && intGridCount > 0)
+        {
+            const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
+            return error;
+        }
+
+        // Cells without a pair are empty
+        for (int32_t i = 0; i < intGridCount; i++)
+        {
+            const LDtkIntGridValue empty = { NULL, 0, { 0 } };
+            intGridValues[i] = empty;
+        }
+
         for (int32_t i = 0; i < intGridCount; i++)
         {
             const Json jsonValuePair = jsonIntGrid.array[i];
@@ -903,7 +1253,15 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
                 return error;
             }
 
-            intGridValues[(int32_t)jsonCoordId.number] = layerDef.intGridValues[(int32_t)jsonV.number];
+            const int64_t coordId = JsonInteger(jsonCoordId);
+            const int64_t valueIndex = JsonInteger(jsonV);
+            if (coordId < 0 || coordId >= intGridCount || valueIndex < 0 || valueIndex >= layerDef.intGridValueCount)
+            {
+                const LDtkError error = { LDtkErrorCode_UnnameError, "IntGrid value is out of range" };
+                return error;
+            }
+
+            intGridValues[coordId] = layerDef.intGridValues[valueIndex];
         }
         layer->valueCount = intGridCount;
         layer->values = intGridValues;
@@ -921,6 +1279,12 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 	{
         int32_t entityCount = jsonEntityInstances.length;
         LDtkEntity* entities = (LDtkEntity*)AllocLower(allocator, NULL, 0, entityCount * sizeof(*entities));
+        if (!entities && entityCount > 0)
+        {
+            const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
+            return error;
+        }
+
         for (int32_t i = 0; i < entityCount; i++)
         {
             Json jsonEntity = jsonEntityInstances.array[i];
@@ -931,6 +1295,7 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
             }
 
             LDtkEntity* entity = &entities[i];
+            memset(entity, 0, sizeof(*entity));
 
             Json jsonIdentifier;
             if (JsonFindWithType(jsonEntity, "__identifier", JsonType_String, &jsonIdentifier) != JsonError_None)
@@ -946,7 +1311,7 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
                 const LDtkError error = { LDtkErrorCode_UnnameError, "" };
                 return error;
             }
-            entity->defId = (int32_t)jsonDefUid.number;
+            entity->defId = (int32_t)JsonInteger(jsonDefUid);
 
             Json jsonWidth;
             if (JsonFindWithType(jsonEntity, "width", JsonType_Number, &jsonWidth) != JsonError_None)
@@ -954,7 +1319,7 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
                 const LDtkError error = { LDtkErrorCode_UnnameError, "" };
                 return error;
             }
-            entity->width = (int32_t)jsonWidth.number;
+            entity->width = (int32_t)JsonInteger(jsonWidth);
 
             Json jsonHeight;
             if (JsonFindWithType(jsonEntity, "height", JsonType_Number, &jsonHeight) != JsonError_None)
@@ -962,7 +1327,7 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
                 const LDtkError error = { LDtkErrorCode_UnnameError, "" };
                 return error;
             }
-            entity->height = (int32_t)jsonHeight.number;
+            entity->height = (int32_t)JsonInteger(jsonHeight);
 
             Json jsonPx;
             if (JsonFindWithType(jsonEntity, "px", JsonType_Array, &jsonPx) != JsonError_None)
@@ -971,15 +1336,15 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
                 return error;
             }
 
-            Json jsonX = jsonPx.array[0];
-            Json jsonY = jsonPx.array[1];
+            Json jsonX = LDtkArrayItem(jsonPx, 0);
+            Json jsonY = LDtkArrayItem(jsonPx, 1);
             if (jsonX.type != JsonType_Number || jsonY.type != JsonType_Number)
             {
                 const LDtkError error = { LDtkErrorCode_UnnameError, "" };
                 return error;
             }
-            entity->x = (int32_t)jsonX.number;
-            entity->y = (int32_t)jsonX.number;
+            entity->x = (int32_t)JsonInteger(jsonX);
+            entity->y = (int32_t)JsonInteger(jsonX);
             entity->worldX = level->worldX + entity->x;
             entity->worldY = level->worldY + entity->y;
 
@@ -990,15 +1355,15 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
                 return error;
             }
 
-            Json jsonGridX = jsonGrid.array[0];
-            Json jsonGridY = jsonGrid.array[1];
+            Json jsonGridX = LDtkArrayItem(jsonGrid, 0);
+            Json jsonGridY = LDtkArrayItem(jsonGrid, 1);
             if (jsonGridX.type != JsonType_Number || jsonGridY.type != JsonType_Number)
             {
                 const LDtkError error = { LDtkErrorCode_UnnameError, "" };
                 return error;
             }
-            entity->gridX = (int32_t)jsonGridX.number;
-            entity->gridY = (int32_t)jsonGridX.number;
+            entity->gridX = (int32_t)JsonInteger(jsonGridX);
+            entity->gridY = (int32_t)JsonInteger(jsonGridX);
 
             Json jsonPivot;
             if (JsonFindWithType(jsonEntity, "__pivot", JsonType_Array, &jsonPivot) != JsonError_None)
@@ -1007,15 +1372,15 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
                 return error;
             }
 
-            Json jsonPivotX = jsonPivot.array[0];
-            Json jsonPivotY = jsonPivot.array[1];
+            Json jsonPivotX = LDtkArrayItem(jsonPivot, 0);
+            Json jsonPivotY = LDtkArrayItem(jsonPivot, 1);
             if (jsonPivotX.type != JsonType_Number || jsonPivotY.type != JsonType_Number)
             {
                 const LDtkError error = { LDtkErrorCode_UnnameError, "" };
                 return error;
             }
-            entity->pivotX = (int32_t)jsonPivotX.number;
-            entity->pivotY = (int32_t)jsonPivotX.number;
+            entity->pivotX = (int32_t)JsonInteger(jsonPivotX);
+            entity->pivotY = (int32_t)JsonInteger(jsonPivotX);
         }
 
         layer->entityCount = entityCount;
@@ -1031,37 +1396,11 @@ static LDtkError LDtkReadLayer(const Json json, Allocator* allocator, LDtkLevel*
 	return error;
 }
 
-static LDtkError LDtkReadLevel(const Json json, const char* levelDirectory, Allocator* allocator, LDtkReadFileFn* readFileFn, LDtkLevel* level, LDtkParseFlags flags, LDtkWorld* world)
+static void LDtkReadLevelBackground(const Json json, LDtkLevel* level)
 {
-    const Json jsonUid;
-    JsonFind(json, "uid", (Json*)&jsonUid);
-    level->id = (int32_t)jsonUid.number;
-
-    const Json jsonIdentifier;
-    JsonFind(json, "identifier", (Json*)&jsonIdentifier);
-    level->name = jsonIdentifier.string;
-
-    const Json jsonWorldX;
-    JsonFind(json, "worldX", (Json*)&jsonWorldX);
-    level->worldX = (int32_t)jsonWorldX.number;
-
-    const Json jsonWorldY;
-    JsonFind(json, "worldY", (Json*)&jsonWorldY);
-    level->worldY = (int32_t)jsonWorldY.number;
-
-    const Json jsonPxWid;
-    JsonFind(json, "pxWid", (Json*)&jsonPxWid);
-    level->width = (int32_t)jsonPxWid.number;
-
-    const Json jsonPxHei;
-    JsonFind(json, "pxHei", (Json*)&jsonPxHei);
-    level->height = (int32_t)jsonPxHei.number;
-
-    // Reading background fields
-
     const Json jsonColor;
     JsonFind(json, "__bgColor", (Json*)&jsonColor);
-    level->bgColor = LDtkColorFromString(jsonColor.string);
+    level->bgColor = LDtkColorFromString(LDtkStringOf(jsonColor));
 
     const Json jsonBgRelPath;
     JsonFind(json, "bgRelPath", (Json*)&jsonBgRelPath);
@@ -1069,11 +1408,11 @@ static LDtkError LDtkReadLevel(const Json json, const char* levelDirectory, Allo
 
     const Json jsonBgPivotX;
     JsonFind(json, "bgPivotX", (Json*)&jsonBgPivotX);
-    level->bgPivotX = (int32_t)jsonBgPivotX.number;
+    level->bgPivotX = (int32_t)JsonInteger(jsonBgPivotX);
 
     const Json jsonBgPivotY;
     JsonFind(json, "bgPivotY", (Json*)&jsonBgPivotY);
-    level->bgPivotY = (int32_t)jsonBgPivotY.number;
+    level->bgPivotY = (int32_t)JsonInteger(jsonBgPivotY);
 
     const Json jsonBgPosMeta;
     if (JsonFind(json, "__bgPos", (Json*)&jsonBgPosMeta))
@@ -1081,26 +1420,63 @@ static LDtkError LDtkReadLevel(const Json json, const char* levelDirectory, Allo
         const Json jsonTopLeftPx;
         if (JsonFind(jsonBgPosMeta, "topLeftPx", (Json*)&jsonTopLeftPx))
         {
-            level->bgPosX = (int32_t)jsonTopLeftPx.array[0].number;
-            level->bgPosY = (int32_t)jsonTopLeftPx.array[1].number;
+            level->bgPosX = (int32_t)JsonInteger(LDtkArrayItem(jsonTopLeftPx, 0));
+            level->bgPosY = (int32_t)JsonInteger(LDtkArrayItem(jsonTopLeftPx, 1));
         }
 
         const Json jsonScale;
         if (JsonFind(jsonBgPosMeta, "scale", (Json*)&jsonScale))
         {
-            level->bgScaleX = (float)jsonScale.array[0].number;
-            level->bgScaleY = (float)jsonScale.array[1].number;
+            level->bgScaleX = (float)JsonNumber(LDtkArrayItem(jsonScale, 0));
+            level->bgScaleY = (float)JsonNumber(LDtkArrayItem(jsonScale, 1));
         }
 
         const Json jsonCropRect;
         if (JsonFind(jsonBgPosMeta, "cropRect", (Json*)&jsonCropRect))
         {
-            level->bgCropX      = (float)jsonCropRect.array[0].number;
-            level->bgCropY      = (float)jsonCropRect.array[1].number;
-            level->bgCropWidth  = (float)jsonCropRect.array[2].number;
-            level->bgCropHeight = (float)jsonCropRect.array[3].number;
+            level->bgCropX      = (float)JsonNumber(LDtkArrayItem(jsonCropRect, 0));
+            level->bgCropY      = (float)JsonNumber(LDtkArrayItem(jsonCropRect, 1));
+            level->bgCropWidth  = (float)JsonNumber(LDtkArrayItem(jsonCropRect, 2));
+            level->bgCropHeight = (float)JsonNumber(LDtkArrayItem(jsonCropRect, 3));
         }
     }
+}
+
+static LDtkError LDtkReadLevelHeader(const Json json, LDtkLevel* level, LDtkParseFlags flags)
+{
+    // Optional fields are zero, a level is read to the same bytes whatever the buffer held
+    memset(level, 0, sizeof(*level));
+
+    const Json jsonUid;
+    JsonFind(json, "uid", (Json*)&jsonUid);
+    level->id = (int32_t)JsonInteger(jsonUid);
+
+    const Json jsonIdentifier;
+    JsonFind(json, "identifier", (Json*)&jsonIdentifier);
+    level->name = jsonIdentifier.string;
+
+    const Json jsonWorldX;
+    JsonFind(json, "worldX", (Json*)&jsonWorldX);
+    level->worldX = (int32_t)JsonInteger(jsonWorldX);
+
+    const Json jsonWorldY;
+    JsonFind(json, "worldY", (Json*)&jsonWorldY);
+    level->worldY = (int32_t)JsonInteger(jsonWorldY);
+
+    const Json jsonPxWid;
+    JsonFind(json, "pxWid", (Json*)&jsonPxWid);
+    level->width = (int32_t)JsonInteger(jsonPxWid);
+
+    const Json jsonPxHei;
+    JsonFind(json, "pxHei", (Json*)&jsonPxHei);
+    level->height = (int32_t)JsonInteger(jsonPxHei);
+
+    // Reading background fields
+
+    if (!(flags & LDtkParseFlags_SkipBackground))
+    {
+        LDtkReadLevelBackground(json, level);
+    }
 
     // Reading neighbours
 
@@ -1121,7 +1497,7 @@ static LDtkError LDtkReadLevel(const Json json, const char* levelDirectory, Allo
                 return error;
             }
 
-            const char* directionName = jsonDir.string;
+            const char* directionName = LDtkStringOf(jsonDir);
 
             LDtkDirection direction;
             if (strcmp(directionName, "e") == 0)
@@ -1153,7 +1529,7 @@ static LDtkError LDtkReadLevel(const Json json, const char* levelDirectory, Allo
                 return error;
             }
 
-            level->neigbourIds[(int32_t)direction][level->neigbourCount[(int32_t)direction]++] = (int32_t)jsonLevelUid.number;
+            level->neigbourIds[(int32_t)direction][level->neigbourCount[(int32_t)direction]++] = (int32_t)JsonInteger(jsonLevelUid);
         }
     }
 
@@ -1171,7 +1547,169 @@ static LDtkError LDtkReadLevel(const Json json, const char* levelDirectory, Allo
         
     }
 
-    // Reading layer instances
+    const LDtkError error = { LDtkErrorCode_None, "" };
+    return error;
+}
+
+// Path of the file of a level saved in a separate file
+static LDtkError LDtkLevelFilePath(const Json json, const char* levelDirectory, char filePath[1024])
+{
+	const Json jsonExternalRelPath;
+	if (!JsonFind(json, "externalRelPath", (Json*)&jsonExternalRelPath))
+	{
+		const LDtkError error = { LDtkErrorCode_MissingLayerDefProperties, "'externalRelPath' is missing" };
+		return error;
+	}
+
+	if (jsonExternalRelPath.type != JsonType_String)
+	{
+		const LDtkError error = { LDtkErrorCode_InvalidLayerDefProperties, "'externalRelPath' must be string" };
+		return error;
+	}
+
+	const int32_t filePathLength = snprintf(filePath, 1024, "%s/%s", levelDirectory, LDtkStringOf(jsonExternalRelPath));
+	if (filePathLength < 0 || filePathLength >= 1024)
+	{
+		const LDtkError error = { LDtkErrorCode_InvalidLayerDefProperties, "'externalRelPath' is too long" };
+		return error;
+	}
+
+	const LDtkError error = { LDtkErrorCode_None, "" };
+	return error;
+}
+
+// The file is kept on the upper side, the strings of the layers point into it
+static LDtkError LDtkReadLevelFile(const char* filePath, Allocator* allocator, LDtkReadFileFn* readFileFn, const LDtkLevelOptions* options, Json* outLayerInstances)
+{
+	int32_t fileSize;
+	if (!readFileFn(filePath, NULL, &fileSize))
+	{
+		const LDtkError error = { LDtkErrorCode_MissingLevelExternalFile, "cannot read file from ..." };
+		return error;
+	}
+
+	void* buffer = AllocUpper(allocator, NULL, 0, fileSize + 1);
+	if (!buffer)
+	{
+		const LDtkError error = { LDtkErrorCode_OutOfMemory, "Cannot read more memory" };
+		return error;
+	}
+
+	if (!readFileFn(filePath, buffer, &fileSize))
+	{
+		const LDtkError error = { LDtkErrorCode_InternalError, "Cannot read more memory" };
+		return error;
+	}
+
+	int32_t contentLength = fileSize;
+	char* content = (char*)buffer;
+	content[contentLength] = 0;
+
+	LDtkLevelSkip skip;
+	const JsonSkipFunc skipFunc = LDtkLevelSkipOf(options, true, &skip);
+
+	Json jsonLevelFile;
+	if (allocator->allocChunk)
+	{
+		const int32_t chunkCount = allocator->chunkCount;
+		const JsonResult result = JsonParseSkipping(content, contentLength, JsonParseFlags_InSitu, skipFunc, &skip,
+			NULL, LDtkAllocChunk, allocator, allocator->lowerMarker, AllocatorRemainSize(allocator), &jsonLevelFile);
+		if (result.error != JsonError_None)
+		{
+			const LDtkError error = { result.error == JsonError_OutOfMemory ? LDtkErrorCode_OutOfMemory : LDtkErrorCode_InternalError, "Cannot read more memory" };
+			return error;
+		}
+
+		// Values continue in the chunks of the JSON parser, what remain of the buffer before them is left
+		if (allocator->chunkCount != chunkCount)
+		{
+			allocator->lowerMarker = allocator->upperMarker;
+		}
+		else
+		{
+			AllocLower(allocator, NULL, 0, result.memoryUsage);
+		}
+	}
+	else
+	{
+		const JsonResult result = JsonParseSkipping(content, contentLength, JsonParseFlags_InSitu, skipFunc, &skip,
+			NULL, NULL, NULL, allocator->lowerMarker, AllocatorRemainSize(allocator), &jsonLevelFile);
+		if (result.error != JsonError_None)
+		{
+			const LDtkError error = { result.error == JsonError_OutOfMemory ? LDtkErrorCode_OutOfMemory : LDtkErrorCode_InternalError, "Cannot read more memory" };
+			return error;
+		}
+	
+		// Move forward
+		AllocLower(allocator, NULL, 0, result.memoryUsage);
+	}
+
+	// File layer instances
+	if (!JsonFind(jsonLevelFile, "layerInstances", outLayerInstances))
+	{
+		const LDtkError error = { LDtkErrorCode_InvalidWorldProperties, "'layerInstances' is missing" };
+		return error;
+	}
+
+	const LDtkError error = { LDtkErrorCode_None, "" };
+	return error;
+}
+
+static LDtkError LDtkReadLevelLayers(const Json jsonLayerInstances, Allocator* allocator, LDtkLevel* level, const LDtkLevelOptions* options, LDtkWorld* world)
+{
+	int32_t layerCount = 0;
+	for (int32_t i = 0; i < jsonLayerInstances.length; i++)
+	{
+		// Null items are the layers the skip hook left out
+		layerCount += jsonLayerInstances.array[i].type != JsonType_Null;
+	}
+
+	level->layerCount = 0;
+	level->layers = (LDtkLayer*)AllocLower(allocator, NULL, 0, layerCount * sizeof(LDtkLayer));
+	if (!level->layers && layerCount > 0)
+	{
+		const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
+		return error;
+	}
+
+    for (int32_t i = 0; i < jsonLayerInstances.length; i++)
+    {
+		const Json layerJson = jsonLayerInstances.array[i];
+		if (layerJson.type == JsonType_Null)
+		{
+			continue;
+		}
+
+		const LDtkError error = LDtkReadLayer(layerJson, allocator, level, world);
+        if (error.code != LDtkErrorCode_None)
+        {
+            return error;
+        }
+    }
+
+    if (options->flags & LDtkParseFlags_LayerReverseOrder)
+    {
+        for (int32_t i = 0, n = layerCount >> 1; i < n; i++)
+        {
+            const LDtkLayer tmp = level->layers[i];
+            level->layers[i] = level->layers[layerCount - i - 1];
+            level->layers[layerCount - i - 1] = tmp;
+        }
+    }
+
+    const LDtkError error = { LDtkErrorCode_None, "" };
+    return error;
+}
+
+static LDtkError LDtkReadLevel(const Json json, const char* levelDirectory, Allocator* allocator, LDtkReadFileFn* readFileFn, LDtkLevel* level, const LDtkLevelOptions* options, LDtkWorld* world)
+{
+    const LDtkError headerError = LDtkReadLevelHeader(json, level, options->flags);
+    if (headerError.code != LDtkErrorCode_None)
+    {
+        return headerError;
+    }
+
+    // Reading layer instances
     Json jsonLayerInstances;
     if (!JsonFind(json, "layerInstances", &jsonLayerInstances))
     {
@@ -1179,210 +1717,1212 @@ static LDtkError LDtkReadLevel(const Json json, const char* levelDirectory, Allo
         return error;
     }
 
-	// Something unclear here
-	// Why we donot have a field to specify that
-	// Layer instances are define in other files
-	if (jsonLayerInstances.type == JsonType_Null)
-	{
-		const Json jsonExternalRelPath;
-		if (!JsonFind(json, "externalRelPath", (Json*)&jsonExternalRelPath))
-		{
-			const LDtkError error = { LDtkErrorCode_MissingLayerDefProperties, "'externalRelPath' is missing" };
-			return error;
-		}
+	// Something unclear here
+	// Why we donot have a field to specify that
+	// Layer instances are define in other files
+	if (jsonLayerInstances.type == JsonType_Null)
+	{
+		char filePath[1024];
+		const LDtkError pathError = LDtkLevelFilePath(json, levelDirectory, filePath);
+		if (pathError.code != LDtkErrorCode_None)
+		{
+			return pathError;
+		}
+
+		const LDtkError fileError = LDtkReadLevelFile(filePath, allocator, readFileFn, options, &jsonLayerInstances);
+		if (fileError.code != LDtkErrorCode_None)
+		{
+			return fileError;
+		}
+	}
+
+	return LDtkReadLevelLayers(jsonLayerInstances, allocator, level, options, world);
+}
+
+// Level of a level index: the layers are read by LDtkLoadLevel, from the file of the level or from json which stay in the world buffer
+static LDtkError LDtkReadLevelIndex(const Json* json, const char* levelDirectory, Allocator* allocator, LDtkLevel* level, LDtkParseFlags flags)
+{
+    const LDtkError headerError = LDtkReadLevelHeader(*json, level, flags);
+    if (headerError.code != LDtkErrorCode_None)
+    {
+        return headerError;
+    }
+
+    Json jsonLayerInstances;
+    if (!JsonFind(*json, "layerInstances", &jsonLayerInstances))
+    {
+        const LDtkError error = { LDtkErrorCode_InvalidWorldProperties, "'layerInstances' is missing" };
+        return error;
+    }
+
+	if (jsonLayerInstances.type == JsonType_Null)
+	{
+		char filePath[1024];
+		const LDtkError pathError = LDtkLevelFilePath(*json, levelDirectory, filePath);
+		if (pathError.code != LDtkErrorCode_None)
+		{
+			return pathError;
+		}
+
+		const int32_t filePathSize = (int32_t)strlen(filePath) + 1;
+		char* externalPath = (char*)AllocLower(allocator, NULL, 0, filePathSize);
+		if (!externalPath)
+		{
+			const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
+			return error;
+		}
+
+		memcpy(externalPath, filePath, (size_t)filePathSize);
+		level->externalPath = externalPath;
+	}
+
+	level->source = json;
+
+    const LDtkError error = { LDtkErrorCode_None, "" };
+    return error;
+}
+
+// External level files are relative to the directory of the world file
+static void LDtkLevelDirectory(const char* ldtkPath, char levelDirectory[1024])
+{
+	int32_t levelDirectoryLength = strlen(ldtkPath);
+	while (ldtkPath[levelDirectoryLength] != '/' && levelDirectoryLength > 0) { levelDirectoryLength--; };
+	memcpy(levelDirectory, ldtkPath, levelDirectoryLength);
+	levelDirectory[levelDirectoryLength] = 0;
+}
+
+// Parallel external levels
+// Levels saved in separate files are read and parsed on the workers of parallelFor, each one in a slice
+// of the free buffer sized by its file. The slices are moved back together in level order after,
+// the pointers into them are rebased. A level which does not fit in its slice is read again serially.
+
+typedef struct LDtkLevelTask
+{
+    int32_t         levelIndex;
+    int32_t         fileSize;
+
+    uint8_t*        base;           // Slice of the free buffer
+    uint8_t*        end;
+    uint8_t*        target;         // Where the slice is moved after reading
+    Allocator       allocator;
+    LDtkError       error;
+} LDtkLevelTask;
+
+typedef struct LDtkLevelTasks
+{
+    LDtkLevelTask*  tasks;
+    Json            jsonLevels;
+    const char*     levelDirectory;
+    LDtkReadFileFn* readFileFn;
+    const LDtkLevelOptions* options;
+    LDtkLevel*      levels;
+    LDtkWorld*      world;
+} LDtkLevelTasks;
+
+// Size of the file of a level saved in a separate file, 0 for the other levels and the files which cannot be read (the serial read report them)
+static int32_t LDtkExternalLevelSize(const Json jsonLevel, const char* levelDirectory, LDtkReadFileFn* readFileFn)
+{
+    Json jsonLayerInstances;
+    if (!JsonFind(jsonLevel, "layerInstances", &jsonLayerInstances) || jsonLayerInstances.type != JsonType_Null)
+    {
+        return 0;
+    }
+
+    Json jsonExternalRelPath;
+    if (JsonFindWithType(jsonLevel, "externalRelPath", JsonType_String, &jsonExternalRelPath) != JsonError_None)
+    {
+        return 0;
+    }
+
+    char filePath[1024];
+    const int32_t filePathLength = snprintf(filePath, sizeof(filePath), "%s/%s", levelDirectory, LDtkStringOf(jsonExternalRelPath));
+    if (filePathLength < 0 || filePathLength >= (int32_t)sizeof(filePath))
+    {
+        return 0;
+    }
+
+    int32_t fileSize;
+    if (!readFileFn(filePath, NULL, &fileSize) || fileSize < 0 || fileSize == INT32_MAX)
+    {
+        return 0;
+    }
+
+    return fileSize + 1;
+}
+
+static void LDtkReadLevelTasks(void* data, int32_t start, int32_t end)
+{
+    LDtkLevelTasks* tasks = (LDtkLevelTasks*)data;
+    for (int32_t i = start; i < end; i++)
+    {
+        LDtkLevelTask* task = &tasks->tasks[i];
+        task->error = LDtkReadLevel(tasks->jsonLevels.array[task->levelIndex], tasks->levelDirectory, &task->allocator, tasks->readFileFn,
+            &tasks->levels[task->levelIndex], tasks->options, tasks->world);
+    }
+}
+
+// Address of pointer once the slice is moved: its lower blocks go to target, its upper blocks (the level file) right after them
+static void* LDtkLevelTask_Rebase(const LDtkLevelTask* task, const void* pointer)
+{
+    const uintptr_t address     = (uintptr_t)pointer;
+    const uintptr_t base        = (uintptr_t)task->base;
+    const uintptr_t upper       = (uintptr_t)task->allocator.upperMarker;
+    const uintptr_t lowerSize   = (uintptr_t)(task->allocator.lowerMarker - task->base);
+
+    if (address - base < lowerSize)
+    {
+        return task->target + (address - base);
+    }
+
+    if (address - upper < (uintptr_t)task->end - upper)
+    {
+        return task->target + lowerSize + (address - upper);
+    }
+
+    return (void*)pointer;
+}
+
+// The blocks are read through the old pointers, they are rebased before the pointers to them
+static void LDtkRebaseLevelTasks(void* data, int32_t start, int32_t end)
+{
+    LDtkLevelTasks* tasks = (LDtkLevelTasks*)data;
+    for (int32_t i = start; i < end; i++)
+    {
+        const LDtkLevelTask* task = &tasks->tasks[i];
+        if (task->error.code != LDtkErrorCode_None)
+        {
+            continue;
+        }
+
+        LDtkLevel* level = &tasks->levels[task->levelIndex];
+        for (int32_t j = 0; j < level->layerCount; j++)
+        {
+            LDtkLayer* layer = &level->layers[j];
+            layer->name         = (const char*)LDtkLevelTask_Rebase(task, layer->name);
+            layer->tileset.name = (const char*)LDtkLevelTask_Rebase(task, layer->tileset.name);
+            layer->tileset.path = (const char*)LDtkLevelTask_Rebase(task, layer->tileset.path);
+            layer->tiles        = (LDtkTile*)LDtkLevelTask_Rebase(task, layer->tiles);
+
+            for (int32_t k = 0; k < layer->valueCount; k++)
+            {
+                layer->values[k].name = (const char*)LDtkLevelTask_Rebase(task, layer->values[k].name);
+            }
+            layer->values = (LDtkIntGridValue*)LDtkLevelTask_Rebase(task, layer->values);
+
+            for (int32_t k = 0; k < layer->entityCount; k++)
+            {
+                layer->entities[k].name = (const char*)LDtkLevelTask_Rebase(task, layer->entities[k].name);
+            }
+            layer->entities = (LDtkEntity*)LDtkLevelTask_Rebase(task, layer->entities);
+        }
+
+        level->name     = (const char*)LDtkLevelTask_Rebase(task, level->name);
+        level->bgPath   = (const char*)LDtkLevelTask_Rebase(task, level->bgPath);
+        level->layers   = (LDtkLayer*)LDtkLevelTask_Rebase(task, level->layers);
+    }
+}
+
+// Return false when the levels must be read serially: fewer than two level files, or a level did not fit when read again
+static bool LDtkReadLevelsParallel(const Json jsonLevels, const char* levelDirectory, Allocator* allocator, LDtkReadFileFn* readFileFn, LDtkParallelForFn* parallelFor,
+    const LDtkLevelOptions* options, LDtkLevel* levels, LDtkWorld* world, LDtkError* outError)
+{
+    const int32_t levelCount = jsonLevels.length;
+
+    int32_t taskCount = 0;
+    for (int32_t i = 0; i < levelCount && taskCount < 2; i++)
+    {
+        taskCount += LDtkExternalLevelSize(jsonLevels.array[i], levelDirectory, readFileFn) > 0;
+    }
+
+    if (taskCount < 2 || levelCount > INT32_MAX / (int32_t)sizeof(LDtkLevelTask))
+    {
+        return false;
+    }
+
+    // The tasks are temporaries on the upper side, the levels of the world file are read first
+    LDtkLevelTask* tasks = (LDtkLevelTask*)AllocUpper(allocator, NULL, 0, levelCount * (int32_t)sizeof(LDtkLevelTask));
+    if (!tasks)
+    {
+        return false;
+    }
+
+    taskCount = 0;
+    int64_t totalCost = 0;
+    for (int32_t i = 0; i < levelCount; i++)
+    {
+        const int32_t fileSize = LDtkExternalLevelSize(jsonLevels.array[i], levelDirectory, readFileFn);
+        if (fileSize > 0)
+        {
+            LDtkLevelTask* task = &tasks[taskCount++];
+            task->levelIndex = i;
+            task->fileSize = fileSize;
+            totalCost += fileSize;
+            continue;
+        }
+
+        *outError = LDtkReadLevel(jsonLevels.array[i], levelDirectory, allocator, readFileFn, &levels[i], options, world);
+        if (outError->code != LDtkErrorCode_None)
+        {
+            return outError->code != LDtkErrorCode_OutOfMemory;
+        }
+    }
+
+    uint8_t* const  freeStart   = allocator->lowerMarker;
+    const int64_t   freeSize    = AllocatorRemainSize(allocator);
+    int64_t         costBefore  = 0;
+    for (int32_t i = 0; i < taskCount; i++)
+    {
+        LDtkLevelTask* task = &tasks[i];
+
+        const int64_t sliceStart = (freeSize * costBefore / totalCost) & ~15;
+        costBefore += task->fileSize;
+        const int64_t sliceEnd = (freeSize * costBefore / totalCost) & ~15;
+
+        const Allocator sliceAllocator = { 0 };
+        task->allocator = sliceAllocator;
+        InitAllocator(&task->allocator, freeStart + sliceStart, (int32_t)(sliceEnd - sliceStart));
+
+        task->base = task->allocator.buffer;
+        task->end = task->allocator.buffer + task->allocator.bufferSize;
+    }
+
+    LDtkLevelTasks levelTasks;
+    levelTasks.tasks            = tasks;
+    levelTasks.jsonLevels       = jsonLevels;
+    levelTasks.levelDirectory   = levelDirectory;
+    levelTasks.readFileFn       = readFileFn;
+    levelTasks.options          = options;
+    levelTasks.levels           = levels;
+    levelTasks.world            = world;
+    parallelFor(LDtkReadLevelTasks, &levelTasks, taskCount, 1);
+
+    // The first error in level order is reported, the levels out of memory are read again after
+    for (int32_t i = 0; i < taskCount; i++)
+    {
+        if (tasks[i].error.code != LDtkErrorCode_None && tasks[i].error.code != LDtkErrorCode_OutOfMemory)
+        {
+            *outError = tasks[i].error;
+            return true;
+        }
+    }
+
+    // Move the slices back together, the pointers are rebased in parallel first.
+    // The levels out of memory are marked with a negative layer count, they are read again once the tasks are freed.
+    uint8_t* lowerEnd = freeStart;
+    for (int32_t i = 0; i < taskCount; i++)
+    {
+        LDtkLevelTask* task = &tasks[i];
+        task->target = lowerEnd;
+        if (task->error.code == LDtkErrorCode_None)
+        {
+            lowerEnd += (task->allocator.lowerMarker - task->base) + (task->end - task->allocator.upperMarker);
+        }
+        else
+        {
+            levels[task->levelIndex].layerCount = -1;
+        }
+    }
+
+    parallelFor(LDtkRebaseLevelTasks, &levelTasks, taskCount, 1);
+
+    for (int32_t i = 0; i < taskCount; i++)
+    {
+        const LDtkLevelTask* task = &tasks[i];
+        if (task->error.code == LDtkErrorCode_None)
+        {
+            const size_t lowerSize = (size_t)(task->allocator.lowerMarker - task->base);
+            memmove(task->target, task->base, lowerSize);
+            memmove(task->target + lowerSize, task->allocator.upperMarker, (size_t)(task->end - task->allocator.upperMarker));
+        }
+    }
+
+    allocator->lowerMarker = lowerEnd;
+    DeallocUpper(allocator, tasks, levelCount * (int32_t)sizeof(LDtkLevelTask));
+
+    for (int32_t i = 0; i < levelCount; i++)
+    {
+        if (levels[i].layerCount < 0)
+        {
+            *outError = LDtkReadLevel(jsonLevels.array[i], levelDirectory, allocator, readFileFn, &levels[i], options, world);
+            if (outError->code != LDtkErrorCode_None)
+            {
+                return outError->code != LDtkErrorCode_OutOfMemory;
+            }
+        }
+    }
+
+    const LDtkError error = { LDtkErrorCode_None, "" };
+    *outError = error;
+    return true;
+}
+
+static LDtkError LDtkReadLevels(const Json json, const char* ldtkPath, Allocator* allocator, LDtkReadFileFn* readFileFn, LDtkParallelForFn* parallelFor, const LDtkLevelOptions* options, LDtkWorld* world)
+{
+    const Json jsonLevels;
+    if (!JsonFind(json, "levels", (Json*)&jsonLevels))
+    {
+        const LDtkError error = { LDtkErrorCode_MissingWorldProperties, "'levels' is not found" };
+        return error;
+    }
+
+	char levelDirectory[1024];
+	LDtkLevelDirectory(ldtkPath, levelDirectory);
+
+    const int32_t   levelCount = jsonLevels.length;
+    LDtkLevel*      levels = (LDtkLevel*)AllocLower(allocator, NULL, 0, sizeof(LDtkLevel) * levelCount);
+    if (!levels && levelCount > 0)
+    {
+        const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
+        return error;
+    }
+
+    if (options->flags & LDtkParseFlags_LevelIndex)
+    {
+        for (int32_t i = 0; i < levelCount; i++)
+        {
+            const LDtkError readError = LDtkReadLevelIndex(&jsonLevels.array[i], levelDirectory, allocator, &levels[i], options->flags);
+            if (readError.code != LDtkErrorCode_None)
+            {
+                return readError;
+            }
+        }
+
+        world->levelCount = levelCount;
+        world->levels = levels;
+
+        const LDtkError error = { LDtkErrorCode_None, "" };
+        return error;
+    }
+
+    // Chunks are asked from one thread only, growable parses read the levels serially
+    if (parallelFor && !allocator->allocChunk)
+    {
+        uint8_t* const lowerMarker = allocator->lowerMarker;
+        uint8_t* const upperMarker = allocator->upperMarker;
+
+        LDtkError parallelError;
+        if (LDtkReadLevelsParallel(jsonLevels, levelDirectory, allocator, readFileFn, parallelFor, options, levels, world, &parallelError))
+        {
+            world->levelCount = levelCount;
+            world->levels = levels;
+            return parallelError;
+        }
+
+        allocator->lowerMarker = lowerMarker;
+        allocator->upperMarker = upperMarker;
+    }
+
+    for (int32_t i = 0; i < levelCount; i++)
+    {
+        LDtkLevel* level        = &levels[i];
+        const Json jsonLevel    = jsonLevels.array[i];
+
+        const LDtkError readError = LDtkReadLevel(jsonLevel, levelDirectory, allocator, readFileFn, level, options, world);
+        if (readError.code != LDtkErrorCode_None)
+        {
+            return readError;
+        }
+    }
+
+    world->levelCount = levelCount;
+    world->levels = levels;
+
+    const LDtkError error = { LDtkErrorCode_None, "" };
+    return error;
+}
+
+LDtkError LDtkParse(const char* ldtkPath, LDtkContext context, LDtkParseFlags flags, LDtkWorld* world)
+{
+	LDtkReadFileFn* readFileFn = context.readFileFn;
+	const LDtkLevelOptions options = LDtkLevelOptionsOf(context, flags);
+
+    Allocator allocator = { 0 };
+    allocator.allocChunk = context.allocChunk;
+    allocator.chunkUserData = context.chunkUserData;
+
+	// One byte is kept for the null terminator
+	char* content = (char*)context.buffer;
+	int32_t contentLength = context.bufferSize - 1;
+	if (context.allocChunk)
+	{
+		// The world file go to a chunk when it does not fit in the buffer
+		if (!readFileFn(ldtkPath, NULL, &contentLength))
+		{
+			const LDtkError error = { LDtkErrorCode_ParseJsonFailed, "" };
+			return error;
+		}
+
+		if (!content || contentLength >= context.bufferSize)
+		{
+			int32_t chunkSize;
+			content = (char*)LDtkAllocChunk(&allocator, contentLength + 1, &chunkSize);
+			if (!content)
+			{
+				const LDtkError error = { LDtkErrorCode_OutOfMemory, "Cannot allocate the world file" };
+				return error;
+			}
+		}
+	}
+	else if (!content || contentLength < 0)
+	{
+		const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
+		return error;
+	}
+
+	if (!readFileFn(ldtkPath, content, &contentLength))
+	{
+		const LDtkError error = { LDtkErrorCode_ParseJsonFailed, "" };
+		return error;
+	}
+	content[contentLength] = 0;
+
+	void* buffer = content + contentLength + 1;
+	int32_t bufferSize = context.bufferSize - contentLength - 1;
+	if (content != (char*)context.buffer)
+	{
+		buffer = context.buffer;
+		bufferSize = context.buffer ? context.bufferSize : 0;
+	}
+
+    // Strings of the world point into content, it live in the same buffer. What the options skip is never built.
+    LDtkLevelSkip skip;
+    const JsonSkipFunc skipFunc = LDtkLevelSkipOf(&options, false, &skip);
+
+    Json json;
+    JsonResult jsonResult;
+    const int32_t jsonChunkCount = allocator.chunkCount;
+    if (context.allocChunk)
+    {
+        jsonResult = JsonParseSkipping(content, contentLength, JsonParseFlags_InSitu, skipFunc, &skip, NULL, LDtkAllocChunk, &allocator, buffer, bufferSize, &json);
+    }
+    else
+    {
+        jsonResult = JsonParseSkipping(content, contentLength, JsonParseFlags_InSitu, skipFunc, &skip, context.parallelFor, NULL, NULL, buffer, bufferSize, &json);
+
+        // The parallel parse may need more than the serial one, content was parsed in place so it is read again
+        if (jsonResult.error == JsonError_OutOfMemory && context.parallelFor)
+        {
+            if (!readFileFn(ldtkPath, content, &contentLength))
+            {
+                const LDtkError error = { LDtkErrorCode_ParseJsonFailed, "" };
+                return error;
+            }
+            content[contentLength] = 0;
+
+            jsonResult = JsonParseSkipping(content, contentLength, JsonParseFlags_InSitu, skipFunc, &skip, NULL, NULL, NULL, buffer, bufferSize, &json);
+        }
+    }
+
+    if (jsonResult.error != JsonError_None)
+    {
+        const LDtkError error = { LDtkErrorCode_ParseJsonFailed, jsonResult.message };
+        return error;
+    }
+
+    // Blocks of the world start after the JSON values, or in a new chunk when the JSON parser needed some
+    if (allocator.chunkCount == jsonChunkCount)
+    {
+        if (!InitAllocator(&allocator, (uint8_t*)buffer + jsonResult.memoryUsage, bufferSize - jsonResult.memoryUsage) && !context.allocChunk)
+        {
+            const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
+            return error;
+        }
+    }
+
+    // Padding is zero, whatever the caller left in world
+    memset(world, 0, sizeof(*world));
+
+    const LDtkError readPropertiesError = LDtkReadWorldProperties(json, world);
+    if (readPropertiesError.code != LDtkErrorCode_None)
+    {
+        return readPropertiesError;
+    }
+
+    const Json jsonDefs;
+    if (!JsonFind(json, "defs", (Json*)&jsonDefs))
+    {
+        const LDtkError error = { LDtkErrorCode_MissingWorldProperties, "'defs' is not found" };
+        return error;
+    }
+
+    LDtkError readDefsError;
+
+    readDefsError = LDtkReadEnums(jsonDefs, &allocator, world);
+    if (readDefsError.code != LDtkErrorCode_None)
+    {
+        return readDefsError;
+    }
+
+    readDefsError = LDtkReadTilesets(jsonDefs, &allocator, world);
+    if (readDefsError.code != LDtkErrorCode_None)
+    {
+        return readDefsError;
+    }
+
+    readDefsError = LDtkReadLayerDefs(jsonDefs, &allocator, world);
+    if (readDefsError.code != LDtkErrorCode_None)
+    {
+        return readDefsError;
+    }
+
+    readDefsError = LDtkReadEntityDefs(jsonDefs, &allocator, world);
+    if (readDefsError.code != LDtkErrorCode_None)
+    {
+        return readDefsError;
+    }
+
+    const LDtkError readLevelsError = LDtkReadLevels(json, ldtkPath, &allocator, readFileFn, context.parallelFor, &options, world);
+    if (readLevelsError.code != LDtkErrorCode_None)
+    {
+        return readLevelsError;
+    }
+
+    world->memoryUsage = context.bufferSize + allocator.chunkTotalSize - AllocatorRemainSize(&allocator);
+
+    const LDtkError error = { LDtkErrorCode_None, "" };
+    return error;
+}
+
+// Lazy levels: the layers of a level of a level index are read in a buffer of their own
+
+static LDtkLevel* LDtkFindLevel(LDtkWorld* world, int32_t levelId)
+{
+    for (int32_t i = 0; i < world->levelCount; i++)
+    {
+        if (world->levels[i].id == levelId)
+        {
+            return &world->levels[i];
+        }
+    }
+
+    return NULL;
+}
+
+LDtkError LDtkLoadLevel(LDtkWorld* world, int32_t levelId, LDtkContext context, LDtkParseFlags flags)
+{
+    LDtkLevel* level = LDtkFindLevel(world, levelId);
+    if (!level)
+    {
+        const LDtkError error = { LDtkErrorCode_UnknownLevel, "Level is not in the world" };
+        return error;
+    }
+
+    // Levels of a whole world, and the levels already loaded
+    if (level->layers || !level->source)
+    {
+        const LDtkError error = { LDtkErrorCode_None, "" };
+        return error;
+    }
+
+    const LDtkLevelOptions options = LDtkLevelOptionsOf(context, flags);
+
+    Allocator allocator = { 0 };
+    allocator.allocChunk = context.allocChunk;
+    allocator.chunkUserData = context.chunkUserData;
+    if (!InitAllocator(&allocator, context.buffer, context.bufferSize) && !context.allocChunk)
+    {
+        const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
+        return error;
+    }
+
+    Json jsonLayerInstances;
+    if (level->externalPath)
+    {
+        const LDtkError fileError = LDtkReadLevelFile(level->externalPath, &allocator, context.readFileFn, &options, &jsonLayerInstances);
+        if (fileError.code != LDtkErrorCode_None)
+        {
+            return fileError;
+        }
+    }
+    else if (!JsonFind(*(const Json*)level->source, "layerInstances", &jsonLayerInstances))
+    {
+        const LDtkError error = { LDtkErrorCode_InvalidWorldProperties, "'layerInstances' is missing" };
+        return error;
+    }
+
+    const LDtkError readError = LDtkReadLevelLayers(jsonLayerInstances, &allocator, level, &options, world);
+    if (readError.code != LDtkErrorCode_None)
+    {
+        level->layerCount = 0;
+        level->layers = NULL;
+        return readError;
+    }
+
+    // The level file is moved right after the lower blocks, like a slice of the parallel levels,
+    // the buffer is in use from its start only
+    if (allocator.chunkCount == 0 && allocator.buffer)
+    {
+        LDtkLevelTask task = { 0 };
+        task.levelIndex = (int32_t)(level - world->levels);
+        task.base = allocator.buffer;
+        task.end = allocator.buffer + allocator.bufferSize;
+        task.target = allocator.buffer;
+        task.allocator = allocator;
+
+        LDtkLevelTasks levelTasks = { 0 };
+        levelTasks.tasks = &task;
+        levelTasks.levels = world->levels;
+        LDtkRebaseLevelTasks(&levelTasks, 0, 1);
+
+        const size_t upperSize = (size_t)(task.end - allocator.upperMarker);
+        memmove(allocator.lowerMarker, allocator.upperMarker, upperSize);
+        allocator.lowerMarker += upperSize;
+        allocator.upperMarker = task.end;
+    }
+
+    level->memoryUsage = context.bufferSize + allocator.chunkTotalSize - AllocatorRemainSize(&allocator);
+
+    const LDtkError error = { LDtkErrorCode_None, "" };
+    return error;
+}
+
+void LDtkUnloadLevel(LDtkWorld* world, int32_t levelId)
+{
+    LDtkLevel* level = LDtkFindLevel(world, levelId);
+    if (level && level->source)
+    {
+        level->layerCount = 0;
+        level->layers = NULL;
+        level->memoryUsage = 0;
+    }
+}
+
+// Memory query: the allocations of LDtkParse are counted with a JsonReader over the files, without building values
+
+typedef struct LDtkQuery
+{
+    LDtkReadFileFn* readFileFn;
+    const char*     levelDirectory;
+
+    const char*     content;        // World file
+    int32_t         contentLength;
+    LDtkLevelSkip   skip;           // Of the world file
+
+    char*           scratch;        // After the world file, hold one external level file
+    int32_t         scratchOffset;
+    int32_t         scratchSize;
+    int32_t         scratchNeed;    // Buffer size of the query when a level file did not fit
+
+    int64_t         lower;          // Blocks of the levels, in the order LDtkParse allocate them
+    int64_t         upper;          // External level files
+    int64_t         peak;           // Highest lower + upper when a level file is parsed
+
+    bool            levelIndex;     // Levels without their layers, only the paths of the level files are kept
+    const LDtkLevelOptions* options;    // The files are parsed with the skip hook of these, the layers it skip are not counted
+} LDtkQuery;
+
+static int32_t LDtkQueryBlock(int32_t count, int32_t size)
+{
+    return count > 0 ? AlignAllocSize(count * size) : 0;
+}
+
+// Item count of the next value, -1 when it is not an array
+static int32_t LDtkQueryArrayLength(JsonReader* reader)
+{
+    const JsonToken token = JsonReader_Next(reader);
+    if (token != JsonToken_ArrayBegin)
+    {
+        LDtkReaderSkip(reader, token);
+        return -1;
+    }
+
+    int32_t count = 0;
+    while (JsonReader_NextItem(reader) && JsonReader_SkipValue(reader))
+    {
+        count++;
+    }
+    return count;
+}
+
+// Array of objects with an array each, like the enums and their values
+static int32_t LDtkQueryItems(JsonReader* reader, const char* childName, int32_t itemSize, int32_t childSize)
+{
+    const JsonToken token = JsonReader_Next(reader);
+    if (token != JsonToken_ArrayBegin)
+    {
+        LDtkReaderSkip(reader, token);
+        return 0;
+    }
+
+    int32_t count = 0;
+    int32_t size = 0;
+    while (JsonReader_NextItem(reader))
+    {
+        count++;
+
+        const JsonToken itemToken = JsonReader_Next(reader);
+        if (itemToken != JsonToken_ObjectBegin)
+        {
+            LDtkReaderSkip(reader, itemToken);
+            continue;
+        }
+
+        // JsonFind return the first member of a name
+        bool found = false;
+        const char* name;
+        while (JsonReader_NextMember(reader, &name))
+        {
+            if (!found && strcmp(name, childName) == 0)
+            {
+                found = true;
+                size += LDtkQueryBlock(LDtkQueryArrayLength(reader), childSize);
+            }
+            else
+            {
+                JsonReader_SkipValue(reader);
+            }
+        }
+    }
+
+    return LDtkQueryBlock(count, itemSize) + size;
+}
 
-		if (jsonExternalRelPath.type != JsonType_String)
-		{
-			const LDtkError error = { LDtkErrorCode_InvalidLayerDefProperties, "'externalRelPath' must be string" };
-			return error;
-		}
+static int32_t LDtkQueryDefs(JsonReader* reader)
+{
+    const JsonToken token = JsonReader_Next(reader);
+    if (token != JsonToken_ObjectBegin)
+    {
+        LDtkReaderSkip(reader, token);
+        return 0;
+    }
 
-		char filePath[1024];
-		sprintf(filePath, "%s/%s", levelDirectory, jsonExternalRelPath.string);
-		
-		int32_t fileSize;
-		if (!readFileFn(filePath, NULL, &fileSize))
-		{
-			const LDtkError error = { LDtkErrorCode_MissingLevelExternalFile, "cannot read file from ..." };
-			return error;
-		}
+    bool foundEnums = false, foundTilesets = false, foundLayers = false, foundEntities = false;
 
-		void* buffer = AllocUpper(allocator, NULL, 0, fileSize + 1);
-		if (!buffer)
-		{
-			const LDtkError error = { LDtkErrorCode_OutOfMemory, "Cannot read more memory" };
-			return error;
-		}
+    int32_t size = 0;
+    const char* name;
+    while (JsonReader_NextMember(reader, &name))
+    {
+        if (!foundEnums && strcmp(name, "enums") == 0)
+        {
+            foundEnums = true;
+            size += LDtkQueryItems(reader, "values", sizeof(LDtkEnum), sizeof(LDtkEnumValue));
+        }
+        else if (!foundTilesets && strcmp(name, "tilesets") == 0)
+        {
+            foundTilesets = true;
+            size += LDtkQueryBlock(LDtkQueryArrayLength(reader), sizeof(LDtkTileset));
+        }
+        else if (!foundLayers && strcmp(name, "layers") == 0)
+        {
+            foundLayers = true;
+            size += LDtkQueryItems(reader, "intGridValues", sizeof(LDtkLayerDef), sizeof(LDtkIntGridValue));
+        }
+        else if (!foundEntities && strcmp(name, "entities") == 0)
+        {
+            foundEntities = true;
+            size += LDtkQueryItems(reader, "tags", sizeof(LDtkEntityDef), sizeof(const char*));
+        }
+        else
+        {
+            JsonReader_SkipValue(reader);
+        }
+    }
 
-		if (!readFileFn(filePath, buffer, &fileSize))
-		{
-			const LDtkError error = { LDtkErrorCode_InternalError, "Cannot read more memory" };
-			return error;
-		}
+    return size;
+}
 
-		int32_t contentLength = fileSize;
-		char* content = (char*)buffer;
-		content[contentLength] = 0;
+// Ask the skip hook about the value the reader is before, the JSON parser give it the same target
+static bool LDtkQuerySkip(JsonReader* reader, const LDtkLevelSkip* skip, const char* content, int32_t length, int32_t depth, const char* name, bool isItem)
+{
+    int64_t start = reader->offset + reader->cursor;
+    while (start < length && content[start] && strchr(" \t\r\n:,", content[start]))
+    {
+        start++;
+    }
 
-		Json jsonLevelFile;
-		const JsonResult result = JsonParse(content, contentLength, JsonParseFlags_Default, allocator->lowerMarker, AllocatorRemainSize(allocator), &jsonLevelFile);
-		if (result.error != JsonError_None)
-		{
-			const LDtkError error = { LDtkErrorCode_InternalError, "Cannot read more memory" };
-			return error;
-		}
-		
-		// Move forward
-		AllocLower(allocator, NULL, 0, result.memoryUsage);
+    if (start >= length || (content[start] != '[' && content[start] != '{'))
+    {
+        return false;
+    }
 
-		// File layer instances
-		if (!JsonFind(jsonLevelFile, "layerInstances", &jsonLayerInstances))
-		{
-			const LDtkError error = { LDtkErrorCode_InvalidWorldProperties, "'layerInstances' is missing" };
-			return error;
-		}
-	}
+    const JsonSkipTarget target = { depth, name, isItem, content + start, length - (int32_t)start };
+    return LDtkLevelSkip_Func((void*)skip, &target);
+}
 
-	const int32_t layerCount = jsonLayerInstances.length;
+// Layer instances, token is the first one of the value. content is the text of the file the reader read.
+static int32_t LDtkQueryLayers(JsonReader* reader, JsonToken token, const LDtkLevelSkip* skip, const char* content, int32_t length)
+{
+    if (token != JsonToken_ArrayBegin)
+    {
+        LDtkReaderSkip(reader, token);
+        return 0;
+    }
 
-	level->layerCount = 0;
-	level->layers = (LDtkLayer*)AllocLower(allocator, NULL, 0, layerCount * sizeof(LDtkLayer));
+    enum { Field_GridTiles, Field_AutoLayerTiles, Field_IntGridCsv, Field_IntGrid, Field_EntityInstances, Field_Count };
+    static const char* fieldNames[Field_Count] = { "gridTiles", "autoLayerTiles", "intGridCsv", "intGrid", "entityInstances" };
+
+    const int32_t layerDepth = skip->levelDepth + 2;
 
-    for (int32_t i = 0; i < layerCount; i++)
+    int32_t layerCount = 0;
+    int32_t size = 0;
+    while (JsonReader_NextItem(reader))
     {
-		const Json layerJson = jsonLayerInstances.array[i];
-		const LDtkError error = LDtkReadLayer(layerJson, allocator, level, world);
-        if (error.code != LDtkErrorCode_None)
+        if (LDtkQuerySkip(reader, skip, content, length, layerDepth, "layerInstances", true))
         {
-            return error;
+            JsonReader_SkipValue(reader);
+            continue;
+        }
+
+        // Null layers are left out, the other values fail the parse
+        const JsonToken layerToken = JsonReader_Next(reader);
+        if (layerToken != JsonToken_ObjectBegin)
+        {
+            LDtkReaderSkip(reader, layerToken);
+            continue;
+        }
+        layerCount++;
+
+        // -1 when missing or not an array, the layer is read without them then
+        int32_t counts[Field_Count] = { -1, -1, -1, -1, -1 };
+        bool    found[Field_Count] = { false };
+        bool    foundType = false;
+        bool    autoTiles = false;
+
+        const char* name;
+        while (JsonReader_NextMember(reader, &name))
+        {
+            if (!foundType && strcmp(name, "__type") == 0)
+            {
+                foundType = true;
+                if (JsonReader_Next(reader) == JsonToken_Value && reader->value.type == JsonType_String && reader->value.string)
+                {
+                    autoTiles = strcmp(reader->value.string, "IntGrid") == 0 || strcmp(reader->value.string, "AutoLayer") == 0;
+                }
+                else
+                {
+                    LDtkReaderSkip(reader, reader->token);
+                }
+                continue;
+            }
+
+            int32_t field = 0;
+            while (field < Field_Count && (found[field] || strcmp(name, fieldNames[field]) != 0))
+            {
+                field++;
+            }
+
+            if (field < Field_Count && LDtkQuerySkip(reader, skip, content, length, layerDepth + 1, name, false))
+            {
+                found[field] = true;
+                JsonReader_SkipValue(reader);
+            }
+            else if (field < Field_Count)
+            {
+                found[field] = true;
+                counts[field] = LDtkQueryArrayLength(reader);
+            }
+            else
+            {
+                JsonReader_SkipValue(reader);
+            }
         }
+
+        const int32_t tileCount = autoTiles ? counts[Field_AutoLayerTiles] : counts[Field_GridTiles];
+        const int32_t valueCount = counts[Field_IntGridCsv] >= 0 ? counts[Field_IntGridCsv] : counts[Field_IntGrid];
+
+        size += LDtkQueryBlock(tileCount, sizeof(LDtkTile));
+        size += LDtkQueryBlock(valueCount, sizeof(LDtkIntGridValue));
+        size += LDtkQueryBlock(counts[Field_EntityInstances], sizeof(LDtkEntity));
     }
 
-    if (flags & LDtkParseFlags_LayerReverseOrder)
+    return LDtkQueryBlock(layerCount, sizeof(LDtkLayer)) + size;
+}
+
+static LDtkError LDtkQueryLevelFile(LDtkQuery* query, const char* externalRelPath)
+{
+    char filePath[1024];
+    const int32_t filePathLength = snprintf(filePath, sizeof(filePath), "%s/%s", query->levelDirectory, externalRelPath);
+    if (filePathLength < 0 || filePathLength >= (int32_t)sizeof(filePath))
     {
-        for (int32_t i = 0, n = layerCount >> 1; i < n; i++)
+        const LDtkError error = { LDtkErrorCode_InvalidLayerDefProperties, "'externalRelPath' is too long" };
+        return error;
+    }
+
+    int32_t fileSize;
+    if (!query->readFileFn(filePath, NULL, &fileSize))
+    {
+        const LDtkError error = { LDtkErrorCode_MissingLevelExternalFile, "cannot read file from ..." };
+        return error;
+    }
+
+    // Keep going to find the scratch size of all the files
+    if (fileSize >= query->scratchSize)
+    {
+        const int32_t scratchNeed = query->scratchOffset + fileSize + 1;
+        query->scratchNeed = scratchNeed > query->scratchNeed ? scratchNeed : query->scratchNeed;
+
+        const LDtkError error = { LDtkErrorCode_None, "" };
+        return error;
+    }
+
+    if (!query->readFileFn(filePath, query->scratch, &fileSize))
+    {
+        const LDtkError error = { LDtkErrorCode_InternalError, "Cannot read more memory" };
+        return error;
+    }
+    LDtkLevelSkip skip;
+    const JsonSkipFunc skipFunc = LDtkLevelSkipOf(query->options, true, &skip);
+
+    int32_t jsonBufferSize;
+    const JsonResult result = JsonQueryMemorySkipping(query->scratch, fileSize, JsonParseFlags_InSitu, skipFunc, &skip, &jsonBufferSize);
+    if (result.error != JsonError_None)
+    {
+        const LDtkError error = { LDtkErrorCode_InvalidLevelExternalFile, result.message };
+        return error;
+    }
+
+    // The file is kept in the upper side, its values are parsed in what remain
+    query->upper += AlignAllocSize(fileSize + 1);
+    if (query->lower + query->upper + jsonBufferSize > query->peak)
+    {
+        query->peak = query->lower + query->upper + jsonBufferSize;
+    }
+    query->lower += result.memoryUsage;
+
+    char window[LDTK_READER_WINDOW_SIZE];
+    LDtkReaderSource source = { query->scratch, fileSize, 0 };
+
+    JsonReader reader;
+    JsonReader_Init(&reader, JsonParseFlags_None, window, sizeof(window), LDtkReaderRead, &source);
+    if (JsonReader_EnterObject(&reader))
+    {
+        bool foundLayerInstances = false;
+
+        const char* name;
+        while (JsonReader_NextMember(&reader, &name))
         {
-            const LDtkLayer tmp = level->layers[i];
-            level->layers[i] = level->layers[layerCount - i - 1];
-            level->layers[layerCount - i - 1] = tmp;
+            if (!foundLayerInstances && strcmp(name, "layerInstances") == 0)
+            {
+                foundLayerInstances = true;
+                query->lower += LDtkQueryLayers(&reader, JsonReader_Next(&reader), &skip, query->scratch, fileSize);
+            }
+            else
+            {
+                JsonReader_SkipValue(&reader);
+            }
         }
     }
 
+    if (reader.error != JsonError_None)
+    {
+        const LDtkError error = { LDtkErrorCode_InvalidLevelExternalFile, "Cannot read the level file" };
+        return error;
+    }
+
     const LDtkError error = { LDtkErrorCode_None, "" };
     return error;
 }
 
-static LDtkError LDtkReadLevels(const Json json, const char* ldtkPath, Allocator* allocator, LDtkReadFileFn* readFileFn, LDtkParseFlags flags, LDtkWorld* world)
+// Levels of the world, in the order LDtkParse read them
+static LDtkError LDtkQueryLevels(LDtkQuery* query, JsonReader* reader, int32_t* outLevelsSize)
 {
-    const Json jsonLevels;
-    if (!JsonFind(json, "levels", (Json*)&jsonLevels))
+    *outLevelsSize = 0;
+
+    const JsonToken token = JsonReader_Next(reader);
+    if (token != JsonToken_ArrayBegin)
     {
-        const LDtkError error = { LDtkErrorCode_MissingWorldProperties, "'levels' is not found" };
+        LDtkReaderSkip(reader, token);
+
+        const LDtkError error = { LDtkErrorCode_None, "" };
         return error;
     }
 
-	char levelDirectory[1024];
-	int32_t levelDirectoryLength = strlen(ldtkPath);
-	while (ldtkPath[levelDirectoryLength] != '/' && levelDirectoryLength > 0) { levelDirectoryLength--; };
-	memcpy(levelDirectory, ldtkPath, levelDirectoryLength);
-	levelDirectory[levelDirectoryLength] = 0;
-
-    const int32_t   levelCount = jsonLevels.length;
-    LDtkLevel*      levels = (LDtkLevel*)AllocLower(allocator, NULL, 0, sizeof(LDtkLevel) * levelCount);
-    for (int32_t i = 0; i < levelCount; i++)
+    int32_t levelCount = 0;
+    while (JsonReader_NextItem(reader))
     {
-        LDtkLevel* level        = &levels[i];
-        const Json jsonLevel    = jsonLevels.array[i];
+        levelCount++;
 
-        const LDtkError readError = LDtkReadLevel(jsonLevel, levelDirectory, allocator, readFileFn, level, flags, world);
-        if (readError.code != LDtkErrorCode_None)
+        const JsonToken levelToken = JsonReader_Next(reader);
+        if (levelToken != JsonToken_ObjectBegin)
         {
-            return readError;
+            LDtkReaderSkip(reader, levelToken);
+            continue;
+        }
+
+        bool foundLayerInstances = false;
+        bool foundExternalRelPath = false;
+        bool external = false;
+        char externalRelPath[1024] = "";
+
+        const char* name;
+        while (JsonReader_NextMember(reader, &name))
+        {
+            if (!foundLayerInstances && strcmp(name, "layerInstances") == 0)
+            {
+                foundLayerInstances = true;
+
+                const JsonToken layersToken = JsonReader_Next(reader);
+                external = layersToken == JsonToken_Value && reader->value.type == JsonType_Null;
+                if (query->levelIndex)
+                {
+                    LDtkReaderSkip(reader, layersToken);
+                }
+                else
+                {
+                    query->lower += LDtkQueryLayers(reader, layersToken, &query->skip, query->content, query->contentLength);
+                }
+            }
+            else if (!foundExternalRelPath && strcmp(name, "externalRelPath") == 0)
+            {
+                foundExternalRelPath = true;
+
+                // Paths longer than LDtkParse accept are left empty, the parse fail on them
+                if (JsonReader_Next(reader) == JsonToken_Value && reader->value.type == JsonType_String && reader->value.string
+                    && reader->value.length < (int32_t)sizeof(externalRelPath))
+                {
+                    memcpy(externalRelPath, reader->value.string, (size_t)reader->value.length + 1);
+                }
+                else
+                {
+                    LDtkReaderSkip(reader, reader->token);
+                }
+            }
+            else
+            {
+                JsonReader_SkipValue(reader);
+            }
+        }
+
+        if (external && foundExternalRelPath && query->levelIndex)
+        {
+            query->lower += AlignAllocSize((int32_t)(strlen(query->levelDirectory) + 1 + strlen(externalRelPath) + 1));
+        }
+        else if (external && foundExternalRelPath)
+        {
+            const LDtkError error = LDtkQueryLevelFile(query, externalRelPath);
+            if (error.code != LDtkErrorCode_None)
+            {
+                return error;
+            }
         }
     }
 
-    world->levelCount = levelCount;
-    world->levels = levels;
+    *outLevelsSize = LDtkQueryBlock(levelCount, sizeof(LDtkLevel));
 
     const LDtkError error = { LDtkErrorCode_None, "" };
     return error;
 }
 
-LDtkError LDtkParse(const char* ldtkPath, LDtkContext context, LDtkParseFlags flags, LDtkWorld* world)
+LDtkError LDtkQueryMemory(const char* ldtkPath, LDtkContext context, LDtkParseFlags flags, int32_t* outSize)
 {
+    assert(outSize);
+
+    *outSize = 0;
+
 	LDtkReadFileFn* readFileFn = context.readFileFn;
 
+	int32_t contentLength;
+	if (!readFileFn(ldtkPath, NULL, &contentLength))
+	{
+		const LDtkError error = { LDtkErrorCode_ParseJsonFailed, "" };
+		return error;
+	}
+
+	if (!context.buffer || contentLength >= context.bufferSize)
+	{
+		*outSize = contentLength + 1;
+
+		const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small for the world file" };
+		return error;
+	}
+
 	char* content = (char*)context.buffer;
-	int32_t contentLength = context.bufferSize;
 	if (!readFileFn(ldtkPath, content, &contentLength))
 	{
 		const LDtkError error = { LDtkErrorCode_ParseJsonFailed, "" };
 		return error;
 	}
-	content[contentLength] = 0;
 
-	void* buffer = content + contentLength + 1;
-	int32_t bufferSize = context.bufferSize - contentLength - 1;
+    const LDtkLevelOptions options = LDtkLevelOptionsOf(context, flags);
+
+    LDtkQuery query = { 0 };
+    const JsonSkipFunc skipFunc = LDtkLevelSkipOf(&options, false, &query.skip);
 
-    const Json json;
-    const JsonResult jsonResult = JsonParse(content, contentLength, JsonParseFlags_Default, buffer, bufferSize, (Json*)&json);
+    int32_t worldBufferSize;
+    const JsonResult jsonResult = JsonQueryMemorySkipping(content, contentLength, JsonParseFlags_InSitu, skipFunc, &query.skip, &worldBufferSize);
     if (jsonResult.error != JsonError_None)
     {
         const LDtkError error = { LDtkErrorCode_ParseJsonFailed, jsonResult.message };
         return error;
     }
 
-    Allocator allocator;
-    if (!InitAllocator(&allocator, (uint8_t*)buffer + jsonResult.memoryUsage, bufferSize - jsonResult.memoryUsage))
+	char levelDirectory[1024];
+	LDtkLevelDirectory(ldtkPath, levelDirectory);
+
+    query.content = content;
+    query.contentLength = contentLength;
+    query.readFileFn = readFileFn;
+    query.levelDirectory = levelDirectory;
+    query.scratch = content + contentLength + 1;
+    query.scratchOffset = contentLength + 1;
+    query.scratchSize = context.bufferSize - contentLength - 1;
+    query.levelIndex = (flags & LDtkParseFlags_LevelIndex) != 0;
+    query.options = &options;
+
+    char window[LDTK_READER_WINDOW_SIZE];
+    LDtkReaderSource source = { content, contentLength, 0 };
+
+    JsonReader reader;
+    JsonReader_Init(&reader, JsonParseFlags_None, window, sizeof(window), LDtkReaderRead, &source);
+
+    int32_t defsSize = 0;
+    int32_t levelsSize = 0;
+    if (JsonReader_EnterObject(&reader))
     {
-        const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small" };
-        return error;
-    }
+        bool foundDefs = false;
+        bool foundLevels = false;
 
-    const LDtkError readPropertiesError = LDtkReadWorldProperties(json, world);
-    if (readPropertiesError.code != LDtkErrorCode_None)
-    {
-        return readPropertiesError;
-    }
+        const char* name;
+        while (JsonReader_NextMember(&reader, &name))
+        {
+            if (!foundDefs && strcmp(name, "defs") == 0)
+            {
+                foundDefs = true;
+                defsSize = LDtkQueryDefs(&reader);
+            }
+            else if (!foundLevels && strcmp(name, "levels") == 0)
+            {
+                foundLevels = true;
 
-    const Json jsonDefs;
-    if (!JsonFind(json, "defs", (Json*)&jsonDefs))
-    {
-        const LDtkError error = { LDtkErrorCode_MissingWorldProperties, "'defs' is not found" };
-        return error;
+                const LDtkError error = LDtkQueryLevels(&query, &reader, &levelsSize);
+                if (error.code != LDtkErrorCode_None)
+                {
+                    return error;
+                }
+            }
+            else
+            {
+                JsonReader_SkipValue(&reader);
+            }
+        }
     }
 
-    LDtkError readDefsError;
-
-    readDefsError = LDtkReadEnums(jsonDefs, &allocator, world);
-    if (readDefsError.code != LDtkErrorCode_None)
+    if (reader.error != JsonError_None)
     {
-        return readDefsError;
+        const LDtkError error = { LDtkErrorCode_ParseJsonFailed, "Cannot read the world file" };
+        return error;
     }
 
-    readDefsError = LDtkReadTilesets(jsonDefs, &allocator, world);
-    if (readDefsError.code != LDtkErrorCode_None)
+    if (query.scratchNeed > 0)
     {
-        return readDefsError;
-    }
+        *outSize = query.scratchNeed;
 
-    readDefsError = LDtkReadLayerDefs(jsonDefs, &allocator, world);
-    if (readDefsError.code != LDtkErrorCode_None)
-    {
-        return readDefsError;
+        const LDtkError error = { LDtkErrorCode_OutOfMemory, "Buffer is too small for the level files" };
+        return error;
     }
 
-    readDefsError = LDtkReadEntityDefs(jsonDefs, &allocator, world);
-    if (readDefsError.code != LDtkErrorCode_None)
+    // Layout of LDtkParse: world file, alignment, JSON values then the blocks of the world
+    const int64_t levelsBufferSize = query.lower + query.upper > query.peak ? query.lower + query.upper : query.peak;
+    const int64_t worldSize = (int64_t)jsonResult.memoryUsage + defsSize + levelsSize + levelsBufferSize;
+    const int32_t adjustment = (16 - ((contentLength + 1) & 15)) & 15;
+    const int64_t totalSize = (int64_t)contentLength + 1 + adjustment + (worldSize > worldBufferSize ? worldSize : worldBufferSize);
+    if (totalSize > INT32_MAX)
     {
-        return readDefsError;
+        const LDtkError error = { LDtkErrorCode_OutOfMemory, "World is too large" };
+        return error;
     }
 
-    const LDtkError readLevelsError = LDtkReadLevels(json, ldtkPath, &allocator, readFileFn, flags, world);
-    if (readLevelsError.code != LDtkErrorCode_None)
-    {
-        return readLevelsError;
-    }
+    *outSize = (int32_t)totalSize;
 
     const LDtkError error = { LDtkErrorCode_None, "" };
     return error;
@@ -1433,7 +2973,12 @@ LDtkContext LDtkContextStdC(void* buffer, int32_t bufferSize)
 	LDtkContext result = {
 		.buffer = buffer,
 		.bufferSize = bufferSize,
-		.readFileFn = LDtkReadFileStdC
+		.readFileFn = LDtkReadFileStdC,
+		.parallelFor = NULL,
+		.allocChunk = NULL,
+		.chunkUserData = NULL,
+		.layerFilter = NULL,
+		.layerFilterUserData = NULL
 	};
 
 	return result;
@@ -1453,11 +2998,14 @@ static bool LDtkReadFileLinux(const char* fileName, void* buffer, int32_t* buffe
 		return false;
 	}
 
-	lseek(file, 0, SEEK_END);
-	off_t fileSize = tell(file);
+	off_t fileSize = lseek(file, 0, SEEK_END);
 	lseek(file, 0, SEEK_SET);
 
-	if (buffer)
+	if (!buffer)
+	{
+		result = (fileSize != -1);
+	}
+	else
 	{
 		if (*bufferSize < (int32_t)fileSize)
 		{
@@ -1480,7 +3028,12 @@ LDtkContext LDtkContextLinux(void* buffer, int32_t bufferSize)
 	LDtkContext result = {
 		.buffer = buffer,
 		.bufferSize = bufferSize,
-		.readFileFn = LDtkReadFileLinux
+		.readFileFn = LDtkReadFileLinux,
+		.parallelFor = NULL,
+		.allocChunk = NULL,
+		.chunkUserData = NULL,
+		.layerFilter = NULL,
+		.layerFilterUserData = NULL
 	};
 
 	return result;
@@ -1524,7 +3077,12 @@ LDtkContext LDtkContextWindows(void* buffer, int32_t bufferSize)
 	LDtkContext result = {
 		.buffer = buffer,
 		.bufferSize = bufferSize,
-		.readFileFn = LDtkReadFileWindows
+		.readFileFn = LDtkReadFileWindows,
+		.parallelFor = NULL,
+		.allocChunk = NULL,
+		.chunkUserData = NULL,
+		.layerFilter = NULL,
+		.layerFilterUserData = NULL
 	};
 
 	return result;
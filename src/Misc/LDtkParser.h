@@ -185,6 +185,11 @@ typedef struct LDtkLevel
 
     int32_t             neigbourCount[4];
     int32_t             neigbourIds[4][16];
+
+    // Level index, see LDtkParseFlags_LevelIndex
+    const char*         externalPath;   // Level file, relative to the working directory, NULL when the layers are in the world file
+    const void*         source;         // JSON of the level in the world buffer, NULL for the levels of a whole world
+    int32_t             memoryUsage;    // Bytes of the context buffer and chunks LDtkLoadLevel used
 } LDtkLevel;
 
 typedef struct LDtkLayerDef
@@ -251,6 +256,8 @@ typedef struct LDtkWorld
 
     int32_t         levelCount;
     LDtkLevel*      levels;
+
+    int32_t         memoryUsage;    // Bytes of the context buffer and chunks in use, file contents and JSON values included
 } LDtkWorld;
 
 typedef enum LDtkErrorCode
@@ -273,6 +280,11 @@ typedef enum LDtkErrorCode
 	LDtkErrorCode_UnnameError,
     LDtkErrorCode_OutOfMemory,
 	LDtkErrorCode_InternalError,
+
+	LDtkErrorCode_StaleCookedWorld,
+	LDtkErrorCode_InvalidCookedWorld,
+
+	LDtkErrorCode_UnknownLevel,
 } LDtkErrorCode;
 
 typedef struct LDtkError
@@ -283,18 +295,44 @@ typedef struct LDtkError
 
 typedef bool LDtkReadFileFn(const char* fileName, void* buffer, int32_t* bufferSize);
 
+/// Run func over [0, count) on worker threads, return when all ranges are done (JobSystem::ParallelFor)
+typedef void LDtkRangeFn(void* data, int32_t start, int32_t end);
+typedef void LDtkParallelForFn(LDtkRangeFn* func, void* data, int32_t count, int32_t batchSize);
+
+/// Get a chunk of at least minSize bytes, store its size in outSize, return NULL when out of memory
+typedef void* LDtkAllocChunkFn(void* userData, int32_t minSize, int32_t* outSize);
+
+/// Return false to leave the layer out of the world, layerName is its identifier
+typedef bool LDtkLayerFilterFn(void* userData, const char* layerName, LDtkLayerType type);
+
 typedef struct LDtkContext
 {
 	void*			buffer;
 	int32_t			bufferSize;
 
 	LDtkReadFileFn*	readFileFn;
+	LDtkParallelForFn* parallelFor;	// Optional, large JSON arrays of the world file and the external level files are parsed in parallel with it,
+									// readFileFn is called from its workers then
+
+	LDtkAllocChunkFn*	allocChunk;		// Optional, the parse continue in chunks when the buffer is full instead of failing, the caller free them
+	void*				chunkUserData;
+
+	LDtkLayerFilterFn*	layerFilter;	// Optional, the layers it return false for are left out like the ones the flags skip,
+										// it is called while the JSON is parsed, from the workers of parallelFor too
+	void*				layerFilterUserData;
 } LDtkContext;
 
 typedef enum LDtkParseFlags
 {
-    LDtkParseFlags_None,
-    LDtkParseFlags_LayerReverseOrder,
+    LDtkParseFlags_None                 = 0,
+    LDtkParseFlags_LayerReverseOrder    = 1 << 0,
+    LDtkParseFlags_LevelIndex           = 1 << 1,   // Levels are read without their layers, LDtkLoadLevel read them on demand
+
+    // Selective parse: what is skipped is passed over by the JSON parser, it is never built into JSON values
+    LDtkParseFlags_SkipEntityLayers     = 1 << 2,   // Layers of entities are left out
+    LDtkParseFlags_SkipAutoLayerTiles   = 1 << 3,   // IntGrid and AutoLayer layers have no tiles
+    LDtkParseFlags_SkipIntGridValues    = 1 << 4,   // IntGrid layers have no values
+    LDtkParseFlags_SkipBackground       = 1 << 5,   // Background fields of the levels are zero
 } LDtkParseFlags;
 
 LDtkContext		LDtkContextStdC(void* buffer, int32_t bufferSize);
@@ -308,6 +346,20 @@ LDtkContext		LDtkContextWindows(void* buffer, int32_t bufferSize);
 
 LDtkError		LDtkParse(const char* ldtkPath, LDtkContext context, LDtkParseFlags flags, LDtkWorld* world);
 
+/// Exact bufferSize LDtkParse need for this world in outSize, for a 16 bytes aligned buffer and a serial parse of the world file.
+/// context.buffer is a scratch for the query, it hold the world file and one external level file at a time.
+/// When it is too small, LDtkErrorCode_OutOfMemory is returned and outSize is the scratch size the query need.
+/// Only the JSON is checked, LDtkParse may still report an error.
+LDtkError		LDtkQueryMemory(const char* ldtkPath, LDtkContext context, LDtkParseFlags flags, int32_t* outSize);
+
+/// Read the layers of a level of a level index in context.buffer, the world buffer must stay alive.
+/// When no chunk is needed, the bytes in use are the first level->memoryUsage bytes of the buffer.
+/// Nothing is read for the levels which have their layers, LDtkErrorCode_UnknownLevel when levelId is not in the world.
+LDtkError		LDtkLoadLevel(LDtkWorld* world, int32_t levelId, LDtkContext context, LDtkParseFlags flags);
+
+/// Forget the layers LDtkLoadLevel read, its buffer can be freed then. The levels of a whole world are kept.
+void			LDtkUnloadLevel(LDtkWorld* world, int32_t levelId);
+
 #ifdef __cplusplus
 }
 #endif
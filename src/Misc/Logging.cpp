@@ -2,7 +2,8 @@
 
 #include <stdio.h>
 #include <stdarg.h>
-#include "Text/String.h"
+#include <string.h>
+#include "Text/StringBuilder.h"
 #include "Misc/Logging.h"
 #include "Native/Memory.h"
 
@@ -26,7 +27,8 @@ static Logger s_defaultLogger = {
 static Logger* s_rootLogger = &s_defaultLogger;
 static Logger* s_lastLogger = &s_defaultLogger;
 
-static char s_logBuffer[4096];
+// Average text size of a record, used to size the text storage of LogStorage blocks
+constexpr int LOG_STORAGE_TEXT_SIZE_PER_RECORD = 96;
 
 void LogAllLoggers(LogLevel level, const char* tag, const char* text)
 {
@@ -36,15 +38,23 @@ void LogAllLoggers(LogLevel level, const char* tag, const char* text)
     }
 }
 
+static void Log_WriteV(LogLevel level, const char* tag, const char* fmt, va_list arg)
+{
+    // Format on the stack, long lines spill to the temporary strings
+    StringBuilder builder;
+    StringBuilder_Init(&builder, String_GetTempArena());
+    StringBuilder_AppendFormatV(&builder, fmt, arg);
+
+    LogAllLoggers(level, tag, StringBuilder_GetString(&builder));
+
+    StringBuilder_CleanUp(&builder);
+}
+
 void Log_InfoImpl(const char* tag, const char* fmt, ...)
 {
     va_list arg;
     va_start(arg, fmt);
-    
-    vsprintf(s_logBuffer, fmt, arg);
-    
-    LogAllLoggers(LogLevel_Info, tag, s_logBuffer);
-
+    Log_WriteV(LogLevel_Info, tag, fmt, arg);
     va_end(arg);
 }
 
@@ -52,11 +62,7 @@ void Log_WarnImpl(const char* tag, const char* fmt, ...)
 {
     va_list arg;
     va_start(arg, fmt);
-    
-    vsprintf(s_logBuffer, fmt, arg);
-    
-    LogAllLoggers(LogLevel_Warn, tag, s_logBuffer);
-
+    Log_WriteV(LogLevel_Warn, tag, fmt, arg);
     va_end(arg);
 }
 
@@ -64,11 +70,7 @@ void Log_ErrorImpl(const char* tag, const char* fmt, ...)
 {
     va_list arg;
     va_start(arg, fmt);
-    
-    vsprintf(s_logBuffer, fmt, arg);
-    
-    LogAllLoggers(LogLevel_Error, tag, s_logBuffer);
-
+    Log_WriteV(LogLevel_Error, tag, fmt, arg);
     va_end(arg);
 }
 
@@ -101,17 +103,17 @@ Logger* Log_GetLastLogger(void)
     return s_rootLogger;
 }
 
-LogStorage* LogStorage_Create(int recordCount)
+static LogStorage* LogStorage_CreateBlock(int recordCount, int textSize)
 {
     const int HEADER_REVERSE = sizeof(LogStorage);
-    const int allocSize = HEADER_REVERSE + recordCount * sizeof(LogRecord);
+    const int allocSize = HEADER_REVERSE + recordCount * sizeof(LogRecord) + textSize;
     void* block = Memory_AllocTag("LogStorage", allocSize, alignof(LogRecord));
     
     LogStorage* storage = (LogStorage*)block;
 
     LogRecord* first = (LogRecord*)((char*)block + HEADER_REVERSE);
     LogRecord* record = first;
-    for (int i = 0; i < recordCount; i++)
+    for (int i = 0; i < recordCount - 1; i++)
     {
         record = record->next = record + 1;
     }
@@ -122,22 +124,26 @@ LogStorage* LogStorage_Create(int recordCount)
     storage->tail = NULL;
     storage->free = first;
 
+    storage->texts = (char*)(first + recordCount);
+    storage->textSize = textSize;
+    storage->textUsed = 0;
+
     storage->prev = NULL;
     storage->current = storage;
 
     return storage;
 }
 
+LogStorage* LogStorage_Create(int recordCount)
+{
+    return LogStorage_CreateBlock(recordCount, recordCount * LOG_STORAGE_TEXT_SIZE_PER_RECORD);
+}
+
 void LogStorage_Destroy(LogStorage* storage)
 {
     storage = storage->current;
     while (storage != NULL)
     {
-        for (LogRecord* record = storage->head; record != nullptr; record = record->next)
-        {
-            String_Free(record->text);
-        }
-
         LogStorage* prev = storage->prev;
         Memory_FreeTag("LogStorage", storage);
         storage = prev;
@@ -146,31 +152,48 @@ void LogStorage_Destroy(LogStorage* storage)
 
 void LogStorage_AddRecord(LogStorage* storage, LogLevel level, const char* tag, const char* text)
 {
+    const int tagLength = (int)strlen(tag);
+    const int textLength = (int)strlen(text);
+    const int copySize = tagLength + textLength + 2;
+
+    // Chain a new block when records or texts are full, blocks are released together
     LogStorage* current = storage->current;
-    if (current->free == NULL)
+    if (current->free == NULL || current->textUsed + copySize > current->textSize)
     {
-        storage->current = LogStorage_Create(storage->count);
-        current->current = storage->current;
-        current = current->current;
+        const int textSize = storage->count * LOG_STORAGE_TEXT_SIZE_PER_RECORD;
+        LogStorage* block = LogStorage_CreateBlock(storage->count, copySize > textSize ? copySize : textSize);
+        block->prev = current;
+
+        storage->current = block;
+        current = block;
     }
 
-    LogRecord* result = storage->free;
-    if (current->tail)
+    LogRecord* result = current->free;
+    current->free = result->next;
+
+    // All records are listed from the first block
+    if (storage->tail)
     {
-        current->tail->next = result;
+        storage->tail->next = result;
     }
     else
     {
-        current->head = result;
+        storage->head = result;
     }
-
-    current->free   = current->free->next;
-    current->tail   = result;
+    storage->tail   = result;
     result->next    = NULL;
 
+    char* tagCopy = current->texts + current->textUsed;
+    memcpy(tagCopy, tag, tagLength + 1);
+
+    char* textCopy = tagCopy + tagLength + 1;
+    memcpy(textCopy, text, textLength + 1);
+
+    current->textUsed += copySize;
+
     result->level   = level;
-    result->tag     = String_Ref(tag);
-    result->text    = String_New(text);
+    result->tag     = tagCopy;
+    result->text    = textCopy;
 
     //return result;
 }
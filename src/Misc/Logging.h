@@ -26,6 +26,9 @@ struct LogRecord
     const char*     text;
 };
 
+/// LogStorage
+/// Records and their tags and texts are stored in blocks, strings are packed after the records
+/// so adding a record does not allocate until the block is full.
 typedef struct LogStorage LogStorage;
 struct LogStorage
 {
@@ -34,6 +37,10 @@ struct LogStorage
     LogRecord*      tail;
     LogRecord*      free;
 
+    char*           texts;
+    int             textSize;
+    int             textUsed;
+
     LogStorage*     prev;
     LogStorage*     current;
 };
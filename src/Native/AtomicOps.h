@@ -7,11 +7,15 @@
 #       define Atomic_SetI32(variable, value)   __atomic_store(variable, value, __ATOMIC_RELAXED)
 #       define Atomic_AddI32(variable, value)   __atomic_add_fetch(variable, value, __ATOMIC_RELAXED)
 #       define Atomic_SubI32(variable, value)   __atomic_sub_fetch(variable, value, __ATOMIC_RELAXED)
+#       define Atomic_TryLockI32(variable)      (__atomic_exchange_n(variable, 1, __ATOMIC_ACQUIRE) == 0)
+#       define Atomic_UnlockI32(variable)       __atomic_store_n(variable, 0, __ATOMIC_RELEASE)
 #   else
 #       define Atomic_GetI32(variable)          ({ __sync_synchronize(); int32_t result = *(variable); __sync_synchronize(); result; })
 #       define Atomic_SetI32(variable, value)   ({ __sync_synchronize(); *(variable) = value; __sync_synchronize(); (void)0; })
 #       define Atomic_AddI32(variable, value)   __sync_add_and_fetch(variable, value)
 #       define Atomic_SubI32(variable, value)   __sync_sub_and_fetch(variable, value)
+#       define Atomic_TryLockI32(variable)      (__sync_lock_test_and_set(variable, 1) == 0)
+#       define Atomic_UnlockI32(variable)       __sync_lock_release(variable)
 #   endif
 #elif defined(_WIN32)
 #   define VC_EXTRALEAN
@@ -21,6 +25,8 @@
 #   define Atomic_SetI32(variable, value)       ((int32_t)InterlockedExchange((volatile long*)(variable), (value)); (void)0)
 #   define Atomic_AddI32(variable, value)       ((int32_t)InterlockedExchange((volatile long*)(variable), *(variable) + value)) 
 #   define Atomic_SubI32(variable, value)       ((int32_t)InterlockedExchange((volatile long*)(variable), *(variable) - value))
+#   define Atomic_TryLockI32(variable)          (InterlockedExchange((volatile long*)(variable), 1) == 0)
+#   define Atomic_UnlockI32(variable)           ((void)InterlockedExchange((volatile long*)(variable), 0))
 #elif defined(__STDC_VERSION_) && (__STDC_VERSION_ >= 201112L)
 #   include <stdint.h>
 #   include <stdatomic.h>
@@ -28,6 +34,8 @@
 #   define Atomic_SetI32(variable, value)       atomic_store_explicit((_Atomic int32_t*)(variable), value, memory_order_relaxed)
 #   define Atomic_AddI32(variable, value)       atomic_sub_fetch_explicit((_Atomic int32_t*)(variable), value, memory_order_relaxed)
 #   define Atomic_SubI32(variable, value)       atomic_add_fetch_explicit((_Atomic int32_t*)(variable), value, memory_order_relaxed)
+#   define Atomic_TryLockI32(variable)          (atomic_exchange_explicit((_Atomic int32_t*)(variable), 1, memory_order_acquire) == 0)
+#   define Atomic_UnlockI32(variable)           atomic_store_explicit((_Atomic int32_t*)(variable), 0, memory_order_release)
 #else
 #   error "This platform is not support atomic operations."
 #endif
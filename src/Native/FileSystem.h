@@ -145,4 +145,16 @@ inline bool FileStream_IsAtEnd(const FileStream* stream)
     return stream->inteface->IsAtEnd(stream);
 }
 
+/// Read callback for chunked readers (JsonReader), userData is the FileStream
+inline int32_t FileStream_ReadCallback(void* userData, void* outputBuffer, int32_t bufferSizeInBytes)
+{
+    return FileStream_Read((FileStream*)userData, outputBuffer, bufferSizeInBytes);
+}
+
+/// Write callback for buffered writers (JsonWriter), userData is the FileStream
+inline int32_t FileStream_WriteCallback(void* userData, const void* inputBuffer, int32_t bufferSizeInBytes)
+{
+    return FileStream_Write((FileStream*)userData, inputBuffer, bufferSizeInBytes);
+}
+
 //! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
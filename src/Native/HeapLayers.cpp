@@ -3,7 +3,6 @@
 #include <assert.h>
 
 #include "HeapLayers.h"
-#include <SDL2/SDL.h>
 
 #if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN
@@ -19,7 +18,8 @@ void* PagedHeap::Alloc(int32_t size)
 #if defined(_WIN32)
     return VirtualAlloc(nullptr, (SIZE_T)size, MEM_COMMIT, PAGE_READWRITE);
 #elif defined(__unix__)
-    return mmap(nullptr, (size_t)allocSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, 0, 0);
+    void* ptr = mmap(nullptr, (size_t)size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return ptr != MAP_FAILED ? ptr : nullptr;
 #endif
 }
 
@@ -28,7 +28,8 @@ void* PagedHeap::Realloc(void* ptr, int32_t size)
 #if defined(_WIN32)
     return VirtualAlloc(ptr, (SIZE_T)size, MEM_COMMIT, PAGE_READWRITE);
 #elif defined(__unix__)
-    return mmap(ptr, (size_t)allocSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, 0, 0);
+    void* newPtr = mmap(ptr, (size_t)size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return newPtr != MAP_FAILED ? newPtr : nullptr;
 #endif
 }
 
@@ -52,18 +53,28 @@ void* PagedFreeList::Alloc(int32_t size)
     if (!freeItem)
     {
         const int32_t itemSize = size;
-        const int32_t allocSize = 64 * 1024;
-        const int32_t itemsPerBatch = (allocSize - sizeof(Page)) / itemSize;
+        const int32_t allocSize = PAGE_SIZE;
+        const int32_t itemsPerBatch = (allocSize - (int32_t)sizeof(Page)) / itemSize;
+        assert(itemsPerBatch > 0 && "Item size is too big for a page");
 
     #if defined(_WIN32)
-        Page* page = (Page*)VirtualAlloc(nullptr, (SIZE_T)allocSize, MEM_COMMIT, PAGE_READWRITE);
+        Page* page = (Page*)VirtualAlloc(nullptr, (SIZE_T)allocSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+        if (page == nullptr)
+        {
+            return nullptr;
+        }
     #elif defined(__unix__)
-        Page* page = (Page*)mmap(nullptr, (size_t)allocSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, 0, 0);
+        Page* page = (Page*)mmap(nullptr, (size_t)allocSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (page == MAP_FAILED)
+        {
+            return nullptr;
+        }
     #else
         #error "The current system doesnot support paged allocations"
     #endif
 
         page->Next = allocedPages;
+        page->pageSize = allocSize;
         page->itemSize = size;
         allocedPages = page;
 
@@ -92,16 +103,16 @@ int32_t PagedFreeList::GetSize(void* ptr) const
     return 0;
 }
 
-PagedFreeList::~PagedFreeList()
+void PagedFreeList::CleanUp(void)
 {
     Page* page = allocedPages;
     while (page != nullptr)
     {
         Page* next = page->Next;
     #if defined(_WIN32)
-        //VirtualFree(page, 0, MEM_DECOMMIT);
-    #else
-
+        VirtualFree(page, 0, MEM_RELEASE);
+    #elif defined(__unix__)
+        munmap(page, (size_t)page->pageSize);
     #endif
         page = next;
     }
@@ -109,3 +120,8 @@ PagedFreeList::~PagedFreeList()
     freeItem = nullptr;
     allocedPages = nullptr;
 }
+
+PagedFreeList::~PagedFreeList()
+{
+    CleanUp();
+}
@@ -12,20 +12,24 @@ struct SizeHeap : public SuperHeap
     inline void* Alloc(int32_t size)
     {
         int32_t* item = (int32_t*)SuperHeap::Alloc(sizeof(int32_t) + size);
-        if (item)
+        if (!item)
         {
-            *item = size;
+            return nullptr;
         }
+
+        *item = size;
         return item + 1;
     }
 
     inline void* Realloc(void* ptr, int32_t size)
     {
-        int32_t* newItem = (int32_t*)SuperHeap::Realloc(ptr ? ((int32_t*)ptr - 1) : nullptr, sizeof(int32_t));
-        if (newItem)
+        int32_t* newItem = (int32_t*)SuperHeap::Realloc(ptr ? ((int32_t*)ptr - 1) : nullptr, sizeof(int32_t) + size);
+        if (!newItem)
         {
-            *newItem = size;
+            return nullptr;
         }
+
+        *newItem = size;
         return newItem + 1;
     }
 
@@ -150,6 +154,8 @@ struct PagedHeap
 
 struct PagedFreeList
 {
+    static constexpr int32_t PAGE_SIZE = 64 * 1024;
+
     struct Item
     {
         Item*       next;
@@ -170,6 +176,9 @@ struct PagedFreeList
     void            Free(void* ptr);
     int32_t         GetSize(void* ptr) const;
 
+    // Release all pages back to the system, every items become invalid
+    void            CleanUp(void);
+
                     ~PagedFreeList();
 
     inline PagedFreeList()
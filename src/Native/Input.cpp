@@ -2,6 +2,7 @@
 #include <SDL2/SDL.h>
 
 #include "Input.h"
+#include "Text/Utf8.h"
 
 #define COUNTOF(x) (sizeof(x) / sizeof((x)[0]))
 
@@ -179,6 +180,9 @@ void Input_UpdateTextInput(const char* string)
         length = sizeof(gInputText) - gInputTextLength - 1;
     }
 
+    // Keep whole code points only, drop invalid input and characters cut by the truncation
+    length = Utf8_ValidPrefix(string, length);
+
     memcpy(gInputText + gInputTextLength, string, length);
     gInputTextLength += length;
 
@@ -9,12 +9,70 @@
 #include "HeapLayers.h"
 #include "Misc/Logging.h"
 
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#elif defined(__unix__)
+#include <dlfcn.h>
+#include <malloc.h>
+#include <unistd.h>
+#include <execinfo.h>
+#include <sys/mman.h>
+#endif
+
+#if !defined(_WIN32)
+// POSIX version of MSVC aligned allocations, malloc already align to max_align_t
+static inline void* _aligned_malloc(size_t size, size_t align)
+{
+    if (align <= alignof(max_align_t))
+    {
+        return malloc(size);
+    }
+
+    void* ptr = nullptr;
+    return posix_memalign(&ptr, align, size) == 0 ? ptr : nullptr;
+}
+
+static inline void* _aligned_realloc(void* ptr, size_t size, size_t align)
+{
+    if (align <= alignof(max_align_t))
+    {
+        return realloc(ptr, size);
+    }
+
+    void* newPtr = _aligned_malloc(size, align);
+    if (newPtr && ptr)
+    {
+        const size_t oldSize = malloc_usable_size(ptr);
+        memcpy(newPtr, ptr, oldSize < size ? oldSize : size);
+        free(ptr);
+    }
+    return newPtr;
+}
+
+static inline void _aligned_free(void* ptr)
+{
+    free(ptr);
+}
+#endif
+
 #if !defined(NDEBUG)
 
 // ----------------------
 // Internal types
 // ----------------------
 
+constexpr int32_t CALLSTACK_MAX_DEPTH = 32;
+
+struct CallStack
+{
+    uint32_t            hash;
+    int32_t             depth;
+    void*               frames[CALLSTACK_MAX_DEPTH];
+
+    struct CallStack*   next;
+};
+
 struct AllocDesc
 {
     void*               ptr;
@@ -32,6 +90,13 @@ struct AllocDesc
     int32_t             modifiedCount;
     int32_t             addressChangedCount;
 
+    void*               guardBase;      // Mapped region when allocated in guard pages mode
+    int32_t             guardSize;
+    MemoryGuardFlags    guardFlags;
+
+    int64_t             serial;         // Allocation order, used by MemoryTracker
+    const CallStack*    callStack;      // Owner call stack, shared between allocations
+
     struct AllocDesc*   next;
 };
 
@@ -45,6 +110,7 @@ static struct
     PagedFreeList   freeAllocDescs;
     AllocDesc*      hashAllocDescs[ALLOC_DESC_COUNT];
 
+    int64_t         allocSerial = 0;
     int32_t         allocSize = 0;
     int32_t         allocations = 0;
     int32_t         allocCalled = 0;
@@ -52,7 +118,134 @@ static struct
     int32_t         freeCalled = 0;
 } gAllocStore;
 
-static void AddAlloc(void* ptr, int32_t size, int32_t align, const char* tag, const char* func, const char* file, int32_t line)
+static AllocDesc* FindAlloc(void* ptr)
+{
+    uint64_t ptrHash = ((uint64_t)ptr) & (ALLOC_DESC_COUNT - 1);
+
+    AllocDesc* allocDesc = gAllocStore.hashAllocDescs[ptrHash];
+    while (allocDesc != nullptr && allocDesc->ptr != ptr)
+    {
+        allocDesc = allocDesc->next;
+    }
+
+    return allocDesc;
+}
+
+// ----------------------------
+// Call stacks helpers
+// ----------------------------
+
+constexpr int32_t CALLSTACK_HASH_COUNT = 4096;
+static struct
+{
+    PagedFreeList   freeCallStacks;
+    CallStack*      hashCallStacks[CALLSTACK_HASH_COUNT];
+
+    int32_t         depth = 12;
+    int32_t         callStackCount = 0;
+    const char*     leakReportPath = "memory_leaks.json";
+} gCallStackStore;
+
+// Capture the call stack of the caller of Memory_*Debug, deduplicated in the stack table
+// @note: must be called directly from Memory_*Debug
+static __noinline const CallStack* CaptureCallStack(void)
+{
+    if (gCallStackStore.depth <= 0)
+    {
+        return nullptr;
+    }
+
+    // Skip CaptureCallStack and Memory_*Debug frames
+    constexpr int32_t SKIP_FRAMES = 2;
+
+    void* frames[CALLSTACK_MAX_DEPTH + SKIP_FRAMES];
+#if defined(_WIN32)
+    int32_t depth = (int32_t)RtlCaptureStackBackTrace(SKIP_FRAMES, (DWORD)gCallStackStore.depth, frames, nullptr);
+    void** ownerFrames = frames;
+#elif defined(__unix__)
+    int32_t depth = backtrace(frames, gCallStackStore.depth + SKIP_FRAMES) - SKIP_FRAMES;
+    void** ownerFrames = frames + SKIP_FRAMES;
+#else
+    int32_t depth = 0;
+    void** ownerFrames = frames;
+#endif
+    if (depth <= 0)
+    {
+        return nullptr;
+    }
+
+    // FNV-1a over frame addresses
+    uint32_t hash = 2166136261u;
+    for (int32_t i = 0; i < depth; i++)
+    {
+        hash = (hash ^ (uint32_t)((uintptr_t)ownerFrames[i] >> 2)) * 16777619u;
+    }
+
+    CallStack** bucket = &gCallStackStore.hashCallStacks[hash & (CALLSTACK_HASH_COUNT - 1)];
+    for (CallStack* callStack = *bucket; callStack != nullptr; callStack = callStack->next)
+    {
+        if (callStack->hash == hash
+            && callStack->depth == depth
+            && memcmp(callStack->frames, ownerFrames, sizeof(void*) * depth) == 0)
+        {
+            return callStack;
+        }
+    }
+
+    CallStack* callStack = (CallStack*)gCallStackStore.freeCallStacks.Alloc(sizeof(CallStack));
+    if (!callStack)
+    {
+        return nullptr;
+    }
+
+    callStack->hash = hash;
+    callStack->depth = depth;
+    memcpy(callStack->frames, ownerFrames, sizeof(void*) * depth);
+
+    callStack->next = *bucket;
+    *bucket = callStack;
+
+    gCallStackStore.callStackCount++;
+    return callStack;
+}
+
+// Find the module contain the address, for offline symbolization
+static const char* GetFrameModule(void* frame, uintptr_t* outModuleBase)
+{
+#if defined(_WIN32)
+    static char modulePath[MAX_PATH];
+
+    HMODULE module = nullptr;
+    if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCSTR)frame, &module)
+        && GetModuleFileNameA(module, modulePath, sizeof(modulePath)) > 0)
+    {
+        *outModuleBase = (uintptr_t)module;
+        return modulePath;
+    }
+#elif defined(__unix__)
+    Dl_info info;
+    if (dladdr(frame, &info) && info.dli_fname)
+    {
+        *outModuleBase = (uintptr_t)info.dli_fbase;
+        return info.dli_fname;
+    }
+#endif
+
+    *outModuleBase = 0;
+    return "?";
+}
+
+void Memory_SetCallStackDepth(int32_t depth)
+{
+    gCallStackStore.depth = depth < 0 ? 0 : (depth > CALLSTACK_MAX_DEPTH ? CALLSTACK_MAX_DEPTH : depth);
+}
+
+void Memory_SetLeakReportPath(const char* path)
+{
+    gCallStackStore.leakReportPath = path;
+}
+
+static AllocDesc* AddAlloc(void* ptr, int32_t size, int32_t align, const char* tag, const char* func, const char* file, int32_t line, const CallStack* callStack)
 {
     AllocDesc* allocDesc = (AllocDesc*)gAllocStore.freeAllocDescs.Alloc(sizeof(AllocDesc));
 
@@ -71,15 +264,24 @@ static void AddAlloc(void* ptr, int32_t size, int32_t align, const char* tag, co
     allocDesc->modifiedCount = 0;
     allocDesc->addressChangedCount = 0;
 
+    allocDesc->guardBase = nullptr;
+    allocDesc->guardSize = 0;
+    allocDesc->guardFlags = MemoryGuardFlags_None;
+
+    allocDesc->serial = ++gAllocStore.allocSerial;
+    allocDesc->callStack = callStack;
+
     uint64_t ptrHash = ((uint64_t)ptr) & (ALLOC_DESC_COUNT - 1);
     allocDesc->next = gAllocStore.hashAllocDescs[ptrHash];
     gAllocStore.hashAllocDescs[ptrHash] = allocDesc;
 
     gAllocStore.allocSize += size;
     gAllocStore.allocations++;
+
+    return allocDesc;
 }
 
-static void UpdateAlloc(void* ptr, void* newPtr, int32_t size, int32_t align, const char* tag, const char* func, const char* file, int32_t line)
+static AllocDesc* UpdateAlloc(void* ptr, void* newPtr, int32_t size, int32_t align, const char* tag, const char* func, const char* file, int32_t line)
 {
     uint64_t ptrHash = ((uint64_t)ptr) & (ALLOC_DESC_COUNT - 1);
 
@@ -92,7 +294,10 @@ static void UpdateAlloc(void* ptr, void* newPtr, int32_t size, int32_t align, co
     }
 
     assert(allocDesc != nullptr && "This block is not allocated by our system, please check your memory source!");
-    assert(strcmp(allocDesc->tag, tag) != 0 && "You attempt free memory with difference tag when allocated!");
+    assert(strcmp(allocDesc->tag, tag) == 0 && "You attempt free memory with difference tag when allocated!");
+
+    gAllocStore.allocSize -= allocDesc->size;
+    gAllocStore.allocSize += size;
 
     allocDesc->ptr = newPtr;
     allocDesc->size = size;
@@ -104,9 +309,6 @@ static void UpdateAlloc(void* ptr, void* newPtr, int32_t size, int32_t align, co
     allocDesc->modifiedCount++;
     allocDesc->addressChangedCount += (ptr != newPtr);
 
-    gAllocStore.allocSize -= allocDesc->size;
-    gAllocStore.allocSize += size;
-
     uint64_t newPtrHash = ((uint64_t)newPtr) & (ALLOC_DESC_COUNT - 1);
     if (newPtrHash != ptrHash)
     {
@@ -122,9 +324,11 @@ static void UpdateAlloc(void* ptr, void* newPtr, int32_t size, int32_t align, co
         allocDesc->next = gAllocStore.hashAllocDescs[newPtrHash];
         gAllocStore.hashAllocDescs[newPtrHash] = allocDesc;
     }
+
+    return allocDesc;
 }
 
-static void RemoveAlloc(void* ptr, const char* tag, const char* func, const char* file, int32_t line)
+static void RemoveAlloc(void* ptr, const char* tag, const char* func, const char* file, int32_t line, AllocDesc* outAllocDesc)
 {
     uint64_t ptrHash = ((uint64_t)ptr) & (ALLOC_DESC_COUNT - 1);
 
@@ -137,9 +341,7 @@ static void RemoveAlloc(void* ptr, const char* tag, const char* func, const char
     }
 
     assert(allocDesc != nullptr && "This block is not allocated by our system! Are you attempt to double-free?");
-    assert(strcmp(allocDesc->tag, tag) != 0 && "You attempt free memory with difference tag when allocated!");
-
-    gAllocStore.freeAllocDescs.Free(allocDesc);
+    assert(strcmp(allocDesc->tag, tag) == 0 && "You attempt free memory with difference tag when allocated!");
 
     if (prevAllocDesc)
     {
@@ -152,16 +354,187 @@ static void RemoveAlloc(void* ptr, const char* tag, const char* func, const char
 
     gAllocStore.allocSize -= allocDesc->size;
     gAllocStore.allocations--;
+
+    *outAllocDesc = *allocDesc;
+    gAllocStore.freeAllocDescs.Free(allocDesc);
+}
+
+// ----------------------------
+// Guard pages helpers
+// ----------------------------
+
+constexpr int32_t GUARD_TAG_COUNT           = 32;
+constexpr int32_t GUARD_QUARANTINE_COUNT    = 256;
+
+static struct
+{
+    const char*         tags[GUARD_TAG_COUNT];
+    MemoryGuardFlags    flags[GUARD_TAG_COUNT];
+    int32_t             tagCount;
+
+    // Freed regions stay mapped but inaccessible until they are evicted
+    void*               quarantineBases[GUARD_QUARANTINE_COUNT];
+    int32_t             quarantineSizes[GUARD_QUARANTINE_COUNT];
+    int32_t             quarantineIndex;
+} gGuardStore;
+
+static MemoryGuardFlags FindGuardFlags(const char* tag)
+{
+    MemoryGuardFlags wildcardFlags = MemoryGuardFlags_None;
+    for (int32_t i = 0; i < gGuardStore.tagCount; i++)
+    {
+        const char* guardTag = gGuardStore.tags[i];
+        if (guardTag == tag || strcmp(guardTag, tag) == 0)
+        {
+            return gGuardStore.flags[i];
+        }
+
+        if (guardTag[0] == '*' && guardTag[1] == '\0')
+        {
+            wildcardFlags = gGuardStore.flags[i];
+        }
+    }
+
+    return wildcardFlags;
+}
+
+static void* GuardMapPages(int32_t size)
+{
+#if defined(_WIN32)
+    return VirtualAlloc(nullptr, (SIZE_T)size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#elif defined(__unix__)
+    void* pages = mmap(nullptr, (size_t)size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return pages != MAP_FAILED ? pages : nullptr;
+#else
+    return nullptr;
+#endif
+}
+
+static void GuardProtectPages(void* pages, int32_t size)
+{
+#if defined(_WIN32)
+    DWORD oldProtect;
+    VirtualProtect(pages, (SIZE_T)size, PAGE_NOACCESS, &oldProtect);
+#elif defined(__unix__)
+    mprotect(pages, (size_t)size, PROT_NONE);
+#endif
+}
+
+static void GuardUnmapPages(void* pages, int32_t size)
+{
+#if defined(_WIN32)
+    (void)size;
+    VirtualFree(pages, 0, MEM_RELEASE);
+#elif defined(__unix__)
+    munmap(pages, (size_t)size);
+#endif
+}
+
+// Allocate block against a guard page, the whole region is [*outBase, *outBase + *outSize)
+static void* GuardAlloc(int32_t size, int32_t align, MemoryGuardFlags flags, void** outBase, int32_t* outSize)
+{
+    assert(align > 0 && (align & (align - 1)) == 0 && "Alignment must be power of two");
+
+    const int32_t pageSize = Memory_PageSize();
+    const int32_t blockSize = (size + pageSize - 1) & ~(pageSize - 1);
+    const int32_t regionSize = blockSize + pageSize;
+
+    uint8_t* base = (uint8_t*)GuardMapPages(regionSize);
+    if (!base)
+    {
+        return nullptr;
+    }
+
+    uint8_t* ptr;
+    if (flags & MemoryGuardFlags_Underrun)
+    {
+        // [guard][block....]
+        GuardProtectPages(base, pageSize);
+        ptr = base + pageSize;
+    }
+    else
+    {
+        // [....block][guard], alignment may leave a few bytes of slack before the guard
+        GuardProtectPages(base + blockSize, pageSize);
+        ptr = (uint8_t*)((uintptr_t)(base + blockSize - size) & ~(uintptr_t)(align - 1));
+    }
+
+    *outBase = base;
+    *outSize = regionSize;
+    return ptr;
+}
+
+static void GuardFree(void* base, int32_t size, MemoryGuardFlags flags)
+{
+    if ((flags & MemoryGuardFlags_DelayReuse) == 0)
+    {
+        GuardUnmapPages(base, size);
+        return;
+    }
+
+    GuardProtectPages(base, size);
+
+    const int32_t index = gGuardStore.quarantineIndex;
+    if (gGuardStore.quarantineBases[index])
+    {
+        GuardUnmapPages(gGuardStore.quarantineBases[index], gGuardStore.quarantineSizes[index]);
+    }
+
+    gGuardStore.quarantineBases[index] = base;
+    gGuardStore.quarantineSizes[index] = size;
+    gGuardStore.quarantineIndex = (index + 1) % GUARD_QUARANTINE_COUNT;
 }
 
+void Memory_SetGuardTag(const char* tag, MemoryGuardFlags flags)
+{
+    assert(tag != nullptr && "Tag must not be null");
+
+    for (int32_t i = 0; i < gGuardStore.tagCount; i++)
+    {
+        if (strcmp(gGuardStore.tags[i], tag) == 0)
+        {
+            gGuardStore.flags[i] = flags;
+            return;
+        }
+    }
+
+    assert(gGuardStore.tagCount < GUARD_TAG_COUNT && "Too many guard tags");
+    if (gGuardStore.tagCount < GUARD_TAG_COUNT)
+    {
+        gGuardStore.tags[gGuardStore.tagCount] = tag;
+        gGuardStore.flags[gGuardStore.tagCount] = flags;
+        gGuardStore.tagCount++;
+    }
+}
+
+// ----------------------------
+// Debug allocations
+// ----------------------------
+
 void* Memory_AllocDebug(const char* tag, int32_t size, int32_t align, const char* func, const char* file, int32_t line)
 {
     assert(size > 0 && "Request size must be greater than 0.");
 
     gAllocStore.allocCalled++;
 
+    const MemoryGuardFlags guardFlags = FindGuardFlags(tag);
+    if (guardFlags != MemoryGuardFlags_None)
+    {
+        void* guardBase;
+        int32_t guardSize;
+        void* ptr = GuardAlloc(size, align, guardFlags, &guardBase, &guardSize);
+        if (ptr)
+        {
+            AllocDesc* allocDesc = AddAlloc(ptr, size, align, tag, func, file, line, CaptureCallStack());
+            allocDesc->guardBase = guardBase;
+            allocDesc->guardSize = guardSize;
+            allocDesc->guardFlags = guardFlags;
+        }
+        return ptr;
+    }
+
     void* ptr = _aligned_malloc((size_t)size, (size_t)align);
-    AddAlloc(ptr, size, align, tag, func, file, line);
+    AddAlloc(ptr, size, align, tag, func, file, line, CaptureCallStack());
     return ptr;
 }
 
@@ -171,10 +544,54 @@ void* Memory_ReallocDebug(const char* tag, void* ptr, int32_t size, int32_t alig
 
     gAllocStore.reallocCalled++;
 
+    const MemoryGuardFlags guardFlags = FindGuardFlags(tag);
+    const AllocDesc* oldAllocDesc = ptr ? FindAlloc(ptr) : nullptr;
+    if (guardFlags != MemoryGuardFlags_None || (oldAllocDesc && oldAllocDesc->guardBase))
+    {
+        // Guarded blocks cannot grow in place, move to a new block
+        assert(!ptr || (oldAllocDesc != nullptr && "This block is not allocated by our system, please check your memory source!"));
+
+        void* guardBase = nullptr;
+        int32_t guardSize = 0;
+        void* newPtr = guardFlags != MemoryGuardFlags_None
+            ? GuardAlloc(size, align, guardFlags, &guardBase, &guardSize)
+            : _aligned_malloc((size_t)size, (size_t)align);
+        if (!newPtr)
+        {
+            return nullptr;
+        }
+
+        if (ptr == nullptr)
+        {
+            AllocDesc* allocDesc = AddAlloc(newPtr, size, align, tag, func, file, line, CaptureCallStack());
+            allocDesc->guardBase = guardBase;
+            allocDesc->guardSize = guardSize;
+            allocDesc->guardFlags = guardFlags;
+            return newPtr;
+        }
+
+        const AllocDesc oldBlock = *oldAllocDesc;
+        memcpy(newPtr, ptr, (size_t)(oldBlock.size < size ? oldBlock.size : size));
+        if (oldBlock.guardBase)
+        {
+            GuardFree(oldBlock.guardBase, oldBlock.guardSize, oldBlock.guardFlags);
+        }
+        else
+        {
+            _aligned_free(ptr);
+        }
+
+        AllocDesc* allocDesc = UpdateAlloc(ptr, newPtr, size, align, tag, func, file, line);
+        allocDesc->guardBase = guardBase;
+        allocDesc->guardSize = guardSize;
+        allocDesc->guardFlags = guardFlags;
+        return newPtr;
+    }
+
     void* newPtr = _aligned_realloc(ptr, (size_t)size, (size_t)align);
     if (ptr == nullptr)
     {
-        AddAlloc(newPtr, size, align, tag, func, file, line);
+        AddAlloc(newPtr, size, align, tag, func, file, line, CaptureCallStack());
     }
     else
     {
@@ -190,8 +607,17 @@ void Memory_FreeDebug(const char* tag, void* ptr, const char* func, const char*
 
     if (ptr)
     {
-        RemoveAlloc(ptr, func, tag, file, line);
-        _aligned_free(ptr);
+        AllocDesc allocDesc;
+        RemoveAlloc(ptr, tag, func, file, line, &allocDesc);
+
+        if (allocDesc.guardBase)
+        {
+            GuardFree(allocDesc.guardBase, allocDesc.guardSize, allocDesc.guardFlags);
+        }
+        else
+        {
+            _aligned_free(ptr);
+        }
     }
 }
 
@@ -223,17 +649,210 @@ void Memory_DumpAllocs(void)
     }
 }
 
+// ----------------------------
+// Leaks report
+// ----------------------------
+
+struct LeakGroup
+{
+    const AllocDesc*    first;          // Representative allocation
+    int64_t             bytes;
+    int32_t             count;
+};
+
+static int CompareLeakOwner(const void* a, const void* b)
+{
+    const AllocDesc* descA = *(const AllocDesc* const*)a;
+    const AllocDesc* descB = *(const AllocDesc* const*)b;
+    if (descA->callStack != descB->callStack)
+    {
+        return (uintptr_t)descA->callStack < (uintptr_t)descB->callStack ? -1 : 1;
+    }
+
+    // No call stack, group by call site
+    if (descA->file != descB->file)
+    {
+        return (uintptr_t)descA->file < (uintptr_t)descB->file ? -1 : 1;
+    }
+    return descA->line - descB->line;
+}
+
+static int CompareLeakBytes(const void* a, const void* b)
+{
+    const LeakGroup* groupA = (const LeakGroup*)a;
+    const LeakGroup* groupB = (const LeakGroup*)b;
+    return groupA->bytes < groupB->bytes ? 1 : (groupA->bytes > groupB->bytes ? -1 : 0);
+}
+
+static void WriteJsonString(FILE* file, const char* string)
+{
+    fputc('"', file);
+    for (const char* c = string; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            fputc('\\', file);
+        }
+        fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+// The text report is printed even when logging is compiled out
+#ifdef LOGGING
+#define LeakReport_Print(fmt, ...) Log_Error("Memory", fmt, ##__VA_ARGS__)
+#else
+#define LeakReport_Print(fmt, ...) fprintf(stderr, fmt, ##__VA_ARGS__)
+#endif
+
+static void WriteLeakReport(const char* path, const LeakGroup* groups, int32_t groupCount, int64_t totalBytes, int32_t totalCount)
+{
+    FILE* file = fopen(path, "w");
+    if (!file)
+    {
+        Log_Error("Memory", "Cannot write leaks report to %s\n", path);
+        return;
+    }
+
+    fprintf(file, "{\n\t\"version\": 1,\n\t\"bytes\": %lld,\n\t\"count\": %d,\n\t\"leaks\": [", (long long)totalBytes, totalCount);
+    for (int32_t i = 0; i < groupCount; i++)
+    {
+        const AllocDesc* desc = groups[i].first;
+
+        fprintf(file, "%s\n\t\t{ \"bytes\": %lld, \"count\": %d, \"tag\": ", i > 0 ? "," : "", (long long)groups[i].bytes, groups[i].count);
+        WriteJsonString(file, desc->tag);
+        fprintf(file, ", \"function\": ");
+        WriteJsonString(file, desc->func);
+        fprintf(file, ", \"file\": ");
+        WriteJsonString(file, desc->file);
+        fprintf(file, ", \"line\": %d, \"frames\": [", desc->line);
+
+        const int32_t depth = desc->callStack ? desc->callStack->depth : 0;
+        for (int32_t frameIndex = 0; frameIndex < depth; frameIndex++)
+        {
+            void* frame = desc->callStack->frames[frameIndex];
+
+            uintptr_t moduleBase;
+            const char* module = GetFrameModule(frame, &moduleBase);
+
+            fprintf(file, "%s{ \"module\": ", frameIndex > 0 ? ", " : "");
+            WriteJsonString(file, module);
+            fprintf(file, ", \"offset\": \"0x%llx\" }", (unsigned long long)((uintptr_t)frame - moduleBase));
+        }
+        fprintf(file, "] }");
+    }
+    fprintf(file, "\n\t]\n}\n");
+
+    fclose(file);
+}
+
+// Report allocations created after markSerial, return number of leaked allocations
+static int32_t ReportLeaks(int64_t markSerial)
+{
+    int32_t leakCount = 0;
+    for (int32_t i = 0; i < ALLOC_DESC_COUNT; i++)
+    {
+        for (const AllocDesc* desc = gAllocStore.hashAllocDescs[i]; desc != nullptr; desc = desc->next)
+        {
+            leakCount += desc->serial > markSerial;
+        }
+    }
+
+    if (leakCount == 0)
+    {
+        return 0;
+    }
+
+    // Use CRT directly, the report must not allocate tracked memory
+    const AllocDesc** leaks = (const AllocDesc**)malloc(sizeof(AllocDesc*) * leakCount);
+    LeakGroup* groups = (LeakGroup*)malloc(sizeof(LeakGroup) * leakCount);
+    if (!leaks || !groups)
+    {
+        free(leaks);
+        free(groups);
+        return leakCount;
+    }
+
+    int32_t index = 0;
+    for (int32_t i = 0; i < ALLOC_DESC_COUNT; i++)
+    {
+        for (const AllocDesc* desc = gAllocStore.hashAllocDescs[i]; desc != nullptr; desc = desc->next)
+        {
+            if (desc->serial > markSerial)
+            {
+                leaks[index++] = desc;
+            }
+        }
+    }
+
+    qsort(leaks, (size_t)leakCount, sizeof(AllocDesc*), CompareLeakOwner);
+
+    int64_t totalBytes = 0;
+    int32_t groupCount = 0;
+    for (int32_t i = 0; i < leakCount; i++)
+    {
+        if (groupCount == 0 || CompareLeakOwner(&groups[groupCount - 1].first, &leaks[i]) != 0)
+        {
+            groups[groupCount].first = leaks[i];
+            groups[groupCount].bytes = 0;
+            groups[groupCount].count = 0;
+            groupCount++;
+        }
+
+        groups[groupCount - 1].bytes += leaks[i]->size;
+        groups[groupCount - 1].count++;
+        totalBytes += leaks[i]->size;
+    }
+
+    qsort(groups, (size_t)groupCount, sizeof(LeakGroup), CompareLeakBytes);
+
+    LeakReport_Print("%d allocations leaked, %lld bytes in %d call stacks\n", leakCount, (long long)totalBytes, groupCount);
+    for (int32_t i = 0; i < groupCount; i++)
+    {
+        const AllocDesc* desc = groups[i].first;
+        LeakReport_Print("#%d: %lld bytes in %d allocations, tag %s, %s:%d:%s\n", i, (long long)groups[i].bytes, groups[i].count, desc->tag, desc->file, desc->line, desc->func);
+
+        const int32_t depth = desc->callStack ? desc->callStack->depth : 0;
+        for (int32_t frameIndex = 0; frameIndex < depth; frameIndex++)
+        {
+            void* frame = desc->callStack->frames[frameIndex];
+
+            uintptr_t moduleBase;
+            const char* module = GetFrameModule(frame, &moduleBase);
+            LeakReport_Print("\t%s+0x%llx\n", module, (unsigned long long)((uintptr_t)frame - moduleBase));
+        }
+    }
+
+    if (gCallStackStore.leakReportPath)
+    {
+        WriteLeakReport(gCallStackStore.leakReportPath, groups, groupCount, totalBytes, leakCount);
+    }
+
+    free(leaks);
+    free(groups);
+    return leakCount;
+}
+
 MemoryTracker::MemoryTracker()
     : markAllocations(gAllocStore.allocations)
+    , markSerial(gAllocStore.allocSerial)
 {
 }
 
 MemoryTracker::~MemoryTracker()
 {
-    assert(markAllocations <= gAllocStore.allocations && "Memory leaks occurred!");
+    const int32_t leakCount = ReportLeaks(markSerial);
+    assert(leakCount == 0 && "Memory leaks occurred!");
+    (void)leakCount;
 }
 // END OF #if !defined(NDEBUG)
 #else
+void Memory_SetGuardTag(const char* tag, MemoryGuardFlags flags)
+{
+    (void)tag;
+    (void)flags;
+}
+
 void* Memory_AllocNDebug(int32_t size, int32_t align)
 {
     return _aligned_malloc((size_t)size, (size_t)align);
@@ -249,12 +868,23 @@ void Memory_FreeNDebug(void* ptr)
     _aligned_free(ptr);
 }
 
-void MemoryDumpAllocs(void)
+void Memory_DumpAllocs(void)
+{
+}
+
+void Memory_SetCallStackDepth(int32_t depth)
 {
+    (void)depth;
+}
+
+void Memory_SetLeakReportPath(const char* path)
+{
+    (void)path;
 }
 
 MemoryTracker::MemoryTracker()
     : markAllocations(0)
+    , markSerial(0)
 {
 }
 
@@ -283,9 +913,6 @@ void* Memory_Move(void* dst, const void* src, const int32_t size)
 // ------------------------------------
 
 #if defined(_WIN32)
-#define WIN32_LEAN_AND_MEAN
-#include <Windows.h>
-
 int32_t Memory_PageSize(void)
 {
     SYSTEM_INFO systemInfo;
@@ -294,13 +921,12 @@ int32_t Memory_PageSize(void)
 }
 
 #elif defined(__unix__)
-#include <unistd.h>
-int32_t MemoryPageSize(void)
+int32_t Memory_PageSize(void)
 {
     return getpagesize();
 }
 #else
-int32_t MemoryPageSize(void)
+int32_t Memory_PageSize(void)
 {
     return 4096;
 }
@@ -319,6 +945,7 @@ void ImGui::DumpMemoryAllocs(ImGuiDumpMemoryFlags flags)
     {
         render = ImGui::Begin("Memory Allocations", nullptr, ImGuiWindowFlags_NoFocusOnAppearing);
     }
+    (void)render; // Only read in profiling builds
 
     #if BUILD_PROFILING
     if (render)
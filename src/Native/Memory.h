@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stddef.h>
 #include <stdint.h>
 #include "Misc/Compiler.h"
 
@@ -13,11 +14,11 @@
 #ifdef __cplusplus
 
 struct MemoryNewWrapper {};
-__forceinline void* operator new(size_t, MemoryNewWrapper, void* ptr) { return ptr; }
-__forceinline void  operator delete(void*, MemoryNewWrapper, void*)   {             } // This is only required so we can use the symmetrical new()
+inline void* operator new(size_t, MemoryNewWrapper, void* ptr) { return ptr; } // Operators cannot be static, so not __forceinline on GCC
+inline void  operator delete(void*, MemoryNewWrapper, void*)   {             } // This is only required so we can use the symmetrical new()
 
-#define Memory_NewPlacement(ptr)                (new (MemoryNewWrapper(), ptr))
-#define Memory_New(Type)                        (new (MemoryNewWrapper(), Memory_AllocTag("C++", sizeof(Type), alignof(Type))))
+#define Memory_NewPlacement(ptr)                new (MemoryNewWrapper(), ptr)
+#define Memory_New(Type)                        new (MemoryNewWrapper(), Memory_AllocTag("C++", sizeof(Type), alignof(Type))) Type
 #define Memory_Delete(ptr)                      (Memory_CallDestructor(ptr), Memory_FreeTag("C++", ptr))
 
 template <typename T>
@@ -79,6 +80,26 @@ void*   Memory_ReallocNDebug(void* ptr, int32_t size, int32_t align);
 void    Memory_FreeNDebug(void* ptr);
 #endif
 
+// --------------------------------------
+// Guard pages debug mode
+// --------------------------------------
+
+/// Placement of debug allocations against inaccessible guard pages
+typedef enum MemoryGuardFlags
+{
+    MemoryGuardFlags_None           = 0,
+    MemoryGuardFlags_Overrun        = 1 << 0,   // Block end touch the guard page, overflows fault immediately
+    MemoryGuardFlags_Underrun       = 1 << 1,   // Block start touch the guard page, underflows fault immediately
+    MemoryGuardFlags_DelayReuse     = 1 << 2,   // Freed pages stay inaccessible for a while, use-after-free fault
+
+    MemoryGuardFlags_Default        = MemoryGuardFlags_Overrun | MemoryGuardFlags_DelayReuse,
+} MemoryGuardFlags;
+
+/// Allocate blocks with given tag in guard pages mode, "*" match all tags
+/// MemoryGuardFlags_None turn off the mode for the tag
+/// @note: only available in debug build, do nothing in release build
+void    Memory_SetGuardTag(const char* tag, MemoryGuardFlags flags);
+
 // --------------------------------------
 // Memory manipulating
 // --------------------------------------
@@ -93,6 +114,14 @@ void*   Memory_Move(void* dst, const void* src, const int32_t size);
 
 void    Memory_DumpAllocs(void);
 
+/// Set the number of call stack frames captured per allocation, 0 to disable
+/// @note: only available in debug build, do nothing in release build
+void    Memory_SetCallStackDepth(int32_t depth);
+
+/// Set the machine-readable (JSON) leak report file written by MemoryTracker, nullptr to disable
+/// @note: only available in debug build, do nothing in release build
+void    Memory_SetLeakReportPath(const char* path);
+
 // ------------------------------------
 // Memory system information functions
 // ------------------------------------
@@ -112,9 +141,12 @@ int32_t Memory_PageSize(void);
 #endif
 
 // @todo: Convert to C version
+// Report allocations that still alive when the tracker go out of scope,
+// grouped by call stack and ranked by bytes
 struct MemoryTracker
 {
     int32_t     markAllocations;
+    int64_t     markSerial;
 
                 MemoryTracker();
                 ~MemoryTracker();
@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <string.h>
 #include "Text/String.h"
+#include "Text/StringBuilder.h"
 #include "Native/Memory.h"
 #include "Native/AtomicOps.h"
 
@@ -59,6 +60,21 @@ const char* String_New(const char* source)
     }
 }
 
+const char* String_NewLength(const char* source, int32_t length)
+{
+    assert(source != nullptr && "Attempt to use null-pointer on string");
+
+    if (length == 0)
+    {
+        return EMPTY_STRING;
+    }
+
+    StringBuffer* buffer = StringBuffer_New(length);
+    memcpy(buffer->data, source, length);
+    buffer->data[length] = '\0';
+    return buffer->data;
+}
+
 void String_Free(const char* target)
 {
     assert(target != nullptr && "Attempt to use null-pointer on string");
@@ -101,26 +117,33 @@ const char* String_From(void* buffer, int32_t bufferSize, const char* source)
 
 const char* String_Format(int32_t bufferSize, const char* format, ...)
 {
-    assert(format != nullptr && "Attempt to use null-pointer on string");
-
-    StringBuffer* buffer = StringBuffer_New(bufferSize);
-
     va_list argv;
     va_start(argv, format);
-    int32_t length = (int32_t)vsnprintf(buffer->data, bufferSize, format, argv);
+    const char* result = String_FormatV(bufferSize, format, argv);
     va_end(argv);
 
-    buffer->length = length;
-    return buffer->data;
+    return result;
 }
 
 const char* String_FormatV(int32_t bufferSize, const char* format, va_list argv)
 {
     assert(format != nullptr && "Attempt to use null-pointer on string");
 
-    StringBuffer* buffer = StringBuffer_New(bufferSize + sizeof(StringBuffer));
-    buffer->length = (int32_t)vsnprintf(buffer->data, bufferSize, format, argv);
-    return buffer->data;
+    // Format in the builder first, it stays inline up to 256 bytes then grows in the thread-local temp arena.
+    // The heap string is then allocated once with the exact length
+    StringBuilder builder;
+    StringBuilder_Init(&builder, String_GetTempArena());
+    StringBuilder_AppendFormatV(&builder, format, argv);
+
+    int32_t length = StringBuilder_GetLength(&builder);
+    if (bufferSize > 0 && length > bufferSize - 1)
+    {
+        length = bufferSize - 1;
+    }
+
+    const char* result = String_NewLength(StringBuilder_GetString(&builder), length);
+    StringBuilder_CleanUp(&builder);
+    return result;
 }
 
 const char* String_FormatBuffer(void* buffer, int32_t bufferSize, const char* format, ...)
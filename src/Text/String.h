@@ -1,6 +1,7 @@
 #pragma once
 
 #include <assert.h>
+#include <stdarg.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include "Misc/Compiler.h"
@@ -28,14 +29,17 @@ extern "C" {
 
 const char*             String_Ref(const char* source);
 const char*             String_New(const char* source);
+const char*             String_NewLength(const char* source, int32_t length);
 void                    String_Free(const char* target);
 
+/// Format to a new heap string, sized to fit the result
+/// bufferSize limit the string size (null-terminator included), 0 for no limit
 const char*             String_Format(int32_t bufferSize, const char* format, ...);
 const char*             String_FormatV(int32_t bufferSize, const char* format, va_list argv);
 
 const char*             String_From(void* buffer, int32_t bufferSize, const char* source);
 const char*             String_FormatBuffer(void* buffer, int32_t bufferSize, const char* format, ...);
-const char*             string_FormatBufferV(void* buffer, int32_t bufferSize, const char* format, va_list argv);
+const char*             String_FormatBufferV(void* buffer, int32_t bufferSize, const char* format, va_list argv);
 
 int32_t                 String_GetLength(const char* target);
 int32_t                 String_CalcLength(const char* target);
@@ -0,0 +1,441 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+
+#include "Text/String.h"
+#include "Text/StringBuilder.h"
+#include "Native/Memory.h"
+
+constexpr const char* STRING_BUILDER_TAG = "StringBuilder";
+
+// Two digits per lookup, halve the divisions of integer formatting
+static const char DIGIT_PAIRS[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+static const uint64_t POW10[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull, 1000000000ull,
+};
+
+// -------------------------------------------------------------------
+// StringArena
+// -------------------------------------------------------------------
+
+void StringArena_Init(StringArena* arena, void* buffer, int32_t size)
+{
+    assert(buffer != nullptr || size == 0);
+
+    arena->buffer   = (char*)buffer;
+    arena->size     = size;
+    arena->used     = 0;
+}
+
+void StringArena_Reset(StringArena* arena)
+{
+    arena->used = 0;
+}
+
+char* StringArena_Alloc(StringArena* arena, int32_t size)
+{
+    assert(size >= 0);
+
+    if (size > arena->size - arena->used)
+    {
+        return nullptr;
+    }
+
+    char* block = arena->buffer + arena->used;
+    arena->used += size;
+    return block;
+}
+
+bool StringArena_Extend(StringArena* arena, char* block, int32_t oldSize, int32_t newSize)
+{
+    if (block + oldSize != arena->buffer + arena->used)
+    {
+        return false;
+    }
+
+    if (newSize - oldSize > arena->size - arena->used)
+    {
+        return false;
+    }
+
+    arena->used += newSize - oldSize;
+    return true;
+}
+
+const char* StringArena_Copy(StringArena* arena, const char* source, int32_t length)
+{
+    char* copy = StringArena_Alloc(arena, length + 1);
+    if (!copy)
+    {
+        return nullptr;
+    }
+
+    memcpy(copy, source, (size_t)length);
+    copy[length] = '\0';
+    return copy;
+}
+
+// -------------------------------------------------------------------
+// StringBuilder
+// -------------------------------------------------------------------
+
+void StringBuilder_Init(StringBuilder* builder, StringArena* arena)
+{
+    builder->data           = builder->inlineData;
+    builder->length         = 0;
+    builder->capacity       = STRING_BUILDER_INLINE_CAPACITY;
+    builder->arena          = arena;
+    builder->heapData       = false;
+    builder->inlineData[0]  = '\0';
+}
+
+void StringBuilder_CleanUp(StringBuilder* builder)
+{
+    if (builder->heapData)
+    {
+        Memory_FreeTag(STRING_BUILDER_TAG, builder->data);
+    }
+
+    StringBuilder_Init(builder, builder->arena);
+}
+
+void StringBuilder_Clear(StringBuilder* builder)
+{
+    builder->length = 0;
+    builder->data[0] = '\0';
+}
+
+bool StringBuilder_Reserve(StringBuilder* builder, int32_t length)
+{
+    const int32_t required = length + 1;
+    if (required <= builder->capacity)
+    {
+        return true;
+    }
+
+    int32_t newCapacity = builder->capacity;
+    while (newCapacity < required)
+    {
+        newCapacity = newCapacity < INT32_MAX / 2 ? newCapacity * 2 : required;
+    }
+
+    if (builder->heapData)
+    {
+        char* newData = (char*)Memory_ReallocTag(STRING_BUILDER_TAG, builder->data, newCapacity, 1);
+        if (!newData)
+        {
+            return false;
+        }
+
+        builder->data = newData;
+        builder->capacity = newCapacity;
+        return true;
+    }
+
+    // Arena storage: grow in place when the builder is the last allocation, move otherwise
+    StringArena* arena = builder->arena;
+    if (arena)
+    {
+        if (builder->data != builder->inlineData && StringArena_Extend(arena, builder->data, builder->capacity, newCapacity))
+        {
+            builder->capacity = newCapacity;
+            return true;
+        }
+
+        char* newData = StringArena_Alloc(arena, newCapacity);
+        if (newData)
+        {
+            memcpy(newData, builder->data, (size_t)builder->length + 1);
+            builder->data = newData;
+            builder->capacity = newCapacity;
+            return true;
+        }
+    }
+
+    char* newData = (char*)Memory_AllocTag(STRING_BUILDER_TAG, newCapacity, 1);
+    if (!newData)
+    {
+        return false;
+    }
+
+    memcpy(newData, builder->data, (size_t)builder->length + 1);
+    builder->data = newData;
+    builder->capacity = newCapacity;
+    builder->heapData = true;
+    return true;
+}
+
+void StringBuilder_Append(StringBuilder* builder, const char* string)
+{
+    assert(string != nullptr && "Attempt to use null-pointer on string");
+    StringBuilder_AppendLength(builder, string, (int32_t)strlen(string));
+}
+
+void StringBuilder_AppendLength(StringBuilder* builder, const char* string, int32_t length)
+{
+    if (!StringBuilder_Reserve(builder, builder->length + length))
+    {
+        assert(false && "Out of memory");
+        return;
+    }
+
+    memcpy(builder->data + builder->length, string, (size_t)length);
+    builder->length += length;
+    builder->data[builder->length] = '\0';
+}
+
+void StringBuilder_AppendChar(StringBuilder* builder, char c)
+{
+    StringBuilder_AppendLength(builder, &c, 1);
+}
+
+// Write digits of value backward, end is one past the last digit, return the first digit
+static char* StringBuilder_WriteDigits(char* end, uint64_t value)
+{
+    while (value >= 100)
+    {
+        const uint32_t pair = (uint32_t)(value % 100) * 2;
+        value /= 100;
+
+        *--end = DIGIT_PAIRS[pair + 1];
+        *--end = DIGIT_PAIRS[pair];
+    }
+
+    if (value >= 10)
+    {
+        const uint32_t pair = (uint32_t)value * 2;
+        *--end = DIGIT_PAIRS[pair + 1];
+        *--end = DIGIT_PAIRS[pair];
+    }
+    else
+    {
+        *--end = (char)('0' + value);
+    }
+
+    return end;
+}
+
+void StringBuilder_AppendUInt(StringBuilder* builder, uint64_t value)
+{
+    char digits[20];
+    char* end = digits + sizeof(digits);
+    char* start = StringBuilder_WriteDigits(end, value);
+    StringBuilder_AppendLength(builder, start, (int32_t)(end - start));
+}
+
+void StringBuilder_AppendInt(StringBuilder* builder, int64_t value)
+{
+    char digits[21];
+    char* end = digits + sizeof(digits);
+
+    // Negate in unsigned, INT64_MIN has no positive counterpart
+    const uint64_t magnitude = value < 0 ? 0ull - (uint64_t)value : (uint64_t)value;
+    char* start = StringBuilder_WriteDigits(end, magnitude);
+    if (value < 0)
+    {
+        *--start = '-';
+    }
+
+    StringBuilder_AppendLength(builder, start, (int32_t)(end - start));
+}
+
+void StringBuilder_AppendFloat(StringBuilder* builder, double value, int32_t decimals)
+{
+    assert(decimals >= 0 && decimals <= 9);
+
+    if (isnan(value))
+    {
+        StringBuilder_AppendLength(builder, signbit(value) ? "-nan" : "nan", signbit(value) ? 4 : 3);
+        return;
+    }
+
+    if (isinf(value))
+    {
+        StringBuilder_AppendLength(builder, value < 0.0 ? "-inf" : "inf", value < 0.0 ? 4 : 3);
+        return;
+    }
+
+    const double magnitude = fabs(value);
+    const uint64_t scale = POW10[decimals];
+
+    // Scaled value must be exact in double (< 2^53), printf handles the rare huge values
+    if (magnitude * (double)scale >= 9007199254740992.0)
+    {
+        StringBuilder_AppendFormat(builder, "%.*f", decimals, value);
+        return;
+    }
+
+    const uint64_t scaled = (uint64_t)(magnitude * (double)scale + 0.5);
+
+    char digits[32];
+    char* end = digits + sizeof(digits);
+    char* start = end;
+
+    if (decimals > 0)
+    {
+        const uint64_t fraction = scaled % scale;
+        start = StringBuilder_WriteDigits(end, fraction);
+        while (end - start < decimals)
+        {
+            *--start = '0';
+        }
+        *--start = '.';
+    }
+
+    start = StringBuilder_WriteDigits(start, scaled / scale);
+    if (signbit(value))
+    {
+        *--start = '-';
+    }
+
+    StringBuilder_AppendLength(builder, start, (int32_t)(end - start));
+}
+
+void StringBuilder_AppendFormat(StringBuilder* builder, const char* format, ...)
+{
+    va_list argv;
+    va_start(argv, format);
+    StringBuilder_AppendFormatV(builder, format, argv);
+    va_end(argv);
+}
+
+void StringBuilder_AppendFormatV(StringBuilder* builder, const char* format, va_list argv)
+{
+    assert(format != nullptr && "Attempt to use null-pointer on string");
+
+    // Format into the free space first, most formats fit and need a single pass
+    va_list argvCopy;
+    va_copy(argvCopy, argv);
+    const int32_t space = builder->capacity - builder->length;
+    const int32_t length = (int32_t)vsnprintf(builder->data + builder->length, (size_t)space, format, argvCopy);
+    va_end(argvCopy);
+
+    if (length < 0)
+    {
+        builder->data[builder->length] = '\0';
+        return;
+    }
+
+    if (length >= space)
+    {
+        if (!StringBuilder_Reserve(builder, builder->length + length))
+        {
+            builder->data[builder->length] = '\0';
+            assert(false && "Out of memory");
+            return;
+        }
+
+        vsnprintf(builder->data + builder->length, (size_t)length + 1, format, argv);
+    }
+
+    builder->length += length;
+}
+
+const char* StringBuilder_ToString(const StringBuilder* builder)
+{
+    return String_NewLength(builder->data, builder->length);
+}
+
+// -------------------------------------------------------------------
+// Temporary strings
+// -------------------------------------------------------------------
+
+static thread_local char        gTempBuffer[STRING_TEMP_ARENA_SIZE];
+static thread_local StringArena gTempArena;
+
+StringArena* String_GetTempArena(void)
+{
+    if (!gTempArena.buffer)
+    {
+        StringArena_Init(&gTempArena, gTempBuffer, STRING_TEMP_ARENA_SIZE);
+    }
+
+    return &gTempArena;
+}
+
+void String_ResetTemp(void)
+{
+    StringArena_Reset(String_GetTempArena());
+}
+
+// Reserve size bytes in the temp arena, wrap around when the end is reached
+static char* String_TempAlloc(int32_t size)
+{
+    StringArena* arena = String_GetTempArena();
+
+    char* block = StringArena_Alloc(arena, size);
+    if (!block)
+    {
+        StringArena_Reset(arena);
+        block = StringArena_Alloc(arena, size);
+    }
+
+    return block;
+}
+
+const char* String_TempCopy(const char* source, int32_t length)
+{
+    assert(source != nullptr && "Attempt to use null-pointer on string");
+
+    length = length < STRING_TEMP_ARENA_SIZE - 1 ? length : STRING_TEMP_ARENA_SIZE - 1;
+
+    char* copy = String_TempAlloc(length + 1);
+    memcpy(copy, source, (size_t)length);
+    copy[length] = '\0';
+    return copy;
+}
+
+const char* String_TempFormat(const char* format, ...)
+{
+    va_list argv;
+    va_start(argv, format);
+    const char* result = String_TempFormatV(format, argv);
+    va_end(argv);
+
+    return result;
+}
+
+const char* String_TempFormatV(const char* format, va_list argv)
+{
+    assert(format != nullptr && "Attempt to use null-pointer on string");
+
+    StringArena* arena = String_GetTempArena();
+
+    va_list argvCopy;
+    va_copy(argvCopy, argv);
+    const int32_t space = arena->size - arena->used;
+    int32_t length = (int32_t)vsnprintf(arena->buffer + arena->used, (size_t)space, format, argvCopy);
+    va_end(argvCopy);
+
+    if (length < 0)
+    {
+        return "";
+    }
+
+    if (length >= space)
+    {
+        // Wrap around, longer strings than the arena are truncated
+        StringArena_Reset(arena);
+        length = length < arena->size - 1 ? length : arena->size - 1;
+        vsnprintf(arena->buffer, (size_t)length + 1, format, argv);
+    }
+
+    return StringArena_Alloc(arena, length + 1);
+}
+
+//! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
+
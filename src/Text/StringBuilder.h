@@ -0,0 +1,108 @@
+#pragma once
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "Misc/Compiler.h"
+
+constexpr int32_t STRING_BUILDER_INLINE_CAPACITY    = 256;
+constexpr int32_t STRING_TEMP_ARENA_SIZE            = 16 * 1024;
+
+/// StringArena
+/// Bump allocator for strings, everything is released at once with StringArena_Reset.
+/// The arena does not own its buffer.
+typedef struct StringArena
+{
+    char*       buffer;
+    int32_t     size;
+    int32_t     used;
+} StringArena;
+
+/// StringBuilder
+/// Growable string, short strings stay in the inline storage and never touch the heap.
+/// Grow in the arena when it has one (falling back to heap when the arena is full), on the heap otherwise.
+/// data is always null-terminated.
+/// @note: data may point to the inline storage, do not copy StringBuilder by value
+typedef struct StringBuilder
+{
+    char*           data;
+    int32_t         length;
+    int32_t         capacity;           // Include the null-terminator
+
+    StringArena*    arena;
+    bool            heapData;           // data is owned by the builder
+
+    char            inlineData[STRING_BUILDER_INLINE_CAPACITY];
+} StringBuilder;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void                    StringArena_Init(StringArena* arena, void* buffer, int32_t size);
+void                    StringArena_Reset(StringArena* arena);
+
+/// Allocate size bytes, nullptr when the arena is full
+char*                   StringArena_Alloc(StringArena* arena, int32_t size);
+
+/// Grow the last allocation in place, fail if block is not the last allocation or the arena is full
+bool                    StringArena_Extend(StringArena* arena, char* block, int32_t oldSize, int32_t newSize);
+
+/// Copy length bytes of source into the arena, null-terminated
+const char*             StringArena_Copy(StringArena* arena, const char* source, int32_t length);
+
+/// Init builder, arena can be nullptr
+void                    StringBuilder_Init(StringBuilder* builder, StringArena* arena);
+
+/// Release heap storage, arena storage is released with the arena
+void                    StringBuilder_CleanUp(StringBuilder* builder);
+
+void                    StringBuilder_Clear(StringBuilder* builder);
+bool                    StringBuilder_Reserve(StringBuilder* builder, int32_t length);
+
+void                    StringBuilder_Append(StringBuilder* builder, const char* string);
+void                    StringBuilder_AppendLength(StringBuilder* builder, const char* string, int32_t length);
+void                    StringBuilder_AppendChar(StringBuilder* builder, char c);
+
+/// Append decimal integers, without printf
+void                    StringBuilder_AppendInt(StringBuilder* builder, int64_t value);
+void                    StringBuilder_AppendUInt(StringBuilder* builder, uint64_t value);
+
+/// Append value with fixed decimals (0-9) like "%.*f", without printf for common values
+/// @note: the last decimal may differ from printf by one, when the value is close to halfway
+void                    StringBuilder_AppendFloat(StringBuilder* builder, double value, int32_t decimals);
+
+void                    StringBuilder_AppendFormat(StringBuilder* builder, const char* format, ...);
+void                    StringBuilder_AppendFormatV(StringBuilder* builder, const char* format, va_list argv);
+
+/// Copy the content to a new heap string (String_Free to release)
+const char*             StringBuilder_ToString(const StringBuilder* builder);
+
+/// Temporary strings of the calling thread
+/// Live until String_ResetTemp, or until the thread temporary arena wraps around
+/// after STRING_TEMP_ARENA_SIZE bytes of newer temporary strings. Use them for
+/// values that are consumed right away (labels, log arguments, debug HUD).
+StringArena*            String_GetTempArena(void);
+void                    String_ResetTemp(void);
+
+const char*             String_TempCopy(const char* source, int32_t length);
+const char*             String_TempFormat(const char* format, ...);
+const char*             String_TempFormatV(const char* format, va_list argv);
+
+#ifdef __cplusplus
+}
+#endif
+
+/// Content of the builder, valid until the next change
+inline const char* StringBuilder_GetString(const StringBuilder* builder)
+{
+    return builder->data;
+}
+
+inline int32_t StringBuilder_GetLength(const StringBuilder* builder)
+{
+    return builder->length;
+}
+
+//! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
+
@@ -0,0 +1,161 @@
+#include <string.h>
+#include <assert.h>
+
+#include "Text/StringId.h"
+#include "Misc/Logging.h"
+#include "Native/Memory.h"
+#include "Native/AtomicOps.h"
+#include "Container/HashTable.h"
+
+constexpr const char*   STRING_ID_TAG           = "StringId";
+constexpr int32_t       STRING_ID_CHUNK_SIZE    = 16 * 1024;
+
+/// Interned strings are packed in chunks, never moved nor freed before shutdown
+struct StringIdChunk
+{
+    StringIdChunk*      next;
+    int32_t             used;
+    int32_t             size;
+    char                data[];
+};
+
+/// Ids are hashes already, spread them a bit more for the table
+struct StringIdTraits
+{
+    static inline uint64_t Hash(StringId id)
+    {
+        return HashTraits_Mix(id);
+    }
+
+    static inline bool Equals(StringId a, StringId b)
+    {
+        return a == b;
+    }
+};
+
+static struct
+{
+    volatile int32_t                                lock;
+    HashTable<StringId, const char*, StringIdTraits> strings;
+    StringIdChunk*                                  chunks;
+} gStringIdStore;
+
+static inline void StringId_Lock(void)
+{
+    while (!Atomic_TryLockI32(&gStringIdStore.lock))
+    {
+        // Interning is short, spinning is cheaper than sleeping
+    }
+}
+
+static inline void StringId_Unlock(void)
+{
+    Atomic_UnlockI32(&gStringIdStore.lock);
+}
+
+static const char* StringId_CopyString(const char* string, int32_t length)
+{
+    StringIdChunk* chunk = gStringIdStore.chunks;
+    if (!chunk || chunk->used + length + 1 > chunk->size)
+    {
+        const int32_t dataSize = length + 1 > STRING_ID_CHUNK_SIZE ? length + 1 : STRING_ID_CHUNK_SIZE;
+        chunk = (StringIdChunk*)Memory_AllocTag(STRING_ID_TAG, (int32_t)sizeof(StringIdChunk) + dataSize, alignof(StringIdChunk));
+        if (!chunk)
+        {
+            return nullptr;
+        }
+
+        chunk->next = gStringIdStore.chunks;
+        chunk->used = 0;
+        chunk->size = dataSize;
+        gStringIdStore.chunks = chunk;
+    }
+
+    char* copy = chunk->data + chunk->used;
+    memcpy(copy, string, (size_t)length);
+    copy[length] = '\0';
+    chunk->used += length + 1;
+    return copy;
+}
+
+StringId StringId_Intern(const char* string)
+{
+    if (!string)
+    {
+        return STRING_ID_NONE;
+    }
+
+    return StringId_InternLength(string, (int32_t)strlen(string));
+}
+
+StringId StringId_InternLength(const char* string, int32_t length)
+{
+    if (!string)
+    {
+        return STRING_ID_NONE;
+    }
+
+    const StringId id = StringId_Hash(string, length);
+
+    StringId_Lock();
+
+    const int32_t index = gStringIdStore.strings.IndexOf(id);
+    if (index > -1)
+    {
+        const char* interned = gStringIdStore.strings.ValueAt(index);
+        if (strncmp(interned, string, (size_t)length) != 0 || interned[length] != '\0')
+        {
+            Log_Error("StringId", "Hash collision: '%s' and '%.*s' have the same id 0x%08x\n", interned, length, string, id);
+            assert(false && "StringId hash collision, rename one of the strings");
+        }
+    }
+    else
+    {
+        const char* copy = StringId_CopyString(string, length);
+        if (!copy || !gStringIdStore.strings.SetValue(id, copy))
+        {
+            assert(false && "Out of memory");
+        }
+    }
+
+    StringId_Unlock();
+    return id;
+}
+
+const char* StringId_GetString(StringId id)
+{
+    StringId_Lock();
+    const char* string = gStringIdStore.strings.GetValue(id, nullptr);
+    StringId_Unlock();
+
+    return string;
+}
+
+int32_t StringId_Count(void)
+{
+    StringId_Lock();
+    const int32_t count = gStringIdStore.strings.Count();
+    StringId_Unlock();
+
+    return count;
+}
+
+void StringId_Shutdown(void)
+{
+    StringId_Lock();
+
+    gStringIdStore.strings.CleanUp();
+
+    StringIdChunk* chunk = gStringIdStore.chunks;
+    while (chunk)
+    {
+        StringIdChunk* next = chunk->next;
+        Memory_FreeTag(STRING_ID_TAG, chunk);
+        chunk = next;
+    }
+    gStringIdStore.chunks = nullptr;
+
+    StringId_Unlock();
+}
+
+//! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stdint.h>
+
+/// StringId
+/// 32-bit FNV-1a hash of a string, stable across runs and platforms.
+/// Ids of literals are computed at compile time with STRING_ID, runtime strings
+/// are registered with StringId_Intern, which keep a copy to map the id back and
+/// report hash collisions.
+typedef uint32_t StringId;
+
+constexpr StringId STRING_ID_NONE = 0;
+
+/// Hash a string, usable in constant expressions
+/// 0 is reserved for STRING_ID_NONE, so a string hashed to 0 gets 1
+constexpr StringId StringId_Hash(const char* string, int32_t length = -1)
+{
+    uint32_t hash = 2166136261u;
+    for (int32_t i = 0; length < 0 ? string[i] != '\0' : i < length; i++)
+    {
+        hash = (hash ^ (uint8_t)string[i]) * 16777619u;
+    }
+    return hash != STRING_ID_NONE ? hash : 1;
+}
+
+template <StringId ID>
+struct StringIdConstant
+{
+    static constexpr StringId VALUE = ID;
+};
+
+/// Id of a literal, always evaluated at compile time
+#define STRING_ID(literal) (StringIdConstant<StringId_Hash(literal)>::VALUE)
+
+/// Register string to the global intern table, thread-safe
+/// Return the id of the string, STRING_ID_NONE for nullptr
+StringId        StringId_Intern(const char* string);
+
+/// Register first length bytes of string
+StringId        StringId_InternLength(const char* string, int32_t length);
+
+/// Get the interned copy of the string, nullptr if the id was never interned
+/// The copy lives until StringId_Shutdown
+const char*     StringId_GetString(StringId id);
+
+/// Number of interned strings
+int32_t         StringId_Count(void);
+
+/// Release all interned strings
+void            StringId_Shutdown(void);
+
+//! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
@@ -0,0 +1,476 @@
+#include <string.h>
+
+#include "Text/Utf8.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define UTF8_USE_SSE2 1
+#include <emmintrin.h>
+#else
+#define UTF8_USE_SSE2 0
+#endif
+
+// The lookup validator needs pshufb (SSSE3), MSVC has no SSSE3 switch and enable it with /arch:AVX
+#if defined(__AVX2__)
+#define UTF8_USE_AVX2 1
+#include <immintrin.h>
+#else
+#define UTF8_USE_AVX2 0
+#endif
+
+#if !UTF8_USE_AVX2 && (defined(__SSSE3__) || defined(__AVX__))
+#define UTF8_USE_SSSE3 1
+#include <tmmintrin.h>
+#else
+#define UTF8_USE_SSSE3 0
+#endif
+
+static inline int32_t Utf8_TrailingZeros32(uint32_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int32_t)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// -------------------------------------------------------------------
+// Scalar
+// -------------------------------------------------------------------
+
+/// Length of the valid sequence at string, 0 when invalid or truncated
+static int32_t Utf8_SequenceLength(const uint8_t* string, int32_t remain)
+{
+    const uint8_t c = string[0];
+    if (c < 0x80)
+    {
+        return 1;
+    }
+
+    int32_t length;
+    uint8_t lower = 0x80;
+    uint8_t upper = 0xBF;
+    if (c < 0xC2)
+    {
+        return 0; // Continuation byte or overlong 2-byte form
+    }
+    else if (c < 0xE0)
+    {
+        length = 2;
+    }
+    else if (c < 0xF0)
+    {
+        length = 3;
+        lower = c == 0xE0 ? 0xA0 : 0x80; // Overlong
+        upper = c == 0xED ? 0x9F : 0xBF; // Surrogates
+    }
+    else if (c < 0xF5)
+    {
+        length = 4;
+        lower = c == 0xF0 ? 0x90 : 0x80; // Overlong
+        upper = c == 0xF4 ? 0x8F : 0xBF; // Above U+10FFFF
+    }
+    else
+    {
+        return 0;
+    }
+
+    if (remain < length || string[1] < lower || string[1] > upper)
+    {
+        return 0;
+    }
+
+    for (int32_t i = 2; i < length; i++)
+    {
+        if ((string[i] & 0xC0) != 0x80)
+        {
+            return 0;
+        }
+    }
+
+    return length;
+}
+
+int32_t Utf8_AsciiPrefix(const char* string, int32_t length)
+{
+    int32_t i = 0;
+
+#if UTF8_USE_SSE2
+    for (; i + 16 <= length; i += 16)
+    {
+        const uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(string + i)));
+        if (mask != 0)
+        {
+            return i + Utf8_TrailingZeros32(mask);
+        }
+    }
+#endif
+
+    while (i < length && (uint8_t)string[i] < 0x80)
+    {
+        i++;
+    }
+
+    return i;
+}
+
+int32_t Utf8_ValidPrefix(const char* string, int32_t length)
+{
+    int32_t i = 0;
+    while (i < length)
+    {
+        i += Utf8_AsciiPrefix(string + i, length - i);
+        if (i >= length)
+        {
+            break;
+        }
+
+        const int32_t sequenceLength = Utf8_SequenceLength((const uint8_t*)string + i, length - i);
+        if (sequenceLength == 0)
+        {
+            break;
+        }
+
+        i += sequenceLength;
+    }
+
+    return i;
+}
+
+// -------------------------------------------------------------------
+// Vectorized lookup validator
+// Classify each byte pair with three 16-entries tables (high nibble of the previous byte,
+// low nibble of the previous byte, high nibble of the current byte), every invalid pair
+// has one error bit set in all three. 3rd/4th continuation bytes are checked separately.
+// See "Validating UTF-8 In Less Than One Instruction Per Byte", Keiser & Lemire.
+// -------------------------------------------------------------------
+
+#if UTF8_USE_SSSE3 || UTF8_USE_AVX2
+
+enum
+{
+    UTF8_TOO_SHORT      = 1 << 0,   // Lead byte followed by a lead byte or ASCII
+    UTF8_TOO_LONG       = 1 << 1,   // ASCII followed by continuation
+    UTF8_OVERLONG_3     = 1 << 2,
+    UTF8_TOO_LARGE      = 1 << 3,
+    UTF8_SURROGATE      = 1 << 4,
+    UTF8_OVERLONG_2     = 1 << 5,
+    UTF8_TOO_LARGE_1000 = 1 << 6,
+    UTF8_OVERLONG_4     = 1 << 6,
+    UTF8_TWO_CONTS      = 1 << 7,   // Two continuations, valid only for 3rd/4th bytes
+
+    UTF8_CARRY          = UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS,
+};
+
+#define UTF8_BYTE_1_HIGH_TABLE                                                                  \
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,                                 \
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,                                 \
+    UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS,                             \
+    UTF8_TOO_SHORT | UTF8_OVERLONG_2,                                                           \
+    UTF8_TOO_SHORT,                                                                             \
+    UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,                                          \
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+
+#define UTF8_BYTE_1_LOW_TABLE                                                                   \
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4,                           \
+    UTF8_CARRY | UTF8_OVERLONG_2,                                                               \
+    UTF8_CARRY,                                                                                 \
+    UTF8_CARRY,                                                                                 \
+    UTF8_CARRY | UTF8_TOO_LARGE,                                                                \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,                                          \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,                                          \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,                                          \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,                                          \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,                                          \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,                                          \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,                                          \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,                                          \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_SURROGATE,                         \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000,                                          \
+    UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000
+
+#define UTF8_BYTE_2_HIGH_TABLE                                                                  \
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,                             \
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,                             \
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4, \
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_OVERLONG_3 | UTF8_TOO_LARGE,        \
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,         \
+    UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS | UTF8_SURROGATE | UTF8_TOO_LARGE,         \
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+
+#endif
+
+#if UTF8_USE_SSSE3
+
+typedef __m128i Utf8Block;
+#define UTF8_BLOCK_SIZE 16
+
+static inline Utf8Block Utf8_Table(const uint8_t table[16])
+{
+    return _mm_loadu_si128((const __m128i*)table);
+}
+
+static inline Utf8Block Utf8_HighNibbles(Utf8Block input)
+{
+    return _mm_and_si128(_mm_srli_epi16(input, 4), _mm_set1_epi8(0x0F));
+}
+
+// Bytes of input shifted by n, the missing bytes come from the end of prev
+#define Utf8_Prev(input, prev, n) _mm_alignr_epi8(input, prev, 16 - (n))
+
+#define Utf8_Lookup     _mm_shuffle_epi8
+#define Utf8_And        _mm_and_si128
+#define Utf8_Or         _mm_or_si128
+#define Utf8_Xor        _mm_xor_si128
+#define Utf8_SubSat     _mm_subs_epu8
+#define Utf8_Set1       _mm_set1_epi8
+#define Utf8_Zero       _mm_setzero_si128
+#define Utf8_Load(p)    _mm_loadu_si128((const __m128i*)(p))
+#define Utf8_IsAscii(v) (_mm_movemask_epi8(v) == 0)
+#define Utf8_IsZero(v)  (_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_setzero_si128())) == 0xFFFF)
+
+#elif UTF8_USE_AVX2
+
+typedef __m256i Utf8Block;
+#define UTF8_BLOCK_SIZE 32
+
+// Tables are repeated in both 128-bit lanes, vpshufb does not cross lanes
+static inline Utf8Block Utf8_Table(const uint8_t table[16])
+{
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)table));
+}
+
+static inline Utf8Block Utf8_HighNibbles(Utf8Block input)
+{
+    return _mm256_and_si256(_mm256_srli_epi16(input, 4), _mm256_set1_epi8(0x0F));
+}
+
+#define Utf8_Prev(input, prev, n) _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - (n))
+
+#define Utf8_Lookup     _mm256_shuffle_epi8
+#define Utf8_And        _mm256_and_si256
+#define Utf8_Or         _mm256_or_si256
+#define Utf8_Xor        _mm256_xor_si256
+#define Utf8_SubSat     _mm256_subs_epu8
+#define Utf8_Set1       _mm256_set1_epi8
+#define Utf8_Zero       _mm256_setzero_si256
+#define Utf8_Load(p)    _mm256_loadu_si256((const __m256i*)(p))
+#define Utf8_IsAscii(v) (_mm256_movemask_epi8(v) == 0)
+#define Utf8_IsZero(v)  (_mm256_testz_si256(v, v) != 0)
+
+#endif
+
+#if UTF8_USE_SSSE3 || UTF8_USE_AVX2
+
+static const uint8_t UTF8_BYTE_1_HIGH[16]    = { UTF8_BYTE_1_HIGH_TABLE };
+static const uint8_t UTF8_BYTE_1_LOW[16]     = { UTF8_BYTE_1_LOW_TABLE };
+static const uint8_t UTF8_BYTE_2_HIGH[16]    = { UTF8_BYTE_2_HIGH_TABLE };
+
+typedef struct Utf8Validator
+{
+    Utf8Block   byte1High;
+    Utf8Block   byte1Low;
+    Utf8Block   byte2High;
+    Utf8Block   incompleteMax;
+
+    Utf8Block   error;
+    Utf8Block   prevInput;
+    Utf8Block   prevIncomplete;
+} Utf8Validator;
+
+static inline void Utf8Validator_Init(Utf8Validator* validator)
+{
+    validator->byte1High        = Utf8_Table(UTF8_BYTE_1_HIGH);
+    validator->byte1Low         = Utf8_Table(UTF8_BYTE_1_LOW);
+    validator->byte2High        = Utf8_Table(UTF8_BYTE_2_HIGH);
+
+    // Last bytes of a block that start a sequence not finished in the block
+    uint8_t incompleteMax[UTF8_BLOCK_SIZE];
+    memset(incompleteMax, 0xFF, sizeof(incompleteMax));
+    incompleteMax[UTF8_BLOCK_SIZE - 3] = 0xF0 - 1;
+    incompleteMax[UTF8_BLOCK_SIZE - 2] = 0xE0 - 1;
+    incompleteMax[UTF8_BLOCK_SIZE - 1] = 0xC0 - 1;
+    validator->incompleteMax    = Utf8_Load(incompleteMax);
+
+    validator->error            = Utf8_Zero();
+    validator->prevInput        = Utf8_Zero();
+    validator->prevIncomplete   = Utf8_Zero();
+}
+
+static inline void Utf8Validator_Next(Utf8Validator* validator, Utf8Block input)
+{
+    // ASCII block: only a sequence left open by the previous block can be wrong
+    if (Utf8_IsAscii(input))
+    {
+        validator->error = Utf8_Or(validator->error, validator->prevIncomplete);
+        validator->prevInput = input;
+        validator->prevIncomplete = Utf8_Zero();
+        return;
+    }
+
+    const Utf8Block prev1 = Utf8_Prev(input, validator->prevInput, 1);
+    const Utf8Block lowNibbleMask = Utf8_Set1(0x0F);
+
+    const Utf8Block byte1High = Utf8_Lookup(validator->byte1High, Utf8_HighNibbles(prev1));
+    const Utf8Block byte1Low = Utf8_Lookup(validator->byte1Low, Utf8_And(prev1, lowNibbleMask));
+    const Utf8Block byte2High = Utf8_Lookup(validator->byte2High, Utf8_HighNibbles(input));
+    const Utf8Block specialCases = Utf8_And(Utf8_And(byte1High, byte1Low), byte2High);
+
+    // 3rd and 4th bytes of a sequence must be continuations, they have TWO_CONTS (0x80) set
+    const Utf8Block prev2 = Utf8_Prev(input, validator->prevInput, 2);
+    const Utf8Block prev3 = Utf8_Prev(input, validator->prevInput, 3);
+    const Utf8Block isThirdByte = Utf8_SubSat(prev2, Utf8_Set1((char)(0xE0 - 0x80)));
+    const Utf8Block isFourthByte = Utf8_SubSat(prev3, Utf8_Set1((char)(0xF0 - 0x80)));
+    const Utf8Block must23 = Utf8_And(Utf8_Or(isThirdByte, isFourthByte), Utf8_Set1((char)0x80));
+
+    validator->error = Utf8_Or(validator->error, Utf8_Xor(must23, specialCases));
+    validator->prevInput = input;
+    validator->prevIncomplete = Utf8_SubSat(input, validator->incompleteMax);
+}
+
+bool Utf8_Validate(const char* string, int32_t length)
+{
+    Utf8Validator validator;
+    Utf8Validator_Init(&validator);
+
+    int32_t i = 0;
+    for (; i + UTF8_BLOCK_SIZE <= length; i += UTF8_BLOCK_SIZE)
+    {
+        Utf8Validator_Next(&validator, Utf8_Load(string + i));
+    }
+
+    // Zero padding is ASCII, a sequence truncated by the end of string is reported as incomplete
+    if (i < length)
+    {
+        char tail[UTF8_BLOCK_SIZE] = { 0 };
+        memcpy(tail, string + i, (size_t)(length - i));
+        Utf8Validator_Next(&validator, Utf8_Load(tail));
+    }
+
+    validator.error = Utf8_Or(validator.error, validator.prevIncomplete);
+    return Utf8_IsZero(validator.error);
+}
+
+#else
+
+bool Utf8_Validate(const char* string, int32_t length)
+{
+    return Utf8_ValidPrefix(string, length) == length;
+}
+
+#endif
+
+// -------------------------------------------------------------------
+// Transcoding
+// -------------------------------------------------------------------
+
+int32_t Utf8_Encode(char* out, uint32_t codepoint)
+{
+    if (codepoint < 0x80)
+    {
+        out[0] = (char)codepoint;
+        return 1;
+    }
+    else if (codepoint < 0x800)
+    {
+        out[0] = (char)(0xC0 | (codepoint >> 6));
+        out[1] = (char)(0x80 | (codepoint & 0x3F));
+        return 2;
+    }
+    else if (codepoint < 0x10000)
+    {
+        if (codepoint >= 0xD800 && codepoint <= 0xDFFF)
+        {
+            return 0;
+        }
+
+        out[0] = (char)(0xE0 | (codepoint >> 12));
+        out[1] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (codepoint & 0x3F));
+        return 3;
+    }
+    else if (codepoint <= 0x10FFFF)
+    {
+        out[0] = (char)(0xF0 | (codepoint >> 18));
+        out[1] = (char)(0x80 | ((codepoint >> 12) & 0x3F));
+        out[2] = (char)(0x80 | ((codepoint >> 6) & 0x3F));
+        out[3] = (char)(0x80 | (codepoint & 0x3F));
+        return 4;
+    }
+
+    return 0;
+}
+
+// Parse "\uXXXX", return the code unit, -1 when malformed
+static int32_t Utf8_ParseEscapeUnit(const char* string, int32_t length)
+{
+    if (length < 6 || string[0] != '\\' || string[1] != 'u')
+    {
+        return -1;
+    }
+
+    int32_t unit = 0;
+    for (int32_t i = 2; i < 6; i++)
+    {
+        const char c = string[i];
+
+        int32_t digit;
+        if (c >= '0' && c <= '9')
+        {
+            digit = c - '0';
+        }
+        else if (c >= 'a' && c <= 'f')
+        {
+            digit = c - 'a' + 10;
+        }
+        else if (c >= 'A' && c <= 'F')
+        {
+            digit = c - 'A' + 10;
+        }
+        else
+        {
+            return -1;
+        }
+
+        unit = (unit << 4) | digit;
+    }
+
+    return unit;
+}
+
+int32_t Utf8_DecodeUnicodeEscape(const char* string, int32_t length, char* out, int32_t* outConsumed)
+{
+    const int32_t unit = Utf8_ParseEscapeUnit(string, length);
+    if (unit < 0)
+    {
+        return 0;
+    }
+
+    uint32_t codepoint = (uint32_t)unit;
+    int32_t consumed = 6;
+
+    // UTF-16 surrogate pair, the high surrogate must be followed by a low surrogate escape
+    if (unit >= 0xD800 && unit <= 0xDBFF)
+    {
+        const int32_t low = Utf8_ParseEscapeUnit(string + 6, length - 6);
+        if (low < 0xDC00 || low > 0xDFFF)
+        {
+            return 0;
+        }
+
+        codepoint = 0x10000 + (((uint32_t)unit - 0xD800) << 10) + ((uint32_t)low - 0xDC00);
+        consumed = 12;
+    }
+
+    const int32_t written = Utf8_Encode(out, codepoint);
+    if (written > 0 && outConsumed)
+    {
+        *outConsumed = consumed;
+    }
+
+    return written;
+}
+
+//! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
+
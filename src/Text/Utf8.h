@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/// UTF-8 helpers shared by Json.c and Text
+/// Validation follows RFC 3629: no overlong forms, no surrogates, nothing above U+10FFFF.
+/// Plain C interface, Json.c is compiled as C.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// Number of leading ASCII bytes, scan 16 bytes at once
+int32_t     Utf8_AsciiPrefix(const char* string, int32_t length);
+
+/// Check that length bytes of string are valid UTF-8
+/// Use a vectorized lookup validator with SSSE3/AVX2, ASCII runs are skipped 16 bytes at once otherwise
+bool        Utf8_Validate(const char* string, int32_t length);
+
+/// Length of the longest valid prefix of string, always ends on a code point boundary
+/// Use it to truncate strings or to locate the first invalid sequence
+int32_t     Utf8_ValidPrefix(const char* string, int32_t length);
+
+/// Encode codepoint, out must have room for 4 bytes
+/// Return number of bytes written, 0 for surrogates and values above U+10FFFF
+int32_t     Utf8_Encode(char* out, uint32_t codepoint);
+
+/// Decode a JSON "\uXXXX" escape (string point to the backslash), followed by its low surrogate escape if any
+/// Write UTF-8 to out (4 bytes room), outConsumed receive the number of escape bytes read (6 or 12)
+/// Return number of bytes written, 0 for bad hex digits or unpaired surrogates
+int32_t     Utf8_DecodeUnicodeEscape(const char* string, int32_t length, char* out, int32_t* outConsumed);
+
+#ifdef __cplusplus
+}
+#endif
+
+//! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
+
@@ -0,0 +1,168 @@
+// LDtk cooker
+// Parse a .ldtk world and write it as a cooked world, the game map it
+// instead of parsing the world while the .ldtk file is not modified.
+//
+// Usage: ldtk_cook <world.ldtk> [output] [--layer-reverse-order]
+//      output                  default <world.ldtk>.cooked, next to the world
+//      --layer-reverse-order   cook with LDtkParseFlags_LayerReverseOrder, what the game use
+
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Misc/LDtkParser.h"
+#include "Misc/LDtkCooker.h"
+
+static void Usage(const char* program)
+{
+    fprintf(stderr, "Usage: %s <world.ldtk> [output] [--layer-reverse-order]\n", program);
+}
+
+// Parse the world in a buffer of the queried size, the world point into *outBuffer
+static LDtkError ParseWorld(const char* ldtkPath, LDtkParseFlags flags, LDtkWorld* outWorld, void** outBuffer)
+{
+    int32_t bufferSize = 64 * 1024;
+    void* buffer = malloc(bufferSize);
+
+    int32_t worldBufferSize;
+    LDtkError error;
+    while ((error = LDtkQueryMemory(ldtkPath, LDtkContextDefault(buffer, bufferSize), flags, &worldBufferSize)).code == LDtkErrorCode_OutOfMemory
+        && worldBufferSize > bufferSize)
+    {
+        bufferSize = worldBufferSize;
+        free(buffer);
+        buffer = malloc(bufferSize);
+    }
+
+    if (error.code == LDtkErrorCode_None)
+    {
+        bufferSize = worldBufferSize;
+        free(buffer);
+        buffer = malloc(bufferSize);
+        error = LDtkParse(ldtkPath, LDtkContextDefault(buffer, bufferSize), flags, outWorld);
+    }
+
+    if (error.code != LDtkErrorCode_None)
+    {
+        free(buffer);
+        buffer = NULL;
+    }
+
+    *outBuffer = buffer;
+    return error;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* ldtkPath = NULL;
+    const char* outputPath = NULL;
+    LDtkParseFlags flags = LDtkParseFlags_None;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--layer-reverse-order") == 0)
+        {
+            flags = LDtkParseFlags_LayerReverseOrder;
+        }
+        else if (!ldtkPath)
+        {
+            ldtkPath = argv[i];
+        }
+        else if (!outputPath)
+        {
+            outputPath = argv[i];
+        }
+        else
+        {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!ldtkPath)
+    {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    char defaultOutputPath[1024];
+    if (!outputPath)
+    {
+        snprintf(defaultOutputPath, sizeof(defaultOutputPath), "%s.cooked", ldtkPath);
+        outputPath = defaultOutputPath;
+    }
+
+    // Stamp before parsing, a world saved while it is cooked is stale
+    LDtkSourceStamp stamp;
+    if (!LDtkGetSourceStamp(ldtkPath, &stamp))
+    {
+        fprintf(stderr, "Cannot find %s\n", ldtkPath);
+        return 1;
+    }
+
+    // The level index give the external level files, they are stamped before the levels are parsed too
+    LDtkWorld levelIndex;
+    void* indexBuffer;
+    LDtkError error = ParseWorld(ldtkPath, flags | LDtkParseFlags_LevelIndex, &levelIndex, &indexBuffer);
+
+    LDtkLevelSource* levelSources = NULL;
+    int32_t levelSourceCount = 0;
+    if (error.code == LDtkErrorCode_None)
+    {
+        levelSourceCount = LDtkGetLevelSources(&levelIndex, NULL, 0);
+        levelSources = (LDtkLevelSource*)malloc(sizeof(LDtkLevelSource) * (size_t)(levelSourceCount + 1));
+        LDtkGetLevelSources(&levelIndex, levelSources, levelSourceCount);
+    }
+
+    LDtkWorld world;
+    void* buffer = NULL;
+    if (error.code == LDtkErrorCode_None)
+    {
+        error = ParseWorld(ldtkPath, flags, &world, &buffer);
+    }
+
+    if (error.code != LDtkErrorCode_None)
+    {
+        fprintf(stderr, "Parse %s failed: %s\n", ldtkPath, error.message);
+        free(levelSources);
+        free(indexBuffer);
+        return 1;
+    }
+
+    int32_t cookedSize;
+    void* cooked = NULL;
+    error = LDtkCook(&world, flags, stamp, levelSources, levelSourceCount, NULL, 0, &cookedSize);
+    if (error.code == LDtkErrorCode_None)
+    {
+        cooked = malloc(cookedSize);
+        error = LDtkCook(&world, flags, stamp, levelSources, levelSourceCount, cooked, cookedSize, &cookedSize);
+    }
+
+    free(levelSources);
+    free(indexBuffer);
+    free(buffer);
+    if (error.code != LDtkErrorCode_None)
+    {
+        fprintf(stderr, "Cook %s failed: %s\n", ldtkPath, error.message);
+        free(cooked);
+        return 1;
+    }
+
+    FILE* file = fopen(outputPath, "wb");
+    if (!file || fwrite(cooked, 1, cookedSize, file) != (size_t)cookedSize)
+    {
+        fprintf(stderr, "Cannot write %s\n", outputPath);
+        if (file) fclose(file);
+        free(cooked);
+        return 1;
+    }
+
+    fclose(file);
+    free(cooked);
+
+    printf("%s: %d levels, %d KB\n", outputPath, world.levelCount, cookedSize / 1024);
+    return 0;
+}
+
+//! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
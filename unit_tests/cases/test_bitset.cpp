@@ -0,0 +1,195 @@
+#include "../test_framework.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "Container/Bitset.h"
+
+// Bit count not multiple of the word size, so the tail word is exercised
+constexpr int32_t TEST_BIT_COUNT = 1000;
+
+static TestRandom gBitsetRandom(3);
+
+// Compare every query of the bitset with a reference array of bools
+template <typename Derived>
+static bool Bitset_MatchReference(const BitsetOps<Derived>& bitset, const bool* reference, int32_t bitCount)
+{
+    int32_t count = 0;
+    for (int32_t i = 0; i < bitCount; i++)
+    {
+        if (bitset.Get(i) != reference[i] || bitset.Rank(i) != count)
+        {
+            return false;
+        }
+        count += reference[i];
+    }
+
+    if (bitset.Count() != count || bitset.Rank(bitCount) != count || bitset.Any() != (count > 0))
+    {
+        return false;
+    }
+
+    // Searches from every start agree with a linear scan
+    for (int32_t start = 0; start < bitCount; start++)
+    {
+        int32_t next = -1;
+        int32_t nextClear = -1;
+        for (int32_t i = bitCount - 1; i >= start; i--)
+        {
+            next = reference[i] ? i : next;
+            nextClear = !reference[i] ? i : nextClear;
+        }
+
+        if (bitset.FindNext(start) != next || bitset.FindNextClear(start) != nextClear)
+        {
+            return false;
+        }
+    }
+
+    int32_t iterateCount = 0;
+    int32_t lastIndex = -1;
+    bool iterateMatch = true;
+    bitset.ForEach([&](int32_t index) {
+        iterateMatch = iterateMatch && index > lastIndex && index < bitCount && reference[index];
+        lastIndex = index;
+        iterateCount++;
+    });
+
+    // Bits past the bit count stay zero
+    const uint64_t* words = bitset.Words();
+    const int32_t tailBits = bitCount % BITSET_WORD_BITS;
+    const bool tailClear = tailBits == 0 || (words[bitset.WordCount() - 1] >> tailBits) == 0;
+
+    return iterateMatch && iterateCount == count && bitset.FindFirst() == bitset.FindNext(0) && tailClear;
+}
+
+template <typename Derived>
+static void Bitset_RandomOps(BitsetOps<Derived>& bitset, bool* reference, int32_t bitCount, int32_t steps)
+{
+    for (int32_t step = 0; step < steps; step++)
+    {
+        const int32_t index = (int32_t)gBitsetRandom.Next((uint32_t)bitCount);
+        switch (gBitsetRandom.Next(6))
+        {
+        case 0:
+            bitset.Set(index);
+            reference[index] = true;
+            break;
+
+        case 1:
+            bitset.Clear(index);
+            reference[index] = false;
+            break;
+
+        case 2:
+            bitset.Toggle(index);
+            reference[index] = !reference[index];
+            break;
+
+        case 3:
+            bitset.Assign(index, (step & 1) != 0);
+            reference[index] = (step & 1) != 0;
+            break;
+
+        case 4:
+        case 5:
+        {
+            const int32_t end = index + (int32_t)gBitsetRandom.Next((uint32_t)(bitCount - index + 1));
+            const bool value = gBitsetRandom.Next(2) != 0;
+            value ? bitset.SetRange(index, end) : bitset.ClearRange(index, end);
+            for (int32_t i = index; i < end; i++)
+            {
+                reference[i] = value;
+            }
+            break;
+        }
+        }
+    }
+}
+
+DEFINE_UNIT_TEST("Bitset unit tests: fixed bitset against a reference")
+{
+    static bool reference[TEST_BIT_COUNT];
+    memset(reference, 0, sizeof(reference));
+
+    FixedBitset<TEST_BIT_COUNT> bitset;
+    TEST(bitset.Count() == 0 && !bitset.Any() && bitset.FindFirst() == -1);
+    TEST(bitset.FindNextClear(0) == 0);
+
+    for (int32_t round = 0; round < 20; round++)
+    {
+        Bitset_RandomOps(bitset, reference, TEST_BIT_COUNT, 200);
+        TEST(Bitset_MatchReference(bitset, reference, TEST_BIT_COUNT));
+    }
+
+    bitset.SetAll();
+    memset(reference, 1, sizeof(reference));
+    TEST(Bitset_MatchReference(bitset, reference, TEST_BIT_COUNT));
+    TEST(bitset.FindNextClear(0) == -1);
+
+    bitset.ClearAll();
+    memset(reference, 0, sizeof(reference));
+    TEST(Bitset_MatchReference(bitset, reference, TEST_BIT_COUNT));
+}
+
+DEFINE_UNIT_TEST("Bitset unit tests: set operations")
+{
+    static bool referenceA[TEST_BIT_COUNT];
+    static bool referenceB[TEST_BIT_COUNT];
+    static bool expected[TEST_BIT_COUNT];
+    memset(referenceA, 0, sizeof(referenceA));
+    memset(referenceB, 0, sizeof(referenceB));
+
+    FixedBitset<TEST_BIT_COUNT> a;
+    FixedBitset<TEST_BIT_COUNT> b;
+    Bitset_RandomOps(a, referenceA, TEST_BIT_COUNT, 500);
+    Bitset_RandomOps(b, referenceB, TEST_BIT_COUNT, 500);
+
+    FixedBitset<TEST_BIT_COUNT> result = a;
+    result.And(b);
+    for (int32_t i = 0; i < TEST_BIT_COUNT; i++) expected[i] = referenceA[i] && referenceB[i];
+    TEST(Bitset_MatchReference(result, expected, TEST_BIT_COUNT));
+
+    result = a;
+    result.Or(b);
+    for (int32_t i = 0; i < TEST_BIT_COUNT; i++) expected[i] = referenceA[i] || referenceB[i];
+    TEST(Bitset_MatchReference(result, expected, TEST_BIT_COUNT));
+
+    result = a;
+    result.AndNot(b);
+    for (int32_t i = 0; i < TEST_BIT_COUNT; i++) expected[i] = referenceA[i] && !referenceB[i];
+    TEST(Bitset_MatchReference(result, expected, TEST_BIT_COUNT));
+}
+
+DEFINE_UNIT_TEST("Bitset unit tests: dynamic bitset resize")
+{
+    MEMORY_TRACKING();
+
+    static bool reference[TEST_BIT_COUNT];
+    memset(reference, 0, sizeof(reference));
+
+    Bitset bitset;
+    TEST(bitset.Resize(100));
+    Bitset_RandomOps(bitset, reference, 100, 300);
+    TEST(Bitset_MatchReference(bitset, reference, 100));
+
+    // Growing keep the bits and clear the new ones
+    TEST(bitset.Resize(TEST_BIT_COUNT));
+    TEST(Bitset_MatchReference(bitset, reference, TEST_BIT_COUNT));
+
+    Bitset_RandomOps(bitset, reference, TEST_BIT_COUNT, 1000);
+    TEST(Bitset_MatchReference(bitset, reference, TEST_BIT_COUNT));
+
+    // Shrinking then growing must not bring the dropped bits back
+    TEST(bitset.Resize(130));
+    TEST(Bitset_MatchReference(bitset, reference, 130));
+
+    memset(reference + 130, 0, sizeof(reference) - 130);
+    TEST(bitset.Resize(TEST_BIT_COUNT));
+    TEST(Bitset_MatchReference(bitset, reference, TEST_BIT_COUNT));
+
+    TEST(bitset.Resize(0));
+    TEST(bitset.Count() == 0 && !bitset.Any() && bitset.FindFirst() == -1);
+
+    bitset.CleanUp();
+}
@@ -0,0 +1,256 @@
+#include "../test_framework.h"
+
+#include <stdint.h>
+
+#include "Native/Memory.h"
+#include "Game/Components.h"
+
+struct Health
+{
+    int32_t     value;
+};
+
+struct Speed
+{
+    float       value;
+    int32_t     padding[3];
+};
+
+// Group invariant: [0, groupCount) is the same entity in both pools, and nothing after it is in both
+static bool Components_IsGroupPacked(ComponentPool<Health>& healths, ComponentPool<Speed>& speeds, int32_t groupCount)
+{
+    for (int32_t i = 0; i < groupCount; i++)
+    {
+        if (healths.entities[i] != speeds.entities[i])
+        {
+            return false;
+        }
+    }
+
+    for (int32_t i = groupCount; i < healths.Count(); i++)
+    {
+        if (speeds.Contains(healths.entities[i]))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+DEFINE_UNIT_TEST("Components unit tests: entity handles")
+{
+    MEMORY_TRACKING();
+
+    World world;
+    World_Init(&world);
+
+    TEST(!world.entities.IsAlive(ENTITY_NONE));
+
+    const EntityId first = World_CreateEntity(&world);
+    TEST(first != ENTITY_NONE && world.entities.IsAlive(first));
+
+    TEST(World_DeferDestroyEntity(&world, first));
+    TEST(world.entities.IsAlive(first));
+    World_Sync(&world);
+    TEST(!world.entities.IsAlive(first));
+
+    // Destroying twice is rejected
+    TEST(!world.entities.Destroy(first));
+
+    // The slot is reused with a new generation, the stale handle stay dead
+    const EntityId second = World_CreateEntity(&world);
+    TEST(Entity_GetIndex(second) == Entity_GetIndex(first));
+    TEST(Entity_GetGeneration(second) != Entity_GetGeneration(first));
+    TEST(world.entities.IsAlive(second) && !world.entities.IsAlive(first));
+    TEST(world.entities.count == 1);
+
+    // Generations wrap without ever making the null entity
+    EntityId entity = second;
+    for (uint32_t i = 0; i < ENTITY_GENERATION_MASK + 2; i++)
+    {
+        TEST(world.entities.Destroy(entity));
+        entity = World_CreateEntity(&world);
+        TEST(entity != ENTITY_NONE && Entity_GetGeneration(entity) != 0);
+    }
+
+    World_CleanUp(&world);
+}
+
+DEFINE_UNIT_TEST("Components unit tests: sparse set add and remove")
+{
+    MEMORY_TRACKING();
+
+    World world;
+    World_Init(&world);
+
+    ComponentPool<Health> healths("Health");
+    World_AddPool(&world, &healths);
+
+    EntityId entities[100];
+    for (int32_t i = 0; i < 100; i++)
+    {
+        entities[i] = World_CreateEntity(&world);
+        TEST(healths.Add(entities[i], Health{ i }) != nullptr);
+    }
+    TEST(healths.Count() == 100);
+
+    // Add overwrite the value of an entity already in the set
+    TEST(healths.Add(entities[5], Health{ 500 })->value == 500);
+    TEST(healths.Count() == 100);
+
+    // Remove every even entity, the last one is swapped into the holes
+    for (int32_t i = 0; i < 100; i += 2)
+    {
+        TEST(healths.Remove(entities[i]));
+        TEST(!healths.Remove(entities[i]));
+    }
+    TEST(healths.Count() == 50);
+
+    for (int32_t i = 0; i < 100; i++)
+    {
+        const Health* health = healths.Get(entities[i]);
+        TEST((health != nullptr) == (i % 2 == 1));
+        TEST(!health || health->value == (i == 5 ? 500 : i));
+    }
+
+    // Dense arrays stay in sync with the sparse lookup
+    for (int32_t i = 0; i < healths.Count(); i++)
+    {
+        TEST(healths.Get(healths.entities[i]) == &healths.Values()[i]);
+    }
+
+    // Stale handles do not see the component of the entity reusing their slot
+    TEST(World_DeferDestroyEntity(&world, entities[1]));
+    World_Sync(&world);
+    TEST(!healths.Contains(entities[1]));
+
+    const EntityId reused = World_CreateEntity(&world);
+    TEST(Entity_GetIndex(reused) == Entity_GetIndex(entities[1]));
+    TEST(healths.Add(reused, Health{ -1 }) != nullptr);
+    TEST(healths.Get(entities[1]) == nullptr);
+    TEST(healths.Get(reused)->value == -1);
+
+    World_CleanUp(&world);
+}
+
+DEFINE_UNIT_TEST("Components unit tests: deferred changes and World_Sync")
+{
+    MEMORY_TRACKING();
+
+    World world;
+    World_Init(&world);
+
+    ComponentPool<Health> healths("Health");
+    ComponentPool<Speed> speeds("Speed");
+    World_AddPool(&world, &healths);
+    World_AddPool(&world, &speeds);
+
+    EntityId entities[64];
+    for (int32_t i = 0; i < 64; i++)
+    {
+        entities[i] = World_CreateEntity(&world);
+        healths.Add(entities[i], Health{ i });
+    }
+
+    // Structural changes inside a view are deferred, the pools do not move while iterating
+    int32_t visitCount = 0;
+    View_ForEach([&](EntityId entity, Health& health) {
+        visitCount++;
+        if (health.value % 2 == 0)
+        {
+            TEST(healths.DeferRemove(entity));
+        }
+        else
+        {
+            TEST(speeds.DeferAdd(entity, Speed{ (float)health.value }));
+        }
+    }, healths);
+
+    TEST(visitCount == 64);
+    TEST(healths.Count() == 64 && speeds.Count() == 0);
+
+    // Destroying in the same frame remove every component of the entity
+    TEST(World_DeferDestroyEntity(&world, entities[1]));
+
+    World_Sync(&world);
+    TEST(healths.Count() == 31);
+    TEST(speeds.Count() == 31);
+    TEST(!world.entities.IsAlive(entities[1]));
+    TEST(!healths.Contains(entities[1]) && !speeds.Contains(entities[1]));
+
+    for (int32_t i = 2; i < 64; i++)
+    {
+        TEST(healths.Contains(entities[i]) == (i % 2 == 1));
+        TEST(speeds.Contains(entities[i]) == (i % 2 == 1));
+        TEST(!speeds.Contains(entities[i]) || speeds.Get(entities[i])->value == (float)i);
+    }
+
+    // A second sync has nothing left to apply
+    World_Sync(&world);
+    TEST(healths.Count() == 31 && speeds.Count() == 31);
+
+    World_CleanUp(&world);
+}
+
+DEFINE_UNIT_TEST("Components unit tests: group packing after removals")
+{
+    MEMORY_TRACKING();
+
+    World world;
+    World_Init(&world);
+
+    ComponentPool<Health> healths("Health");
+    ComponentPool<Speed> speeds("Speed");
+    World_AddPool(&world, &healths);
+    World_AddPool(&world, &speeds);
+
+    constexpr int32_t ENTITY_COUNT = 300;
+    EntityId entities[ENTITY_COUNT];
+    for (int32_t i = 0; i < ENTITY_COUNT; i++)
+    {
+        entities[i] = World_CreateEntity(&world);
+        healths.Add(entities[i], Health{ i });
+        if (i % 3 != 0)
+        {
+            speeds.Add(entities[i], Speed{ (float)i });
+        }
+    }
+
+    int32_t groupCount = View_Group(healths, speeds);
+    TEST(groupCount == 200);
+    TEST(Components_IsGroupPacked(healths, speeds, groupCount));
+
+    // Removals swap entities around, grouping again must pack them back
+    for (int32_t i = 0; i < ENTITY_COUNT; i += 7)
+    {
+        speeds.Remove(entities[i]);
+    }
+    for (int32_t i = 0; i < ENTITY_COUNT; i += 11)
+    {
+        TEST(World_DeferDestroyEntity(&world, entities[i]));
+    }
+    World_Sync(&world);
+
+    int32_t expectedCount = 0;
+    for (int32_t i = 0; i < ENTITY_COUNT; i++)
+    {
+        expectedCount += (i % 3 != 0 && i % 7 != 0 && i % 11 != 0);
+    }
+
+    groupCount = View_Group(healths, speeds);
+    TEST(groupCount == expectedCount);
+    TEST(Components_IsGroupPacked(healths, speeds, groupCount));
+
+    // Packed values still belong to their entity
+    for (int32_t i = 0; i < groupCount; i++)
+    {
+        TEST((float)healths.Values()[i].value == speeds.Values()[i].value);
+    }
+
+    // Grouping a packed group is a no-op
+    TEST(View_Group(healths, speeds) == groupCount);
+    TEST(Components_IsGroupPacked(healths, speeds, groupCount));
+
+    World_CleanUp(&world);
+}
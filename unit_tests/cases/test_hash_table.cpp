@@ -0,0 +1,164 @@
+#include "../test_framework.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "Container/HashTable.h"
+
+// Every key land in the same probe group, the table have to walk past tombstones and full groups
+struct CollideTraits
+{
+    static inline uint64_t Hash(int32_t key)
+    {
+        return (uint64_t)(key & 3);
+    }
+
+    static inline bool Equals(int32_t a, int32_t b)
+    {
+        return a == b;
+    }
+};
+
+static TestRandom gTableRandom(7);
+
+// Run random inserts and removes, then compare every key with a reference array indexed by key
+template <typename TTraits>
+static void HashTable_TestAgainstReference(int32_t keyRange, int32_t steps)
+{
+    int32_t* reference = (int32_t*)Memory_Alloc((int32_t)sizeof(int32_t) * keyRange, alignof(int32_t));
+    for (int32_t i = 0; i < keyRange; i++)
+    {
+        reference[i] = -1;
+    }
+
+    HashTable<int32_t, int32_t, TTraits> table;
+
+    int32_t referenceCount = 0;
+    for (int32_t step = 0; step < steps; step++)
+    {
+        const int32_t key = (int32_t)gTableRandom.Next((uint32_t)keyRange);
+        if (gTableRandom.Next(100) < 55)
+        {
+            TEST(table.SetValue(key, step));
+            referenceCount += reference[key] < 0;
+            reference[key] = step;
+        }
+        else
+        {
+            TEST(table.Remove(key) == (reference[key] >= 0));
+            referenceCount -= reference[key] >= 0;
+            reference[key] = -1;
+        }
+
+        TEST(table.Count() == referenceCount);
+    }
+
+    for (int32_t key = 0; key < keyRange; key++)
+    {
+        int32_t value;
+        TEST(table.TryGetValue(key, &value) == (reference[key] >= 0));
+        TEST(reference[key] < 0 || value == reference[key]);
+        TEST(table.GetValue(key, -1) == reference[key]);
+    }
+
+    // Slot iteration see every entry once
+    int32_t iterateCount = 0;
+    table.ForEach([&](const int32_t& key, int32_t& value) {
+        TEST(reference[key] == value);
+        iterateCount++;
+    });
+    TEST(iterateCount == referenceCount);
+
+    table.CleanUp();
+    Memory_Free(reference);
+}
+
+DEFINE_UNIT_TEST("HashTable unit tests: empty table")
+{
+    MEMORY_TRACKING();
+
+    HashTable<int32_t, int32_t> table;
+    TEST(table.Count() == 0 && table.Capacity() == 0);
+    TEST(table.IndexOf(1) == -1);
+    TEST(!table.ContainsKey(1));
+    TEST(!table.Remove(1));
+    TEST(table.GetValue(1, 42) == 42);
+
+    table.CleanUp();
+}
+
+DEFINE_UNIT_TEST("HashTable unit tests: insert, erase and find against a reference")
+{
+    MEMORY_TRACKING();
+
+    HashTable_TestAgainstReference<HashTraits<int32_t>>(4096, 200000);
+}
+
+DEFINE_UNIT_TEST("HashTable unit tests: colliding hashes")
+{
+    MEMORY_TRACKING();
+
+    HashTable_TestAgainstReference<CollideTraits>(200, 20000);
+}
+
+DEFINE_UNIT_TEST("HashTable unit tests: growth and tombstones")
+{
+    MEMORY_TRACKING();
+
+    HashTable<int32_t, int32_t> table;
+
+    // Growth keep every entry
+    for (int32_t i = 0; i < 10000; i++)
+    {
+        TEST(table.SetValue(i, i * 2));
+    }
+    TEST(table.Count() == 10000);
+    TEST(table.Count() <= table.Capacity() - table.Capacity() / 8);
+
+    for (int32_t i = 0; i < 10000; i++)
+    {
+        TEST(table.GetValue(i) == i * 2);
+    }
+
+    // Insert/remove churn on a small working set must not grow the table forever
+    table.Clear();
+    TEST(table.Count() == 0);
+
+    const int32_t capacity = table.Capacity();
+    for (int32_t i = 0; i < 100000; i++)
+    {
+        TEST(table.SetValue(i, i));
+        TEST(table.Remove(i));
+    }
+    TEST(table.Count() == 0 && table.Capacity() == capacity);
+
+    // Reserve do not rehash when there is already room
+    TEST(table.Reserve(100));
+    TEST(table.Capacity() == capacity);
+
+    table.CleanUp();
+    TEST(table.Capacity() == 0);
+}
+
+DEFINE_UNIT_TEST("HashTable unit tests: string keys")
+{
+    MEMORY_TRACKING();
+
+    HashTable<const char*, int32_t> table;
+
+    char key[] = "level_0";
+    TEST(table.SetValue("level_0", 1));
+    TEST(table.SetValue("level_1", 2));
+
+    // Keys are compared by content, not by pointer
+    TEST(table.GetValue(key, 0) == 1);
+    key[6] = '1';
+    TEST(table.GetValue(key, 0) == 2);
+    key[6] = '2';
+    TEST(!table.ContainsKey(key));
+
+    TEST(table.Remove("level_0"));
+    TEST(!table.ContainsKey("level_0") && table.Count() == 1);
+
+    table.CleanUp();
+}
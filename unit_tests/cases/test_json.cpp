@@ -1,50 +1,332 @@
 #include "../test_framework.h"
 
-#if 0
-#include "Text/Json.h"
-#include "Text/JsonSchema.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "Misc/Json.h"
+
+static char gJsonBuffer[1024 * 1024];
+
+static Json ParseJson(const char* jsonCode, JsonParseFlags flags = JsonParseFlags_Default)
+{
+    Json json;
+    const JsonResult result = JsonParse(jsonCode, (int32_t)strlen(jsonCode), flags, gJsonBuffer, sizeof(gJsonBuffer), &json);
+    TEST(result.error == JsonError_None);
+    return json;
+}
+
+static JsonError ParseJsonError(const char* jsonCode, JsonParseFlags flags = JsonParseFlags_Default)
+{
+    Json json;
+    return JsonParse(jsonCode, (int32_t)strlen(jsonCode), flags, gJsonBuffer, sizeof(gJsonBuffer), &json).error;
+}
 
 DEFINE_UNIT_TEST("Json unit tests: object")
 {
-    const char jsonCode[] = "{}";
-    Json* json = Json_Parse(jsonCode, sizeof(jsonCode) - 1, JsonFlags_None);
-    TEST(json != nullptr && json->type == JsonType_Object && Json_GetError(json) == JsonError_None);
-    
-    Json_Destroy(json);
+    const Json json = ParseJson("{}");
+    TEST(json.type == JsonType_Object && json.length == 0);
 }
 
 DEFINE_UNIT_TEST("Json unit tests: array")
 {
-    const char jsonCode[] = "[]";
-    Json* json = Json_Parse(jsonCode, sizeof(jsonCode) - 1, JsonFlags_None);
-    TEST(json != nullptr && json->type == JsonType_Array && Json_GetError(json) == JsonError_None);
-
-    Json_Destroy(json);
+    const Json json = ParseJson("[1, true, null, \"a\", [], {}]");
+    TEST(json.type == JsonType_Array && json.length == 6);
+    TEST(json.array[1].type == JsonType_Boolean && json.array[1].boolean);
+    TEST(json.array[2].type == JsonType_Null);
+    TEST(json.array[4].type == JsonType_Array && json.array[5].type == JsonType_Object);
 }
 
 DEFINE_UNIT_TEST("Json unit tests: error")
 {
-    const char jsonCode[] = "";
-    Json* json = Json_Parse(jsonCode, sizeof(jsonCode) - 1, JsonFlags_None);
-    TEST(json == nullptr);
+    TEST(ParseJsonError("") == JsonError_WrongFormat);
+    TEST(ParseJsonError("123") != JsonError_None);
+    TEST(ParseJsonError("[1, 2") != JsonError_None);
+    TEST(ParseJsonError("{\"a\" 1}") != JsonError_None);
+    TEST(ParseJsonError("[\"\xff\"]") != JsonError_None);
+    TEST(ParseJsonError("[1] x") != JsonError_None);
 
-    Json_Destroy(json);
+    // Comments and scalar top level are opt-in
+    TEST(ParseJsonError("// comment\n[1]") != JsonError_None);
+    TEST(ParseJsonError("// comment\n[1]", JsonParseFlags_SupportComment) == JsonError_None);
+    TEST(ParseJsonError("123", JsonParseFlags_NoStrictTopLevel) == JsonError_None);
 }
 
-DEFINE_UNIT_TEST("JsonSchema unit tests")
+DEFINE_UNIT_TEST("Json unit tests: numbers")
 {
-#if 0
-    JsonSchema_DefineMember(vec2, x, float);
-    JsonSchema_DefineMember(vec2, y, float);
+    const Json json = ParseJson("[9007199254740993, -9223372036854775808, 0.1, 1e308, 5e-324, 10.0]");
+    TEST(JsonIsInteger(json.array[0]) && json.array[0].integer == 9007199254740993ll);
+    TEST(JsonIsInteger(json.array[1]) && json.array[1].integer == INT64_MIN);
+    TEST(!JsonIsInteger(json.array[2]) && JsonNumber(json.array[2]) == 0.1);
+    TEST(JsonNumber(json.array[3]) == 1e308);
+    TEST(JsonNumber(json.array[4]) == 5e-324);
+    TEST(!JsonIsInteger(json.array[5]) && JsonInteger(json.array[5]) == 10);
+}
 
-    const char jsonCode[] = "{\"x\": 1.0, \"y\": 2.0}";
-    Json* json = Json_Parse(jsonCode, sizeof(jsonCode) - 1, JsonFlags_None);
-    TEST(json != nullptr && json->type == JsonType_Object && Json_GetError(json) == JsonError_None);
+DEFINE_UNIT_TEST("Json unit tests: strings")
+{
+    const Json json = ParseJson("[\"\", \"plain\", \"\\\"\\\\\\/\\b\\f\\n\\r\\t\", \"\\u00e9\\ud83d\\ude00\"]");
+    TEST(json.array[0].length == 0);
+    TEST(json.array[1].length == 5 && strcmp(json.array[1].string, "plain") == 0);
+    TEST(strcmp(json.array[2].string, "\"\\/\b\f\n\r\t") == 0);
+    TEST(strcmp(json.array[3].string, "\xc3\xa9\xf0\x9f\x98\x80") == 0);
 
-    vec2 value;
-    JsonSchema_Deserialize("vec2", &value, json);
+    TEST(ParseJsonError("[\"\\x\"]") != JsonError_None);
+    TEST(ParseJsonError("[\"\\ud83d\"]") != JsonError_None);
+}
+
+DEFINE_UNIT_TEST("Json unit tests: in situ strings")
+{
+    char jsonCode[] = "{\"name\": \"plain\", \"escaped\": \"a\\nb\"}";
 
-    Json_Destroy(json);
-#endif
+    Json json;
+    const JsonResult result = JsonParse(jsonCode, (int32_t)strlen(jsonCode), JsonParseFlags_InSitu, gJsonBuffer, sizeof(gJsonBuffer), &json);
+    TEST(result.error == JsonError_None);
+
+    Json name, escaped;
+    TEST(JsonFind(json, "name", &name) && JsonFind(json, "escaped", &escaped));
+    TEST(name.string >= jsonCode && name.string < jsonCode + sizeof(jsonCode));
+    TEST(strcmp(name.string, "plain") == 0);
+    TEST(escaped.length == 3 && strcmp(escaped.string, "a\nb") == 0);
 }
-#endif
+
+DEFINE_UNIT_TEST("Json unit tests: find")
+{
+    const Json json = ParseJson("{\"a\": 1, \"b\": 2, \"c\": 3, \"d\": 4, \"e\": 5, \"f\": 6, \"g\": 7, \"h\": 8, \"i\": \"x\", \"a\": 10}");
+    TEST(json.length >= JSON_OBJECT_INDEX_MIN && json.indexed);
+
+    // The first member wins, like the linear scan
+    Json value;
+    TEST(JsonFind(json, "a", &value) && JsonInteger(value) == 1);
+    TEST(JsonFind(json, "h", &value) && JsonInteger(value) == 8);
+    TEST(!JsonFind(json, "z", &value));
+
+    const JsonKey key = JsonMakeKey("i");
+    TEST(JsonFindKey(json, key, &value) && value.type == JsonType_String);
+    TEST(JsonFindKeyWithType(json, key, JsonType_Number, &value) == JsonError_WrongType);
+    TEST(JsonFindWithType(json, "z", JsonType_Number, &value) == JsonError_MissingField);
+
+    // Objects built by hand have no index, large ones are scanned too
+    JsonObjectMember members[JSON_OBJECT_INDEX_MIN + 2];
+    const char* names[] = { "a", "b", "c", "d", "e", "f", "g", "h", "i", "j" };
+    for (int32_t i = 0; i < JSON_OBJECT_INDEX_MIN + 2; i++)
+    {
+        members[i].name = names[i];
+        members[i].value = JSON_NULL;
+        members[i].value.type = JsonType_Number;
+        members[i].value.length = JsonNumberKind_Integer;
+        members[i].value.integer = i;
+    }
+
+    Json built = JSON_NULL;
+    built.type = JsonType_Object;
+    built.length = JSON_OBJECT_INDEX_MIN + 2;
+    built.object = members;
+    TEST(!built.indexed);
+    TEST(JsonFind(built, "j", &value) && JsonInteger(value) == JSON_OBJECT_INDEX_MIN + 1);
+    TEST(!JsonFind(built, "z", &value));
+}
+
+DEFINE_UNIT_TEST("Json unit tests: reader")
+{
+    struct Source
+    {
+        const char* text;
+        int32_t     cursor;
+
+        // One byte at a time
+        static int32_t Read(void* userData, void* buffer, int32_t bufferSize)
+        {
+            Source* source = (Source*)userData;
+            if (bufferSize <= 0 || source->text[source->cursor] == '\0')
+            {
+                return 0;
+            }
+
+            ((char*)buffer)[0] = source->text[source->cursor++];
+            return 1;
+        }
+    };
+
+    Source source = { "{\"a\": [1, \"s\"], \"skip\": {\"x\": [[]]}, \"b\": null}", 0 };
+
+    char buffer[64];
+    JsonReader reader;
+    TEST(JsonReader_Init(&reader, JsonParseFlags_Default, buffer, sizeof(buffer), Source::Read, &source));
+
+    const char* name;
+    TEST(JsonReader_EnterObject(&reader));
+    TEST(JsonReader_NextMember(&reader, &name) && strcmp(name, "a") == 0);
+    TEST(JsonReader_EnterArray(&reader));
+    TEST(JsonReader_NextItem(&reader) && JsonReader_Next(&reader) == JsonToken_Value && JsonInteger(reader.value) == 1);
+    TEST(JsonReader_NextItem(&reader) && JsonReader_Next(&reader) == JsonToken_Value && strcmp(reader.value.string, "s") == 0);
+    TEST(!JsonReader_NextItem(&reader));
+    TEST(JsonReader_NextMember(&reader, &name) && strcmp(name, "skip") == 0);
+    TEST(JsonReader_SkipValue(&reader));
+    TEST(JsonReader_NextMember(&reader, &name) && strcmp(name, "b") == 0);
+    TEST(JsonReader_Next(&reader) == JsonToken_Value && reader.value.type == JsonType_Null);
+    TEST(!JsonReader_NextMember(&reader, &name));
+    TEST(JsonReader_Next(&reader) == JsonToken_End && reader.error == JsonError_None);
+}
+
+DEFINE_UNIT_TEST("Json unit tests: tape")
+{
+    const char jsonCode[] = "{\"levels\": [{\"id\": \"L0\"}, {\"id\": \"L\\u0031\", \"w\": 256}], \"n\": 2}";
+
+    static char tapeBuffer[64 * 1024];
+    JsonTape tape;
+    TEST(JsonTape_Build(jsonCode, sizeof(jsonCode) - 1, JsonParseFlags_Default, tapeBuffer, sizeof(tapeBuffer), &tape).error == JsonError_None);
+
+    const int32_t levels = JsonTape_Find(&tape, 0, "levels");
+    TEST(JsonTape_GetType(&tape, levels) == JsonType_Array && JsonTape_GetLength(&tape, levels) == 2);
+    TEST(JsonTape_Find(&tape, 0, "missing") < 0);
+
+    const int32_t level = JsonTape_GetItem(&tape, levels, 1);
+    char id[16];
+    TEST(JsonTape_GetString(&tape, JsonTape_Find(&tape, level, "id"), id, sizeof(id)) == 2 && strcmp(id, "L1") == 0);
+
+    Json count;
+    TEST(JsonTape_GetValue(&tape, JsonTape_Find(&tape, 0, "n"), &count) == JsonError_None && JsonInteger(count) == 2);
+
+    Json value, width;
+    TEST(JsonTape_Parse(&tape, level, JsonParseFlags_Default, gJsonBuffer, sizeof(gJsonBuffer), &value).error == JsonError_None);
+    TEST(JsonFind(value, "w", &width) && JsonInteger(width) == 256);
+}
+
+DEFINE_UNIT_TEST("Json unit tests: parallel")
+{
+    struct Serial
+    {
+        // Ranges in reverse order, like workers finishing out of order
+        static void ParallelFor(JsonRangeFunc func, void* data, int32_t count, int32_t batchSize)
+        {
+            (void)batchSize;
+            for (int32_t i = count - 1; i >= 0; i--)
+            {
+                func(data, i, i + 1);
+            }
+        }
+    };
+
+    static char jsonCode[256 * 1024];
+    int32_t length = snprintf(jsonCode, sizeof(jsonCode), "{\"items\": [");
+    for (int32_t i = 0; length < 200 * 1024; i++)
+    {
+        length += snprintf(jsonCode + length, sizeof(jsonCode) - length, "%s{\"id\": %d, \"name\": \"item\\u0020%d\", \"tags\": [%d, true]}", i > 0 ? ", " : "", i, i, i % 7);
+    }
+    length += snprintf(jsonCode + length, sizeof(jsonCode) - length, "], \"count\": 0}");
+
+    static char serialBuffer[8 * 1024 * 1024];
+    static char parallelBuffer[8 * 1024 * 1024];
+
+    Json serial, parallel;
+    const JsonResult serialResult = JsonParse(jsonCode, length, JsonParseFlags_Default, serialBuffer, sizeof(serialBuffer), &serial);
+    const JsonResult parallelResult = JsonParseParallel(jsonCode, length, JsonParseFlags_Default, Serial::ParallelFor, parallelBuffer, sizeof(parallelBuffer), &parallel);
+    TEST(serialResult.error == JsonError_None && parallelResult.error == JsonError_None);
+    TEST(JsonEquals(serial, parallel) && parallelResult.memoryUsage == serialResult.memoryUsage);
+
+    // Errors inside a chunk are the errors of the serial parser
+    strstr(jsonCode + length / 2, "}, {")[1] = ':';
+    TEST(JsonParseParallel(jsonCode, length, JsonParseFlags_Default, Serial::ParallelFor, parallelBuffer, sizeof(parallelBuffer), &parallel).error
+        == JsonParse(jsonCode, length, JsonParseFlags_Default, serialBuffer, sizeof(serialBuffer), &serial).error);
+}
+
+DEFINE_UNIT_TEST("Json unit tests: memory query")
+{
+    static char jsonCode[64 * 1024];
+    int32_t length = snprintf(jsonCode, sizeof(jsonCode), "{\"levels\": [");
+    for (int32_t i = 0; i < 100; i++)
+    {
+        length += snprintf(jsonCode + length, sizeof(jsonCode) - length, "%s{\"name\": \"level\\t%d\", \"tiles\": [%d, %d, %d], \"empty\": \"\"}", i > 0 ? ", " : "", i, i, i + 1, i + 2);
+    }
+    length += snprintf(jsonCode + length, sizeof(jsonCode) - length, "], \"count\": 100}");
+
+    int32_t bufferSize;
+    const JsonResult query = JsonQueryMemory(jsonCode, length, JsonParseFlags_Default, &bufferSize);
+    TEST(query.error == JsonError_None && bufferSize >= query.memoryUsage);
+
+    // The size is exact for an aligned buffer
+    alignas(16) static char buffer[64 * 1024];
+    Json json;
+    const JsonResult result = JsonParse(jsonCode, length, JsonParseFlags_Default, buffer, bufferSize, &json);
+    TEST(result.error == JsonError_None && result.memoryUsage == query.memoryUsage);
+    TEST(JsonParse(jsonCode, length, JsonParseFlags_Default, buffer, bufferSize - 16, &json).error == JsonError_OutOfMemory);
+
+    TEST(JsonQueryMemory("[1, 2", 5, JsonParseFlags_Default, &bufferSize).error != JsonError_None);
+}
+
+DEFINE_UNIT_TEST("Json unit tests: chunked")
+{
+    struct Chunks
+    {
+        char    pool[4096];
+        int32_t used;
+        int32_t count;
+
+        static void* Alloc(void* userData, int32_t minSize, int32_t* outSize)
+        {
+            Chunks* self = (Chunks*)userData;
+            if (self->used + minSize > (int32_t)sizeof(self->pool))
+            {
+                return NULL;
+            }
+
+            *outSize = minSize;
+            self->count++;
+            self->used += minSize;
+            return self->pool + self->used - minSize;
+        }
+    };
+
+    const char jsonCode[] = "{\"a\": [1, 2, 3, {\"b\": \"text\"}], \"c\": [[], {}, \"\\u00e9\"], \"d\": null}";
+    const Json json = ParseJson(jsonCode);
+
+    // Values continue in the chunks when the buffer is full
+    static Chunks chunks = {};
+    char buffer[100];
+    Json chunked;
+    const JsonResult result = JsonParseChunked(jsonCode, (int32_t)strlen(jsonCode), JsonParseFlags_Default, Chunks::Alloc, &chunks, buffer, sizeof(buffer), &chunked);
+    TEST(result.error == JsonError_None && chunks.count > 0);
+    TEST(JsonEquals(json, chunked));
+}
+
+DEFINE_UNIT_TEST("Json unit tests: writer")
+{
+    char buffer[256];
+    JsonWriter writer;
+    TEST(JsonWriter_Init(&writer, JsonWriteFlags_Default, buffer, sizeof(buffer), NULL, NULL));
+
+    TEST(JsonWriter_BeginObject(&writer));
+    TEST(JsonWriter_Name(&writer, "a") && JsonWriter_Integer(&writer, -42));
+    TEST(JsonWriter_Name(&writer, "b") && JsonWriter_BeginArray(&writer));
+    TEST(JsonWriter_Number(&writer, 0.1) && JsonWriter_Number(&writer, 1e21) && JsonWriter_Number(&writer, 2.0) && JsonWriter_Number(&writer, NAN));
+    TEST(JsonWriter_EndArray(&writer));
+    TEST(JsonWriter_Name(&writer, "c") && JsonWriter_String(&writer, "\"\n\x01", -1));
+    TEST(JsonWriter_EndObject(&writer) && JsonWriter_Finish(&writer));
+    TEST(strcmp(buffer, "{\"a\":-42,\"b\":[0.1,1e21,2.0,null],\"c\":\"\\\"\\n\\u0001\"}") == 0);
+
+    // Misuse is reported, not written
+    TEST(JsonWriter_Init(&writer, JsonWriteFlags_Default, buffer, sizeof(buffer), NULL, NULL));
+    TEST(JsonWriter_BeginObject(&writer) && !JsonWriter_Integer(&writer, 1) && writer.error == JsonError_UnexpectedToken);
+}
+
+DEFINE_UNIT_TEST("Json unit tests: writer round trip")
+{
+    const char jsonCode[] = "{\"s\": \"a\\u00e9\\t\", \"n\": [0, -1.5, 3.141592653589793, 1e-7, 123456789012345678], \"o\": {\"\": null, \"t\": true}}";
+    const Json json = ParseJson(jsonCode);
+
+    for (int32_t pretty = 0; pretty < 2; pretty++)
+    {
+        static char output[4096];
+        JsonWriter writer;
+        TEST(JsonWriter_Init(&writer, pretty ? JsonWriteFlags_Pretty : JsonWriteFlags_Default, output, sizeof(output), NULL, NULL));
+        TEST(JsonWriter_Value(&writer, json) && JsonWriter_Finish(&writer));
+
+        static char parseBuffer[64 * 1024];
+        Json written;
+        TEST(JsonParse(output, writer.length, JsonParseFlags_Default, parseBuffer, sizeof(parseBuffer), &written).error == JsonError_None);
+        TEST(JsonEquals(json, written));
+    }
+}
+
+//! LEAVE AN EMPTY LINE HERE, REQUIRE BY GCC/G++
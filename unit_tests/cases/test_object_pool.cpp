@@ -0,0 +1,129 @@
+#include "../test_framework.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "Container/ObjectPool.h"
+
+struct PoolItem
+{
+    int32_t     value;
+    int32_t     padding[3];
+};
+
+// Reference: what each handle the test got should see in the pool
+struct PoolReference
+{
+    ObjectHandle    handle;
+    int32_t         value;
+    bool            alive;
+};
+
+static TestRandom gPoolRandom(1);
+
+DEFINE_UNIT_TEST("ObjectPool unit tests: null handle")
+{
+    MEMORY_TRACKING();
+
+    ObjectPool<PoolItem> pool;
+    TEST(!pool.IsAlive(OBJECT_HANDLE_NONE));
+    TEST(pool.Get(OBJECT_HANDLE_NONE) == nullptr);
+    TEST(!pool.Free(OBJECT_HANDLE_NONE));
+
+    PoolItem* item;
+    const ObjectHandle handle = pool.Alloc(&item);
+    TEST(handle != OBJECT_HANDLE_NONE && pool.Get(handle) == item);
+    TEST(!pool.IsAlive(OBJECT_HANDLE_NONE));
+
+    pool.CleanUp();
+}
+
+DEFINE_UNIT_TEST("ObjectPool unit tests: stale handles")
+{
+    MEMORY_TRACKING();
+
+    ObjectPool<PoolItem> pool;
+
+    const ObjectHandle first = pool.Alloc();
+    TEST(pool.Free(first));
+    TEST(!pool.IsAlive(first) && pool.Get(first) == nullptr);
+    TEST(!pool.Free(first));
+
+    // The slot is reused with a new generation, the old handle stay dead
+    const ObjectHandle second = pool.Alloc();
+    TEST((second & ObjectPool<PoolItem>::INDEX_MASK) == (first & ObjectPool<PoolItem>::INDEX_MASK));
+    TEST(second != first);
+    TEST(pool.IsAlive(second) && !pool.IsAlive(first));
+    TEST(pool.Count() == 1);
+
+    // Generations wrap without ever making the null handle
+    ObjectHandle handle = second;
+    for (uint32_t i = 0; i < ObjectPool<PoolItem>::GENERATION_MASK + 2; i++)
+    {
+        TEST(pool.Free(handle));
+        handle = pool.Alloc();
+        TEST(handle != OBJECT_HANDLE_NONE && (handle >> ObjectPool<PoolItem>::INDEX_BITS) != 0);
+    }
+
+    pool.CleanUp();
+}
+
+DEFINE_UNIT_TEST("ObjectPool unit tests: alloc and free against a reference")
+{
+    MEMORY_TRACKING();
+
+    constexpr int32_t REFERENCE_COUNT = 20000;
+    static PoolReference references[REFERENCE_COUNT];
+    memset(references, 0, sizeof(references));
+
+    ObjectPool<PoolItem> pool;
+
+    int32_t referenceCount = 0;
+    int32_t aliveCount = 0;
+    for (int32_t step = 0; step < 60000; step++)
+    {
+        const bool alloc = referenceCount < REFERENCE_COUNT && (aliveCount == 0 || gPoolRandom.Next(100) < 60);
+        if (alloc)
+        {
+            PoolItem* item;
+            const ObjectHandle handle = pool.Alloc(&item);
+            TEST(handle != OBJECT_HANDLE_NONE);
+            item->value = step;
+
+            references[referenceCount++] = PoolReference{ handle, step, true };
+            aliveCount++;
+        }
+        else
+        {
+            // Stale handles are picked too, they must be rejected
+            PoolReference* reference = &references[gPoolRandom.Next((uint32_t)referenceCount)];
+            TEST(pool.Free(reference->handle) == reference->alive);
+            aliveCount -= reference->alive;
+            reference->alive = false;
+        }
+
+        TEST(pool.Count() == aliveCount);
+    }
+
+    int64_t aliveSum = 0;
+    for (int32_t i = 0; i < referenceCount; i++)
+    {
+        const PoolItem* item = pool.Get(references[i].handle);
+        TEST((item != nullptr) == references[i].alive);
+        TEST(!item || item->value == references[i].value);
+        aliveSum += references[i].alive ? references[i].value : 0;
+    }
+
+    // Dense iteration see every alive object once, and HandleAt map back to them
+    int64_t iterateSum = 0;
+    pool.ForEach([&](PoolItem& item) { iterateSum += item.value; });
+    TEST(iterateSum == aliveSum);
+
+    for (int32_t i = 0; i < pool.Count(); i++)
+    {
+        TEST(pool.Get(pool.HandleAt(i)) == &pool.At(i));
+    }
+
+    pool.CleanUp();
+    TEST(pool.Count() == 0);
+}
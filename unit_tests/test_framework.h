@@ -3,6 +3,7 @@
 #include <stdio.h>
 #include <assert.h>
 #include <stdlib.h>
+#include <stdint.h>
 
 #include <vectormath.h>
 
@@ -77,6 +78,22 @@ extern "C" __declspec(dllimport) int __stdcall IsDebuggerPresent(void);
         }                                                                       \
     } while (false)
 
+// Xorshift random, seeded so a failing test replay the same sequence
+struct TestRandom
+{
+    uint32_t                state;
+
+    explicit                TestRandom(uint32_t seed) : state(seed) { assert(seed != 0); }
+
+    uint32_t Next(uint32_t range)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state % range;
+    }
+};
+
 // ------------------------------------------------------------------------------------------
 // Define test runner
 // ------------------------------------------------------------------------------------------